@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/rng-stream.h"
+
+/**
+ * \file
+ * \ingroup core-examples
+ * \ingroup randomvariable
+ * Measure the throughput of the random number generation.
+ *
+ * The uniform numbers of an RngStream are measured both one by one,
+ * with RandU01 (), and by batches, with RandU01 (double *, uint32_t).
+ * Then the GetValue () rate of a few random variables is measured.
+ *
+ * \code
+ *   ./waf --run "bench-random-variable-stream --count=10000000"
+ * \endcode
+ */
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * Print a rate.
+ *
+ * \param [in] name The name of the measure.
+ * \param [in] count The number of values generated.
+ * \param [in] ms The duration, in ms.
+ * \param [in] sum The sum of the values, printed so that the
+ *             generation is not optimized away.
+ */
+void
+Print (std::string name, uint32_t count, int64_t ms, double sum)
+{
+  double rate = count / (std::max<int64_t> (ms, 1) / 1000.0);
+  std::cout << std::left << std::setw (24) << name
+            << std::setw (16) << std::setprecision (4) << rate
+            << std::setw (16) << std::setprecision (4) << 1e9 / rate
+            << sum / count << std::endl;
+}
+
+/**
+ * Measure the GetValue () rate of a random variable.
+ *
+ * \param [in] name The name of the random variable.
+ * \param [in] rv The random variable.
+ * \param [in] count The number of values to generate.
+ */
+void
+BenchVariable (std::string name, Ptr<RandomVariableStream> rv, uint32_t count)
+{
+  double sum = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      sum += rv->GetValue ();
+    }
+  Print (name, count, clock.End (), sum);
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t count = 10000000;
+  uint32_t batch = 1024;
+
+  CommandLine cmd;
+  cmd.Usage ("Measure the throughput of the random number generation.");
+  cmd.AddValue ("count", "number of values generated per measure", count);
+  cmd.AddValue ("batch", "size of the batches of uniform numbers", batch);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::left << std::setw (24) << "generator"
+            << std::setw (16) << "values/s"
+            << std::setw (16) << "ns/value"
+            << "mean" << std::endl;
+
+  {
+    RngStream rng (1, 0, 0);
+    double sum = 0;
+    SystemWallClockMs clock;
+    clock.Start ();
+    for (uint32_t i = 0; i < count; ++i)
+      {
+        sum += rng.RandU01 ();
+      }
+    Print ("RandU01 (single)", count, clock.End (), sum);
+  }
+
+  {
+    RngStream rng (1, 0, 0);
+    std::vector<double> values (batch);
+    double sum = 0;
+    uint32_t done = 0;
+    SystemWallClockMs clock;
+    clock.Start ();
+    while (done < count)
+      {
+        uint32_t n = std::min (batch, count - done);
+        rng.RandU01 (values.data (), n);
+        for (uint32_t i = 0; i < n; ++i)
+          {
+            sum += values[i];
+          }
+        done += n;
+      }
+    Print ("RandU01 (batch)", count, clock.End (), sum);
+  }
+
+  BenchVariable ("Uniform", CreateObject<UniformRandomVariable> (), count);
+  BenchVariable ("Exponential", CreateObject<ExponentialRandomVariable> (), count);
+  BenchVariable ("Normal", CreateObject<NormalRandomVariable> (), count);
+
+  Ptr<EmpiricalRandomVariable> empirical = CreateObject<EmpiricalRandomVariable> ();
+  empirical->CDF (0.0, 0.0);
+  empirical->CDF (5.0, 0.25);
+  empirical->CDF (10.0, 0.75);
+  empirical->CDF (20.0, 1.0);
+  BenchVariable ("Empirical", empirical, count);
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+/**
+ * \file
+ * \ingroup core-examples
+ * \ingroup scheduler
+ * Compare the event rate of the available schedulers.
+ *
+ * Each scheduler is measured with the classic "hold" model: a population
+ * of pending events is kept constant by scheduling a new event, at an
+ * exponentially distributed delay, every time one expires.
+ *
+ * Two figures are printed per scheduler:
+ *  - "queue": Insert/RemoveNext on the scheduler alone, which isolates
+ *    the cost of the data structure;
+ *  - "simulator": the same load through Simulator::Schedule, which also
+ *    includes the allocation and release of the EventImpl of every event.
+ *
+ * \code
+ *   ./waf --run "bench-scheduler --pop=100000 --total=2000000"
+ * \endcode
+ */
+
+using namespace ns3;
+
+namespace {
+
+/** Random event delays, in ns. */
+Ptr<ExponentialRandomVariable> g_delay;
+/** Number of events run by the simulator benchmark. */
+uint32_t g_count = 0;
+/** Number of events to run by the simulator benchmark. */
+uint32_t g_total = 0;
+
+/** Hold-model event: reschedule a new event until g_total is reached. */
+void
+Hold (void)
+{
+  if (++g_count < g_total)
+    {
+      Simulator::Schedule (NanoSeconds (g_delay->GetInteger ()), &Hold);
+    }
+}
+
+/**
+ * Run the hold model directly on a scheduler.
+ *
+ * \param [in] factory The scheduler factory.
+ * \param [in] pop The event population.
+ * \param [in] total The number of events to process.
+ * \returns The event rate, in events/s.
+ */
+double
+BenchQueue (ObjectFactory factory, uint32_t pop, uint32_t total)
+{
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  uint32_t uid = 0;
+  for (uint32_t i = 0; i < pop; ++i)
+    {
+      Scheduler::Event ev;
+      ev.impl = 0;
+      ev.key.m_ts = g_delay->GetInteger ();
+      ev.key.m_uid = uid++;
+      ev.key.m_context = 0;
+      scheduler->Insert (ev);
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < total; ++i)
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      ev.key.m_ts += g_delay->GetInteger ();
+      ev.key.m_uid = uid++;
+      scheduler->Insert (ev);
+    }
+  int64_t ms = clock.End ();
+  return total / (std::max<int64_t> (ms, 1) / 1000.0);
+}
+
+/**
+ * Run the hold model through the simulator.
+ *
+ * \param [in] factory The scheduler factory.
+ * \param [in] pop The event population.
+ * \param [in] total The number of events to process.
+ * \returns The event rate, in events/s.
+ */
+double
+BenchSimulator (ObjectFactory factory, uint32_t pop, uint32_t total)
+{
+  Simulator::SetScheduler (factory);
+  g_count = 0;
+  g_total = total;
+  for (uint32_t i = 0; i < pop; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (g_delay->GetInteger ()), &Hold);
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+  return g_count / (std::max<int64_t> (ms, 1) / 1000.0);
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t pop = 100000;
+  uint32_t total = 1000000;
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,"
+    "ns3::CalendarScheduler,ns3::PriorityQueueScheduler";
+
+  CommandLine cmd;
+  cmd.Usage ("Compare the event rate of the simulator schedulers.");
+  cmd.AddValue ("pop", "event population size", pop);
+  cmd.AddValue ("total", "total number of events to run", total);
+  cmd.AddValue ("schedulers", "comma separated list of scheduler TypeIds", schedulers);
+  cmd.Parse (argc, argv);
+
+  g_delay = CreateObject<ExponentialRandomVariable> ();
+  g_delay->SetAttribute ("Mean", DoubleValue (100));
+
+  std::cout << "population: " << pop << ", events: " << total << std::endl;
+  std::cout << std::left << std::setw (32) << "scheduler"
+            << std::setw (16) << "queue (ev/s)"
+            << std::setw (16) << "simulator (ev/s)" << std::endl;
+
+  std::istringstream list (schedulers);
+  std::string name;
+  while (std::getline (list, name, ','))
+    {
+      ObjectFactory factory (name);
+      double queue = BenchQueue (factory, pop, total);
+      double simulator = BenchSimulator (factory, pop, total);
+      std::cout << std::left << std::setw (32) << name
+                << std::setw (16) << std::setprecision (4) << queue
+                << std::setw (16) << std::setprecision (4) << simulator
+                << std::endl;
+    }
+  return 0;
+}
@@ -28,6 +28,7 @@
 #include "attribute.h"
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
+#include "small-object-pool.h"
 #include <typeinfo>
 
 /**
@@ -154,6 +155,28 @@ public:
    */
   virtual std::string GetTypeid (void) const = 0;
 
+  /**
+   * Allocate the storage of a callback implementation from the
+   * SmallObjectPool: MakeCallback() is often called per packet.
+   *
+   * \param [in] size The size of the object.
+   * \returns The storage for the object.
+   */
+  static void * operator new (std::size_t size)
+  {
+    return SmallObjectPool::Allocate (size);
+  }
+  /**
+   * Release the storage of a callback implementation.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the object.
+   */
+  static void operator delete (void *p, std::size_t size)
+  {
+    SmallObjectPool::Deallocate (p, size);
+  }
+
 protected:
   /**
    * \param [in] mangled The mangled string
@@ -26,6 +26,7 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
 #include <sstream>
 
 /**
@@ -150,6 +151,8 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into ranges of matching indices.
  */
 class ArrayMatcher
 {
@@ -161,13 +164,19 @@ public:
    */
   ArrayMatcher (std::string element);
   /**
-   * Test if a specific index matches the Config Path.
+   * Get the indices matching the Config path specification.
    *
-   * \param [in] i The index.
-   * \returns \c true if the index matches the Config Path.
+   * \returns The ranges of matching indices, bounds included,
+   *          sorted and disjoint.
    */
-  bool Matches (uint32_t i) const;
+  std::vector<std::pair<uint32_t, uint32_t> > GetRanges (void) const;
 private:
+  /**
+   * Parse a Config path specification, or a part of it.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -178,6 +187,8 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** The ranges of matching indices, sorted and disjoint. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 
 };  // class ArrayMatcher
 
@@ -186,69 +197,73 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
+  // Merge the overlapping and adjacent ranges.
+  std::sort (m_ranges.begin (), m_ranges.end ());
+  std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = m_ranges.begin ();
+       i != m_ranges.end (); i++)
+    {
+      if (!ranges.empty () &&
+          (ranges.back ().second == 0xffffffff || i->first <= ranges.back ().second + 1))
+        {
+          ranges.back ().second = std::max (ranges.back ().second, i->second);
+        }
+      else
+        {
+          ranges.push_back (*i);
+        }
+    }
+  m_ranges.swap (ranges);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_ranges.push_back (std::make_pair (0, 0xffffffff));
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      std::string left = element.substr (0, tmp-0);
+      std::string right = element.substr (tmp+1, element.size () - (tmp + 1));
+      Parse (left);
+      Parse (right);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      m_ranges.push_back (std::make_pair (value, value));
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-  return false;
+}
+std::vector<std::pair<uint32_t, uint32_t> >
+ArrayMatcher::GetRanges (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_ranges;
 }
 
 bool
@@ -263,17 +278,17 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 
 /**
  * \ingroup config-impl
- * Abstract class to parse Config paths into object references.
+ * Abstract class to resolve a CompiledPath into object references.
  */
 class Resolver
 {
 public:
   /**
-   * Construct from a base Config path.
+   * Construct from a compiled Config path.
    *
-   * \param [in] path The Config path.
+   * \param [in] path The Config path, which must outlive the resolver.
    */
-  Resolver (std::string path);
+  Resolver (const CompiledPath &path);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -287,23 +302,31 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] element The first remaining element of the Config path.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (uint32_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] element The index element of the Config path.
+   * \param [in] root The object holding the container.
+   * \param [in] info The container attribute.
+   */
+  void DoArrayResolve (uint32_t element, Ptr<Object> root,
+                       const struct TypeId::AttributeInformation &info);
+  /**
+   * Handle one object of a container matching an index of the path.
+   *
+   * \param [in] element The index element of the Config path.
+   * \param [in] index The index of the object in its container.
+   * \param [in] object The object.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolveOne (uint32_t element, uint32_t index, Ptr<Object> object);
   /**
    * Handle one object found on the path.
    *
@@ -327,46 +350,26 @@ private:
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
   /** The Config path. */
-  std::string m_path;
+  const CompiledPath &m_path;
 
 };  // class Resolver
 
-Resolver::Resolver (std::string path)
+Resolver::Resolver (const CompiledPath &path)
   : m_path (path)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << path.GetPath ());
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -392,13 +395,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t element, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << element << root);
 
-  if (next == std::string::npos)
+  if (element == m_path.m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -414,8 +415,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const std::string &item = m_path.m_elements[element].name;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -426,11 +426,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (element + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -447,7 +446,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (element + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -477,7 +476,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (element + 1, object);
       m_workStack.pop_back ();
     }
   else 
@@ -516,7 +515,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                     }
                   foundMatch = true;
                   m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
+                  DoResolve (element + 1, object);
                   m_workStack.pop_back ();
                 }
               // attempt to cast to an object vector.
@@ -524,12 +523,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                 dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
               if (vectorChecker != 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
+                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath ());
                   foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
                   m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
+                  DoArrayResolve (element + 1, root, info);
                   m_workStack.pop_back ();
                 }
               // this could be anything else and we don't know what to do with it.
@@ -548,34 +545,152 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t element, Ptr<Object> root,
+                          const struct TypeId::AttributeInformation &info)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << element << root << info.name);
+  if (element == m_path.m_elements.size ())
+    {
+      return;
+    }
+  const std::vector<CompiledPath::Range> &indices = m_path.m_elements[element].indices;
+
+  //
+  // When the index of an object is its position in the container, as in
+  // the NodeList and the DeviceList, get the matching objects directly.
+  //
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+  uint32_t n;
+  if (accessor != 0 && accessor->HasPositionalIndex () &&
+      accessor->GetN (PeekPointer (root), &n))
     {
+      for (std::vector<CompiledPath::Range>::const_iterator i = indices.begin ();
+           i != indices.end () && i->first < n; i++)
+        {
+          uint32_t last = std::min (i->second, n - 1);
+          for (uint32_t j = i->first; ; j++)
+            {
+              uint32_t index;
+              Ptr<Object> object = accessor->Get (PeekPointer (root), j, &index);
+              DoArrayResolveOne (element, index, object);
+              if (j == last)
+                {
+                  break;
+                }
+            }
+        }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  // Otherwise, get all the objects, sorted by index.
+  ObjectPtrContainerValue container;
+  root->GetAttribute (info.name, container);
+  std::vector<CompiledPath::Range>::const_iterator range = indices.begin ();
   ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  for (it = container.Begin (); it != container.End () && range != indices.end (); ++it)
     {
-      if (matcher.Matches ((*it).first))
+      while (range != indices.end () && range->second < (*it).first)
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          range++;
+        }
+      if (range != indices.end () && range->first <= (*it).first)
+        {
+          DoArrayResolveOne (element, (*it).first, (*it).second);
         }
     }
 }
 
+void
+Resolver::DoArrayResolveOne (uint32_t element, uint32_t index, Ptr<Object> object)
+{
+  NS_LOG_FUNCTION (this << element << index << object);
+  std::ostringstream oss;
+  oss << index;
+  m_workStack.push_back (oss.str ());
+  DoResolve (element + 1, object);
+  m_workStack.pop_back ();
+}
+
+/**
+ * \ingroup config-impl
+ * Resolver collecting the matching objects and their contexts.
+ */
+class LookupMatchesResolver : public Resolver
+{
+public:
+  /**
+   * Construct from a compiled Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  LookupMatchesResolver (const CompiledPath &path)
+    : Resolver (path)
+  {}
+  virtual void DoOne (Ptr<Object> object, std::string path)
+  {
+    m_objects.push_back (object);
+    m_contexts.push_back (path);
+  }
+  std::vector<Ptr<Object> > m_objects; //!< The matching objects.
+  std::vector<std::string> m_contexts; //!< The contexts of the matching objects.
+};
+
+/**
+ * \ingroup config-impl
+ * Resolver connecting, or disconnecting, a trace source of each
+ * matching object as soon as it is found.
+ */
+class TraceResolver : public Resolver
+{
+public:
+  /** The operation to apply to the trace sources. */
+  enum Operation
+  {
+    CONNECT,                   //!< TraceConnect.
+    CONNECT_WITHOUT_CONTEXT,   //!< TraceConnectWithoutContext.
+    DISCONNECT,                //!< TraceDisconnect.
+    DISCONNECT_WITHOUT_CONTEXT //!< TraceDisconnectWithoutContext.
+  };
+  /**
+   * Construct from a compiled Config path.
+   *
+   * \param [in] path The Config path.
+   * \param [in] operation The operation to apply.
+   * \param [in] name The name of the trace source.
+   * \param [in] cb The sink.
+   */
+  TraceResolver (const CompiledPath &path, enum Operation operation,
+                 std::string name, const CallbackBase &cb)
+    : Resolver (path),
+      m_operation (operation),
+      m_name (name),
+      m_cb (cb)
+  {}
+  virtual void DoOne (Ptr<Object> object, std::string path)
+  {
+    switch (m_operation)
+      {
+      case CONNECT:
+        object->TraceConnect (m_name, path + m_name, m_cb);
+        break;
+      case CONNECT_WITHOUT_CONTEXT:
+        object->TraceConnectWithoutContext (m_name, m_cb);
+        break;
+      case DISCONNECT:
+        object->TraceDisconnect (m_name, path + m_name, m_cb);
+        break;
+      case DISCONNECT_WITHOUT_CONTEXT:
+        object->TraceDisconnectWithoutContext (m_name, m_cb);
+        break;
+      }
+  }
+private:
+  enum Operation m_operation; //!< The operation to apply.
+  std::string m_name;         //!< The name of the trace source.
+  const CallbackBase &m_cb;   //!< The sink.
+};
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -595,6 +710,13 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Resolve a Config path from every root namespace object, and then
+   * from the root of the "/Names" namespace.
+   *
+   * \param [in,out] resolver The resolver of the path.
+   */
+  void Resolve (Resolver &resolver) const;
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -643,8 +765,7 @@ ConfigImpl::Set (std::string path, const AttributeValue &value)
 
   std::string root, leaf;
   ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.Set (leaf, value);
+  CompiledPath (root).Set (leaf, value);
 }
 void 
 ConfigImpl::ConnectWithoutContext (std::string path, const CallbackBase &cb)
@@ -652,8 +773,7 @@ ConfigImpl::ConnectWithoutContext (std::string path, const CallbackBase &cb)
   NS_LOG_FUNCTION (this << path << &cb);
   std::string root, leaf;
   ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.ConnectWithoutContext (leaf, cb);
+  CompiledPath (root).ConnectWithoutContext (leaf, cb);
 }
 void 
 ConfigImpl::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
@@ -661,8 +781,7 @@ ConfigImpl::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
   NS_LOG_FUNCTION (this << path << &cb);
   std::string root, leaf;
   ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.DisconnectWithoutContext (leaf, cb);
+  CompiledPath (root).DisconnectWithoutContext (leaf, cb);
 }
 void 
 ConfigImpl::Connect (std::string path, const CallbackBase &cb)
@@ -671,8 +790,7 @@ ConfigImpl::Connect (std::string path, const CallbackBase &cb)
 
   std::string root, leaf;
   ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.Connect (leaf, cb);
+  CompiledPath (root).Connect (leaf, cb);
 }
 void 
 ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
@@ -681,28 +799,20 @@ ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
 
   std::string root, leaf;
   ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.Disconnect (leaf, cb);
+  CompiledPath (root).Disconnect (leaf, cb);
 }
 
 MatchContainer 
 ConfigImpl::LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
-  class LookupMatchesResolver : public Resolver 
-  {
-  public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
-    {}
-    virtual void DoOne (Ptr<Object> object, std::string path)
-    {
-      m_objects.push_back (object);
-      m_contexts.push_back (path);
-    }
-    std::vector<Ptr<Object> > m_objects;
-    std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  return CompiledPath (path).LookupMatches ();
+}
+
+void
+ConfigImpl::Resolve (Resolver &resolver) const
+{
+  NS_LOG_FUNCTION (this << &resolver);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -714,8 +824,6 @@ ConfigImpl::LookupMatches (std::string path)
   // looking at the root of the "/Names" namespace during this go.
   //
   resolver.Resolve (0);
-
-  return MatchContainer (resolver.m_objects, resolver.m_contexts, path);
 }
 
 void 
@@ -754,6 +862,91 @@ ConfigImpl::GetRootNamespaceObject (uint32_t i) const
 }
 
 
+CompiledPath::CompiledPath (std::string path)
+  : m_path (path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  std::string canonical = path;
+  std::string::size_type tmp = canonical.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      canonical = "/" + canonical;
+    }
+  tmp = canonical.find_last_of ("/");
+  if (tmp != (canonical.size () - 1))
+    {
+      // no slash at end
+      canonical = canonical + "/";
+    }
+
+  // split the elements between the slashes
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = canonical.find ("/", start)) != std::string::npos)
+    {
+      Element element;
+      element.name = canonical.substr (start, next - start);
+      element.indices = ArrayMatcher (element.name).GetRanges ();
+      m_elements.push_back (element);
+      start = next + 1;
+    }
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_path;
+}
+MatchContainer
+CompiledPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  LookupMatchesResolver resolver (*this);
+  ConfigImpl::Get ()->Resolve (resolver);
+  return MatchContainer (resolver.m_objects, resolver.m_contexts, m_path);
+}
+void
+CompiledPath::Set (std::string name, const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << name << &value);
+  // Find all the objects before changing any of them, since a new
+  // attribute value may change the objects on the path.
+  MatchContainer container = LookupMatches ();
+  container.Set (name, value);
+}
+void
+CompiledPath::Connect (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  TraceResolver resolver (*this, TraceResolver::CONNECT, name, cb);
+  ConfigImpl::Get ()->Resolve (resolver);
+}
+void
+CompiledPath::ConnectWithoutContext (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  TraceResolver resolver (*this, TraceResolver::CONNECT_WITHOUT_CONTEXT, name, cb);
+  ConfigImpl::Get ()->Resolve (resolver);
+}
+void
+CompiledPath::Disconnect (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  TraceResolver resolver (*this, TraceResolver::DISCONNECT, name, cb);
+  ConfigImpl::Get ()->Resolve (resolver);
+}
+void
+CompiledPath::DisconnectWithoutContext (std::string name, const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << name << &cb);
+  TraceResolver resolver (*this, TraceResolver::DISCONNECT_WITHOUT_CONTEXT, name, cb);
+  ConfigImpl::Get ()->Resolve (resolver);
+}
+
+
 void Reset (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
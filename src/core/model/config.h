@@ -22,6 +22,7 @@
 
 #include "ptr.h"
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -258,6 +259,104 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief A path parsed once, to match objects many times.
+ *
+ * Config::Set, Config::Connect and the other functions of the Config
+ * namespace parse their path on every call.  A CompiledPath splits its
+ * path into elements and parses the container indices ("3", "*",
+ * "[2-5]", "1|4") once, and then looks up the matched indices directly
+ * in the containers of the path, such as the NodeList and the
+ * DeviceList, instead of getting every object of every container.
+ *
+ * The paths are matched exactly as by Config::LookupMatches.
+ */
+class CompiledPath
+{
+public:
+  /**
+   * \param [in] path A path to match objects, such as
+   *                  "/NodeList/[0-3]/DeviceList/0".
+   */
+  CompiledPath (std::string path);
+
+  /**
+   * \returns The path used to perform the object matching.
+   */
+  std::string GetPath (void) const;
+  /**
+   * \returns A container which contains all the objects which match
+   *          the path.
+   * \sa ns3::Config::LookupMatches
+   */
+  MatchContainer LookupMatches (void) const;
+
+  /**
+   * \param [in] name Name of attribute to set
+   * \param [in] value Value to set to the attribute
+   *
+   * Set the specified attribute value to all the objects which match
+   * the path.
+   * \sa ns3::Config::Set
+   */
+  void Set (std::string name, const AttributeValue &value) const;
+  /**
+   * \param [in] name The name of the trace source to connect to
+   * \param [in] cb The sink to connect to the trace source
+   *
+   * Connect the specified sink to all the objects which match the
+   * path, in a single walk of the path: each object is connected as
+   * soon as it is found.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to connect to
+   * \param [in] cb The sink to connect to the trace source
+   *
+   * Connect the specified sink to all the objects which match the
+   * path, in a single walk of the path.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to disconnect from
+   * \param [in] cb The sink to disconnect from the trace source
+   *
+   * Disconnect the specified sink from all the objects which match the
+   * path.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (std::string name, const CallbackBase &cb) const;
+  /**
+   * \param [in] name The name of the trace source to disconnect from
+   * \param [in] cb The sink to disconnect from the trace source
+   *
+   * Disconnect the specified sink from all the objects which match the
+   * path.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (std::string name, const CallbackBase &cb) const;
+
+private:
+  friend class Resolver;
+
+  /** A range of container indices, bounds included. */
+  typedef std::pair<uint32_t, uint32_t> Range;
+  /** An element of the path, between two slashes. */
+  struct Element
+  {
+    std::string name;           //!< The text of the element.
+    std::vector<Range> indices; //!< The container indices it matches, sorted and disjoint.
+  };
+
+  /** The path used to perform the object matching. */
+  std::string m_path;
+  /** The elements of the path. */
+  std::vector<Element> m_elements;
+};
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -19,6 +19,7 @@
  */
 
 #include "event-impl.h"
+#include "small-object-pool.h"
 #include "log.h"
 
 /**
@@ -31,6 +32,18 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+void *
+EventImpl::operator new (std::size_t size)
+{
+  return SmallObjectPool::Allocate (size);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  SmallObjectPool::Deallocate (p, size);
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
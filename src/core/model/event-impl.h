@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,21 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate the storage of an event from the SmallObjectPool.
+   *
+   * \param [in] size The size of the event object.
+   * \returns The storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an event allocated by operator new().
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the event object.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
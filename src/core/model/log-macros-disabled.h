@@ -52,6 +52,9 @@
 #define NS_LOG_FUNCTION(parameters) \
         NS_LOG_NOOP_INTERNAL (parameters)
 
+#define NS_LOG_SAMPLED(level, period, msg) \
+        NS_LOG_NOOP_INTERNAL (msg)
+
 #define NS_LOG_UNCOND(msg) \
         NS_LOG_NOOP_INTERNAL (msg)
 
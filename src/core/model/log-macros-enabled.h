@@ -29,6 +29,7 @@
 
 #ifdef NS3_LOG_ENABLE
 
+#include <atomic>
 
 /**
  * \ingroup logging
@@ -130,6 +131,35 @@
 #define NS_LOG_CONDITION
 #endif
 
+#ifndef NS_LOG_MAX_LEVEL
+/**
+ * \ingroup logging
+ * The most verbose LogLevel compiled in.
+ *
+ * The log statements above this ceiling are removed at compile time,
+ * including the enabled check and the formatting of their arguments.
+ * Like \c NS_LOG_CONDITION, it can be defined in a `.cc` file, before
+ * the includes, to set the ceiling of the components of this file:
+ * \code
+ *   #define NS_LOG_MAX_LEVEL ns3::LOG_LEVEL_INFO
+ * \endcode
+ * or for the whole build with
+ * `CXXFLAGS="-DNS_LOG_MAX_LEVEL=ns3::LOG_LEVEL_WARN"`.
+ */
+#define NS_LOG_MAX_LEVEL ns3::LOG_LEVEL_ALL
+#endif
+
+/**
+ * \ingroup logging
+ * Check if a LogLevel is below the compile time ceiling
+ * \c NS_LOG_MAX_LEVEL, and enabled at run time.
+ * \param [in] level The LogLevel.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ */
+#define NS_LOG_IS_ENABLED(level)                                \
+  (((NS_LOG_MAX_LEVEL) & (level)) != 0 && g_log.IsEnabled (level))
+
 /**
  * \ingroup logging
  *
@@ -153,7 +183,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (NS_LOG_IS_ENABLED (level))                            \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -177,7 +207,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_IS_ENABLED (ns3::LOG_FUNCTION))                \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -214,7 +244,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_IS_ENABLED (ns3::LOG_FUNCTION))                \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -228,6 +258,40 @@
   while (false)
 
 
+/**
+ * \ingroup logging
+ *
+ * Log one of every \c period messages of a call site, for the
+ * statements of hot paths which would otherwise flood the output and
+ * slow down the simulation.
+ *
+ * The messages are only counted while \c level is enabled, and the
+ * first one is logged. The count of a call site is shared by all the
+ * threads of the simulation.
+ *
+ * Typical usage looks like:
+ * \code
+ * NS_LOG_SAMPLED (LOG_DEBUG, 1000, "cache miss for " << address);
+ * \endcode
+ *
+ * \param [in] level The log level
+ * \param [in] period Log one message of every \c period.
+ * \param [in] msg The message to log
+ */
+#define NS_LOG_SAMPLED(level, period, msg)                      \
+  do                                                            \
+    {                                                           \
+      if (NS_LOG_IS_ENABLED (level))                            \
+        {                                                       \
+          static std::atomic<uint32_t> ns_log_sampled (0);      \
+          if (ns_log_sampled++ % (period) == 0)                 \
+            {                                                   \
+              NS_LOG (level, msg);                              \
+            }                                                   \
+        }                                                       \
+    }                                                           \
+  while (false)
+
 /**
  * \ingroup logging
  *
@@ -442,6 +442,21 @@ private:
 
 };  // class LogComponent
 
+/*
+ * Inlined, since every log statement checks its component.
+ */
+inline bool
+LogComponent::IsEnabled (const enum LogLevel level) const
+{
+  return (level & m_levels) ? 1 : 0;
+}
+
+inline bool
+LogComponent::IsNoneEnabled (void) const
+{
+  return m_levels == 0;
+}
+
 /**
  * Get the LogComponent registered with the given name.
  *
@@ -0,0 +1,685 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "multithreaded-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "uinteger.h"
+
+#include "ptr.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Value of g_partition outside of the partition threads. */
+const uint32_t GLOBAL_PARTITION = 0xffffffff;
+/** Entry of m_contextPartition for the contexts without explicit partition. */
+const uint32_t UNASSIGNED_PARTITION = 0xffffffff;
+/** Timestamp meaning "never". */
+const uint64_t NEVER = 0x7fffffffffffffffULL;
+
+/**
+ * The partition run by the current thread. The main thread runs the
+ * global partition outside of Simulator::Run.
+ */
+thread_local uint32_t g_partition = GLOBAL_PARTITION;
+/** The simulator running Simulator::Run, if any. */
+MultithreadedSimulatorImpl *g_running = 0;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The number of partitions, each run by its own thread; "
+                   "0 means one per hardware thread.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Lookahead",
+                   "The minimum delay of the events scheduled by a partition "
+                   "for another one, usually the smallest delay of the links "
+                   "between partitions.",
+                   TimeValue (NanoSeconds (1)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_lookahead),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_threadCount (0),
+    m_global (0),
+    m_windowEnd (0),
+    m_done (false),
+    m_barrierCount (0),
+    m_barrierGeneration (0),
+    m_nextWorker (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *partition = m_partitions[i];
+      for (uint32_t j = 0; j < partition->outbox.size (); j++)
+        {
+          for (uint32_t k = 0; k < partition->outbox[j].size (); k++)
+            {
+              partition->outbox[j][k].impl->Unref ();
+            }
+        }
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  m_global = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+
+  if (m_partitions.empty ())
+    {
+      if (m_threadCount == 0)
+        {
+          m_threadCount = std::max (std::thread::hardware_concurrency (), 1U);
+        }
+      // The global partition is the last one.
+      for (uint32_t i = 0; i <= m_threadCount; i++)
+        {
+          Partition *partition = new Partition ();
+          partition->events = schedulerFactory.Create<Scheduler> ();
+          // uids are allocated from 4.
+          // uid 0 is "invalid" events
+          // uid 1 is "now" events
+          // uid 2 is "destroy" events
+          partition->uid = 4;
+          partition->currentUid = 0;
+          partition->currentTs = 0;
+          partition->currentContext = Simulator::NO_CONTEXT;
+          partition->unscheduledEvents = 0;
+          partition->stop = false;
+          partition->stopTs = NEVER;
+          if (i < m_threadCount)
+            {
+              partition->outbox.resize (m_threadCount + 1);
+            }
+          m_partitions.push_back (partition);
+        }
+      m_global = m_partitions.back ();
+      return;
+    }
+
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      Ptr<Scheduler> events = m_partitions[i]->events;
+      while (!events->IsEmpty ())
+        {
+          scheduler->Insert (events->RemoveNext ());
+        }
+      m_partitions[i]->events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ASSERT_MSG (g_running == 0, "Partitions cannot change while the simulation runs");
+  NS_ASSERT (context != Simulator::NO_CONTEXT);
+  NS_ASSERT (partition < m_threadCount);
+  if (context >= m_contextPartition.size ())
+    {
+      m_contextPartition.resize (context + 1, UNASSIGNED_PARTITION);
+    }
+  m_contextPartition[context] = partition;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return m_threadCount;
+    }
+  if (context < m_contextPartition.size ()
+      && m_contextPartition[context] != UNASSIGNED_PARTITION)
+    {
+      return m_contextPartition[context];
+    }
+  return context % m_threadCount;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return m_threadCount;
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemote (uint32_t context)
+{
+  return g_running != 0
+         && g_partition != GLOBAL_PARTITION
+         && g_running->GetPartition (context) != g_partition;
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetCurrent (void) const
+{
+  if (g_partition == GLOBAL_PARTITION)
+    {
+      return *m_global;
+    }
+  return *m_partitions[g_partition];
+}
+
+MultithreadedSimulatorImpl::Partition &
+MultithreadedSimulatorImpl::GetPartitionOf (uint32_t context) const
+{
+  return *m_partitions[GetPartition (context)];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition &partition, Scheduler::Event &ev)
+{
+  ev.key.m_uid = partition.uid;
+  partition.uid++;
+  partition.unscheduledEvents++;
+  partition.events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition &partition)
+{
+  Scheduler::Event next = partition.events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition.currentTs);
+  partition.unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition.currentTs = next.key.m_ts;
+  partition.currentContext = next.key.m_context;
+  partition.currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition &partition)
+{
+  while (!partition.events->IsEmpty () && !partition.stop)
+    {
+      if (partition.events->PeekNext ().key.m_ts >= m_windowEnd)
+        {
+          break;
+        }
+      ProcessOneEvent (partition);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::MergeOutboxes (void)
+{
+  // Merging in a fixed order keeps the uids, and hence the order of the
+  // simultaneous events, independent of the thread timings.
+  for (uint32_t dst = 0; dst <= m_threadCount; dst++)
+    {
+      for (uint32_t src = 0; src < m_threadCount; src++)
+        {
+          std::vector<Scheduler::Event> &outbox = m_partitions[src]->outbox[dst];
+          for (uint32_t i = 0; i < outbox.size (); i++)
+            {
+              Insert (*m_partitions[dst], outbox[i]);
+            }
+          outbox.clear ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Synchronize (void)
+{
+  while (true)
+    {
+      MergeOutboxes ();
+
+      bool stop = m_global->stop;
+      uint64_t stopTs = m_global->stopTs;
+      uint64_t next = NEVER;
+      for (uint32_t i = 0; i < m_threadCount; i++)
+        {
+          Partition *partition = m_partitions[i];
+          stop = stop || partition->stop;
+          stopTs = std::min (stopTs, partition->stopTs);
+          partition->stop = false;
+          partition->stopTs = NEVER;
+          if (!partition->events->IsEmpty ())
+            {
+              next = std::min (next, partition->events->PeekNext ().key.m_ts);
+            }
+        }
+      m_global->stop = false;
+      m_global->stopTs = stopTs;
+      uint64_t nextGlobal = m_global->events->IsEmpty () ?
+        NEVER : m_global->events->PeekNext ().key.m_ts;
+
+      if (stop || std::min (next, nextGlobal) == NEVER)
+        {
+          m_done = true;
+          return;
+        }
+      if (std::min (next, nextGlobal) >= stopTs)
+        {
+          // As if the simulation was stopped by an event at the stop time.
+          m_global->currentTs = stopTs;
+          m_global->stopTs = NEVER;
+          m_done = true;
+          return;
+        }
+      if (nextGlobal <= next)
+        {
+          // The global events run alone: they may touch any partition.
+          while (!m_global->events->IsEmpty () && !m_global->stop
+                 && m_global->events->PeekNext ().key.m_ts == nextGlobal)
+            {
+              ProcessOneEvent (*m_global);
+            }
+          continue;
+        }
+      m_windowEnd = std::min (std::min (next + m_lookahead.GetTimeStep (), nextGlobal), stopTs);
+      NS_LOG_LOGIC ("window [" << next << ", " << m_windowEnd << ")");
+      return;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (void)
+{
+  uint32_t generation = m_barrierGeneration.load ();
+  if (m_barrierCount.fetch_add (1) + 1 == m_threadCount)
+    {
+      m_barrierCount.store (0);
+      m_barrierGeneration.fetch_add (1);
+    }
+  else
+    {
+      while (m_barrierGeneration.load () == generation)
+        {
+          std::this_thread::yield ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t index)
+{
+  g_partition = index;
+  Partition &partition = *m_partitions[index];
+  while (true)
+    {
+      Barrier ();
+      if (index == 0)
+        {
+          g_partition = GLOBAL_PARTITION;
+          Synchronize ();
+          g_partition = index;
+        }
+      Barrier ();
+      if (m_done)
+        {
+          break;
+        }
+      ProcessWindow (partition);
+    }
+  g_partition = GLOBAL_PARTITION;
+}
+
+void
+MultithreadedSimulatorImpl::WorkerThread (void)
+{
+  RunPartition (m_nextWorker.fetch_add (1));
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (g_partition == GLOBAL_PARTITION && g_running == 0,
+                 "Simulator::Run cannot be called from an event");
+  m_global->stop = false;
+  m_done = false;
+  m_nextWorker = 1;
+  g_running = this;
+
+  std::vector<Ptr<SystemThread> > workers;
+  for (uint32_t i = 1; i < m_threadCount; i++)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (
+          MakeCallback (&MultithreadedSimulatorImpl::WorkerThread, this));
+      worker->Start ();
+      workers.push_back (worker);
+    }
+  // The main thread runs the first partition and the global events.
+  RunPartition (0);
+  for (uint32_t i = 0; i < workers.size (); i++)
+    {
+      workers[i]->Join ();
+    }
+  g_running = 0;
+
+  // Continue from the last event run by any partition.
+  bool empty = true;
+  int unscheduledEvents = 0;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_global->currentTs = std::max (m_global->currentTs, m_partitions[i]->currentTs);
+      empty = empty && m_partitions[i]->events->IsEmpty ();
+      unscheduledEvents += m_partitions[i]->unscheduledEvents;
+    }
+  m_global->currentContext = Simulator::NO_CONTEXT;
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!empty || unscheduledEvents == 0);
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      if (m_partitions[i]->stop)
+        {
+          return true;
+        }
+      if (!m_partitions[i]->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  GetCurrent ().stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Partition &current = GetCurrent ();
+  current.stopTs = std::min (current.stopTs, current.currentTs + delay.GetTimeStep ());
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  Partition &current = GetCurrent ();
+
+  Time tAbsolute = delay + TimeStep (current.currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (current.currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = current.currentContext;
+  uint32_t uid = Insert (current, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Partition &current = GetCurrent ();
+  uint32_t target = GetPartition (context);
+
+  Time tAbsolute = delay + TimeStep (current.currentTs);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = context;
+
+  // The global events run while the partition threads wait, so they
+  // can insert directly into any partition.
+  if (g_partition == GLOBAL_PARTITION || g_partition == target)
+    {
+      Insert (*m_partitions[target], ev);
+      return;
+    }
+  if (ev.key.m_ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event for context " << context << " scheduled "
+                      << delay.As (Time::S) << " in the future from another "
+                      << "partition, less than the Lookahead of "
+                      << m_lookahead.As (Time::S));
+    }
+  current.outbox[target].push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrent ().currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrent ().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrent ().currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition &partition = GetPartitionOf (id.GetContext ());
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition.events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0)
+    {
+      return true;
+    }
+  // An event id only refers to an event of the partition which
+  // scheduled it, the one of its context.
+  const Partition &partition = GetPartitionOf (id.GetContext ());
+  if (id.GetTs () < partition.currentTs ||
+      (id.GetTs () == partition.currentTs &&
+       id.GetUid () <= partition.currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrent ().currentContext;
+}
+
+} // namespace ns3
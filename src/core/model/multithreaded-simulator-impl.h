@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-mutex.h"
+#include "nstime.h"
+
+#include "ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A parallel simulator implementation running the events of
+ * disjoint sets of nodes in several threads of a single process.
+ *
+ * The events are partitioned by context: the events of context \c c
+ * run in partition <tt>c % ThreadCount</tt>, unless SetPartition()
+ * assigned the context to another partition. Each partition has its own
+ * event list and is run by its own thread. Events without context
+ * (Simulator::NO_CONTEXT, e.g. the ones scheduled by the main program
+ * before Simulator::Run) form a "global" partition, which runs alone
+ * while all the partition threads wait.
+ *
+ * The partitions are synchronized as in the granted-time-window
+ * algorithm of the DistributedSimulatorImpl: at every barrier, the
+ * earliest pending event time T of all the partitions is computed, and
+ * every partition then runs, concurrently with the others, all its
+ * events before T + Lookahead. An event scheduled by a partition for
+ * another partition must therefore be at least Lookahead in the future,
+ * which is typically the smallest propagation delay of the links between
+ * nodes of different partitions; a violation is a fatal error.
+ *
+ * The events scheduled for another partition are appended to a queue
+ * dedicated to the (source, destination) pair of partitions, and moved
+ * into the destination event list at the next barrier. No lock is taken
+ * on the event path: each queue has a single writer during a window and
+ * is only read while all the partition threads wait at the barrier.
+ *
+ * Simulator::Stop () stops the simulation at the end of the current
+ * window, and Simulator::Stop (delay) before the first event at or after
+ * the stop time.
+ *
+ * \warning The models must not share mutable state between nodes of
+ * different partitions other than through scheduled events, and the
+ * objects passed from one partition to another must not be referenced by
+ * the sender anymore: the reference counts of ns-3 objects are not
+ * atomic. The PointToPointChannel hands a serialized copy of the packet
+ * over to a remote partition, as the PointToPointRemoteChannel of the
+ * MPI module does; as there, the packet tags are not carried over.
+ * Events scheduled from threads other than the simulator ones (as with
+ * the RealtimeSimulatorImpl) are not supported.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * Run the events of a context in a given partition.
+   *
+   * Must be called before Simulator::Run.
+   *
+   * \param [in] context The context, usually a node id.
+   * \param [in] partition The partition index, less than ThreadCount.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param [in] context The context, usually a node id.
+   * \returns The partition running the events of \p context, or
+   *          GetNPartitions () for the events without context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /** \returns The number of partitions, and of threads. */
+  uint32_t GetNPartitions (void) const;
+
+  /**
+   * Check whether the events of a context run concurrently with the
+   * calling event.
+   *
+   * This is \c false unless a MultithreadedSimulatorImpl is running and
+   * the calling event runs in a partition other than the one of
+   * \p context. Models use it to decide whether what they pass to
+   * \p context must be detached from their own objects.
+   *
+   * \param [in] context The context, usually a node id.
+   * \returns \c true if \p context runs in another partition thread.
+   */
+  static bool IsRemote (uint32_t context);
+
+private:
+  virtual void DoDispose (void);
+
+  /** The state of one partition. */
+  struct Partition
+  {
+    /** The event list. */
+    Ptr<Scheduler> events;
+    /** Next event unique id. */
+    uint32_t uid;
+    /** Unique id of the current event. */
+    uint32_t currentUid;
+    /** Timestamp of the current event. */
+    uint64_t currentTs;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /**
+     * Number of events that have been inserted but not yet run,
+     * used for validation.
+     */
+    int unscheduledEvents;
+    /** Simulator::Stop () was called by an event of this partition. */
+    bool stop;
+    /** Earliest time requested by Simulator::Stop (delay). */
+    uint64_t stopTs;
+    /**
+     * Events scheduled for the other partitions during the current
+     * window, indexed by destination partition (the last one is the
+     * global partition).
+     */
+    std::vector<std::vector<Scheduler::Event> > outbox;
+  };
+
+  /** \returns The partition of the calling thread. */
+  Partition & GetCurrent (void) const;
+  /**
+   * \param [in] context The context.
+   * \returns The partition running \p context, possibly the global one.
+   */
+  Partition & GetPartitionOf (uint32_t context) const;
+  /**
+   * Insert an event in the event list of a partition.
+   *
+   * \param [in] partition The partition.
+   * \param [in] ev The event; its uid is allocated by the partition.
+   * \returns The event uid.
+   */
+  uint32_t Insert (Partition &partition, Scheduler::Event &ev);
+
+  /** Entry point of the worker threads. */
+  void WorkerThread (void);
+  /**
+   * Run the window loop of one partition until the end of the simulation.
+   *
+   * \param [in] index The partition index.
+   */
+  void RunPartition (uint32_t index);
+  /**
+   * Merge the cross-partition events, run the global events and compute
+   * the next window, or decide to stop. Only called by partition 0 while
+   * the other threads wait at the barrier.
+   */
+  void Synchronize (void);
+  /** Move the events of the outboxes into their destination event list. */
+  void MergeOutboxes (void);
+  /**
+   * Run the events of a partition before the end of the current window.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessWindow (Partition &partition);
+  /**
+   * Run the next event of a partition.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessOneEvent (Partition &partition);
+  /** Wait until all the partition threads reach the barrier. */
+  void Barrier (void);
+
+  /** The number of partitions. */
+  uint32_t m_threadCount;
+  /** The minimum delay of the events scheduled for another partition. */
+  Time m_lookahead;
+  /** The scheduler factory. */
+  ObjectFactory m_schedulerFactory;
+  /** The partitions. */
+  std::vector<Partition *> m_partitions;
+  /** The partition of the events without context. */
+  Partition *m_global;
+  /** Explicit partition of the contexts, indexed by context. */
+  std::vector<uint32_t> m_contextPartition;
+
+  /** End (exclusive) of the current window. */
+  uint64_t m_windowEnd;
+  /** Set by Synchronize() when the simulation must stop. */
+  bool m_done;
+
+  /** Number of threads waiting at the barrier. */
+  std::atomic<uint32_t> m_barrierCount;
+  /** Incremented every time all the threads passed the barrier. */
+  std::atomic<uint32_t> m_barrierGeneration;
+  /** Index of the next worker thread to start. */
+  std::atomic<uint32_t> m_nextWorker;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Protect the destroy events, which may be scheduled by any thread. */
+  mutable SystemMutex m_destroyEventsMutex;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
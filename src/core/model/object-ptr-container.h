@@ -220,6 +220,35 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the number of instances in the container.
+   *
+   * Unlike Get(), this does not build an ObjectPtrContainerValue
+   * with all the instances.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns true if the value could be obtained successfully.
+   */
+  bool GetN (const ObjectBase *object, uint32_t *n) const;
+  /**
+   * Get one instance from the container.
+   *
+   * \param [in] object The container object.
+   * \param [in] i The position of the instance, less than GetN().
+   * \param [out] index The index of the instance.
+   * \returns The instance.
+   */
+  Ptr<Object> Get (const ObjectBase *object, uint32_t i, uint32_t *index) const;
+  /**
+   * Check if the index of every instance is its position.
+   *
+   * When true, the instance of index \c i, if any, can be fetched
+   * directly with Get(), without scanning the container.
+   *
+   * \returns true if the index of the i-th instance is always \c i.
+   */
+  virtual bool HasPositionalIndex (void) const;
 private:
   /**
    * Get the number of instances in the container.
@@ -261,6 +290,9 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual bool HasPositionalIndex (void) const {
+      return true;
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
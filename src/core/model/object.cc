@@ -93,6 +93,21 @@ Object::GetTypeId (void)
 }
 
 
+/**
+ * The cache entries: the slot of a TypeId is its uid modulo the number
+ * of entries, and a slot whose uid is zero (never a valid TypeId uid) is
+ * empty. A null object records a failed lookup.
+ */
+struct Object::GetObjectCache
+{
+  /** The number of entries, a power of two. */
+  static const uint16_t SIZE = 16;
+  /** The uid of the TypeId looked up in each slot. */
+  uint16_t tid[SIZE];
+  /** The result of the lookup in each slot. */
+  Object *object[SIZE];
+};
+
 Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
@@ -102,6 +117,7 @@ Object::Object ()
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -121,11 +137,17 @@ Object::~Object ()
         }
     }
   // finally, if all objects have been removed from the list,
-  // delete the aggregate list
+  // delete the aggregate list, or else forget the lookups which
+  // may have returned this object.
   if (m_aggregates->n == 0)
     {
+      std::free (m_aggregates->cache);
       std::free (m_aggregates);
     }
+  else if (m_aggregates->cache != 0)
+    {
+      std::memset (m_aggregates->cache, 0, sizeof (struct GetObjectCache));
+    }
   m_aggregates = 0;
 }
 Object::Object (const Object &o)
@@ -136,6 +158,7 @@ Object::Object (const Object &o)
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -151,6 +174,20 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  uint16_t uid = tid.GetUid ();
+  struct GetObjectCache *cache = m_aggregates->cache;
+  uint16_t slot = uid & (GetObjectCache::SIZE - 1);
+  if (cache != 0 && cache->tid[slot] == uid)
+    {
+      return cache->object[slot];
+    }
+  if (cache == 0)
+    {
+      cache = (struct GetObjectCache *) std::calloc (1, sizeof (struct GetObjectCache));
+      m_aggregates->cache = cache;
+    }
+
+  Object *found = 0;
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -173,11 +210,13 @@ Object::DoGetObject (TypeId tid) const
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          found = current;
+          break;
         }
     }
-  return 0;
+  cache->tid[slot] = uid;
+  cache->object[slot] = found;
+  return found;
 }
 void
 Object::Initialize (void)
@@ -263,6 +302,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->cache = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -314,7 +354,9 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  std::free (a->cache);
   std::free (a);
+  std::free (b->cache);
   std::free (b);
 }
 /**
@@ -340,6 +382,11 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  // the lookups done so far saw the previous type of this object
+  if (m_aggregates->cache != 0)
+    {
+      std::memset (m_aggregates->cache, 0, sizeof (struct GetObjectCache));
+    }
 }
 
 void
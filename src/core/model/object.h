@@ -320,6 +320,19 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * A direct-mapped cache of the DoGetObject() results of an aggregate
+   * set, indexed by TypeId uid.
+   *
+   * Hot code paths look up the same few interfaces on every packet,
+   * e.g. the Ipv4L3Protocol or the LispOverIpv4 of a Node, and many of
+   * these lookups fail; without the cache, each of them walks the
+   * parent chain of the TypeId of every aggregated Object. The cache
+   * belongs to the Aggregates, so that it is dropped with them when
+   * AggregateObject() builds a new aggregate set, and it is cleared
+   * when an Object leaves the set.
+   */
+  struct GetObjectCache;
   /**
    * The list of Objects aggregated to this one.
    *
@@ -335,6 +348,11 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The results of the previous DoGetObject() lookups, allocated
+     * on the first lookup.
+     */
+    struct GetObjectCache *cache;
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "priority-queue-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::PriorityQueueScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PriorityQueueScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (PriorityQueueScheduler);
+
+TypeId
+PriorityQueueScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PriorityQueueScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<PriorityQueueScheduler> ()
+  ;
+  return tid;
+}
+
+PriorityQueueScheduler::PriorityQueueScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PriorityQueueScheduler::~PriorityQueueScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PriorityQueueScheduler::SiftUp (uint32_t index, const Event &ev)
+{
+  while (index > 0)
+    {
+      uint32_t parent = (index - 1) / ARITY;
+      if (!(ev < m_heap[parent]))
+        {
+          break;
+        }
+      m_heap[index] = m_heap[parent];
+      index = parent;
+    }
+  m_heap[index] = ev;
+}
+
+void
+PriorityQueueScheduler::SiftDown (uint32_t index, const Event &ev)
+{
+  uint32_t size = m_heap.size ();
+  while (true)
+    {
+      uint32_t first = index * ARITY + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t last = std::min (first + ARITY, size);
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (m_heap[child] < m_heap[smallest])
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_heap[smallest] < ev))
+        {
+          break;
+        }
+      m_heap[index] = m_heap[smallest];
+      index = smallest;
+    }
+  m_heap[index] = ev;
+}
+
+void
+PriorityQueueScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_heap.push_back (ev);
+  SiftUp (m_heap.size () - 1, ev);
+}
+
+bool
+PriorityQueueScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_heap.empty ();
+}
+
+Scheduler::Event
+PriorityQueueScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_heap.front ();
+}
+
+Scheduler::Event
+PriorityQueueScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = m_heap.front ();
+  Event last = m_heap.back ();
+  m_heap.pop_back ();
+  if (!m_heap.empty ())
+    {
+      SiftDown (0, last);
+    }
+  return next;
+}
+
+void
+PriorityQueueScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t uid = ev.key.m_uid;
+  for (uint32_t i = 0; i < m_heap.size (); i++)
+    {
+      if (uid == m_heap[i].key.m_uid)
+        {
+          NS_ASSERT (m_heap[i].impl == ev.impl);
+          Event last = m_heap.back ();
+          m_heap.pop_back ();
+          if (i == m_heap.size ())
+            {
+              // the removed event was the last one
+              return;
+            }
+          if (i > 0 && last < m_heap[(i - 1) / ARITY])
+            {
+              SiftUp (i, last);
+            }
+          else
+            {
+              SiftDown (i, last);
+            }
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PRIORITY_QUEUE_SCHEDULER_H
+#define PRIORITY_QUEUE_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::PriorityQueueScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary implicit heap event scheduler
+ *
+ * The events are kept in a single contiguous std::vector managed as a
+ * heap in which every node has four children. Compared to the binary
+ * HeapScheduler, the tree is half as deep, so RemoveNext performs half
+ * as many levels of sift-down, and the four children compared at each
+ * level are adjacent in memory (usually in the same cache line).
+ * Compared to the MapScheduler, there is no per-event node allocation.
+ *
+ * Sifting moves a hole through the heap instead of swapping entries,
+ * so each level costs a single copy.
+ *
+ * Remove() is linear in the number of pending events, as for the
+ * HeapScheduler. It is only used by Simulator::Remove; Simulator::Cancel
+ * does not touch the scheduler.
+ */
+class PriorityQueueScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  PriorityQueueScheduler ();
+  /** Destructor. */
+  virtual ~PriorityQueueScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Number of children of each heap node. */
+  static const uint32_t ARITY = 4;
+
+  /**
+   * Move \p ev up from the hole at \p index to its proper position.
+   *
+   * \param [in] index The index of the hole.
+   * \param [in] ev The event to place.
+   */
+  void SiftUp (uint32_t index, const Scheduler::Event &ev);
+  /**
+   * Move \p ev down from the hole at \p index to its proper position.
+   *
+   * \param [in] index The index of the hole.
+   * \param [in] ev The event to place.
+   */
+  void SiftDown (uint32_t index, const Scheduler::Event &ev);
+
+  /** The event list, root at index 0. */
+  std::vector<Scheduler::Event> m_heap;
+};
+
+} // namespace ns3
+
+#endif /* PRIORITY_QUEUE_SCHEDULER_H */
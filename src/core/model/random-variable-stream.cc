@@ -726,15 +726,15 @@ NormalRandomVariable::GetValue (double mean, double variance, double bound)
     { // See Simulation Modeling and Analysis p. 466 (Averill Law)
       // for algorithm; basically a Box-Muller transform:
       // http://en.wikipedia.org/wiki/Box-Muller_transform
-      double u1 = Peek ()->RandU01 ();
-      double u2 = Peek ()->RandU01 ();
+      double u[2];
+      Peek ()->RandU01 (u, 2);
       if (IsAntithetic ())
         {
-          u1 = (1 - u1);
-          u2 = (1 - u2);
+          u[0] = (1 - u[0]);
+          u[1] = (1 - u[1]);
         }
-      double v1 = 2 * u1 - 1;
-      double v2 = 2 * u2 - 1;
+      double v1 = 2 * u[0] - 1;
+      double v2 = 2 * u[1] - 1;
       double w = v1 * v1 + v2 * v2;
       if (w <= 1.0)
         { // Got good pair
@@ -1042,15 +1042,15 @@ GammaRandomVariable::GetNormalValue (double mean, double variance, double bound)
     { // See Simulation Modeling and Analysis p. 466 (Averill Law)
       // for algorithm; basically a Box-Muller transform:
       // http://en.wikipedia.org/wiki/Box-Muller_transform
-      double u1 = Peek ()->RandU01 ();
-      double u2 = Peek ()->RandU01 ();
+      double u[2];
+      Peek ()->RandU01 (u, 2);
       if (IsAntithetic ())
         {
-          u1 = (1 - u1);
-          u2 = (1 - u2);
+          u[0] = (1 - u[0]);
+          u[1] = (1 - u[1]);
         }
-      double v1 = 2 * u1 - 1;
-      double v2 = 2 * u2 - 1;
+      double v1 = 2 * u[0] - 1;
+      double v2 = 2 * u[1] - 1;
       double w = v1 * v1 + v2 * v2;
       if (w <= 1.0)
         { // Got good pair
@@ -329,35 +329,55 @@ namespace ns3 {
 
 using namespace MRG32k3a;
   
-double RngStream::RandU01 ()
+void
+RngStream::Generate (double *u, uint32_t n)
 {
-  int32_t k;
-  double p1, p2, u;
-
-  /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
-  k = static_cast<int32_t> (p1 / m1);
-  p1 -= k * m1;
-  if (p1 < 0.0)
+  // The recurrences are computed on 64-bit integers, in which the
+  // products cannot overflow, and the reductions modulo the constant
+  // m1 and m2 then compile to multiplications rather than to the
+  // floating point divisions of the original algorithm.  The state
+  // being made of integers below 2^32, the numbers are exactly the
+  // same.  Negative terms are made positive by adding a multiple of
+  // the modulus.
+  const uint64_t im1 = 4294967087ULL;
+  const uint64_t im2 = 4294944443ULL;
+  uint64_t s10 = static_cast<uint64_t> (m_currentState[0]);
+  uint64_t s11 = static_cast<uint64_t> (m_currentState[1]);
+  uint64_t s12 = static_cast<uint64_t> (m_currentState[2]);
+  uint64_t s20 = static_cast<uint64_t> (m_currentState[3]);
+  uint64_t s21 = static_cast<uint64_t> (m_currentState[4]);
+  uint64_t s22 = static_cast<uint64_t> (m_currentState[5]);
+  for (uint32_t i = 0; i < n; i++)
     {
-      p1 += m1;
+      /* Component 1 */
+      uint64_t p1 = (1403580ULL * s11 + 810728ULL * (im1 - s10)) % im1;
+      s10 = s11; s11 = s12; s12 = p1;
+
+      /* Component 2 */
+      uint64_t p2 = (527612ULL * s22 + 1370589ULL * (im2 - s20)) % im2;
+      s20 = s21; s21 = s22; s22 = p2;
+
+      /* Combination */
+      u[i] = ((p1 > p2) ? (p1 - p2) * norm : (p1 + im1 - p2) * norm);
     }
-  m_currentState[0] = m_currentState[1]; m_currentState[1] = m_currentState[2]; m_currentState[2] = p1;
+  m_currentState[0] = s10;
+  m_currentState[1] = s11;
+  m_currentState[2] = s12;
+  m_currentState[3] = s20;
+  m_currentState[4] = s21;
+  m_currentState[5] = s22;
+}
 
-  /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
-  k = static_cast<int32_t> (p2 / m2);
-  p2 -= k * m2;
-  if (p2 < 0.0)
+void
+RngStream::RandU01 (double *u, uint32_t n)
+{
+  // First the numbers already generated ahead.
+  while (n > 0 && m_next < BATCH_SIZE)
     {
-      p2 += m2;
+      *u++ = m_batch[m_next++];
+      n--;
     }
-  m_currentState[3] = m_currentState[4]; m_currentState[4] = m_currentState[5]; m_currentState[5] = p2;
-
-  /* Combination */
-  u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
-
-  return u;
+  Generate (u, n);
 }
 
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
@@ -372,6 +392,7 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
     }
   AdvanceNthBy (stream, 127, m_currentState);
   AdvanceNthBy (substream, 76, m_currentState);
+  m_next = BATCH_SIZE;
 }
 
 RngStream::RngStream(const RngStream& r)
@@ -380,6 +401,11 @@ RngStream::RngStream(const RngStream& r)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (uint32_t i = 0; i < BATCH_SIZE; ++i)
+    {
+      m_batch[i] = r.m_batch[i];
+    }
+  m_next = r.m_next;
 }
 
 void 
@@ -67,11 +67,33 @@ public:
    * Generate the next random number for this stream.
    * Uniformly distributed between 0 and 1.
    *
+   * The numbers are generated ahead, by batches, and then
+   * returned one by one.
+   *
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \p n random numbers for this stream.
+   *
+   * This is the same as \p n calls to RandU01 (), the numbers
+   * just being generated in a single loop.
+   *
+   * \param [out] u The buffer to fill with the random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *u, uint32_t n);
 
 private:
+  /**
+   * Generate the numbers which follow the state of the RNG, and
+   * advance the state past them.
+   *
+   * \param [out] u The buffer to fill with the random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void Generate (double *u, uint32_t n);
+
   /**
    * Advance \p state of the RNG by leaps and bounds.
    *
@@ -81,10 +103,28 @@ private:
    */
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
 
-  /** The RNG state vector. */
+  /** The number of random numbers generated ahead by RandU01 (). */
+  static const uint32_t BATCH_SIZE = 16;
+
+  /** The RNG state vector, after the numbers generated ahead. */
   double m_currentState[6];
+  /** The random numbers generated ahead. */
+  double m_batch[BATCH_SIZE];
+  /** The index of the next random number of m_batch. */
+  uint32_t m_next;
 };
 
+inline double
+RngStream::RandU01 (void)
+{
+  if (m_next == BATCH_SIZE)
+    {
+      Generate (m_batch, BATCH_SIZE);
+      m_next = 0;
+    }
+  return m_batch[m_next++];
+}
+
 } // namespace ns3
 
 #endif
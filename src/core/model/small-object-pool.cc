@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "small-object-pool.h"
+#include <stdint.h>
+#include <new>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SmallObjectPool implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** Granularity of the size classes, in bytes. */
+const std::size_t POOL_GRANULE = 16;
+/** Number of size classes. */
+const std::size_t POOL_CLASSES = SmallObjectPool::MAX_SIZE / POOL_GRANULE;
+/** Maximum number of free blocks kept per size class. */
+const uint32_t POOL_MAX_FREE = 4096;
+
+/** A free block, linked in the free list of its size class. */
+struct PoolBlock
+{
+  PoolBlock *next;       /**< Next free block. */
+};
+
+/**
+ * Per-thread free lists.
+ *
+ * Deliberately a POD without destructor: objects may still be released
+ * during static destruction, and the bounded number of cached blocks is
+ * left to the operating system at exit.
+ */
+struct Pool
+{
+  PoolBlock *head[POOL_CLASSES];  /**< Free list heads. */
+  uint32_t count[POOL_CLASSES];   /**< Free list lengths. */
+};
+
+/** The pool of the current thread. */
+thread_local Pool g_pool;
+
+} // unnamed namespace
+
+void *
+SmallObjectPool::Allocate (std::size_t size)
+{
+  std::size_t cls = (size - 1) / POOL_GRANULE;
+  if (cls < POOL_CLASSES)
+    {
+      PoolBlock *block = g_pool.head[cls];
+      if (block != 0)
+        {
+          g_pool.head[cls] = block->next;
+          g_pool.count[cls]--;
+          return block;
+        }
+      return ::operator new ((cls + 1) * POOL_GRANULE);
+    }
+  return ::operator new (size);
+}
+
+void
+SmallObjectPool::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  std::size_t cls = (size - 1) / POOL_GRANULE;
+  if (cls < POOL_CLASSES && g_pool.count[cls] < POOL_MAX_FREE)
+    {
+      PoolBlock *block = static_cast<PoolBlock *> (p);
+      block->next = g_pool.head[cls];
+      g_pool.head[cls] = block;
+      g_pool.count[cls]++;
+      return;
+    }
+  ::operator delete (p);
+}
+
+} // namespace ns3
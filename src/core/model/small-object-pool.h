@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SMALL_OBJECT_POOL_H
+#define SMALL_OBJECT_POOL_H
+
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SmallObjectPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief Storage of the small objects created at a very high rate.
+ *
+ * The events bound by MakeEvent() and the callback implementations
+ * bound by MakeCallback() are created and destroyed for nearly every
+ * packet. Their classes allocate through this pool, which recycles the
+ * storage of the objects up to MAX_SIZE bytes through per-thread free
+ * lists, one per size class, instead of going through the global
+ * allocator every time. Larger objects fall back to the global
+ * operator new.
+ */
+class SmallObjectPool
+{
+public:
+  /** Largest object size served from the free lists, in bytes. */
+  static const std::size_t MAX_SIZE = 128;
+
+  /**
+   * Allocate storage.
+   *
+   * \param [in] size The size of the object.
+   * \returns The storage for the object.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release storage allocated by Allocate().
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the object, as passed to Allocate().
+   */
+  static void Deallocate (void *p, std::size_t size);
+};
+
+} // namespace ns3
+
+#endif /* SMALL_OBJECT_POOL_H */
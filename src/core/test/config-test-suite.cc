@@ -821,6 +821,131 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for paths compiled once and resolved many times.
+ */
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CompiledPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~CompiledPathConfigTestCase () {}
+
+  /**
+   * Trace callback without context.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void Trace (int16_t oldValue, int16_t newValue) { m_count++; }
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param old The old value.
+   * \param newValue The new value.
+   */
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue)
+  { m_count++; m_path = path; }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;   //!< Number of trace notifications.
+  std::string m_path; //!< The context path.
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check paths compiled once and resolved many times")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> objects[6];
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      objects[i] = CreateObject<ConfigTestObject> ();
+      root->AddNodeA (objects[i]);
+    }
+
+  //
+  // The objects are found in the order of their indices, whatever the
+  // order of the indices in the path, and as by Config::LookupMatches.
+  //
+  Config::CompiledPath path ("/NodesA/[4-5]|1|0|4");
+  NS_TEST_ASSERT_MSG_EQ (path.GetPath (), "/NodesA/[4-5]|1|0|4", "Unexpected path");
+  Config::MatchContainer matches = path.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 4, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[0], "Unexpected first match");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), objects[1], "Unexpected second match");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (2), objects[4], "Unexpected third match");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (3), objects[5], "Unexpected fourth match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (2), "/NodesA/4/", "Unexpected matched path");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetPath (), "/NodesA/[4-5]|1|0|4", "Unexpected path");
+  Config::MatchContainer expected = Config::LookupMatches ("/NodesA/[4-5]|1|0|4");
+  NS_TEST_ASSERT_MSG_EQ (expected.GetN (), matches.GetN (), "Config::LookupMatches differs");
+
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("NodesA/*").LookupMatches ().GetN (), 6,
+                         "Unexpected number of matches of *");
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("/NodesA/[3-9]").LookupMatches ().GetN (), 3,
+                         "Unexpected number of matches of a range past the end");
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("/NodesA/6").LookupMatches ().GetN (), 0,
+                         "Unexpected match past the end");
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("/NodesA/[3-1]").LookupMatches ().GetN (), 0,
+                         "Unexpected match of an empty range");
+  NS_TEST_ASSERT_MSG_EQ (Config::CompiledPath ("/NodesA/x").LookupMatches ().GetN (), 0,
+                         "Unexpected match of a bad index");
+
+  //
+  // A compiled path may be used again after the objects change.
+  //
+  path.Set ("A", IntegerValue (3));
+  objects[4]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 3, "Object Attribute \"A\" not set");
+  objects[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+  Ptr<ConfigTestObject> last = CreateObject<ConfigTestObject> ();
+  root->AddNodeA (last);
+  path.Set ("A", IntegerValue (5));
+  last->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+  Config::CompiledPath ("/NodesA/6").Set ("A", IntegerValue (5));
+  last->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 5, "Object Attribute \"A\" not set");
+
+  //
+  // Connect all the matching trace sources at once.
+  //
+  m_count = 0;
+  path.Connect ("Source", MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  objects[5]->SetAttribute ("Source", IntegerValue (-2));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "Trace 5 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodesA/5/Source", "Trace 5 did not provide expected context");
+  objects[2]->SetAttribute ("Source", IntegerValue (-2));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "Trace 2 fired unexpectedly");
+  path.Disconnect ("Source", MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  objects[5]->SetAttribute ("Source", IntegerValue (-3));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "Trace 5 fired after the disconnection");
+
+  m_count = 0;
+  path.ConnectWithoutContext ("Source", MakeCallback (&CompiledPathConfigTestCase::Trace, this));
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      objects[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_count, 4, "Traces did not fire as expected");
+  path.DisconnectWithoutContext ("Source", MakeCallback (&CompiledPathConfigTestCase::Trace, this));
+  objects[0]->SetAttribute ("Source", IntegerValue (-1));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 4, "Trace 0 fired after the disconnection");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -839,6 +964,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new CompiledPathConfigTestCase);
 }
 
 /**
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// The log statements of this file above LOG_INFO are compiled out.
+#define NS_LOG_MAX_LEVEL ns3::LOG_LEVEL_INFO
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup log-tests
+ * Logging macros test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup log-tests Logging macros test suite
+ */
+
+namespace ns3 {
+
+  namespace tests {
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuite");
+
+/**
+ * \ingroup log-tests
+ * Check the compile time ceiling of the log levels, and the sampled
+ * log statements.
+ */
+class LogMacrosTestCase : public TestCase
+{
+public:
+  LogMacrosTestCase ();
+  virtual ~LogMacrosTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LogMacrosTestCase::LogMacrosTestCase (void)
+  : TestCase ("Check the log level ceiling and the sampled log statements")
+{
+}
+
+void
+LogMacrosTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  std::streambuf *clog = std::clog.rdbuf (oss.rdbuf ());
+  LogComponentEnable ("LogTestSuite", LOG_LEVEL_ALL);
+
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("logic");
+  NS_LOG_INFO ("info");
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      NS_LOG_SAMPLED (LOG_INFO, 4, "sample " << i);
+      NS_LOG_SAMPLED (LOG_LOGIC, 4, "logic sample " << i);
+    }
+
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+  NS_LOG_INFO ("disabled");
+  std::clog.rdbuf (clog);
+
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), "info\nsample 0\nsample 4\nsample 8\n",
+                         "Unexpected log output");
+#else
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), "", "Unexpected log output");
+#endif
+}
+
+/**
+ * \ingroup log-tests
+ * Logging macros test suite
+ */
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log")
+{
+  AddTestCase (new LogMacrosTestCase);
+}
+
+/**
+ * \ingroup log-tests
+ * LogTestSuite instance variable.
+ */
+static LogTestSuite g_logTestSuite;
+
+
+  }  // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Pass tokens around a ring of contexts spread over the partitions of
+ * the MultithreadedSimulatorImpl, and check that every context sees its
+ * events in order, at the right time and in the right context.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] threads The number of partitions.
+   * \param [in] stop The stop time, or zero to run until the end.
+   */
+  MultithreadedSimulatorTestCase (uint32_t threads, Time stop);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Receive the token, and pass it to the next context.
+   *
+   * \param [in] node The receiving context.
+   * \param [in] hops The number of hops left.
+   * \param [in] expected The expected time of the event.
+   */
+  void Hop (uint32_t node, uint32_t hops, Time expected);
+  /**
+   * An event local to a context.
+   *
+   * \param [in] node The context.
+   */
+  void Local (uint32_t node);
+  /** An event without context, run while the partitions wait. */
+  void Global (void);
+
+  /** Number of contexts on the ring. */
+  static const uint32_t N_NODES = 8;
+  /** Number of hops of every token. */
+  static const uint32_t N_HOPS = 79;
+
+  uint32_t m_threads;                 //!< Number of partitions.
+  Time m_stop;                        //!< Stop time.
+  uint32_t m_hops[N_NODES];           //!< Tokens received per context.
+  uint32_t m_locals[N_NODES];         //!< Local events per context.
+  Time m_last[N_NODES];               //!< Time of the last event per context.
+  std::string m_error[N_NODES];       //!< First error per context.
+  bool m_global;                      //!< The global event ran.
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (uint32_t threads, Time stop)
+  : TestCase ("Check the MultithreadedSimulatorImpl with " + std::to_string (threads)
+              + " threads" + (stop.IsZero () ? "" : " and a stop time")),
+    m_threads (threads),
+    m_stop (stop),
+    m_global (false)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Hop (uint32_t node, uint32_t hops, Time expected)
+{
+  if (Simulator::GetContext () != node)
+    {
+      m_error[node] = "Bad context";
+    }
+  if (Simulator::Now () != expected || Simulator::Now () < m_last[node])
+    {
+      m_error[node] = "Bad event time";
+    }
+  m_last[node] = Simulator::Now ();
+  m_hops[node]++;
+  if (hops > 0)
+    {
+      uint32_t next = (node + 1) % N_NODES;
+      Simulator::ScheduleWithContext (next, MilliSeconds (1),
+                                      &MultithreadedSimulatorTestCase::Hop, this,
+                                      next, hops - 1, expected + MilliSeconds (1));
+      Simulator::Schedule (MicroSeconds (300), &MultithreadedSimulatorTestCase::Local, this, node);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Local (uint32_t node)
+{
+  if (Simulator::GetContext () != node || Simulator::Now () < m_last[node])
+    {
+      m_error[node] = "Bad local event";
+    }
+  m_last[node] = Simulator::Now ();
+  m_locals[node]++;
+}
+
+void
+MultithreadedSimulatorTestCase::Global (void)
+{
+  m_global = Simulator::GetContext () == Simulator::NO_CONTEXT;
+  // Without context, an event may schedule any context without delay.
+  Simulator::ScheduleWithContext (0, Seconds (0), &MultithreadedSimulatorTestCase::Local, this, 0);
+}
+
+void
+MultithreadedSimulatorTestCase::DoSetup (void)
+{
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (m_threads));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (MilliSeconds (1)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      m_hops[i] = 0;
+      m_locals[i] = 0;
+      m_last[i] = Seconds (0);
+      m_error[i] = "";
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (0));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (NanoSeconds (1)));
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      Simulator::ScheduleWithContext (i, Seconds (0), &MultithreadedSimulatorTestCase::Hop, this,
+                                      i, N_HOPS, Seconds (0));
+    }
+  Simulator::Schedule (MicroSeconds (5500), &MultithreadedSimulatorTestCase::Global, this);
+  if (!m_stop.IsZero ())
+    {
+      Simulator::Stop (m_stop);
+    }
+  Simulator::Run ();
+  Time end = Simulator::Now ();
+  Simulator::Destroy ();
+
+  uint32_t hops = 0;
+  uint32_t locals = 0;
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_error[i], "", "Error in context " << i);
+      hops += m_hops[i];
+      locals += m_locals[i];
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_global, true, "The global event did not run without context");
+  if (m_stop.IsZero ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (hops, N_NODES * (N_HOPS + 1), "Lost tokens");
+      NS_TEST_EXPECT_MSG_EQ (locals, N_NODES * N_HOPS + 1, "Lost local events");
+      NS_TEST_EXPECT_MSG_EQ (end, MilliSeconds (N_HOPS), "Bad end time");
+    }
+  else
+    {
+      // One hop per millisecond on every context, up to the stop time.
+      uint64_t ms = m_stop.GetMilliSeconds ();
+      NS_TEST_EXPECT_MSG_EQ (hops, N_NODES * ms, "Bad number of tokens before the stop time");
+      NS_TEST_EXPECT_MSG_EQ (locals, N_NODES * ms + 1, "Bad number of local events before the stop time");
+      NS_TEST_EXPECT_MSG_EQ (end, m_stop, "Bad end time");
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * The MultithreadedSimulatorImpl test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase (1, Seconds (0)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (3, Seconds (0)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, Seconds (0)), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, MilliSeconds (10)), TestCase::QUICK);
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite; //!< Static variable for test initialization
@@ -396,6 +396,22 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // The lookups are cached per aggregation.  A lookup which failed before an
+  // aggregation must succeed after it, and repeated lookups must keep
+  // returning the same Object.
+  //
+  baseA = CreateObject<BaseA> ();
+  baseB = CreateObject<DerivedB> ();
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB before aggregation");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB before aggregation");
+
+  baseA->AggregateObject (baseB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), baseB, "Stale GetObject result (through baseA) for BaseB");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), baseB, "Stale GetObject result (through baseA) for BaseB");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), baseB, "Stale GetObject result (through baseA) for DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<BaseA> (), baseA, "Stale GetObject result (through baseB) for BaseA");
 }
 
 /**
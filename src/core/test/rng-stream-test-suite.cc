@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/rng-stream.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup core-tests
+ *
+ * Check the numbers of RngStream against values of the reference
+ * MRG32k3a implementation, so that the streams stay reproducible.
+ */
+class RngStreamKnownAnswerTestCase : public TestCase
+{
+public:
+  RngStreamKnownAnswerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamKnownAnswerTestCase::RngStreamKnownAnswerTestCase ()
+  : TestCase ("Check RngStream against known values")
+{
+}
+
+void
+RngStreamKnownAnswerTestCase::DoRun (void)
+{
+  RngStream rng (1, 0, 0);
+  NS_TEST_EXPECT_MSG_EQ (rng.RandU01 (), 0.0003395772237870988, "Bad 1st value");
+  NS_TEST_EXPECT_MSG_EQ (rng.RandU01 (), 0.55588071598279964, "Bad 2nd value");
+  NS_TEST_EXPECT_MSG_EQ (rng.RandU01 (), 0.014204660652803588, "Bad 3rd value");
+  for (uint32_t i = 3; i < 999999; i++)
+    {
+      rng.RandU01 ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (rng.RandU01 (), 0.05900169589378703, "Bad 1000000th value");
+
+  RngStream other (12345, 3, 7);
+  NS_TEST_EXPECT_MSG_EQ (other.RandU01 (), 0.087170955755645138, "Bad 1st value of stream 3, substream 7");
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the numbers generated by batches are the same as the
+ * numbers generated one by one, whatever the mix of both.
+ */
+class RngStreamBatchTestCase : public TestCase
+{
+public:
+  RngStreamBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamBatchTestCase::RngStreamBatchTestCase ()
+  : TestCase ("Check RngStream batches against single draws")
+{
+}
+
+void
+RngStreamBatchTestCase::DoRun (void)
+{
+  const uint32_t n = 1000;
+  std::vector<double> expected (n);
+  RngStream single (42, 5, 2);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      expected[i] = single.RandU01 ();
+    }
+
+  RngStream batch (42, 5, 2);
+  std::vector<double> values (n);
+  uint32_t i = 0;
+  // Mix single draws and batches of various sizes, the batches
+  // starting in the middle of the numbers generated ahead.
+  for (uint32_t size = 0; i + size + 1 <= n; size = (size + 7) % 53)
+    {
+      values[i++] = batch.RandU01 ();
+      batch.RandU01 (values.data () + i, size);
+      i += size;
+    }
+  for (uint32_t j = 0; j < i; j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (values[j], expected[j], "Bad value " << j << " of the batches");
+    }
+
+  // A copy goes on with the same numbers.
+  RngStream copy (batch);
+  for (uint32_t j = i; j < n; j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (copy.RandU01 (), expected[j], "Bad value " << j << " of the copy");
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * The RngStream test suite.
+ */
+class RngStreamTestSuite : public TestSuite
+{
+public:
+  RngStreamTestSuite ()
+    : TestSuite ("rng-stream", UNIT)
+  {
+    AddTestCase (new RngStreamKnownAnswerTestCase, TestCase::QUICK);
+    AddTestCase (new RngStreamBatchTestCase, TestCase::QUICK);
+  }
+};
+
+static RngStreamTestSuite g_rngStreamTestSuite; //!< Static variable for test initialization
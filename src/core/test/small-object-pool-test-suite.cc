@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/small-object-pool.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/** Granularity of the size classes of the pool, in bytes. */
+const std::size_t GRANULE = 16;
+/** Maximum number of free blocks kept per size class by the pool. */
+const uint32_t MAX_FREE = 4096;
+
+/**
+ * Empty the free list of a size class: the free list holds at most
+ * MAX_FREE blocks, so one more allocation gets past all of them.
+ *
+ * \param [in] size The size of the objects of the class.
+ * \returns The blocks allocated, to release with Release().
+ */
+std::vector<void *>
+Drain (std::size_t size)
+{
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i <= MAX_FREE; i++)
+    {
+      blocks.push_back (SmallObjectPool::Allocate (size));
+    }
+  return blocks;
+}
+
+/**
+ * Release blocks allocated by Drain().
+ *
+ * \param [in] blocks The blocks.
+ * \param [in] size The size of the objects of the class.
+ */
+void
+Release (const std::vector<void *> &blocks, std::size_t size)
+{
+  for (std::size_t i = 0; i < blocks.size (); i++)
+    {
+      SmallObjectPool::Deallocate (blocks[i], size);
+    }
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that a released block is reused by the next allocation of its
+ * size class, and only of its size class.
+ */
+class SmallObjectPoolReuseTestCase : public TestCase
+{
+public:
+  SmallObjectPoolReuseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SmallObjectPoolReuseTestCase::SmallObjectPoolReuseTestCase ()
+  : TestCase ("Check the reuse of the blocks within each size class")
+{
+}
+
+void
+SmallObjectPoolReuseTestCase::DoRun (void)
+{
+  for (std::size_t max = GRANULE; max <= SmallObjectPool::MAX_SIZE; max += GRANULE)
+    {
+      std::size_t min = max - GRANULE + 1;
+      std::vector<void *> blocks = Drain (max);
+
+      // Any size of the class gets the last block released in the class
+      void *p = SmallObjectPool::Allocate (min);
+      std::memset (p, 0xa5, max);
+      SmallObjectPool::Deallocate (p, min);
+      NS_TEST_EXPECT_MSG_EQ (SmallObjectPool::Allocate (max), p,
+                             "Block of " << min << " bytes not reused for " << max << " bytes");
+      void *q = SmallObjectPool::Allocate (min);
+      NS_TEST_EXPECT_MSG_NE (q, p, "Block in use reused for " << min << " bytes");
+      SmallObjectPool::Deallocate (q, max);
+      SmallObjectPool::Deallocate (p, max);
+      NS_TEST_EXPECT_MSG_EQ (SmallObjectPool::Allocate (min), p, "Blocks of " << max << " bytes not reused in LIFO order");
+      NS_TEST_EXPECT_MSG_EQ (SmallObjectPool::Allocate (min), q, "Blocks of " << max << " bytes not reused in LIFO order");
+
+      // The other classes do not get it
+      SmallObjectPool::Deallocate (p, max);
+      if (max < SmallObjectPool::MAX_SIZE)
+        {
+          void *next = SmallObjectPool::Allocate (max + 1);
+          NS_TEST_EXPECT_MSG_NE (next, p, "Block of " << max << " bytes reused for " << max + 1 << " bytes");
+          SmallObjectPool::Deallocate (next, max + 1);
+        }
+      if (min > 1)
+        {
+          void *previous = SmallObjectPool::Allocate (min - 1);
+          NS_TEST_EXPECT_MSG_NE (previous, p, "Block of " << max << " bytes reused for " << min - 1 << " bytes");
+          SmallObjectPool::Deallocate (previous, min - 1);
+        }
+      NS_TEST_EXPECT_MSG_EQ (SmallObjectPool::Allocate (max), p, "Block of " << max << " bytes lost");
+
+      SmallObjectPool::Deallocate (q, max);
+      SmallObjectPool::Deallocate (p, max);
+      Release (blocks, max);
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the objects larger than SmallObjectPool::MAX_SIZE bytes are
+ * not served from the free lists.
+ */
+class SmallObjectPoolLargeTestCase : public TestCase
+{
+public:
+  SmallObjectPoolLargeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SmallObjectPoolLargeTestCase::SmallObjectPoolLargeTestCase ()
+  : TestCase ("Check the fallback on operator new above the largest size class")
+{
+}
+
+void
+SmallObjectPoolLargeTestCase::DoRun (void)
+{
+  const std::size_t sizes[] = { SmallObjectPool::MAX_SIZE + 1, 2 * SmallObjectPool::MAX_SIZE, 4096 };
+  std::vector<void *> blocks = Drain (SmallObjectPool::MAX_SIZE);
+  for (std::size_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      // The largest class holds a free block, which the large objects
+      // must not get.
+      void *p = SmallObjectPool::Allocate (SmallObjectPool::MAX_SIZE);
+      SmallObjectPool::Deallocate (p, SmallObjectPool::MAX_SIZE);
+      void *large = SmallObjectPool::Allocate (sizes[i]);
+      NS_TEST_EXPECT_MSG_NE (large, 0, "No storage for " << sizes[i] << " bytes");
+      NS_TEST_EXPECT_MSG_NE (large, p, "Block of the pool used for " << sizes[i] << " bytes");
+      std::memset (large, 0xa5, sizes[i]);
+      SmallObjectPool::Deallocate (large, sizes[i]);
+      NS_TEST_EXPECT_MSG_EQ (SmallObjectPool::Allocate (SmallObjectPool::MAX_SIZE), p,
+                             "Storage of " << sizes[i] << " bytes put in the largest size class");
+      SmallObjectPool::Deallocate (p, SmallObjectPool::MAX_SIZE);
+    }
+  Release (blocks, SmallObjectPool::MAX_SIZE);
+
+  // Releasing a null pointer is allowed, whatever the size
+  SmallObjectPool::Deallocate (0, GRANULE);
+  SmallObjectPool::Deallocate (0, 4096);
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that a size class keeps at most 4096 free blocks, and gives the
+ * others back to operator delete.
+ */
+class SmallObjectPoolLimitTestCase : public TestCase
+{
+public:
+  SmallObjectPoolLimitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SmallObjectPoolLimitTestCase::SmallObjectPoolLimitTestCase ()
+  : TestCase ("Check the limit of free blocks per size class")
+{
+}
+
+void
+SmallObjectPoolLimitTestCase::DoRun (void)
+{
+  const std::size_t size = 3 * GRANULE;
+  // The free list of the class is empty after Drain (): the first MAX_FREE
+  // blocks released are kept and the last one is not.
+  std::vector<void *> blocks = Drain (size);
+  Release (blocks, size);
+  // The last block is back to operator delete.
+  blocks.pop_back ();
+  for (uint32_t i = MAX_FREE; i > 0; i--)
+    {
+      void *p = SmallObjectPool::Allocate (size);
+      NS_TEST_EXPECT_MSG_EQ (p, blocks[i - 1], "Wrong free block " << i - 1);
+      blocks[i - 1] = p;
+    }
+  Release (blocks, size);
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * The SmallObjectPool test suite.
+ */
+class SmallObjectPoolTestSuite : public TestSuite
+{
+public:
+  SmallObjectPoolTestSuite ()
+    : TestSuite ("small-object-pool", UNIT)
+  {
+    AddTestCase (new SmallObjectPoolReuseTestCase, TestCase::QUICK);
+    AddTestCase (new SmallObjectPoolLargeTestCase, TestCase::QUICK);
+    AddTestCase (new SmallObjectPoolLimitTestCase, TestCase::QUICK);
+  }
+};
+
+static SmallObjectPoolTestSuite g_smallObjectPoolTestSuite; //!< Static variable for test initialization
@@ -194,6 +194,17 @@ CsmaChannel::TransmitStart (Ptr<const Packet> p, uint32_t srcId)
   return true;
 }
 
+void
+CsmaChannel::TransmitContinue (Ptr<const Packet> p, Time currentEnd)
+{
+  NS_LOG_FUNCTION (this << p << currentEnd);
+  NS_LOG_INFO ("UID is " << p->GetUid () << ")");
+
+  NS_ASSERT (m_state == TRANSMITTING);
+  ScheduleReceive (currentEnd + m_delay);
+  m_currentPkt = p->Copy ();
+}
+
 bool
 CsmaChannel::IsActive (uint32_t deviceId)
 {
@@ -217,7 +228,18 @@ CsmaChannel::TransmitEnd ()
       retVal = false;
     }
 
-  NS_LOG_LOGIC ("Schedule event in " << m_delay.GetSeconds () << " sec");
+  ScheduleReceive (m_delay);
+
+  // also schedule for the tx side to go back to IDLE
+  Simulator::Schedule (m_delay, &CsmaChannel::PropagationCompleteEvent,
+                       this);
+  return retVal;
+}
+
+void
+CsmaChannel::ScheduleReceive (Time delay)
+{
+  NS_LOG_LOGIC ("Schedule event in " << delay.GetSeconds () << " sec");
 
 
   NS_LOG_LOGIC ("Receive");
@@ -230,17 +252,12 @@ CsmaChannel::TransmitEnd ()
         {
           // schedule reception events
           Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
-                                          m_delay,
+                                          delay,
                                           &CsmaNetDevice::Receive, it->devicePtr,
                                           m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
         }
       devId++;
     }
-
-  // also schedule for the tx side to go back to IDLE
-  Simulator::Schedule (m_delay, &CsmaChannel::PropagationCompleteEvent,
-                       this);
-  return retVal;
 }
 
 void
@@ -186,6 +186,21 @@ public:
    */
   bool TransmitStart (Ptr<const Packet> p, uint32_t srcId);
 
+  /**
+   * \brief Append a packet to the current transmission
+   *
+   * The current packet ends in the given time, and the packet p follows
+   * it back to back, in the same transmission: the channel stays busy
+   * until TransmitEnd.  The reception of the current packet is scheduled
+   * now, at the arrival time of its last bit.
+   *
+   * \param p A reference to the packet that will be transmitted over
+   * the channel
+   * \param currentEnd The time, relative to now, at which the current
+   * packet has been completely transmitted
+   */
+  void TransmitContinue (Ptr<const Packet> p, Time currentEnd);
+
   /**
    * \brief Indicates that the net device has finished transmitting
    * the packet over the channel
@@ -293,6 +308,14 @@ public:
   Time GetDelay (void);
 
 private:
+  /**
+   * \brief Schedule the reception of the current packet by all the
+   * active net devices
+   *
+   * \param delay The time, relative to now, of the reception
+   */
+  void ScheduleReceive (Time delay);
+
   /**
    * Copy constructor is declared but not implemented.  This disables the
    * copy constructor for CsmaChannel objects.
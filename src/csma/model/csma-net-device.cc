@@ -78,6 +78,16 @@ CsmaNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&CsmaNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("MaxBurstSize",
+                   "The maximum number of queued packets sent back to back "
+                   "in one transmission on the channel (1 disables the bursts).  "
+                   "The packets are received at their own times.  No burst "
+                   "is sent while the sniffer, PhyTxBegin or PhyTxEnd traces "
+                   "are connected; the queue Dequeue trace of a burst fires "
+                   "at its start",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&CsmaNetDevice::m_maxBurstSize),
+                   MakeUintegerChecker<uint32_t> (1))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -191,6 +201,7 @@ CsmaNetDevice::CsmaNetDevice ()
   m_txMachineState = READY;
   m_tInterframeGap = Seconds (0);
   m_channel = 0;
+  m_maxBurstSize = 1;
 
   // 
   // We would like to let the attribute system take care of initializing the 
@@ -218,6 +229,7 @@ CsmaNetDevice::DoDispose ()
   NS_LOG_FUNCTION_NOARGS ();
   m_channel = 0;
   m_node = 0;
+  m_currentBurst.clear ();
   m_queue = 0;
   m_queueInterface = 0;
   NetDevice::DoDispose ();
@@ -472,6 +484,14 @@ CsmaNetDevice::ProcessHeader (Ptr<Packet> p, uint16_t & param)
 }
 #endif
 
+bool
+CsmaNetDevice::IsBurstEnabled (void) const
+{
+  return m_maxBurstSize > 1
+         && m_snifferTrace.IsEmpty () && m_promiscSnifferTrace.IsEmpty ()
+         && m_phyTxBeginTrace.IsEmpty () && m_phyTxEndTrace.IsEmpty ();
+}
+
 void
 CsmaNetDevice::TransmitStart (void)
 {
@@ -559,6 +579,22 @@ CsmaNetDevice::TransmitStart (void)
           m_phyTxBeginTrace (m_currentPkt);
 
           Time tEvent = m_bps.CalculateBytesTxTime (m_currentPkt->GetSize ());
+
+          //
+          // Send the packets waiting in the queue back to back with this
+          // one, in the same transmission.
+          //
+          uint32_t maxBurstSize = IsBurstEnabled () ? m_maxBurstSize : 1;
+          while (m_currentBurst.size () + 1 < maxBurstSize && !m_queue->IsEmpty ())
+            {
+              Ptr<Packet> packet = m_queue->Dequeue ();
+              m_snifferTrace (packet);
+              m_promiscSnifferTrace (packet);
+              m_channel->TransmitContinue (packet, tEvent);
+              m_phyTxBeginTrace (packet);
+              m_currentBurst.push_back (packet);
+              tEvent += m_tInterframeGap + m_bps.CalculateBytesTxTime (packet->GetSize ());
+            }
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -636,6 +672,11 @@ CsmaNetDevice::TransmitCompleteEvent (void)
   m_channel->TransmitEnd (); 
   m_phyTxEndTrace (m_currentPkt);
   m_currentPkt = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator i = m_currentBurst.begin (); i != m_currentBurst.end (); i++)
+    {
+      m_phyTxEndTrace (*i);
+    }
+  m_currentBurst.clear ();
 
   NS_LOG_LOGIC ("Schedule TransmitReadyEvent in " << m_tInterframeGap.GetSeconds () << "sec");
 
@@ -22,6 +22,7 @@
 #define CSMA_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/node.h"
 #include "ns3/backoff.h"
 #include "ns3/address.h"
@@ -55,6 +56,15 @@ class NetDeviceQueueInterface;
  * The Csma net device class is analogous to layer 1 and 2 of the
  * TCP stack. The NetDevice takes a raw packet of bytes and creates a
  * protocol specific packet from them. 
+ *
+ * When the MaxBurstSize attribute is greater than one, the device sends
+ * the packets waiting in its queue back to back once it has the channel,
+ * in a single transmission, as in the frame bursting of gigabit Ethernet:
+ * one event ends the transmission.  Each packet is still received at the
+ * arrival time of its own last bit.  No burst is sent while the sniffer,
+ * PhyTxBegin or PhyTxEnd traces are connected, so that they keep the
+ * times of each packet; the Dequeue trace of the queue fires when the
+ * burst starts.
  */
 class CsmaNetDevice : public NetDevice 
 {
@@ -403,6 +413,13 @@ private:
    */
   void TransmitStart ();
 
+  /**
+   * \returns true if the queued packets are sent in bursts: MaxBurstSize
+   * is greater than one, and neither the sniffers nor the PhyTxBegin and
+   * PhyTxEnd traces, whose timestamps a burst would shift, are connected.
+   */
+  bool IsBurstEnabled (void) const;
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -520,6 +537,16 @@ private:
    */
   Ptr<Packet> m_currentPkt;
 
+  /**
+   * The packets which are transmitted back to back after m_currentPkt.
+   */
+  std::vector<Ptr<Packet> > m_currentBurst;
+
+  /**
+   * The maximum number of packets of a transmission.
+   */
+  uint32_t m_maxBurstSize;
+
   /**
    * The CsmaChannel to which this CsmaNetDevice has been
    * attached.
@@ -19,12 +19,18 @@
 //
 
 #include "flow-classifier.h"
+#include "ns3/assert.h"
 
 namespace ns3 {
 
+FlowClassifier::FlowIdSequence::FlowIdSequence ()
+  : lastNewFlowId (0)
+{
+}
+
 FlowClassifier::FlowClassifier ()
   :
-    m_lastNewFlowId (0)
+    m_flowIds (Create<FlowIdSequence> ())
 {
 }
 
@@ -35,7 +41,19 @@ FlowClassifier::~FlowClassifier ()
 FlowId
 FlowClassifier::GetNewFlowId ()
 {
-  return ++m_lastNewFlowId;
+  return ++m_flowIds->lastNewFlowId;
+}
+
+void
+FlowClassifier::ShareFlowIds (Ptr<FlowClassifier> classifier)
+{
+  NS_ASSERT_MSG (m_flowIds->lastNewFlowId == 0, "The classifier has already given FlowIds");
+  m_flowIds = classifier->m_flowIds;
+}
+
+void
+FlowClassifier::EvictFlow (FlowId flowId)
+{
 }
 
 
@@ -22,6 +22,7 @@
 #define FLOW_CLASSIFIER_H
 
 #include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
 #include <ostream>
 
 namespace ns3 {
@@ -53,7 +54,13 @@ typedef uint32_t FlowPacketId;
 class FlowClassifier : public SimpleRefCount<FlowClassifier>
 {
 private:
-  FlowId m_lastNewFlowId; //!< Last known Flow ID
+  /// The FlowIds given so far, possibly shared by several classifiers
+  struct FlowIdSequence : public SimpleRefCount<FlowIdSequence>
+  {
+    FlowIdSequence ();
+    FlowId lastNewFlowId; //!< Last known Flow ID
+  };
+  Ptr<FlowIdSequence> m_flowIds; //!< FlowId sequence
 
   /// Defined and not implemented to avoid misuse
   FlowClassifier (FlowClassifier const &);
@@ -71,6 +78,17 @@ public:
   /// \param indent number of spaces to use as base indentation level
   virtual void SerializeToXmlStream (std::ostream &os, uint16_t indent) const = 0;
 
+  /// Forget a flow evicted by the FlowMonitor.  The packets of the same
+  /// flow seen later are given a new FlowId.
+  /// \param flowId the flow identifier
+  virtual void EvictFlow (FlowId flowId);
+
+  /// Draw the FlowIds of this classifier from the same sequence as
+  /// another one, so that no flow of the two shares a FlowId.  Must be
+  /// called before this classifier gives its first FlowId.
+  /// \param classifier the classifier whose FlowId sequence is used
+  void ShareFlowIds (Ptr<FlowClassifier> classifier);
+
 protected:
   /// Returns a new, unique Flow Identifier
   /// \returns a new FlowId
@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_HASH_TABLE_H
+#define FLOW_HASH_TABLE_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup flow-monitor
+ * \brief A hash table with open addressing, for the per-packet lookups
+ * of the flow monitor.
+ *
+ * The entries are stored in a single array of slots, probed linearly
+ * from the slot given by the hash of the key, so that neither a lookup
+ * nor an insertion allocates memory, except when the table grows.  An
+ * erased entry is filled by shifting back the entries that follow it,
+ * so the table keeps no tombstones.
+ *
+ * The slots can be walked by index, from 0 to GetCapacity () - 1.
+ *
+ * \warning Insert () and Erase () may move the entries: the pointers
+ * and references to the values, and the slot indices, are only valid
+ * until the next call to one of them.
+ *
+ * \tparam Key the type of the keys
+ * \tparam Value the type of the values, which must be default-constructible
+ * \tparam Hash the hash function of the keys
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key> >
+class FlowHashTable
+{
+public:
+  FlowHashTable ();
+
+  /**
+   * \param key the key of an entry
+   * \return the value of the entry, or 0 if there is none
+   */
+  Value *Find (const Key &key);
+  /**
+   * \param key the key of an entry
+   * \return the value of the entry, or 0 if there is none
+   */
+  const Value *Find (const Key &key) const;
+
+  /**
+   * \brief Find an entry, or add it if there is none.
+   *
+   * \param key the key of the entry
+   * \param inserted set to true if the entry was added, with a
+   *        default-constructed value
+   * \return the value of the entry
+   */
+  Value &Insert (const Key &key, bool *inserted);
+
+  /**
+   * \param key the key of an entry
+   * \return true if the entry was erased, false if there was none
+   */
+  bool Erase (const Key &key);
+
+  /**
+   * \brief Erase all the entries.
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of entries
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \return the number of slots
+   */
+  uint32_t GetCapacity (void) const;
+
+  /**
+   * \param slot the index of a slot
+   * \return true if the slot holds an entry
+   */
+  bool IsUsed (uint32_t slot) const;
+
+  /**
+   * \param slot the index of a used slot
+   * \return the key of the entry of the slot
+   */
+  const Key &GetKey (uint32_t slot) const;
+
+  /**
+   * \param slot the index of a used slot
+   * \return the value of the entry of the slot
+   */
+  Value &GetValue (uint32_t slot);
+
+private:
+  /** A slot of the table. */
+  struct Slot
+  {
+    Key key;      //!< The key of the entry.
+    Value value;  //!< The value of the entry.
+    bool used;    //!< The slot holds an entry.
+  };
+
+  /**
+   * \param key a key
+   * \return the first slot probed for the key
+   */
+  uint32_t GetHome (const Key &key) const;
+
+  /**
+   * \param key a key
+   * \return the slot of the entry of the key, or the free slot where
+   *         it would be added
+   */
+  uint32_t Probe (const Key &key) const;
+
+  /**
+   * \brief Double the number of slots.
+   */
+  void Grow (void);
+
+  /** The number of slots of an empty table. */
+  static const uint32_t INITIAL_CAPACITY = 16;
+
+  std::vector<Slot> m_slots; //!< The slots, a power of two of them.
+  uint32_t m_size;           //!< The number of entries.
+  uint32_t m_shift;          //!< 64 minus the log2 of the number of slots.
+};
+
+} // namespace ns3
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename Key, typename Value, typename Hash>
+FlowHashTable<Key, Value, Hash>::FlowHashTable ()
+  : m_slots (INITIAL_CAPACITY),
+    m_size (0),
+    m_shift (64 - 4)
+{
+  for (uint32_t i = 0; i < m_slots.size (); i++)
+    {
+      m_slots[i].used = false;
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::GetHome (const Key &key) const
+{
+  // Fibonacci hashing: spreads the consecutive flow and packet
+  // identifiers over the whole table.
+  uint64_t h = static_cast<uint64_t> (Hash () (key));
+  return static_cast<uint32_t> ((h * 0x9e3779b97f4a7c15ULL) >> m_shift);
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::Probe (const Key &key) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t slot = GetHome (key);
+  while (m_slots[slot].used && !(m_slots[slot].key == key))
+    {
+      slot = (slot + 1) & mask;
+    }
+  return slot;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value *
+FlowHashTable<Key, Value, Hash>::Find (const Key &key)
+{
+  uint32_t slot = Probe (key);
+  return m_slots[slot].used ? &m_slots[slot].value : 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+const Value *
+FlowHashTable<Key, Value, Hash>::Find (const Key &key) const
+{
+  uint32_t slot = Probe (key);
+  return m_slots[slot].used ? &m_slots[slot].value : 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value &
+FlowHashTable<Key, Value, Hash>::Insert (const Key &key, bool *inserted)
+{
+  uint32_t slot = Probe (key);
+  if (m_slots[slot].used)
+    {
+      *inserted = false;
+      return m_slots[slot].value;
+    }
+  // Keep the load factor below 1/2, so that the probe sequences stay short.
+  if (2 * (m_size + 1) > m_slots.size ())
+    {
+      Grow ();
+      slot = Probe (key);
+    }
+  m_slots[slot].key = key;
+  m_slots[slot].used = true;
+  m_size++;
+  *inserted = true;
+  return m_slots[slot].value;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool
+FlowHashTable<Key, Value, Hash>::Erase (const Key &key)
+{
+  uint32_t hole = Probe (key);
+  if (!m_slots[hole].used)
+    {
+      return false;
+    }
+  uint32_t mask = m_slots.size () - 1;
+  for (uint32_t next = (hole + 1) & mask; m_slots[next].used; next = (next + 1) & mask)
+    {
+      // Move the entry back to the hole, unless its home slot lies
+      // between the hole and its current slot.
+      uint32_t home = GetHome (m_slots[next].key);
+      if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+          m_slots[hole].key = m_slots[next].key;
+          m_slots[hole].value = m_slots[next].value;
+          hole = next;
+        }
+    }
+  m_slots[hole].value = Value ();
+  m_slots[hole].used = false;
+  m_size--;
+  return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+void
+FlowHashTable<Key, Value, Hash>::Clear (void)
+{
+  std::vector<Slot> slots (INITIAL_CAPACITY);
+  m_slots.swap (slots);
+  for (uint32_t i = 0; i < m_slots.size (); i++)
+    {
+      m_slots[i].used = false;
+    }
+  m_size = 0;
+  m_shift = 64 - 4;
+}
+
+template <typename Key, typename Value, typename Hash>
+void
+FlowHashTable<Key, Value, Hash>::Grow (void)
+{
+  std::vector<Slot> old (m_slots.size () * 2);
+  old.swap (m_slots);
+  for (uint32_t i = 0; i < m_slots.size (); i++)
+    {
+      m_slots[i].used = false;
+    }
+  m_shift--;
+  for (uint32_t i = 0; i < old.size (); i++)
+    {
+      if (old[i].used)
+        {
+          uint32_t slot = Probe (old[i].key);
+          m_slots[slot].key = old[i].key;
+          std::swap (m_slots[slot].value, old[i].value);
+          m_slots[slot].used = true;
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::GetSize (void) const
+{
+  return m_size;
+}
+
+template <typename Key, typename Value, typename Hash>
+uint32_t
+FlowHashTable<Key, Value, Hash>::GetCapacity (void) const
+{
+  return m_slots.size ();
+}
+
+template <typename Key, typename Value, typename Hash>
+bool
+FlowHashTable<Key, Value, Hash>::IsUsed (uint32_t slot) const
+{
+  return m_slots[slot].used;
+}
+
+template <typename Key, typename Value, typename Hash>
+const Key &
+FlowHashTable<Key, Value, Hash>::GetKey (uint32_t slot) const
+{
+  return m_slots[slot].key;
+}
+
+template <typename Key, typename Value, typename Hash>
+Value &
+FlowHashTable<Key, Value, Hash>::GetValue (uint32_t slot)
+{
+  return m_slots[slot].value;
+}
+
+} // namespace ns3
+
+#endif /* FLOW_HASH_TABLE_H */
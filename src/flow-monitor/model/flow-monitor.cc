@@ -22,8 +22,10 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 #define PERIODIC_CHECK_INTERVAL (Seconds (1))
 
@@ -69,6 +71,23 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("ExportFile", ("The name of a CSV file to which the flows changed since the last export "
+                                  "are written periodically, or empty to disable the export.  See ExportFlows."),
+                   StringValue (""),
+                   MakeStringAccessor (&FlowMonitor::m_exportFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("ExportInterval", ("The interval between two exports of the changed flows."),
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_exportInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("FlowEvictionTimeout", ("The time after which a flow with no packet in flight, and no new packet, "
+                                           "is exported a last time and removed from the flow statistics, "
+                                           "or zero to keep all the flows.  Without ExportFile, "
+                                           "the statistics of the evicted flows are lost.  The probes and the classifiers "
+                                           "forget the evicted flows too, so a flow seen again gets a new FlowId."),
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_flowEvictionTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -99,15 +118,20 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  Simulator::Cancel (m_exportEvent);
+  if (m_exportStream.is_open ())
+    {
+      m_exportStream.close ();
+    }
   Object::DoDispose ();
 }
 
-inline FlowMonitor::FlowStats&
-FlowMonitor::GetStatsForFlow (FlowId flowId)
+inline FlowMonitor::FlowState&
+FlowMonitor::GetStateForFlow (FlowId flowId)
 {
-  FlowStatsContainerI iter;
-  iter = m_flowStats.find (flowId);
-  if (iter == m_flowStats.end ())
+  bool inserted;
+  FlowState &state = m_flowStates.Insert (flowId, &inserted);
+  if (inserted)
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
       ref.delaySum = Seconds (0);
@@ -123,14 +147,37 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
       ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
       ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
-      return ref;
+      state.stats = &ref;
+      state.packetsInFlight = 0;
+      state.changed = false;
+      if (m_flowEvictionTimeout.IsStrictlyPositive ())
+        {
+          state.idlePosition = m_idleFlows.insert (m_idleFlows.end (), flowId);
+        }
     }
-  else
+  if (!state.changed && !m_exportFileName.empty ())
+    {
+      state.changed = true;
+      m_changedFlows.push_back (flowId);
+    }
+  return state;
+}
+
+inline void
+FlowMonitor::SetFlowActive (FlowState &state)
+{
+  if (m_flowEvictionTimeout.IsStrictlyPositive ())
     {
-      return iter->second;
+      m_idleFlows.splice (m_idleFlows.end (), m_idleFlows, state.idlePosition);
     }
 }
 
+inline uint64_t
+FlowMonitor::GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId)
+{
+  return (static_cast<uint64_t> (flowId) << 32) | packetId;
+}
+
 
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
@@ -140,7 +187,8 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  bool inserted;
+  TrackedPacket &tracked = m_trackedPackets.Insert (GetTrackedPacketKey (flowId, packetId), &inserted);
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -149,7 +197,13 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
 
   probe->AddPacketStats (flowId, packetSize, Seconds (0));
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowState &state = GetStateForFlow (flowId);
+  FlowStats &stats = *state.stats;
+  if (inserted)
+    {
+      state.packetsInFlight++;
+    }
+  SetFlowActive (state);
   stats.txBytes += packetSize;
   stats.txPackets++;
   if (stats.txPackets == 1)
@@ -167,19 +221,18 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
-  if (tracked == m_trackedPackets.end ())
+  TrackedPacket *tracked = m_trackedPackets.Find (GetTrackedPacketKey (flowId, packetId));
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
       return;
     }
 
-  tracked->second.timesForwarded++;
-  tracked->second.lastSeenTime = Simulator::Now ();
+  tracked->timesForwarded++;
+  tracked->lastSeenTime = Simulator::Now ();
 
-  Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
+  Time delay = (Simulator::Now () - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 }
 
@@ -191,8 +244,9 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked == m_trackedPackets.end ())
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  TrackedPacket *tracked = m_trackedPackets.Find (key);
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
@@ -200,10 +254,12 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     }
 
   Time now = Simulator::Now ();
-  Time delay = (now - tracked->second.firstSeenTime);
+  Time delay = (now - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowState &state = GetStateForFlow (flowId);
+  FlowStats &stats = *state.stats;
+  SetFlowActive (state);
   stats.delaySum += delay;
   stats.delayHistogram.AddValue (delay.GetSeconds ());
   if (stats.rxPackets > 0 )
@@ -239,12 +295,13 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
         }
     }
   stats.timeLastRxPacket = now;
-  stats.timesForwarded += tracked->second.timesForwarded;
+  stats.timesForwarded += tracked->timesForwarded;
 
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  m_trackedPackets.Erase (key); // we don't need to track this packet anymore
+  state.packetsInFlight--;
 }
 
 void
@@ -258,7 +315,8 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
 
   probe->AddPacketDropStats (flowId, packetSize, reasonCode);
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowState &state = GetStateForFlow (flowId);
+  FlowStats &stats = *state.stats;
   stats.lostPackets++;
   if (stats.packetsDropped.size () < reasonCode + 1)
     {
@@ -269,14 +327,13 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked != m_trackedPackets.end ())
+  if (m_trackedPackets.Erase (GetTrackedPacketKey (flowId, packetId)))
     {
       // we don't need to track this packet anymore
       // FIXME: this will not necessarily be true with broadcast/multicast
-      NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
+      NS_LOG_DEBUG ("ReportDrop: removed tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      state.packetsInFlight--;
     }
 }
 
@@ -292,24 +349,28 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // Erasing shifts the entries of the table: collect the lost packets first.
+  std::vector<uint64_t> lost;
+  for (uint32_t slot = 0; slot < m_trackedPackets.GetCapacity (); slot++)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
-        {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
-
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
+      if (m_trackedPackets.IsUsed (slot)
+          && now - m_trackedPackets.GetValue (slot).lastSeenTime >= maxDelay)
         {
-          iter++;
+          lost.push_back (m_trackedPackets.GetKey (slot));
         }
     }
+  for (std::vector<uint64_t>::const_iterator iter = lost.begin (); iter != lost.end (); iter++)
+    {
+      // packet is considered lost, add it to the loss statistics
+      FlowId flowId = static_cast<FlowId> (*iter >> 32);
+      NS_ASSERT (m_flowStates.Find (flowId) != 0);
+      FlowState &state = GetStateForFlow (flowId);
+      state.stats->lostPackets++;
+
+      // we won't track it anymore
+      m_trackedPackets.Erase (*iter);
+      state.packetsInFlight--;
+    }
 }
 
 void
@@ -325,6 +386,157 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::PeriodicExportFlows ()
+{
+  ExportFlows ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExportFlows, this);
+}
+
+namespace {
+
+/// Write values separated by spaces
+/// \param os the output stream
+/// \param values the values
+template <typename T>
+void
+WriteValues (std::ostream &os, const std::vector<T> &values)
+{
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      os << (i == 0 ? "" : " ") << values[i];
+    }
+}
+
+/// Write the non-empty bins of an histogram, as bin:count pairs
+/// separated by spaces
+/// \param os the output stream
+/// \param histogram the histogram
+void
+WriteHistogram (std::ostream &os, Histogram &histogram)
+{
+  const char *separator = "";
+  for (uint32_t bin = 0; bin < histogram.GetNBins (); bin++)
+    {
+      uint32_t count = histogram.GetBinCount (bin);
+      if (count > 0)
+        {
+          os << separator << bin << ':' << count;
+          separator = " ";
+        }
+    }
+}
+
+} // anonymous namespace
+
+void
+FlowMonitor::ExportFlow (FlowId flowId, FlowStats &stats, bool evicted)
+{
+  std::ostream &os = m_exportStream;
+  os << Simulator::Now ().GetNanoSeconds () << ',' << flowId << ',' << evicted
+     << ',' << stats.timeFirstTxPacket.GetNanoSeconds ()
+     << ',' << stats.timeFirstRxPacket.GetNanoSeconds ()
+     << ',' << stats.timeLastTxPacket.GetNanoSeconds ()
+     << ',' << stats.timeLastRxPacket.GetNanoSeconds ()
+     << ',' << stats.delaySum.GetNanoSeconds ()
+     << ',' << stats.jitterSum.GetNanoSeconds ()
+     << ',' << stats.lastDelay.GetNanoSeconds ()
+     << ',' << stats.txBytes
+     << ',' << stats.rxBytes
+     << ',' << stats.txPackets
+     << ',' << stats.rxPackets
+     << ',' << stats.lostPackets
+     << ',' << stats.timesForwarded
+     << ',';
+  WriteValues (os, stats.packetsDropped);
+  os << ',';
+  WriteValues (os, stats.bytesDropped);
+  os << ',';
+  WriteHistogram (os, stats.delayHistogram);
+  os << ',';
+  WriteHistogram (os, stats.jitterHistogram);
+  os << ',';
+  WriteHistogram (os, stats.packetSizeHistogram);
+  os << ',';
+  WriteHistogram (os, stats.flowInterruptionsHistogram);
+  os << '\n';
+}
+
+void
+FlowMonitor::ExportFlows ()
+{
+  bool exporting = !m_exportFileName.empty ();
+  if (exporting && !m_exportStream.is_open ())
+    {
+      m_exportStream.open (m_exportFileName.c_str (), std::ios::out | std::ios::trunc);
+      if (!m_exportStream)
+        {
+          NS_FATAL_ERROR ("Cannot open the flow export file " << m_exportFileName);
+        }
+      m_exportStream << "time,flowId,evicted,timeFirstTxPacket,timeFirstRxPacket,"
+                     << "timeLastTxPacket,timeLastRxPacket,delaySum,jitterSum,lastDelay,"
+                     << "txBytes,rxBytes,txPackets,rxPackets,lostPackets,timesForwarded,"
+                     << "packetsDropped,bytesDropped,delayHistogram,jitterHistogram,"
+                     << "packetSizeHistogram,flowInterruptionsHistogram\n";
+    }
+
+  // The flows are walked from the least recently active one, up to
+  // the first one active within the timeout.
+  Time now = Simulator::Now ();
+  for (std::list<FlowId>::iterator idle = m_idleFlows.begin (); idle != m_idleFlows.end (); )
+    {
+      FlowId flowId = *idle;
+      FlowState *state = m_flowStates.Find (flowId);
+      NS_ASSERT (state != 0);
+      FlowStats &stats = *state->stats;
+      if (now - std::max (stats.timeLastTxPacket, stats.timeLastRxPacket) < m_flowEvictionTimeout)
+        {
+          break;
+        }
+      if (state->packetsInFlight > 0)
+        {
+          idle++;
+          continue;
+        }
+      NS_LOG_DEBUG ("Evicting flow " << flowId);
+      if (exporting)
+        {
+          ExportFlow (flowId, stats, true);
+        }
+      m_flowStates.Erase (flowId);
+      m_flowStats.erase (flowId);
+      idle = m_idleFlows.erase (idle);
+      for (FlowProbeContainerI probe = m_flowProbes.begin (); probe != m_flowProbes.end (); probe++)
+        {
+          (*probe)->EvictFlow (flowId);
+        }
+      // The classifiers share one FlowId sequence: only the classifier
+      // of the flow knows its FlowId.
+      for (std::list<Ptr<FlowClassifier> >::iterator classifier = m_classifiers.begin ();
+           classifier != m_classifiers.end (); classifier++)
+        {
+          (*classifier)->EvictFlow (flowId);
+        }
+    }
+
+  if (exporting)
+    {
+      for (std::vector<FlowId>::const_iterator flowId = m_changedFlows.begin ();
+           flowId != m_changedFlows.end (); flowId++)
+        {
+          // the evicted flows were exported above
+          FlowState *state = m_flowStates.Find (*flowId);
+          if (state != 0)
+            {
+              state->changed = false;
+              ExportFlow (*flowId, *state->stats, false);
+            }
+        }
+      m_changedFlows.clear ();
+      m_exportStream.flush ();
+    }
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
@@ -377,6 +589,10 @@ FlowMonitor::StartRightNow ()
       return;
     }
   m_enabled = true;
+  if (!m_exportFileName.empty () || m_flowEvictionTimeout.IsStrictlyPositive ())
+    {
+      m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExportFlows, this);
+    }
 }
 
 
@@ -389,11 +605,22 @@ FlowMonitor::StopRightNow ()
     }
   m_enabled = false;
   CheckForLostPackets ();
+  if (m_exportEvent.IsRunning ())
+    {
+      m_exportEvent.Cancel ();
+      ExportFlows ();
+    }
 }
 
 void
 FlowMonitor::AddFlowClassifier (Ptr<FlowClassifier> classifier)
 {
+  // The statistics are keyed by FlowId only: the flows of all the
+  // classifiers must get distinct FlowIds.
+  if (!m_classifiers.empty ())
+    {
+      classifier->ShareFlowIds (m_classifiers.front ());
+    }
   m_classifiers.push_back (classifier);
 }
 
@@ -23,11 +23,14 @@
 
 #include <vector>
 #include <map>
+#include <list>
+#include <fstream>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
@@ -228,7 +231,8 @@ public:
   /// Retrieve all collected the flow statistics.  Note, if the
   /// FlowMonitor has not stopped monitoring yet, you should call
   /// CheckForLostPackets() to make sure all possibly lost packets are
-  /// accounted for.
+  /// accounted for.  The flows evicted after the FlowEvictionTimeout
+  /// attribute are not included.
   /// \returns the flows statistics
   const FlowStatsContainer& GetFlowStats () const;
 
@@ -256,6 +260,27 @@ public:
   /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /// Write the statistics of the flows changed since the last export to
+  /// the file named by the ExportFile attribute, then evict the flows
+  /// idle for longer than the FlowEvictionTimeout attribute.
+  ///
+  /// This is done periodically, every ExportInterval, while the monitor
+  /// is running, and once more when it stops.  The file is a CSV file,
+  /// with a header line and one line per exported flow:
+  ///  - time: the time of the export, in nanoseconds;
+  ///  - flowId: the identifier of the flow;
+  ///  - evicted: 1 if this is the last line of the flow, which was removed
+  ///    from GetFlowStats ();
+  ///  - the fields of FlowStats, with the times in nanoseconds;
+  ///  - packetsDropped and bytesDropped: space-separated values, by reason code;
+  ///  - the histograms: space-separated bin:count pairs, for the non-empty bins.
+  ///
+  /// Each line holds the totals of the flow since it was first seen, or
+  /// since it was last evicted.  The evicted flows are also removed from
+  /// the FlowProbe statistics and from the classifiers: a flow seen again
+  /// after its eviction gets a new FlowId, and starts from zero.
+  void ExportFlows ();
+
 
 protected:
 
@@ -272,11 +297,26 @@ private:
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
   };
 
+  /// Bookkeeping of a flow of m_flowStats
+  struct FlowState
+  {
+    FlowStats *stats;          //!< the entry of the flow in m_flowStats, which is never moved
+    uint32_t packetsInFlight;  //!< number of tracked packets of the flow
+    bool changed;              //!< whether the flow is in m_changedFlows
+    std::list<FlowId>::iterator idlePosition; //!< position of the flow in m_idleFlows
+  };
+
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
-
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// FlowId --> FlowState, for the flows of m_flowStats only, so that
+  /// the probes find the statistics without a map lookup.
+  typedef FlowHashTable<FlowId, FlowState> FlowStateMap;
+  FlowStateMap m_flowStates; //!< The state of the flows
+
+  /// (FlowId,PacketId) --> TrackedPacket, with the FlowId in the upper
+  /// 32 bits of the key.  The packets are stored in the slots of the
+  /// table, which are reused from one packet to the next.
+  typedef FlowHashTable<uint64_t, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
@@ -293,13 +333,43 @@ private:
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
 
-  /// Get the stats for a given flow
+  /// Get the state of a given flow, and mark the flow as changed
   /// \param flowId the Flow identification
-  /// \returns the stats of the flow
-  FlowStats& GetStatsForFlow (FlowId flowId);
+  /// \returns the state of the flow, valid until the next flow is added
+  FlowState& GetStateForFlow (FlowId flowId);
+
+  /// Move a flow to the end of m_idleFlows, after a packet of the flow
+  /// was sent or received
+  /// \param state the state of the flow
+  void SetFlowActive (FlowState &state);
+
+  /// Get the key of a tracked packet
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the key of the packet in m_trackedPackets
+  static uint64_t GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId);
 
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Periodic function to export the changed flows
+  void PeriodicExportFlows ();
+
+  /// Write a line of the export file
+  /// \param flowId the Flow identification
+  /// \param stats the stats of the flow
+  /// \param evicted whether the flow is being evicted
+  void ExportFlow (FlowId flowId, FlowStats &stats, bool evicted);
+
+  std::string m_exportFileName;    //!< Name of the export file
+  Time m_exportInterval;           //!< Interval between the exports
+  Time m_flowEvictionTimeout;      //!< Idle time after which a flow is evicted
+  std::ofstream m_exportStream;    //!< Export file
+  EventId m_exportEvent;           //!< Periodic export event
+  std::vector<FlowId> m_changedFlows; //!< Flows changed since the last export
+  /// The flows by time of their last packet sent or received, oldest
+  /// first, when FlowEvictionTimeout is set
+  std::list<FlowId> m_idleFlows;
 };
 
 
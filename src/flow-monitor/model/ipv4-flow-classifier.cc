@@ -96,6 +96,17 @@ bool operator == (const Ipv4FlowClassifier::FiveTuple &t1,
 
 
 
+size_t
+Ipv4FlowClassifier::FiveTupleHash::operator() (const FiveTuple &tuple) const
+{
+  uint64_t addresses = (static_cast<uint64_t> (tuple.sourceAddress.Get ()) << 32)
+    | tuple.destinationAddress.Get ();
+  uint64_t ports = (static_cast<uint64_t> (tuple.protocol) << 32)
+    | (static_cast<uint32_t> (tuple.sourcePort) << 16) | tuple.destinationPort;
+  uint64_t h = addresses ^ (ports * 0xff51afd7ed558ccdULL);
+  return static_cast<size_t> (h ^ (h >> 29));
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier ()
 {
 }
@@ -148,35 +159,36 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  bool inserted;
+  Flow &flow = m_flowMap.Insert (tuple, &inserted);
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
-  if (insert.second)
+  if (inserted)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
-      m_flowDscpMap[newFlowId];
+      flow.flowId = GetNewFlowId ();
+      flow.lastPacketId = 0;
+      m_tuples.Insert (flow.flowId, &inserted) = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      flow.lastPacketId++;
     }
 
   // increment the counter of packets with the same DSCP value
   Ipv4Header::DscpType dscp = ipHeader.GetDscp ();
-  std::pair<std::map<Ipv4Header::DscpType, uint32_t>::iterator, bool> dscpInserter
-    = m_flowDscpMap[insert.first->second].insert (std::pair<Ipv4Header::DscpType, uint32_t> (dscp, 1));
-
-  // if the insertion did not succeed, we need to increment the counter
-  if (!dscpInserter.second)
+  DscpCounts::iterator count = flow.dscpCounts.begin ();
+  while (count != flow.dscpCounts.end () && count->first < dscp)
+    {
+      count++;
+    }
+  if (count == flow.dscpCounts.end () || count->first != dscp)
     {
-      m_flowDscpMap[insert.first->second][dscp] ++;
+      count = flow.dscpCounts.insert (count, std::make_pair (dscp, 0));
     }
+  count->second++;
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = flow.flowId;
+  *out_packetId = flow.lastPacketId;
 
   return true;
 }
@@ -185,13 +197,10 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple != 0)
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return *tuple;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv4Address::GetZero (), Ipv4Address::GetZero (), 0, 0, 0 };
@@ -208,15 +217,13 @@ Ipv4FlowClassifier::SortByCount::operator() (std::pair<Ipv4Header::DscpType, uin
 std::vector<std::pair<Ipv4Header::DscpType, uint32_t> >
 Ipv4FlowClassifier::GetDscpCounts (FlowId flowId) const
 {
-  std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t> >::const_iterator flow
-    = m_flowDscpMap.find (flowId);
-
-  if (flow == m_flowDscpMap.end ())
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple == 0)
     {
       NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
     }
 
-  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > v (flow->second.begin (), flow->second.end ());
+  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > v (m_flowMap.Find (*tuple)->dscpCounts);
   std::sort (v.begin (), v.end (), SortByCount ());
   return v;
 }
@@ -226,30 +233,36 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
 {
   Indent (os, indent); os << "<Ipv4FlowClassifier>\n";
 
+  // in the order of the flow identifiers
+  std::vector<FlowId> flowIds;
+  for (uint32_t slot = 0; slot < m_tuples.GetCapacity (); slot++)
+    {
+      if (m_tuples.IsUsed (slot))
+        {
+          flowIds.push_back (m_tuples.GetKey (slot));
+        }
+    }
+  std::sort (flowIds.begin (), flowIds.end ());
+
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (std::vector<FlowId>::const_iterator flowId = flowIds.begin (); flowId != flowIds.end (); flowId++)
     {
+      const FiveTuple &tuple = *m_tuples.Find (*flowId);
+      const Flow &flow = *m_flowMap.Find (tuple);
       Indent (os, indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+      os << "<Flow flowId=\"" << *flowId << "\""
+         << " sourceAddress=\"" << tuple.sourceAddress << "\""
+         << " destinationAddress=\"" << tuple.destinationAddress << "\""
+         << " protocol=\"" << int(tuple.protocol) << "\""
+         << " sourcePort=\"" << tuple.sourcePort << "\""
+         << " destinationPort=\"" << tuple.destinationPort << "\">\n";
 
       indent += 2;
-      std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t> >::const_iterator flow
-        = m_flowDscpMap.find (iter->second);
-
-      if (flow != m_flowDscpMap.end ())
+      for (DscpCounts::const_iterator i = flow.dscpCounts.begin (); i != flow.dscpCounts.end (); i++)
         {
-          for (std::map<Ipv4Header::DscpType, uint32_t>::const_iterator i = flow->second.begin (); i != flow->second.end (); i++)
-            {
-              Indent (os, indent);
-              os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
-                 << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+          Indent (os, indent);
+          os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
+             << " packets=\"" << std::dec << i->second << "\" />\n";
         }
 
       indent -= 2;
@@ -260,6 +273,23 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
   Indent (os, indent); os << "</Ipv4FlowClassifier>\n";
 }
 
+void
+Ipv4FlowClassifier::EvictFlow (FlowId flowId)
+{
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple != 0)
+    {
+      m_flowMap.Erase (*tuple);
+      m_tuples.Erase (flowId);
+    }
+}
+
+uint32_t
+Ipv4FlowClassifier::GetNFlows (void) const
+{
+  return m_tuples.GetSize ();
+}
+
 
 } // namespace ns3
 
@@ -22,6 +22,7 @@
 #include "ns3/ipv4-flow-classifier.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
@@ -216,6 +217,20 @@ Ipv4FlowProbeTag::IsSrcDstValid (Ipv4Address src, Ipv4Address dst) const
   return ((m_src == src) && (m_dst == dst));
 }
 
+/**
+ * \ingroup flow-monitor
+ * \brief Give the Ipv4FlowProbeTag, set on every monitored packet, a
+ * fixed slot in the PacketTagList.
+ */
+static class Ipv4FlowProbeTagSlot
+{
+public:
+  Ipv4FlowProbeTagSlot ()
+  {
+    PacketTagList::RegisterFastTag (Ipv4FlowProbeTag ());
+  }
+} g_ipv4FlowProbeTagSlot; //!< Registers the Ipv4FlowProbeTag with a fixed slot
+
 ////////////////////////////////////////
 // Ipv4FlowProbe class implementation //
 ////////////////////////////////////////
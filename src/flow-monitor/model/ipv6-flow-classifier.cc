@@ -97,6 +97,18 @@ bool operator == (const Ipv6FlowClassifier::FiveTuple &t1,
 
 
 
+size_t
+Ipv6FlowClassifier::FiveTupleHash::operator() (const FiveTuple &tuple) const
+{
+  Ipv6AddressHash addressHash;
+  uint64_t addresses = (static_cast<uint64_t> (addressHash (tuple.sourceAddress)) << 32)
+    ^ addressHash (tuple.destinationAddress);
+  uint64_t ports = (static_cast<uint64_t> (tuple.protocol) << 32)
+    | (static_cast<uint32_t> (tuple.sourcePort) << 16) | tuple.destinationPort;
+  uint64_t h = addresses ^ (ports * 0xff51afd7ed558ccdULL);
+  return static_cast<size_t> (h ^ (h >> 29));
+}
+
 Ipv6FlowClassifier::Ipv6FlowClassifier ()
 {
 }
@@ -149,35 +161,36 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  bool inserted;
+  Flow &flow = m_flowMap.Insert (tuple, &inserted);
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
-  if (insert.second)
+  if (inserted)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
-      m_flowDscpMap[newFlowId];
+      flow.flowId = GetNewFlowId ();
+      flow.lastPacketId = 0;
+      m_tuples.Insert (flow.flowId, &inserted) = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      flow.lastPacketId++;
     }
 
   // increment the counter of packets with the same DSCP value
   Ipv6Header::DscpType dscp = ipHeader.GetDscp ();
-  std::pair<std::map<Ipv6Header::DscpType, uint32_t>::iterator, bool> dscpInserter
-    = m_flowDscpMap[insert.first->second].insert (std::pair<Ipv6Header::DscpType, uint32_t> (dscp, 1));
-
-  // if the insertion did not succeed, we need to increment the counter
-  if (!dscpInserter.second)
+  DscpCounts::iterator count = flow.dscpCounts.begin ();
+  while (count != flow.dscpCounts.end () && count->first < dscp)
+    {
+      count++;
+    }
+  if (count == flow.dscpCounts.end () || count->first != dscp)
     {
-      m_flowDscpMap[insert.first->second][dscp] ++;
+      count = flow.dscpCounts.insert (count, std::make_pair (dscp, 0));
     }
+  count->second++;
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = flow.flowId;
+  *out_packetId = flow.lastPacketId;
 
   return true;
 }
@@ -186,13 +199,10 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple != 0)
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return *tuple;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv6Address::GetZero (), Ipv6Address::GetZero (), 0, 0, 0 };
@@ -209,15 +219,13 @@ Ipv6FlowClassifier::SortByCount::operator() (std::pair<Ipv6Header::DscpType, uin
 std::vector<std::pair<Ipv6Header::DscpType, uint32_t> >
 Ipv6FlowClassifier::GetDscpCounts (FlowId flowId) const
 {
-  std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t> >::const_iterator flow
-    = m_flowDscpMap.find (flowId);
-
-  if (flow == m_flowDscpMap.end ())
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple == 0)
     {
       NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
     }
 
-  std::vector<std::pair<Ipv6Header::DscpType, uint32_t> > v (flow->second.begin (), flow->second.end ());
+  std::vector<std::pair<Ipv6Header::DscpType, uint32_t> > v (m_flowMap.Find (*tuple)->dscpCounts);
   std::sort (v.begin (), v.end (), SortByCount ());
   return v;
 }
@@ -227,30 +235,36 @@ Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
 {
   Indent (os, indent); os << "<Ipv6FlowClassifier>\n";
 
+  // in the order of the flow identifiers
+  std::vector<FlowId> flowIds;
+  for (uint32_t slot = 0; slot < m_tuples.GetCapacity (); slot++)
+    {
+      if (m_tuples.IsUsed (slot))
+        {
+          flowIds.push_back (m_tuples.GetKey (slot));
+        }
+    }
+  std::sort (flowIds.begin (), flowIds.end ());
+
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (std::vector<FlowId>::const_iterator flowId = flowIds.begin (); flowId != flowIds.end (); flowId++)
     {
+      const FiveTuple &tuple = *m_tuples.Find (*flowId);
+      const Flow &flow = *m_flowMap.Find (tuple);
       Indent (os, indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+      os << "<Flow flowId=\"" << *flowId << "\""
+         << " sourceAddress=\"" << tuple.sourceAddress << "\""
+         << " destinationAddress=\"" << tuple.destinationAddress << "\""
+         << " protocol=\"" << int(tuple.protocol) << "\""
+         << " sourcePort=\"" << tuple.sourcePort << "\""
+         << " destinationPort=\"" << tuple.destinationPort << "\">\n";
 
       indent += 2;
-      std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t> >::const_iterator flow
-        = m_flowDscpMap.find (iter->second);
-
-      if (flow != m_flowDscpMap.end ())
+      for (DscpCounts::const_iterator i = flow.dscpCounts.begin (); i != flow.dscpCounts.end (); i++)
         {
-          for (std::map<Ipv6Header::DscpType, uint32_t>::const_iterator i = flow->second.begin (); i != flow->second.end (); i++)
-            {
-              Indent (os, indent);
-              os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
-                 << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+          Indent (os, indent);
+          os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t> (i->first) << "\""
+             << " packets=\"" << std::dec << i->second << "\" />\n";
         }
 
       indent -= 2;
@@ -259,7 +273,23 @@ Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, uint16_t indent) con
 
   indent -= 2;
   Indent (os, indent); os << "</Ipv6FlowClassifier>\n";
+}
 
+void
+Ipv6FlowClassifier::EvictFlow (FlowId flowId)
+{
+  const FiveTuple *tuple = m_tuples.Find (flowId);
+  if (tuple != 0)
+    {
+      m_flowMap.Erase (*tuple);
+      m_tuples.Erase (flowId);
+    }
+}
+
+uint32_t
+Ipv6FlowClassifier::GetNFlows (void) const
+{
+  return m_tuples.GetSize ();
 }
 
 
@@ -23,10 +23,11 @@
 #define IPV6_FLOW_CLASSIFIER_H
 
 #include <stdint.h>
-#include <map>
+#include <vector>
 
 #include "ns3/ipv6-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flow-hash-table.h"
 
 namespace ns3 {
 
@@ -91,14 +92,36 @@ public:
 
   virtual void SerializeToXmlStream (std::ostream &os, uint16_t indent) const;
 
+  virtual void EvictFlow (FlowId flowId);
+
+  /// \returns the number of flows known by the classifier
+  uint32_t GetNFlows (void) const;
+
 private:
 
-  /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-  /// Map FlowIds to (DSCP value, packet count) pairs
-  std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t> > m_flowDscpMap;
+  /// Hash function of FiveTuple
+  struct FiveTupleHash
+  {
+    /// \param tuple the tuple to hash
+    /// \returns the hash of the tuple
+    size_t operator() (const FiveTuple &tuple) const;
+  };
+
+  /// (DSCP value, packet count) pairs, sorted by DSCP value
+  typedef std::vector<std::pair<Ipv6Header::DscpType, uint32_t> > DscpCounts;
+
+  /// Structure to store a flow seen by the classifier
+  struct Flow
+  {
+    FlowId flowId;             //!< The identifier of the flow
+    FlowPacketId lastPacketId; //!< The identifier of the last packet of the flow
+    DscpCounts dscpCounts;     //!< The number of packets of each DSCP value
+  };
+
+  /// Map to Flows Identifiers to Flows
+  FlowHashTable<FiveTuple, Flow, FiveTupleHash> m_flowMap;
+  /// The tuples of the flows, by FlowId
+  FlowHashTable<FlowId, FiveTuple> m_tuples;
 
 };
 
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <map>
+
+#include "ns3/flow-hash-table.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/packet.h"
+#include "ns3/udp-header.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowHashTable Test: random insertions and erasures, checked
+ * against a std::map.
+ */
+class FlowHashTableTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name the name of the test
+   * \param collide whether all the keys have the same hash
+   */
+  FlowHashTableTestCase (std::string name, bool collide);
+  virtual void DoRun (void);
+
+private:
+  /// A hash function which puts all the keys in the same slot
+  struct CollidingHash
+  {
+    /// \return 0
+    size_t operator() (uint64_t) const
+    {
+      return 0;
+    }
+  };
+
+  /**
+   * Run the test with a hash function.
+   * \tparam Hash the hash function
+   */
+  template <typename Hash>
+  void Check (void);
+
+  bool m_collide; //!< Whether all the keys have the same hash
+};
+
+FlowHashTableTestCase::FlowHashTableTestCase (std::string name, bool collide)
+  : TestCase (name),
+    m_collide (collide)
+{
+}
+
+template <typename Hash>
+void
+FlowHashTableTestCase::Check (void)
+{
+  FlowHashTable<uint64_t, uint32_t, Hash> table;
+  std::map<uint64_t, uint32_t> reference;
+  uint32_t state = 12345;
+  uint32_t keys = m_collide ? 64 : 4096;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      state = state * 1103515245 + 12345;
+      uint64_t key = (static_cast<uint64_t> ((state >> 8) % 4) << 32) | ((state >> 12) % keys);
+      bool erase = ((state >> 28) & 3) == 0;
+      if (erase)
+        {
+          bool known = reference.erase (key) == 1;
+          NS_TEST_ASSERT_MSG_EQ (table.Erase (key), known, "Wrong erasure of " << key);
+        }
+      else
+        {
+          bool inserted;
+          uint32_t &value = table.Insert (key, &inserted);
+          bool known = reference.count (key) == 1;
+          NS_TEST_ASSERT_MSG_EQ (inserted, !known, "Wrong insertion of " << key);
+          value = i;
+          reference[key] = i;
+        }
+      NS_TEST_ASSERT_MSG_EQ (table.GetSize (), reference.size (), "Wrong size");
+    }
+
+  for (std::map<uint64_t, uint32_t>::const_iterator it = reference.begin (); it != reference.end (); it++)
+    {
+      uint32_t *value = table.Find (it->first);
+      NS_TEST_ASSERT_MSG_NE (value, 0, "Lost key " << it->first);
+      NS_TEST_EXPECT_MSG_EQ (*value, it->second, "Wrong value of " << it->first);
+    }
+  uint32_t used = 0;
+  for (uint32_t slot = 0; slot < table.GetCapacity (); slot++)
+    {
+      if (table.IsUsed (slot))
+        {
+          used++;
+          NS_TEST_EXPECT_MSG_EQ (reference.count (table.GetKey (slot)), 1, "Unknown key " << table.GetKey (slot));
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (used, reference.size (), "Wrong number of used slots");
+
+  table.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (table.GetSize (), 0, "Table not cleared");
+  NS_TEST_EXPECT_MSG_EQ (table.Find (reference.begin ()->first), 0, "Table not cleared");
+}
+
+void
+FlowHashTableTestCase::DoRun (void)
+{
+  if (m_collide)
+    {
+      Check<CollidingHash> ();
+    }
+  else
+    {
+      Check<std::hash<uint64_t> > ();
+    }
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Ipv4FlowClassifier Test: flow and packet identifiers, and DSCP counts.
+ */
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase ()
+  : TestCase ("Ipv4FlowClassifier")
+{
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  const uint32_t flows = 1000;
+  for (uint32_t round = 0; round < 3; round++)
+    {
+      for (uint32_t i = 0; i < flows; i++)
+        {
+          Ipv4Header ipHeader;
+          ipHeader.SetSource (Ipv4Address (0x0a000000 + i));
+          ipHeader.SetDestination (Ipv4Address ("10.1.0.1"));
+          ipHeader.SetProtocol (17);
+          ipHeader.SetDscp (round == 2 ? Ipv4Header::DSCP_EF : Ipv4Header::DscpDefault);
+          UdpHeader udpHeader;
+          udpHeader.SetSourcePort (1000 + i % 7);
+          udpHeader.SetDestinationPort (9);
+          Ptr<Packet> p = Create<Packet> (100);
+          p->AddHeader (udpHeader);
+
+          uint32_t flowId;
+          uint32_t packetId;
+          NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ipHeader, p, &flowId, &packetId), true, "Not classified");
+          NS_TEST_ASSERT_MSG_EQ (flowId, i + 1, "Wrong flow ID");
+          NS_TEST_ASSERT_MSG_EQ (packetId, round, "Wrong packet ID");
+        }
+    }
+
+  Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow (42);
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourceAddress, Ipv4Address (0x0a000000 + 41), "Wrong source address");
+  NS_TEST_EXPECT_MSG_EQ (tuple.sourcePort, 1000 + 41 % 7, "Wrong source port");
+  NS_TEST_EXPECT_MSG_EQ (tuple.destinationPort, 9, "Wrong destination port");
+
+  std::vector<std::pair<Ipv4Header::DscpType, uint32_t> > dscp = classifier->GetDscpCounts (42);
+  NS_TEST_ASSERT_MSG_EQ (dscp.size (), 2, "Wrong number of DSCP values");
+  NS_TEST_EXPECT_MSG_EQ (dscp[0].first, Ipv4Header::DscpDefault, "Wrong most frequent DSCP value");
+  NS_TEST_EXPECT_MSG_EQ (dscp[0].second, 2, "Wrong DSCP count");
+  NS_TEST_EXPECT_MSG_EQ (dscp[1].first, Ipv4Header::DSCP_EF, "Wrong least frequent DSCP value");
+  NS_TEST_EXPECT_MSG_EQ (dscp[1].second, 1, "Wrong DSCP count");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowHashTable TestSuite
+ */
+class FlowHashTableTestSuite : public TestSuite
+{
+public:
+  FlowHashTableTestSuite ();
+};
+
+FlowHashTableTestSuite::FlowHashTableTestSuite ()
+  : TestSuite ("flow-hash-table", UNIT)
+{
+  AddTestCase (new FlowHashTableTestCase ("FlowHashTable", false), TestCase::QUICK);
+  AddTestCase (new FlowHashTableTestCase ("FlowHashTable with colliding keys", true), TestCase::QUICK);
+  AddTestCase (new Ipv4FlowClassifierTestCase, TestCase::QUICK);
+}
+
+static FlowHashTableTestSuite g_flowHashTableTestSuite; //!< Static variable for test initialization
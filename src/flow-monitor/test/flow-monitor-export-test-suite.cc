@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv6-flow-classifier.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief A probe which reports nothing by itself.
+ */
+class ExportTestProbe : public FlowProbe
+{
+public:
+  /**
+   * Constructor
+   * \param monitor the FlowMonitor
+   */
+  ExportTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor export Test: the changed flows are exported
+ * periodically, and the idle flows evicted.
+ */
+class FlowMonitorExportTestCase : public TestCase
+{
+public:
+  FlowMonitorExportTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorExportTestCase::FlowMonitorExportTestCase ()
+  : TestCase ("FlowMonitor export and eviction")
+{
+}
+
+void
+FlowMonitorExportTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-monitor-export.csv");
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("ExportFile", StringValue (fileName));
+  monitor->SetAttribute ("ExportInterval", TimeValue (Seconds (1)));
+  monitor->SetAttribute ("FlowEvictionTimeout", TimeValue (Seconds (2)));
+  Ptr<FlowProbe> probe = CreateObject<ExportTestProbe> (monitor);
+
+  Simulator::Schedule (Seconds (0), &FlowMonitor::StartRightNow, monitor);
+  // flow 1 is idle from 0.2 s to 6.5 s: evicted at 3 s, and seen again
+  Simulator::Schedule (MilliSeconds (100), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 0, 100);
+  Simulator::Schedule (MilliSeconds (200), &FlowMonitor::ReportLastRx, monitor, probe, 1, 0, 100);
+  Simulator::Schedule (MilliSeconds (6500), &FlowMonitor::ReportFirstTx, monitor, probe, 1, 1, 100);
+  Simulator::Schedule (MilliSeconds (6600), &FlowMonitor::ReportLastRx, monitor, probe, 1, 1, 100);
+  // flow 2 has a packet in flight until 4.5 s: evicted at 7 s only
+  Simulator::Schedule (MilliSeconds (100), &FlowMonitor::ReportFirstTx, monitor, probe, 2, 0, 200);
+  Simulator::Schedule (MilliSeconds (4500), &FlowMonitor::ReportLastRx, monitor, probe, 2, 0, 200);
+  Simulator::Schedule (Seconds (8), &FlowMonitor::StopRightNow, monitor);
+  Simulator::Stop (Seconds (9));
+  Simulator::Run ();
+
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), 1, "Flow 2 should be evicted");
+  NS_TEST_ASSERT_MSG_EQ (stats.begin ()->first, 1, "Flow 1 should be kept");
+  NS_TEST_EXPECT_MSG_EQ (stats.begin ()->second.txPackets, 1, "Flow 1 should start from zero after its eviction");
+
+  Simulator::Destroy ();
+
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line.substr (0, 22), "time,flowId,evicted,ti", "Wrong header");
+
+  // time, flowId, evicted, delaySum of each line
+  const int64_t expected[][4] = {
+    { 1000000000, 1, 0, 100000000 },
+    { 1000000000, 2, 0, 0 },
+    { 3000000000LL, 1, 1, 100000000 },
+    { 5000000000LL, 2, 0, 4400000000LL },
+    { 7000000000LL, 2, 1, 4400000000LL },
+    { 7000000000LL, 1, 0, 100000000 },
+  };
+  uint32_t count = 0;
+  while (std::getline (file, line))
+    {
+      NS_TEST_ASSERT_MSG_LT (count, 6, "Too many lines, at " << line);
+      std::vector<std::string> fields;
+      std::istringstream iss (line);
+      std::string field;
+      while (std::getline (iss, field, ','))
+        {
+          fields.push_back (field);
+        }
+      NS_TEST_ASSERT_MSG_GT (fields.size (), 7, "Missing fields in " << line);
+      int64_t values[4];
+      std::istringstream (fields[0]) >> values[0];
+      std::istringstream (fields[1]) >> values[1];
+      std::istringstream (fields[2]) >> values[2];
+      std::istringstream (fields[7]) >> values[3];
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (values[i], expected[count][i], "Wrong field " << i << " in " << line);
+        }
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 6, "Missing lines");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor eviction Test: the probes and the classifiers forget
+ * the evicted flows too, and the IPv6 flows are not mistaken for IPv4 ones.
+ */
+class FlowMonitorEvictionTestCase : public TestCase
+{
+public:
+  FlowMonitorEvictionTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Classify a UDP packet, and report it as sent and received.
+   * \param sourcePort the source port of the packet
+   * \return the FlowId of the packet
+   */
+  FlowId SendPacket (uint16_t sourcePort);
+  /**
+   * Classify an IPv6 UDP packet, and report it as sent and received.
+   * \return the FlowId of the packet
+   */
+  FlowId SendPacket6 (void);
+  /**
+   * Check the flows known by the monitor, the probe and the classifier.
+   * \param flows the number of flows expected
+   * \param flowId a flow expected in the probe
+   */
+  void CheckFlows (uint32_t flows, FlowId flowId);
+
+  Ptr<FlowMonitor> m_monitor;           //!< The FlowMonitor
+  Ptr<FlowProbe> m_probe;               //!< The probe
+  Ptr<Ipv4FlowClassifier> m_classifier; //!< The classifier
+  Ptr<Ipv6FlowClassifier> m_classifier6; //!< The IPv6 classifier
+};
+
+FlowMonitorEvictionTestCase::FlowMonitorEvictionTestCase ()
+  : TestCase ("FlowMonitor eviction of the probe and classifier flows")
+{
+}
+
+FlowId
+FlowMonitorEvictionTestCase::SendPacket (uint16_t sourcePort)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  Ptr<Packet> packet = Create<Packet> (100);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (sourcePort);
+  udpHeader.SetDestinationPort (9);
+  packet->AddHeader (udpHeader);
+
+  uint32_t flowId;
+  uint32_t packetId;
+  bool classified = m_classifier->Classify (ipHeader, packet, &flowId, &packetId);
+  NS_TEST_EXPECT_MSG_EQ (classified, true, "The packet should be classified");
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, packet->GetSize ());
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, packet->GetSize ());
+  return flowId;
+}
+
+FlowId
+FlowMonitorEvictionTestCase::SendPacket6 (void)
+{
+  Ipv6Header ipHeader;
+  ipHeader.SetSourceAddress (Ipv6Address ("2001:db8::1"));
+  ipHeader.SetDestinationAddress (Ipv6Address ("2001:db8::2"));
+  ipHeader.SetNextHeader (UdpL4Protocol::PROT_NUMBER);
+  Ptr<Packet> packet = Create<Packet> (100);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (3000);
+  udpHeader.SetDestinationPort (9);
+  packet->AddHeader (udpHeader);
+
+  uint32_t flowId;
+  uint32_t packetId;
+  bool classified = m_classifier6->Classify (ipHeader, packet, &flowId, &packetId);
+  NS_TEST_EXPECT_MSG_EQ (classified, true, "The IPv6 packet should be classified");
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, packet->GetSize ());
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, packet->GetSize ());
+  return flowId;
+}
+
+void
+FlowMonitorEvictionTestCase::CheckFlows (uint32_t flows, FlowId flowId)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().size (), flows, "Wrong number of monitor flows");
+  FlowProbe::Stats stats = m_probe->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.size (), flows, "Wrong number of probe flows");
+  NS_TEST_EXPECT_MSG_EQ ((stats.find (flowId) != stats.end ()), true, "Missing probe flow " << flowId);
+  NS_TEST_EXPECT_MSG_EQ (m_classifier->GetNFlows () + m_classifier6->GetNFlows (), flows,
+                         "Wrong number of classifier flows");
+}
+
+void
+FlowMonitorEvictionTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("ExportInterval", TimeValue (Seconds (1)));
+  m_monitor->SetAttribute ("FlowEvictionTimeout", TimeValue (Seconds (2)));
+  m_probe = CreateObject<ExportTestProbe> (m_monitor);
+  m_classifier = Create<Ipv4FlowClassifier> ();
+  m_monitor->AddFlowClassifier (m_classifier);
+  m_classifier6 = Create<Ipv6FlowClassifier> ();
+  m_monitor->AddFlowClassifier (m_classifier6);
+  m_monitor->StartRightNow ();
+
+  // the IPv4 flows are seen at 0.1 s and the IPv6 flow 3 at 0.2 s, then
+  // flows 2 and 3 again at 2.5 s: flow 1 is evicted at 3 s
+  Simulator::Schedule (MilliSeconds (100), &FlowMonitorEvictionTestCase::SendPacket, this, 1000);
+  Simulator::Schedule (MilliSeconds (100), &FlowMonitorEvictionTestCase::SendPacket, this, 2000);
+  Simulator::Schedule (MilliSeconds (200), &FlowMonitorEvictionTestCase::SendPacket6, this);
+  Simulator::Schedule (MilliSeconds (2500), &FlowMonitorEvictionTestCase::SendPacket, this, 2000);
+  Simulator::Schedule (MilliSeconds (2500), &FlowMonitorEvictionTestCase::SendPacket6, this);
+  Simulator::Schedule (MilliSeconds (2900), &FlowMonitorEvictionTestCase::CheckFlows, this, 3, 1);
+  Simulator::Schedule (MilliSeconds (3100), &FlowMonitorEvictionTestCase::CheckFlows, this, 2, 2);
+  Simulator::Stop (MilliSeconds (3200));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_classifier->FindFlow (2).sourcePort, 2000, "Wrong tuple of flow 2");
+  NS_TEST_EXPECT_MSG_EQ (m_classifier6->GetNFlows (), 1, "The IPv6 flow should be kept");
+  NS_TEST_EXPECT_MSG_EQ (m_classifier6->FindFlow (3).sourcePort, 3000, "Wrong tuple of the IPv6 flow");
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().find (3)->second.txPackets, 2,
+                         "The IPv6 flow should not share the statistics of an IPv4 flow");
+  // flow 1 is a new flow now
+  NS_TEST_EXPECT_MSG_EQ (SendPacket (1000), 4, "An evicted flow should get a new FlowId");
+  CheckFlows (3, 4);
+
+  Simulator::Destroy ();
+  m_monitor = 0;
+  m_probe = 0;
+  m_classifier = 0;
+  m_classifier6 = 0;
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor export TestSuite
+ */
+class FlowMonitorExportTestSuite : public TestSuite
+{
+public:
+  FlowMonitorExportTestSuite ();
+};
+
+FlowMonitorExportTestSuite::FlowMonitorExportTestSuite ()
+  : TestSuite ("flow-monitor-export", UNIT)
+{
+  AddTestCase (new FlowMonitorExportTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorEvictionTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorExportTestSuite g_flowMonitorExportTestSuite; //!< Static variable for test initialization
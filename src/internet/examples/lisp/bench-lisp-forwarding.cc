@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the wall-clock cost of forwarding packets through a pair of
+ * xTRs, i.e. of the per-packet work of the LISP data plane (map-cache
+ * lookup, encapsulation, decapsulation) and of the IPv4 stack around it.
+ *
+ * The topology and the mapping files are the ones of the simple-lisp
+ * test suite, so the program must be run from the top of the tree:
+ *
+ *   ./waf --run "bench-lisp-forwarding --packets=200000"
+ *
+ * Topology:                    MR/MS (n5/n6)
+ *                                  |
+ *              xTR1 (n1) <----> R (n2) <-----> xTR2 (n3)
+ *              /               (non-LISP)        \
+ *             /                                   \
+ *          n0 (non-LISP)                         n4 (non-LISP)
+ */
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BenchLispForwarding");
+
+/** Number of packets received by n4. */
+static uint32_t g_received = 0;
+
+static void
+RxSink (Ptr<const Packet> p, const Address &from)
+{
+  g_received++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t packets = 100000;
+  uint32_t packetSize = 512;
+  std::string rlocs = "src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs.txt";
+  std::string mapTables = "src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs_config_xml.txt";
+
+  CommandLine cmd;
+  cmd.Usage ("Measure the per-packet cost of LISP forwarding.");
+  cmd.AddValue ("packets", "number of packets sent from n0 to n4", packets);
+  cmd.AddValue ("packetSize", "size of the UDP payload", packetSize);
+  cmd.AddValue ("rlocs", "RLOC set file", rlocs);
+  cmd.AddValue ("mapTables", "map tables file", mapTables);
+  cmd.Parse (argc, argv);
+
+  // As in the simple-lisp test: the LISP code needs the packet metadata.
+  PacketMetadata::Enable ();
+
+  NodeContainer nodes;
+  nodes.Create (7);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  // Fast links, so that the run is dominated by the per-packet processing.
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer dn0_dxTR1 = p2p.Install (nodes.Get (0), nodes.Get (1));
+  NetDeviceContainer dxTR1_dR = p2p.Install (nodes.Get (1), nodes.Get (2));
+  NetDeviceContainer dR_dxTR2 = p2p.Install (nodes.Get (2), nodes.Get (3));
+  NetDeviceContainer dxTR2_dn4 = p2p.Install (nodes.Get (3), nodes.Get (4));
+  NetDeviceContainer dR_dMR = p2p.Install (nodes.Get (2), nodes.Get (5));
+  NetDeviceContainer dR_dMS = p2p.Install (nodes.Get (2), nodes.Get (6));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (dn0_dxTR1);
+  ipv4.SetBase ("192.168.1.0", "255.255.255.0");
+  ipv4.Assign (dxTR1_dR);
+  ipv4.SetBase ("192.168.2.0", "255.255.255.0");
+  ipv4.Assign (dR_dxTR2);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer ixTR2_in4 = ipv4.Assign (dxTR2_dn4);
+  ipv4.SetBase ("192.168.3.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMR = ipv4.Assign (dR_dMR);
+  ipv4.SetBase ("192.168.4.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMS = ipv4.Assign (dR_dMS);
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  NodeContainer lispRouters = NodeContainer (nodes.Get (1), nodes.Get (3), nodes.Get (5), nodes.Get (6));
+  NodeContainer xTRs = NodeContainer (nodes.Get (1), nodes.Get (3));
+
+  LispHelper lispHelper;
+  lispHelper.BuildRlocsSet (rlocs);
+  lispHelper.Install (lispRouters);
+  lispHelper.BuildMapTables2 (mapTables);
+  lispHelper.InstallMapTables (lispRouters);
+
+  LispEtrItrAppHelper lispAppHelper;
+  lispAppHelper.AddMapResolverRlocs (Create<Locator> (iR_iMR.GetAddress (1)));
+  lispAppHelper.AddMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  ApplicationContainer xTRApps = lispAppHelper.Install (xTRs);
+  xTRApps.Start (Seconds (1.0));
+
+  MapResolverDdtHelper mrHelper;
+  mrHelper.SetMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  mrHelper.Install (nodes.Get (5)).Start (Seconds (0.0));
+
+  MapServerDdtHelper msHelper;
+  msHelper.Install (nodes.Get (6)).Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (4));
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&RxSink));
+
+  // A first packet makes xTR1 resolve the mapping of n4, so that the
+  // measured packets hit the map-cache instead of being dropped on a miss.
+  UdpClientHelper client (ixTR2_in4.GetAddress (1), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (1));
+  client.Install (nodes.Get (0)).Start (Seconds (2.0));
+
+  // Then one packet every 10 us.
+  client.SetAttribute ("MaxPackets", UintegerValue (packets));
+  client.SetAttribute ("Interval", TimeValue (MicroSeconds (10)));
+  client.SetAttribute ("PacketSize", UintegerValue (packetSize));
+  client.Install (nodes.Get (0)).Start (Seconds (4.0));
+
+  Simulator::Stop (Seconds (5.0) + MicroSeconds (10) * packets);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+
+  // The first packet is dropped by xTR1 on the map-cache miss.
+  std::cout << "packets sent: " << packets << ", received: " << g_received << std::endl;
+  std::cout << "wall clock: " << ms << " ms, "
+            << (g_received ? ms * 1000.0 / g_received : 0) << " us/packet" << std::endl;
+  return 0;
+}
@@ -30,6 +30,7 @@ NS_LOG_COMPONENT_DEFINE ("LispEtrItrAppHelper");
 LispEtrItrAppHelper::LispEtrItrAppHelper ()
 {
   m_factory.SetTypeId (LispEtrItrApplication::GetTypeId ());
+  m_registerScheduler = CreateObject<MapRegisterScheduler> ();
 }
 
 LispEtrItrAppHelper::~LispEtrItrAppHelper ()
@@ -89,6 +90,7 @@ Ptr<Application> LispEtrItrAppHelper::InstallPriv (Ptr<Node> node) const
   lisp->GetMapTablesV4 ()->SetxTRApp (app);
   lisp->GetMapTablesV6 ()->SetxTRApp (app);
   app->SetMapServerAddresses (m_mapServerAddresses);
+  app->SetMapRegisterScheduler (m_registerScheduler);
   node->AddApplication (app);
   return app;
 }
@@ -103,4 +105,9 @@ void LispEtrItrAppHelper::AddMapResolverRlocs (Ptr<Locator> locator)
   m_mapResolverRlocs.push_back (locator);
 }
 
+Ptr<MapRegisterScheduler> LispEtrItrAppHelper::GetMapRegisterScheduler (void) const
+{
+  return m_registerScheduler;
+}
+
 } /* namespace ns3 */
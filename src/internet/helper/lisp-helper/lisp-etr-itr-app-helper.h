@@ -85,6 +85,12 @@ public:
   void AddMapResolverRlocs (Ptr<Locator> locator);
   void SetMapResolverRlocs (std::list<Ptr<Locator> > locator);
 
+  /**
+   * \return The scheduler shared by all the xTRs installed by this helper
+   * to refresh their registration (see the MapRegisterRefresh attribute).
+   */
+  Ptr<MapRegisterScheduler> GetMapRegisterScheduler (void) const;
+
 private:
   /**
    * Install an ns3::UdpEchoServer on the node configured with all the
@@ -97,6 +103,7 @@ private:
 
   std::list<Ptr<Locator> > m_mapResolverRlocs;
   std::list<Address> m_mapServerAddresses;
+  Ptr<MapRegisterScheduler> m_registerScheduler;
   ObjectFactory m_factory; //!<Object factory
 };
 
@@ -107,8 +107,8 @@ void LispHelper::Install (Ptr<Node> node) const
    * which will lead to segmentation fault for packet copy-forwarding.
    * We make sure once lispOverIpv4 is created, mapTables are always accessible.
    */
-  Ptr<MapTables> mapTablesv4 = Create<SimpleMapTables>();
-  Ptr<MapTables> mapTablesv6 = Create<SimpleMapTables>();
+  Ptr<MapTables> mapTablesv4 = CreateObject<SimpleMapTables> ();
+  Ptr<MapTables> mapTablesv6 = CreateObject<SimpleMapTables> ();
   lisp->SetMapTablesIpv4 (mapTablesv4);
   lisp->SetMapTablesIpv6 (mapTablesv6);
   /**
@@ -338,8 +338,8 @@ LispHelper::BuildMapTables (std::string localMapTablesConfigFilePath)
         }
 
       // Create MapTables
-      Ptr<SimpleMapTables> ipv4MapTables = Create<SimpleMapTables> ();
-      Ptr<SimpleMapTables> ipv6MapTables = Create<SimpleMapTables> ();
+      Ptr<SimpleMapTables> ipv4MapTables = CreateObject<SimpleMapTables> ();
+      Ptr<SimpleMapTables> ipv6MapTables = CreateObject<SimpleMapTables> ();
       int eidIpv4Rlocs = 0;
       int eidIpv6Rlocs = 0;
       // insert ipv4 eid map entries
@@ -574,8 +574,8 @@ void LispHelper::BuildMapTables2 (std::string localMapTablesConfigFilePath)
                                                              vect[1].c_str ()));
                 }
               // creating mapTables
-              Ptr<SimpleMapTables> ipv4MapTables = Create<SimpleMapTables> ();
-              Ptr<SimpleMapTables> ipv6MapTables = Create<SimpleMapTables> ();
+              Ptr<SimpleMapTables> ipv4MapTables = CreateObject<SimpleMapTables> ();
+              Ptr<SimpleMapTables> ipv6MapTables = CreateObject<SimpleMapTables> ();
               // start encoding one ENTRY
               while (std::getline (configFile, str))
                 {
@@ -49,24 +49,27 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
-  typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  typedef CandidateQueue::CandidateHeap_t Heap_t;
+  typedef Heap_t::const_iterator CIter_t;
+  Heap_t heap = q.m_candidates;
+  std::sort (heap.begin (), heap.end (), &CandidateQueue::CompareCandidate);
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
-  for (CIter_t iter = list.begin (); iter != list.end (); iter++)
+  for (CIter_t iter = heap.begin (); iter != heap.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_vertices (),
+    m_order (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,11 +97,12 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  Candidate c;
+  c.vertex = vNew;
+  c.order = m_order++;
+  m_candidates.push_back (c);
+  SiftUp (m_candidates.size () - 1, c);
+  m_vertices[vNew->GetVertexId ()] = vNew;
 }
 
 SPFVertex *
@@ -110,8 +114,18 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_candidates.front ().vertex;
+  Candidate last = m_candidates.back ();
+  m_candidates.pop_back ();
+  if (!m_candidates.empty ())
+    {
+      SiftDown (0, last);
+    }
+  CandidateMap_t::iterator i = m_vertices.find (v->GetVertexId ());
+  if (i != m_vertices.end () && i->second == v)
+    {
+      m_vertices.erase (i);
+    }
   return v;
 }
 
@@ -124,7 +138,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.front ().vertex;
 }
 
 bool
@@ -145,30 +159,106 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
-
-  for (; i != m_candidates.end (); i++)
+  CandidateMap_t::const_iterator i = m_vertices.find (addr);
+  if (i != m_vertices.end ())
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
-        {
-          return v;
-        }
+      return i->second;
     }
 
   return 0;
 }
 
+void
+CandidateQueue::DecreaseKey (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+  uint32_t index = v->m_candidateIndex;
+  NS_ASSERT (index < m_candidates.size () && m_candidates[index].vertex == v);
+
+  // A sorted list would have moved v after the vertices it now ties with,
+  // which were all before it: give it a new push order.
+  Candidate c = m_candidates[index];
+  c.order = m_order++;
+  SiftUp (index, c);
+}
+
 void
 CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  uint32_t size = m_candidates.size ();
+  for (uint32_t i = size / 2; i > 0; i--)
+    {
+      Candidate c = m_candidates[i - 1];
+      SiftDown (i - 1, c);
+    }
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::Set (uint32_t index, const Candidate& c)
+{
+  m_candidates[index] = c;
+  c.vertex->m_candidateIndex = index;
+}
+
+void
+CandidateQueue::SiftUp (uint32_t index, const Candidate& c)
+{
+  while (index > 0)
+    {
+      uint32_t parent = (index - 1) / 2;
+      if (!CompareCandidate (c, m_candidates[parent]))
+        {
+          break;
+        }
+      Set (index, m_candidates[parent]);
+      index = parent;
+    }
+  Set (index, c);
+}
+
+void
+CandidateQueue::SiftDown (uint32_t index, const Candidate& c)
+{
+  uint32_t size = m_candidates.size ();
+  while (true)
+    {
+      uint32_t child = 2 * index + 1;
+      if (child >= size)
+        {
+          break;
+        }
+      if (child + 1 < size && CompareCandidate (m_candidates[child + 1], m_candidates[child]))
+        {
+          child++;
+        }
+      if (!CompareCandidate (m_candidates[child], c))
+        {
+          break;
+        }
+      Set (index, m_candidates[child]);
+      index = child;
+    }
+  Set (index, c);
+}
+
+bool
+CandidateQueue::CompareCandidate (const Candidate& c1, const Candidate& c2)
+{
+  if (CompareSPFVertex (c1.vertex, c2.vertex))
+    {
+      return true;
+    }
+  if (CompareSPFVertex (c2.vertex, c1.vertex))
+    {
+      return false;
+    }
+  return c1.order < c2.order;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -45,8 +46,14 @@ class SPFVertex;
  *
  * Although a STL priority_queue almost does what we want, the requirement
  * for a Find () operation, the dynamic nature of the data and the derived
- * requirement for a Reorder () operation led us to implement this simple 
+ * requirement for a DecreaseKey () operation led us to implement this
  * enhanced priority queue.
+ *
+ * The queue is a binary heap, so that Push (), Pop () and DecreaseKey () are
+ * logarithmic in the number of candidates, and an index of the vertices by
+ * vertex ID makes Find () logarithmic too.  Vertices which compare equal are
+ * popped in the order they were pushed, as they were with the sorted list
+ * this queue replaces, so that the routes computed do not change.
  */
 class CandidateQueue
 {
@@ -138,6 +145,17 @@ public:
  * @returns The SPFVertex* pointer corresponding to the given IP address.
  */
   SPFVertex* Find (const Ipv4Address addr) const;
+/**
+ * @brief Restores the priority of a Shortest Path First Vertex of the
+ * Candidate Queue whose m_distanceFromRoot has just been decreased.
+ *
+ * The vertex is then popped after the vertices of equal priority already in
+ * the queue, as if it had just been pushed.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex, which must be in the queue.
+ */
+  void DecreaseKey (SPFVertex *v);
 
 /**
  * @brief Reorders the Candidate Queue according to the priority scheme.
@@ -148,7 +166,8 @@ public:
  * increasing distance.
  *
  * This method is provided in case the values of m_distanceFromRoot change
- * during the routing calculations.
+ * during the routing calculations.  When a single vertex got closer to the
+ * root, DecreaseKey () is cheaper.
  *
  * @see SPFVertex
  */
@@ -184,8 +203,45 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /**
+   * \brief An entry of the heap.
+   */
+  struct Candidate
+  {
+    SPFVertex *vertex; //!< the candidate vertex
+    uint32_t order;    //!< the push order, which breaks the ties of CompareSPFVertex
+  };
+  /**
+   * \brief return true if c1 must be popped before c2
+   * \param c1 first operand
+   * \param c2 second operand
+   * \return True if c1 should be popped before c2; false otherwise
+   */
+  static bool CompareCandidate (const Candidate& c1, const Candidate& c2);
+  /**
+   * \brief Store a candidate at a given position of the heap
+   * \param index the position
+   * \param c the candidate
+   */
+  void Set (uint32_t index, const Candidate& c);
+  /**
+   * \brief Move a candidate up the heap, from the given position
+   * \param index the position of the hole to fill
+   * \param c the candidate
+   */
+  void SiftUp (uint32_t index, const Candidate& c);
+  /**
+   * \brief Move a candidate down the heap, from the given position
+   * \param index the position of the hole to fill
+   * \param c the candidate
+   */
+  void SiftDown (uint32_t index, const Candidate& c);
+
+  typedef std::vector<Candidate> CandidateHeap_t; //!< container of SPFVertex candidates
+  CandidateHeap_t m_candidates;  //!< SPFVertex candidates, as a binary heap
+  typedef std::map<Ipv4Address, SPFVertex*> CandidateMap_t; //!< container of vertex IDs / SPFVertex pointers
+  CandidateMap_t m_vertices;  //!< SPFVertex candidates, indexed by vertex ID
+  uint32_t m_order;  //!< the push order of the next candidate
 
   /**
    * \brief Stream insertion operator.
@@ -538,6 +538,9 @@ private:
   ListOfSPFVertex_t m_parents; //!< parent list
   ListOfSPFVertex_t m_children; //!< Children list
   bool m_vertexProcessed; //!< Flag to note whether vertex has been processed in stage two of SPF computation
+  uint32_t m_candidateIndex; //!< Position of the vertex in the heap of the CandidateQueue holding it
+
+  friend class CandidateQueue;
 
 /**
  * @brief The SPFVertex copy construction is disallowed.  There's no need for
@@ -680,6 +683,8 @@ private:
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+  typedef std::map<Ipv4Address, LSDBMap_t::const_iterator> LinkDataMap_t; //!< container of link data / database entries
+  LinkDataMap_t m_linkData; //!< database entries indexed by the link data of their TransitNetwork link records
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
 
 /**
@@ -767,7 +772,22 @@ private:
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
   SPFVertex* m_spfroot; //!< the root node
+  Ptr<Node> m_spfrootNode; //!< the node of the root vertex, whose routes are being computed
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  typedef std::map<Ipv4Address, Ptr<Node> > RouterNodeMap_t; //!< container of router IDs / nodes
+  RouterNodeMap_t m_routerNodes; //!< the nodes of the global routers, indexed by router ID
+
+  /**
+   * \brief Find the node of a global router.
+   *
+   * The SPF calculation writes the routes of the root vertex to its node;
+   * the nodes are indexed once by router ID instead of walking the node
+   * list every time a route is added.
+   *
+   * \param routerId the router ID
+   * \returns the node, or 0 if no node has this router ID
+   */
+  Ptr<Node> GetRouterNode (Ipv4Address routerId);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
 
@@ -40,6 +41,11 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed by local port and, when their peer is fully
+ * specified, by (local port, peer address, peer port), so that a lookup
+ * only considers the endpoints which can match the packet instead of all
+ * the endpoints of the node.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +172,80 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief The endpoints bound to a local port.
+   */
+  struct Port
+  {
+    EndPoints endPoints; //!< All the endpoints, in allocation order.
+    EndPoints wildcard;  //!< The endpoints with a wildcard peer address or port.
+  };
+
+  /**
+   * \brief Key of the endpoints with a fully specified peer.
+   */
+  struct Connection
+  {
+    uint16_t localPort;      //!< The local port.
+    Ipv4Address peerAddress; //!< The peer address.
+    uint16_t peerPort;       //!< The peer port.
+
+    /**
+     * \brief Equality operator.
+     * \param other the other key
+     * \return true if the keys are equal
+     */
+    bool operator== (const Connection &other) const;
+  };
+
+  /**
+   * \brief Hash function of Connection.
+   */
+  struct ConnectionHash
+  {
+    /**
+     * \brief Hash a key.
+     * \param key the key
+     * \return the hash
+     */
+    size_t operator() (const Connection &key) const;
+  };
+
+  /**
+   * \brief Container of the endpoints by local port.
+   */
+  typedef std::unordered_map<uint16_t, Port> Ports;
+
+  /**
+   * \brief Container of the endpoints by local port and peer.
+   */
+  typedef std::unordered_map<Connection, EndPoints, ConnectionHash> Connections;
+
+  /**
+   * \brief Add an endpoint to the containers.
+   * \param endPoint the endpoint
+   */
+  void Add (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Index an endpoint by its peer.
+   *
+   * Called by the endpoint when its peer is set.
+   *
+   * \param endPoint the endpoint
+   */
+  void IndexPeer (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove the index of an endpoint by its peer.
+   *
+   * Called by the endpoint before its peer is changed.
+   *
+   * \param endPoint the endpoint
+   */
+  void UnindexPeer (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +272,16 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The IPv4 end points by local port.
+   */
+  Ports m_ports;
+
+  /**
+   * \brief The IPv4 end points with a fully specified peer.
+   */
+  Connections m_connections;
 };
 
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -272,6 +274,11 @@ private:
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  Ipv4RouteTrie m_hostRouteTrie;       //!< Index of the routes to hosts
+  Ipv4RouteTrie m_networkRouteTrie;    //!< Index of the routes to networks
+  Ipv4RouteTrie m_ASexternalRouteTrie; //!< Index of the external routes
+  std::vector<Ipv4RouteTrie::Route> m_matches; //!< Routes found by LookupGlobal
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -39,6 +39,7 @@
 #include "arp-cache.h"
 #include "ipv4-l3-protocol.h"
 #include "icmpv4-l4-protocol.h"
+#include "udp-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
 #include "ipv4-netfilter.h"
@@ -115,6 +116,10 @@ Ipv4L3Protocol::GetTypeId (void)
 Ipv4L3Protocol::Ipv4L3Protocol () : m_netfilter (0)
 {
   NS_LOG_FUNCTION (this);
+  m_ucb = MakeCallback (&Ipv4L3Protocol::IpForward, this);
+  m_mcb = MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this);
+  m_lcb = MakeCallback (&Ipv4L3Protocol::LocalDeliver, this);
+  m_ecb = MakeCallback (&Ipv4L3Protocol::RouteInputError, this);
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -291,6 +296,11 @@ Ipv4L3Protocol::SetNetfilter (Ptr<Ipv4Netfilter> netfilter)
 {
   NS_LOG_FUNCTION (this << netfilter);
   m_netfilter = netfilter;
+  m_netfilterConfirm = ContinueCallback ();
+  if (netfilter != 0)
+    {
+      m_netfilterConfirm = MakeCallback (&Ipv4Netfilter::NetfilterConntrackConfirm, PeekPointer (netfilter));
+    }
 }
 
 Ptr<Ipv4Netfilter>
@@ -684,12 +694,7 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
     }
 
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
-  if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
-                                      MakeCallback (&Ipv4L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv4L3Protocol::RouteInputError, this)
-                                      ))
+  if (!m_routingProtocol->RouteInput (packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
       m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), interface);
@@ -916,14 +921,22 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
            *    Own MapRegister messages musn't be encapsulated.
            */
 
+          /* Only the LISP control messages, over UDP, need a special
+           * treatment: e.g. ICMP errors between RLOCs are sent as is. */
+          if (protocol != UdpL4Protocol::PROT_NUMBER)
+            {
+              goto no_encap;
+            }
+
           /* Check if this is a MapRegister message */
           Ptr<Packet> packetCopy = packet->Copy ();
           UdpHeader udpHeader;
           packetCopy->RemoveHeader (udpHeader);
 
-          uint8_t buf[packetCopy->GetSize ()];
-          packetCopy->CopyData (buf, packetCopy->GetSize ());
-          uint8_t msg_type = (buf[0] >> 4);
+          // Only the message type is needed: do not copy the payload.
+          uint8_t firstByte = 0;
+          packetCopy->CopyData (&firstByte, 1);
+          uint8_t msg_type = (firstByte >> 4);
           if (msg_type == static_cast<uint8_t> (MapRegisterMsg::GetMsgType ()))
             {
               if (lispOverIpv4->IsNated ())
@@ -1159,7 +1172,7 @@ no_encap:
                 {
                   packetCopy->AddHeader (ipHeader);
                   NS_LOG_DEBUG ("NF_INET_POST_ROUTING Hook on node " << m_node->GetId ());
-                  Callback<uint32_t, Ptr<Packet> > ccb = MakeCallback (&Ipv4Netfilter::NetfilterConntrackConfirm, m_netfilter);
+                  ContinueCallback ccb = m_netfilterConfirm;
                   Verdicts_t verdict = (Verdicts_t) m_netfilter->ProcessHook (PF_INET, NF_INET_POST_ROUTING, packetCopy, 0, device, ccb);
                   if (verdict == NF_DROP)
                     {
@@ -1216,7 +1229,7 @@ no_encap:
                 {
                   NS_LOG_DEBUG ("NF_INET_POST_ROUTING Hook on node " << m_node->GetId ());
                   packetCopy->AddHeader (ipHeader);
-                  Callback<uint32_t, Ptr<Packet> > ccb = MakeCallback (&Ipv4Netfilter::NetfilterConntrackConfirm, m_netfilter);
+                  ContinueCallback ccb = m_netfilterConfirm;
                   Verdicts_t verdict = (Verdicts_t) m_netfilter->ProcessHook (PF_INET, NF_INET_POST_ROUTING, packetCopy, 0, device, ccb);
                   if (verdict == NF_DROP)
                     {
@@ -1400,7 +1413,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
 
       packetCopy->AddHeader (ipHeader);
       Ptr<NetDevice> device = route->GetOutputDevice ();
-      ContinueCallback ccb = MakeCallback (&Ipv4Netfilter::NetfilterConntrackConfirm, m_netfilter);
+      ContinueCallback ccb = m_netfilterConfirm;
       Verdicts_t verdict = (Verdicts_t) m_netfilter->ProcessHook (PF_INET, NF_INET_POST_ROUTING, packetCopy, 0, device, ccb);
       if (verdict == NF_DROP)
         {
@@ -1608,7 +1621,7 @@ Ipv4L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv4Header const&ip, uin
   if (m_netfilter != 0)
     {
       NS_LOG_DEBUG ("NF_INET_LOCAL_IN Hook on node " << m_node->GetId ());
-      Callback<uint32_t, Ptr<Packet> > ccb = MakeCallback (&Ipv4Netfilter::NetfilterConntrackConfirm, m_netfilter);
+      ContinueCallback ccb = m_netfilterConfirm;
       Verdicts_t verdict = (Verdicts_t) m_netfilter->ProcessHook (PF_INET, NF_INET_LOCAL_IN, pkt, 0, device, ccb);
       if (verdict == NF_DROP)
         {
@@ -492,6 +492,13 @@ private:
 
   Ptr<Ipv4RoutingProtocol> m_routingProtocol; //!< Routing protocol associated with the stack
   Ptr<Ipv4Netfilter> m_netfilter;
+  Callback<uint32_t, Ptr<Packet> > m_netfilterConfirm; //!< Netfilter conntrack confirmation callback
+
+  // Callbacks passed to RouteInput for every received packet, built once.
+  Ipv4RoutingProtocol::UnicastForwardCallback m_ucb; //!< Unicast forward callback
+  Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; //!< Multicast forward callback
+  Ipv4RoutingProtocol::LocalDeliverCallback m_lcb; //!< Local receive callback
+  Ipv4RoutingProtocol::ErrorCallback m_ecb; //!< Error callback
   SocketList m_sockets; //!< List of IPv4 raw sockets.
 
   /**
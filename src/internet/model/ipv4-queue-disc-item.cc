@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/hash.h"
 #include "ipv4-queue-disc-item.h"
 
 namespace ns3 {
@@ -109,4 +110,53 @@ Ipv4QueueDiscItem::GetUint8Value (QueueItem::Uint8Values field, uint8_t& value)
   return ret;
 }
 
+uint32_t
+Ipv4QueueDiscItem::DoHash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+
+  Ipv4Address src = m_header.GetSource ();
+  Ipv4Address dest = m_header.GetDestination ();
+  uint8_t prot = m_header.GetProtocol ();
+  uint16_t fragOffset = m_header.GetFragmentOffset ();
+
+  uint16_t srcPort = 0;
+  uint16_t destPort = 0;
+
+  if ((prot == 6 || prot == 17) && fragOffset == 0) // TCP or UDP
+    {
+      // both carry the ports in the first four bytes of their header
+      Ptr<Packet> pkt = GetPacket ();
+      uint32_t offset = m_headerAdded ? m_header.GetSerializedSize () : 0;
+      uint8_t data[64];
+      if (pkt->GetSize () >= offset + 4)
+        {
+          pkt->CopyData (data, offset + 4);
+          srcPort = (data[offset] << 8) | data[offset + 1];
+          destPort = (data[offset + 2] << 8) | data[offset + 3];
+        }
+    }
+
+  /* serialize the 5-tuple and the perturbation in buf */
+  uint8_t buf[17];
+  src.Serialize (buf);
+  dest.Serialize (buf + 4);
+  buf[8] = prot;
+  buf[9] = (srcPort >> 8) & 0xff;
+  buf[10] = srcPort & 0xff;
+  buf[11] = (destPort >> 8) & 0xff;
+  buf[12] = destPort & 0xff;
+  buf[13] = (perturbation >> 24) & 0xff;
+  buf[14] = (perturbation >> 16) & 0xff;
+  buf[15] = (perturbation >> 8) & 0xff;
+  buf[16] = perturbation & 0xff;
+
+  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
+  uint32_t hash = Hash32 ((char*) buf, 17);
+
+  NS_LOG_DEBUG ("Hash value of the five tuple " << hash);
+
+  return hash;
+}
+
 } // namespace ns3
@@ -103,6 +103,17 @@ private:
    */
   Ipv4QueueDiscItem &operator = (const Ipv4QueueDiscItem &);
 
+  /**
+   * \brief Computes the hash of the 5-tuple of the packet
+   *
+   * The ports of TCP and UDP packets are read from the first four bytes
+   * of the payload, without deserializing the transport header.
+   *
+   * \param perturbation the salt used as an additional input to the hash
+   * \return the murmur3 hash of the 5-tuple and of the perturbation
+   */
+  virtual uint32_t DoHash (uint32_t perturbation) const;
+
   Ipv4Header m_header;  //!< The IPv4 header.
   bool m_headerAdded;   //!< True if the header has already been added to the packet.
 };
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ipv4-route-trie.h"
+#include "ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RouteTrie");
+
+namespace {
+
+/**
+ * \brief Compare two routes by insertion rank.
+ * \param a the first route
+ * \param b the second route
+ * \return true if \p a was inserted before \p b
+ */
+bool
+CompareOrder (const Ipv4RouteTrie::Route &a, const Ipv4RouteTrie::Route &b)
+{
+  return a.order < b.order;
+}
+
+} // anonymous namespace
+
+Ipv4RouteTrie::Ipv4RouteTrie ()
+  : m_root (0),
+    m_order (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4RouteTrie::~Ipv4RouteTrie ()
+{
+  NS_LOG_FUNCTION (this);
+  Delete (m_root);
+}
+
+bool
+Ipv4RouteTrie::GetLength (Ipv4Mask mask, uint32_t &length)
+{
+  length = mask.GetPrefixLength ();
+  uint32_t expected = length == 0 ? 0 : 0xffffffff << (32 - length);
+  return mask.Get () == expected;
+}
+
+void
+Ipv4RouteTrie::Delete (Node *node)
+{
+  if (node != 0)
+    {
+      Delete (node->child[0]);
+      Delete (node->child[1]);
+      delete node;
+    }
+}
+
+void
+Ipv4RouteTrie::Insert (Ipv4RoutingTableEntry *entry, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << entry << metric);
+  Route route;
+  route.entry = entry;
+  route.metric = metric;
+  route.order = m_order++;
+
+  uint32_t length;
+  if (!GetLength (entry->GetDestNetworkMask (), length))
+    {
+      NS_LOG_LOGIC ("Non-contiguous mask " << entry->GetDestNetworkMask ());
+      m_others.push_back (route);
+      return;
+    }
+  uint32_t key = entry->GetDestNetwork ().Get ();
+  Node **node = &m_root;
+  for (uint32_t i = 0; ; i++)
+    {
+      if (*node == 0)
+        {
+          *node = new Node ();
+          (*node)->child[0] = 0;
+          (*node)->child[1] = 0;
+        }
+      if (i == length)
+        {
+          break;
+        }
+      node = &(*node)->child[(key >> (31 - i)) & 1];
+    }
+  (*node)->routes.push_back (route);
+}
+
+void
+Ipv4RouteTrie::Remove (Ipv4RoutingTableEntry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  uint32_t length;
+  std::vector<Route> *routes = &m_others;
+  Node **path[33];
+  uint32_t depth = 0;
+  if (GetLength (entry->GetDestNetworkMask (), length))
+    {
+      uint32_t key = entry->GetDestNetwork ().Get ();
+      path[0] = &m_root;
+      for (depth = 0; depth < length && *path[depth] != 0; depth++)
+        {
+          path[depth + 1] = &(*path[depth])->child[(key >> (31 - depth)) & 1];
+        }
+      NS_ASSERT_MSG (*path[depth] != 0, "Route " << entry << " not found");
+      routes = &(*path[depth])->routes;
+    }
+
+  std::vector<Route>::iterator i;
+  for (i = routes->begin (); i != routes->end () && i->entry != entry; i++)
+    {
+    }
+  NS_ASSERT_MSG (i != routes->end (), "Route " << entry << " not found");
+  routes->erase (i);
+
+  if (routes == &m_others)
+    {
+      return;
+    }
+  // Prune the nodes left without routes nor children.
+  for (uint32_t d = depth + 1; d-- > 0; )
+    {
+      Node *node = *path[d];
+      if (!node->routes.empty () || node->child[0] != 0 || node->child[1] != 0)
+        {
+          break;
+        }
+      delete node;
+      *path[d] = 0;
+    }
+}
+
+void
+Ipv4RouteTrie::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  Delete (m_root);
+  m_root = 0;
+  m_others.clear ();
+}
+
+void
+Ipv4RouteTrie::Lookup (Ipv4Address dest, std::vector<Route> &routes) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  routes.clear ();
+  uint32_t key = dest.Get ();
+  // The routes of each node are in insertion order already: the result
+  // only needs sorting when it merges the routes of several prefixes.
+  uint32_t sources = 0;
+  const Node *node = m_root;
+  for (uint32_t i = 0; node != 0; i++)
+    {
+      if (!node->routes.empty ())
+        {
+          routes.insert (routes.end (), node->routes.begin (), node->routes.end ());
+          sources++;
+        }
+      node = i < 32 ? node->child[(key >> (31 - i)) & 1] : 0;
+    }
+  for (std::vector<Route>::const_iterator i = m_others.begin (); i != m_others.end (); i++)
+    {
+      if (i->entry->GetDestNetworkMask ().IsMatch (dest, i->entry->GetDestNetwork ()))
+        {
+          routes.push_back (*i);
+          sources++;
+        }
+    }
+  if (sources > 1)
+    {
+      std::sort (routes.begin (), routes.end (), &CompareOrder);
+    }
+}
+
+} // namespace ns3
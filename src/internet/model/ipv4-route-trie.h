@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Prefix index over the unicast routes of a routing protocol.
+ *
+ * The routes are stored in a binary trie keyed by the bits of their
+ * destination prefix, so that all the routes matching a destination are
+ * found by walking at most 32 nodes, whatever the number of routes.
+ *
+ * Lookup() returns every matching route in insertion order: the routing
+ * protocols run their usual selection (longest prefix and metric,
+ * equal-cost candidate sets, ...) over these few candidates instead of
+ * their whole table, and therefore keep their exact semantics.
+ *
+ * Routes with a non-contiguous network mask, which cannot be stored in
+ * the trie, are kept aside and matched one by one.
+ *
+ * The index does not own the routing table entries.
+ */
+class Ipv4RouteTrie
+{
+public:
+  /** A route stored in the index. */
+  struct Route
+  {
+    Ipv4RoutingTableEntry *entry; //!< The routing table entry.
+    uint32_t metric;              //!< The metric of the route.
+    uint64_t order;               //!< Insertion rank of the route.
+  };
+
+  Ipv4RouteTrie ();
+  ~Ipv4RouteTrie ();
+
+  /**
+   * \brief Add a route to the index.
+   * \param entry the routing table entry
+   * \param metric the metric of the route
+   */
+  void Insert (Ipv4RoutingTableEntry *entry, uint32_t metric = 0);
+  /**
+   * \brief Remove a route from the index.
+   *
+   * The destination of \p entry must not have changed since Insert().
+   *
+   * \param entry the routing table entry
+   */
+  void Remove (Ipv4RoutingTableEntry *entry);
+  /**
+   * \brief Remove all the routes from the index.
+   */
+  void Clear (void);
+  /**
+   * \brief Find the routes matching a destination.
+   * \param dest the destination address
+   * \param routes filled with the matching routes, in insertion order
+   */
+  void Lookup (Ipv4Address dest, std::vector<Route> &routes) const;
+
+private:
+  /** A node of the trie. */
+  struct Node
+  {
+    Node *child[2];             //!< Children, for a next bit of 0 and 1.
+    std::vector<Route> routes;  //!< Routes to the prefix of the node.
+  };
+
+  /**
+   * \brief Copy constructor (disabled).
+   * \param o object to copy
+   */
+  Ipv4RouteTrie (const Ipv4RouteTrie &o);
+  /**
+   * \brief Assignment operator (disabled).
+   * \param o object to copy
+   * \returns the copied object
+   */
+  Ipv4RouteTrie &operator= (const Ipv4RouteTrie &o);
+
+  /**
+   * \brief Get the length of a mask if it is contiguous.
+   * \param mask the mask
+   * \param length set to the prefix length of \p mask
+   * \return true if \p mask only has leading ones
+   */
+  static bool GetLength (Ipv4Mask mask, uint32_t &length);
+  /**
+   * \brief Delete a node and its descendants.
+   * \param node the node
+   */
+  static void Delete (Node *node);
+
+  Node *m_root;                //!< Root node, for the /0 prefix.
+  std::vector<Route> m_others; //!< Routes with a non-contiguous mask.
+  uint64_t m_order;            //!< Rank of the next inserted route.
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
@@ -24,6 +24,7 @@
 
 #include <list>
 #include <utility>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -31,6 +32,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -418,6 +420,16 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the index of the forwarding table for network.
+   */
+  Ipv4RouteTrie m_networkRouteTrie;
+
+  /**
+   * \brief the routes found by LookupStatic.
+   */
+  std::vector<Ipv4RouteTrie::Route> m_matches;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -127,6 +127,10 @@ Ipv6L3Protocol::Ipv6L3Protocol ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_pmtuCache = CreateObject<Ipv6PmtuCache> ();
+  m_ucb = MakeCallback (&Ipv6L3Protocol::IpForward, this);
+  m_mcb = MakeCallback (&Ipv6L3Protocol::IpMulticastForward, this);
+  m_lcb = MakeCallback (&Ipv6L3Protocol::LocalDeliver, this);
+  m_ecb = MakeCallback (&Ipv6L3Protocol::RouteInputError, this);
 }
 
 Ipv6L3Protocol::~Ipv6L3Protocol ()
@@ -1079,11 +1083,7 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
         }
     }
 
-  if (!m_routingProtocol->RouteInput (packet, hdr, device,
-                                      MakeCallback (&Ipv6L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv6L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv6L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv6L3Protocol::RouteInputError, this)))
+  if (!m_routingProtocol->RouteInput (packet, hdr, device, m_ucb, m_mcb, m_lcb, m_ecb))
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
       // Drop trace and ICMPs are courtesy of RouteInputError
@@ -29,6 +29,7 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-pmtu-cache.h"
+#include "ns3/ipv6-routing-protocol.h"
 
 class Ipv6L3ProtocolTestCase;
 
@@ -726,6 +727,15 @@ private:
    */
   Ptr<Ipv6RoutingProtocol> m_routingProtocol;
 
+  /**
+   * \brief Callbacks passed to RouteInput for every received packet,
+   * built once.
+   */
+  Ipv6RoutingProtocol::UnicastForwardCallback m_ucb;
+  Ipv6RoutingProtocol::MulticastForwardCallback m_mcb; //!< Multicast forward callback
+  Ipv6RoutingProtocol::LocalDeliverCallback m_lcb; //!< Local receive callback
+  Ipv6RoutingProtocol::ErrorCallback m_ecb; //!< Error callback
+
   /**
    * \brief List of IPv6 raw sockets.
    */
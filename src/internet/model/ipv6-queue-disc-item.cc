@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/hash.h"
 #include "ipv6-queue-disc-item.h"
 
 namespace ns3 {
@@ -108,4 +109,52 @@ Ipv6QueueDiscItem::GetUint8Value (QueueItem::Uint8Values field, uint8_t& value)
   return ret;
 }
 
+uint32_t
+Ipv6QueueDiscItem::DoHash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+
+  Ipv6Address src = m_header.GetSourceAddress ();
+  Ipv6Address dest = m_header.GetDestinationAddress ();
+  uint8_t prot = m_header.GetNextHeader ();
+
+  uint16_t srcPort = 0;
+  uint16_t destPort = 0;
+
+  if (prot == 6 || prot == 17) // TCP or UDP
+    {
+      // both carry the ports in the first four bytes of their header
+      Ptr<Packet> pkt = GetPacket ();
+      uint32_t offset = m_headerAdded ? m_header.GetSerializedSize () : 0;
+      uint8_t data[44];
+      if (pkt->GetSize () >= offset + 4)
+        {
+          pkt->CopyData (data, offset + 4);
+          srcPort = (data[offset] << 8) | data[offset + 1];
+          destPort = (data[offset + 2] << 8) | data[offset + 3];
+        }
+    }
+
+  /* serialize the 5-tuple and the perturbation in buf */
+  uint8_t buf[41];
+  src.Serialize (buf);
+  dest.Serialize (buf + 16);
+  buf[32] = prot;
+  buf[33] = (srcPort >> 8) & 0xff;
+  buf[34] = srcPort & 0xff;
+  buf[35] = (destPort >> 8) & 0xff;
+  buf[36] = destPort & 0xff;
+  buf[37] = (perturbation >> 24) & 0xff;
+  buf[38] = (perturbation >> 16) & 0xff;
+  buf[39] = (perturbation >> 8) & 0xff;
+  buf[40] = perturbation & 0xff;
+
+  /* Linux calculates the jhash2 (jenkins hash), we calculate the murmur3 */
+  uint32_t hash = Hash32 ((char*) buf, 41);
+
+  NS_LOG_DEBUG ("Hash value of the five tuple " << hash);
+
+  return hash;
+}
+
 } // namespace ns3
@@ -44,6 +44,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv6.h"
 #include <climits>
+#include <algorithm>
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv6-routing-protocol.h"
 #include "ns3/ipv4-route.h"
@@ -61,6 +62,7 @@ NS_LOG_COMPONENT_DEFINE ("LispEtrItrApplication");
 NS_OBJECT_ENSURE_REGISTERED (LispEtrItrApplication);
 
 const uint8_t LispEtrItrApplication::MAX_REQUEST_NB = 3;
+const uint8_t LispEtrItrApplication::MAX_RECORDS_PER_MSG = 0xff;
 
 TypeId LispEtrItrApplication::GetTypeId (void)
 {
@@ -97,6 +99,38 @@ TypeId LispEtrItrApplication::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&LispEtrItrApplication::m_enableSubscribe),
                    MakeBooleanChecker ())
+    .AddAttribute ("MapRegisterRefresh",
+                   "The period at which the xTR refreshes its registration. Zero means the database is registered only once.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LispEtrItrApplication::m_registerRefresh),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("MapRegisterTtl",
+                   "The Record TTL of the registered mappings, in minutes: the map server removes "
+                   "a registration which is not refreshed within this time. "
+                   "The default (0xffffffff) registrations never expire.",
+                   UintegerValue (MapReplyRecord::m_defaultRecordTtl),
+                   MakeUintegerAccessor (&LispEtrItrApplication::m_registerTtl),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("EnableRlocProbing",
+                   "If the ITR should periodically probe the RLOCs of its map-cache.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LispEtrItrApplication::m_rlocProbing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RlocProbeInterval",
+                   "The time between two RLOC-probing rounds. A probe not answered before the next round is lost.",
+                   TimeValue (Seconds (10.0)),
+                   MakeTimeAccessor (&LispEtrItrApplication::m_rlocProbeInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("RlocProbeBudget",
+                   "The maximum number of RLOCs probed during one round.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&LispEtrItrApplication::m_rlocProbeBudget),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RlocProbeMaxMissed",
+                   "The number of consecutive lost probes after which an RLOC is considered down.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&LispEtrItrApplication::m_rlocProbeMaxMissed),
+                   MakeUintegerChecker<uint8_t> (1))
     .AddTraceSource ("MapRegisterTx", "A MapRegister is sent by the LISP device",
                      MakeTraceSourceAccessor (&LispEtrItrApplication::m_mapRegisterTxTrace),
                      "ns3::Packet::TracedCallback")
@@ -105,7 +139,10 @@ TypeId LispEtrItrApplication::GetTypeId (void)
                      "ns3::Packet::TracedCallback")
     .AddTraceSource ("MappingUpdateTrace", "A MapReply is sent down to the data plane.",
                      MakeTraceSourceAccessor (&LispEtrItrApplication::m_mappingUpdateTrace),
-                     "ns3::Packet::TracedCallback");
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("RlocStateChange", "RLOC-probing changed the reachability of a remote RLOC.",
+                     MakeTraceSourceAccessor (&LispEtrItrApplication::m_rlocStateTrace),
+                     "ns3::LispEtrItrApplication::RlocStateTracedCallback");
   return tid;
 }
 
@@ -122,6 +159,8 @@ LispEtrItrApplication::LispEtrItrApplication ()
   m_requestSent = 0;
   m_lispProtoAddress = Address ();      // invalid address
   m_recvIvkSmr = false;
+  m_registerWithRtr = false;
+  m_rlocProbeRound = 0;
 }
 
 LispEtrItrApplication::~LispEtrItrApplication ()
@@ -148,6 +187,11 @@ void LispEtrItrApplication::AddMapResolverLoc (Ptr<Locator> locator)
 
 void LispEtrItrApplication::DoDispose (void)
 {
+  if (m_registerScheduler)
+    {
+      m_registerScheduler->Remove (this);
+      m_registerScheduler = 0;
+    }
   Application::DoDispose ();
 }
 
@@ -174,6 +218,8 @@ void LispEtrItrApplication::StartApplication (void)
     }
   m_lispMappingSocket->SetRecvCallback (
     MakeCallback (&LispEtrItrApplication::HandleMapSockRead, this));
+  DynamicCast<LispMappingSocket> (m_lispMappingSocket)->SetRecvMsgCallback (
+    MakeCallback (&LispEtrItrApplication::HandleMapSockMsg, this));
 
   /* --- Socket for communication with MS --- */
   // Yue: Useful to send MapRegister message...
@@ -242,6 +288,10 @@ void LispEtrItrApplication::StartApplication (void)
     MakeCallback (&LispEtrItrApplication::HandleReadControlMsg, this));
 
   ScheduleTransmit (Seconds (0.));
+  if (m_rlocProbing)
+    {
+      m_rlocProbeEvent = Simulator::Schedule (m_rlocProbeInterval, &LispEtrItrApplication::SendRlocProbes, this);
+    }
   NS_LOG_DEBUG ("Lisp xTR Application Starts");
 }
 
@@ -254,6 +304,8 @@ void LispEtrItrApplication::StopApplication (void)
       m_lispMappingSocket->Close ();
       m_lispMappingSocket->SetRecvCallback (
         MakeNullCallback<void, Ptr<Socket> >());
+      DynamicCast<LispMappingSocket> (m_lispMappingSocket)->SetRecvMsgCallback (
+        MakeNullCallback<void, Ptr<LispMappingSocket>, const MappingSocketMsgHeader &, Ptr<MappingSocketMsg> >());
       m_lispMappingSocket = 0;
     }
 
@@ -281,6 +333,11 @@ void LispEtrItrApplication::StopApplication (void)
     }
 
   Simulator::Cancel (m_event);
+  Simulator::Cancel (m_rlocProbeEvent);
+  if (m_registerScheduler)
+    {
+      m_registerScheduler->Remove (this);
+    }
 }
 
 void LispEtrItrApplication::ScheduleTransmit (Time dt)
@@ -336,6 +393,7 @@ void LispEtrItrApplication::SendMapRegisters (bool rtr)
     }
   m_mapTablesV4->GetMapEntryList (MapTables::IN_DATABASE, mapEntries);
   m_mapTablesV6->GetMapEntryList (MapTables::IN_DATABASE, mapEntries);
+  Ptr<MapRegisterMsg> msg;
   // Iterate mapEntries to construct Map-Register message.
   for (std::list<Ptr<MapEntry> >::const_iterator it = mapEntries.begin ();
        it != mapEntries.end (); ++it)
@@ -361,44 +419,90 @@ void LispEtrItrApplication::SendMapRegisters (bool rtr)
         }
 
 
-      Ptr<MapRegisterMsg> msg = LispEtrItrApplication::GenerateMapRegister (
-        *it, rtr);
-      /**
-         * Calculating the bytes held by Map-Register Message...
-         * BUF_SIZE = 16+AuthDataLen+16+12*LocatorCount
-         */
-      uint8_t BUF_SIZE = 16 + msg->GetAuthDataLen () + 16
-        + 12 * msg->GetRecord ()->GetLocatorCount ();
-      uint8_t buf[BUF_SIZE];
-      //std::memset(buf, 0, sizeof(buf));
-      msg->Serialize (buf);
-      Ptr<Packet> p = Create<Packet> (buf, BUF_SIZE);
-
-      /* --- Tracing --- */
-      m_mapRegisterTxTrace (p);
-
-      Simulator::Schedule (Seconds (m_xtrToMapServerDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
-                           this, m_mapServerAddress.front (), LispOverIp::LISP_SIG_PORT, p);
-      NS_LOG_DEBUG (
-        "Map-Register message sent to " << Ipv4Address::ConvertFrom (m_mapServerAddress.front ()));
+      // All the prefixes of the database are registered with as few
+      // Map-Register messages as the 8-bit Record Count field allows.
+      if (msg == 0)
+        {
+          msg = LispEtrItrApplication::GenerateMapRegister (*it, rtr);
+        }
+      else
+        {
+          msg->AddRecord (GenerateMapRegisterRecord (*it, rtr));
+        }
+      if (msg->GetRecordCount () == MAX_RECORDS_PER_MSG)
+        {
+          SendMapRegister (msg);
+          msg = 0;
+        }
+    }
+  if (msg != 0)
+    {
+      SendMapRegister (msg);
     }
 
   ++m_sent;
 
+  m_registerWithRtr = rtr;
+  if (!m_registerRefresh.IsZero ())
+    {
+      if (m_registerScheduler == 0)
+        {
+          m_registerScheduler = CreateObject<MapRegisterScheduler> ();
+        }
+      m_registerScheduler->Schedule (this, m_registerRefresh);
+    }
+
   /*if (m_sent < m_count)
    {
    ScheduleTransmit (m_interval);
    }*/
 }
 
-void LispEtrItrApplication::SendToLisp (Ptr<Packet> packet)
+void LispEtrItrApplication::RefreshMapRegisters (void)
 {
   NS_LOG_FUNCTION (this);
-  m_mappingUpdateTrace (packet);
-  m_lispMappingSocket->Send (packet);
+  SendMapRegisters (m_registerWithRtr);
+}
+
+void LispEtrItrApplication::SetMapRegisterScheduler (Ptr<MapRegisterScheduler> scheduler)
+{
+  m_registerScheduler = scheduler;
+}
+
+void LispEtrItrApplication::SendMapRegister (Ptr<MapRegisterMsg> msg)
+{
+  NS_LOG_FUNCTION (this << unsigned (msg->GetRecordCount ()));
+  uint32_t bufSize = msg->GetSizeInBytes ();
+  uint8_t buf[bufSize];
+  msg->Serialize (buf);
+  Ptr<Packet> p = Create<Packet> (buf, bufSize);
+
+  /* --- Tracing --- */
+  m_mapRegisterTxTrace (p);
+
+  Simulator::Schedule (Seconds (m_xtrToMapServerDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
+                       this, m_mapServerAddress.front (), LispOverIp::LISP_SIG_PORT, p);
+  NS_LOG_DEBUG (
+    "Map-Register message with " << unsigned (msg->GetRecordCount ()) << " record(s) sent to " << Ipv4Address::ConvertFrom (m_mapServerAddress.front ()));
+}
+
+void LispEtrItrApplication::SendToLisp (const MappingSocketMsgHeader &mapSockHeader,
+                                        Ptr<MappingSocketMsg> mapSockMsg)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_mappingUpdateTrace.IsEmpty ())
+    {
+      // Only build the packet if somebody listens to the trace.
+      uint8_t buf[256];
+      mapSockMsg->Serialize (buf);
+      Ptr<Packet> packet = Create<Packet> (buf, 256);
+      packet->AddHeader (mapSockHeader);
+      m_mappingUpdateTrace (packet);
+    }
+  DynamicCast<LispMappingSocket> (m_lispMappingSocket)->SendMsg (mapSockHeader, mapSockMsg);
 
   NS_LOG_DEBUG (
-    "LispEtrItrApplication sent a packet to lispOverIp by lispMappingSocket! \nThe packet is: " << *packet);
+    "LispEtrItrApplication sent a message to lispOverIp by lispMappingSocket! \nThe message header is: " << mapSockHeader);
 }
 
 void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
@@ -454,7 +558,6 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
 
               if (!lisp->IsNated ())
                 {
-                  uint8_t newBuf[256];
                   Ptr<MapReplyMsg> mapReply = LispEtrItrApplication::GenerateMapReply (requestMsg);
                   /**
                  * Update, 02-02-2018, Yue
@@ -463,8 +566,10 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
                  */
                   if (mapReply != 0)
                     {
+                      uint32_t bufSize = mapReply->GetSizeInBytes ();
+                      uint8_t newBuf[bufSize];
                       mapReply->Serialize (newBuf);
-                      reactedPacket = Create<Packet> (newBuf, 256);
+                      reactedPacket = Create<Packet> (newBuf, bufSize);
 
                       Simulator::Schedule (Seconds (m_xtrToXtrDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
                                            this, destination, m_peerPort, reactedPacket);
@@ -542,18 +647,14 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
               m_recvIvkSmr = true;
               // Given reception of SMR-invoked map request, remove the scheduled event.
               Simulator::Remove (m_resendSmrEvent);
-              uint8_t newBuf[256];
-
               // Instead of response the queried EID-prefix, maReply conveys the content of database!
-              // Ptr<MapReplyMsg> mapReply = LispEtrItrApplication::GenerateMapReply4ChangedMapping(requestMsg);
-              /* Emeline: this code doesn't work because MapRequest/Reply can only carry one
-                 * Mapping Record (due to implementation).
-                 * Therefore: just answer with a normal MapReply */
-              Ptr<MapReplyMsg> mapReply = LispEtrItrApplication::GenerateMapReply (requestMsg);
+              Ptr<MapReplyMsg> mapReply = LispEtrItrApplication::GenerateMapReply4ChangedMapping (requestMsg);
               if (mapReply != 0)
                 {
+                  uint32_t bufSize = mapReply->GetSizeInBytes ();
+                  uint8_t newBuf[bufSize];
                   mapReply->Serialize (newBuf);
-                  reactedPacket = Create<Packet> (newBuf, 256);
+                  reactedPacket = Create<Packet> (newBuf, bufSize);
 
                   /* --- Artificial delay for SMR procedure --- */
                   Simulator::Schedule (Seconds (m_xtrToXtrDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
@@ -583,34 +684,39 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
           NS_LOG_DEBUG (
             "Msg Type " << unsigned (msg_type) << ": GET a MAP REPLY");
           // Get Map Reply
-          Ptr<MapReplyMsg> replyMsg = MapReplyMsg::Deserialize (buf);
-
-          // prepare mapping socket message body+header
-          Ptr<MappingSocketMsg> mapSockMsg = GenerateMapSocketAddMsgBody (
-            replyMsg);
-          MappingSocketMsgHeader mapSockHeader =
-            GenerateMapSocketAddMsgHeader (replyMsg);
-          NS_LOG_DEBUG ("Mapping socket message created");
-          NS_ASSERT_MSG (mapSockMsg != 0,
-                         "Cannot create map socket message body !!! Please check why.");
-          uint8_t buf[256];
-          mapSockMsg->Serialize (buf);
-          /**
-         * In my opinion, it is not necessary to create a packet with 256 bytes as payload.
-         * In fact, we just need to ensure that length of buffer is more than the length of mapSockMsg.
-         * Since this is just an exchange between LispOverIp(data plan) and LispEtrItrApplication(control plan)
-         * Both data plan and control plan are on the same node.
-         * It is like a socket communication between user and kernel space.
-         */
-          Ptr<Packet> packet = Create<Packet> (buf, 256);
-          packet->AddHeader (mapSockHeader);
-          // Send to lispOverIp object so that it can insert the mapping entry in Cache.
-          // ATTENTION: with SMR, before inserting one map entry, should first check its presence in Cache.
-          // Now we apply a replacement strategy: if the EID-prefix already in Cache, replace it with the new
-          // One.
-          SendToLisp (packet);
-          // Don't forget to remove Eid in pending list...
-          DeleteFromMapReqList (mapSockMsg->GetEndPointId ());
+          Ptr<MapReplyMsg> replyMsg = MapReplyMsg::Deserialize (buf, packet->GetSize ());
+          if (replyMsg == 0)
+            {
+              NS_LOG_WARN ("Truncated Map-Reply, drop it");
+              continue;
+            }
+          if (replyMsg->GetP ())
+            {
+              // Answer to an RLOC-probe: the map-cache is not updated.
+              HandleRlocProbeReply (replyMsg);
+              continue;
+            }
+
+          // Every record of the Map-Reply is a distinct mapping to insert
+          const std::vector<Ptr<MapReplyRecord> > &records = replyMsg->GetRecords ();
+          for (std::vector<Ptr<MapReplyRecord> >::const_iterator rec = records.begin ();
+               rec != records.end (); ++rec)
+            {
+              // prepare mapping socket message body+header
+              Ptr<MappingSocketMsg> mapSockMsg = GenerateMapSocketAddMsgBody (*rec);
+              MappingSocketMsgHeader mapSockHeader =
+                GenerateMapSocketAddMsgHeader (*rec);
+              NS_LOG_DEBUG ("Mapping socket message created");
+              NS_ASSERT_MSG (mapSockMsg != 0,
+                             "Cannot create map socket message body !!! Please check why.");
+              // Send to lispOverIp object so that it can insert the mapping entry in Cache.
+              // ATTENTION: with SMR, before inserting one map entry, should first check its presence in Cache.
+              // Now we apply a replacement strategy: if the EID-prefix already in Cache, replace it with the new
+              // One.
+              SendToLisp (mapSockHeader, mapSockMsg);
+              // Don't forget to remove Eid in pending list...
+              DeleteFromMapReqList (mapSockMsg->GetEndPointId ());
+            }
           /**
          * After reception of map reply and insertion of received EID-RLOC mapping into cache,
          * remember to check if the map request messages with received EID are present in m_mapReqMsg. If yes,
@@ -642,25 +748,55 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
           /* --- Tracing --- */
           m_mapNotifyRxTrace (packet);
 
-          Ptr<MapNotifyMsg> notifyMsg = MapNotifyMsg::Deserialize (buf);
-          Ptr<MapReplyRecord> record = notifyMsg->GetRecord ();
-
-          // Check if the EID is local.
-          Ptr<MapEntry> mapEntry;
-          if (Ipv4Address::IsMatchingType (record->GetEidPrefix ()))
+          Ptr<MapNotifyMsg> notifyMsg = MapNotifyMsg::Deserialize (buf, packet->GetSize ());
+          if (notifyMsg == 0)
             {
-              mapEntry = m_mapTablesV4->DatabaseLookup (record->GetEidPrefix ());
+              NS_LOG_WARN ("Truncated Map-Notify, drop it");
+              continue;
             }
-          else if (Ipv6Address::IsMatchingType (record->GetEidPrefix ()))
+          bool registered = false;
+          const std::vector<Ptr<MapReplyRecord> > &records = notifyMsg->GetRecords ();
+          for (std::vector<Ptr<MapReplyRecord> >::const_iterator rec = records.begin ();
+               rec != records.end (); ++rec)
             {
-              mapEntry = m_mapTablesV4->DatabaseLookup (record->GetEidPrefix ());
-            }
-          else
-            {
-              NS_LOG_ERROR ("EID prefix neither IPV4 or IPV6.");
+              Ptr<MapReplyRecord> record = *rec;
+              // Check if the EID is local.
+              Ptr<MapEntry> mapEntry;
+              if (Ipv4Address::IsMatchingType (record->GetEidPrefix ()))
+                {
+                  mapEntry = m_mapTablesV4->DatabaseLookup (record->GetEidPrefix ());
+                }
+              else if (Ipv6Address::IsMatchingType (record->GetEidPrefix ()))
+                {
+                  mapEntry = m_mapTablesV4->DatabaseLookup (record->GetEidPrefix ());
+                }
+              else
+                {
+                  NS_LOG_ERROR ("EID prefix neither IPV4 or IPV6.");
+                }
+
+              if (mapEntry != 0)
+                {
+                  // Acknowledgement of our own registration: handled once for
+                  // the whole message below.
+                  registered = true;
+                }
+              else
+                {
+                  NS_LOG_LOGIC ("MapNotify EID not local.");
+                  // prepare mapping socket message body+header
+                  Ptr<MappingSocketMsg> mapSockMsg = GenerateMapSocketAddMsgBody (record);
+                  MappingSocketMsgHeader mapSockHeader = GenerateMapSocketAddMsgHeader (record);
+                  NS_LOG_DEBUG ("Mapping socket message created");
+                  NS_ASSERT_MSG (mapSockMsg != 0,
+                                 "Cannot create map socket message body !!! Please check why.");
+                  SendToLisp (mapSockHeader, mapSockMsg);
+
+                  // TODO Send map-notify-ack.
+                }
             }
 
-          if (mapEntry != 0)
+          if (registered)
             {
               /* --- Notifies DataPlane that LISP device is registered (allowed to send data packets)--- */
               Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg>();
@@ -676,11 +812,7 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
               //MAPA_EID used to say that LISP device is registered.
               //MAPA_EIDMASK is used to say that LISP device is NOT registered.
 
-              uint8_t buf[256];
-              mapSockMsg->Serialize (buf);
-              Ptr<Packet> packet = Create<Packet> (buf, 256);
-              packet->AddHeader (mapSockHeader);
-              SendToLisp (packet);
+              SendToLisp (mapSockHeader, mapSockMsg);
 
 
               /* The SMR procedure is now implemented on the RemoteItr Cache, instead of on the LISP Cache */
@@ -699,27 +831,6 @@ void LispEtrItrApplication::HandleReadControlMsg (Ptr<Socket> socket)
                   m_recvIvkSmr = false;
                 }
             }
-          else
-            {
-              NS_LOG_LOGIC ("MapNotify EID not local.");
-              Ptr<MapReplyMsg> replyToDataPlane = Create<MapReplyMsg>();
-              replyToDataPlane->SetRecordCount (notifyMsg->GetRecordCount ());
-              replyToDataPlane->SetRecord (notifyMsg->GetRecord ());
-
-              // prepare mapping socket message body+header
-              Ptr<MappingSocketMsg> mapSockMsg = GenerateMapSocketAddMsgBody (replyToDataPlane);
-              MappingSocketMsgHeader mapSockHeader = GenerateMapSocketAddMsgHeader (replyToDataPlane);
-              NS_LOG_DEBUG ("Mapping socket message created");
-              NS_ASSERT_MSG (mapSockMsg != 0,
-                             "Cannot create map socket message body !!! Please check why.");
-              uint8_t buf[256];
-              mapSockMsg->Serialize (buf);
-              Ptr<Packet> packet = Create<Packet> (buf, 256);
-              packet->AddHeader (mapSockHeader);
-              SendToLisp (packet);
-
-              // TODO Send map-notify-ack.
-            }
         }
       else
         {
@@ -751,9 +862,10 @@ void LispEtrItrApplication::SendSmrMsg ()
         LispEtrItrApplication::GenerateMapRequest (GetLispMnEid ());
       //IMPORTANT: set SMR bit!!!
       mapReqMsg->SetS (1);
-      uint8_t bufMapReq[64];
+      uint32_t bufSize = mapReqMsg->GetSizeInBytes ();
+      uint8_t bufMapReq[bufSize];
       mapReqMsg->Serialize (bufMapReq);
-      Ptr<Packet> packetSmrMsg = Create<Packet> (bufMapReq, 64);
+      Ptr<Packet> packetSmrMsg = Create<Packet> (bufMapReq, bufSize);
       Simulator::Schedule (Seconds (m_xtrToXtrDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
                            this, dstRlocAddr, m_peerPort, packetSmrMsg);
       NS_LOG_DEBUG ("A SMR message has been sent to PITR " << dstRlocAddr);
@@ -785,10 +897,11 @@ void LispEtrItrApplication::SendSmrMsgForEID (Ptr<EndpointId> eid)
         LispEtrItrApplication::GenerateMapRequest (eid);
       //IMPORTANT: set SMR bit!!!
       mapReqMsg->SetS (1);
-      uint8_t bufMapReq[64];
+      uint32_t bufSize = mapReqMsg->GetSizeInBytes ();
+      uint8_t bufMapReq[bufSize];
       mapReqMsg->Serialize (bufMapReq);
       Ptr<Packet> packetSmrMsg;
-      packetSmrMsg = Create<Packet> (bufMapReq, 64);
+      packetSmrMsg = Create<Packet> (bufMapReq, bufSize);
 
       Simulator::Schedule (Seconds (m_xtrToXtrDelayVariable->GetValue ()), &LispEtrItrApplication::SendTo,
                            this, dstRlocAddr, LispOverIp::LISP_SIG_PORT, packetSmrMsg);
@@ -800,7 +913,6 @@ void LispEtrItrApplication::SendInvokedSmrMsg (Ptr<MapRequestMsg> smr)
 {
   Ptr<Packet> reactedPacket;
 
-  uint8_t newBuf[256];
   //TODO: verify if we can directly copy map request message as SMR-invoked map request
   // We just need to change SMR-invoked bit as 1 and change the source ITR's address
   //TODO: now I'm lost about defintion of m_mapResolverRlocs...
@@ -818,8 +930,10 @@ void LispEtrItrApplication::SendInvokedSmrMsg (Ptr<MapRequestMsg> smr)
       smr->SetItrRlocAddrIpv6 (itrAddress);
     }
   // TODO:Actually, we also choose a new nonce number. (RFC6830)
+  uint32_t bufSize = smr->GetSizeInBytes ();
+  uint8_t newBuf[bufSize];
   smr->Serialize (newBuf);
-  reactedPacket = Create<Packet> (newBuf, 256);
+  reactedPacket = Create<Packet> (newBuf, bufSize);
   // IMPORTANT: set invoked-SMR bit as 1.
   // TODO: Question: what about bit S? 1 or 0 ? or whatever?
 
@@ -841,14 +955,188 @@ void LispEtrItrApplication::SendInvokedSmrMsg (Ptr<MapRequestMsg> smr)
 
 void LispEtrItrApplication::SendMapRequest (Ptr<MapRequestMsg> mapReqMsg)
 {
-  //TODO: whehter here 64 bytes here is good...
-  uint8_t bufMapReq[64];
+  uint32_t bufSize = mapReqMsg->GetSizeInBytes ();
+  uint8_t bufMapReq[bufSize];
   mapReqMsg->Serialize (bufMapReq);
   Ptr<Packet> packetMapReqMsg;
-  packetMapReqMsg = Create<Packet> (bufMapReq, 64);
+  packetMapReqMsg = Create<Packet> (bufMapReq, bufSize);
   this->SendTo (m_mapResolverRlocs.front ()->GetRlocAddress (), LispOverIp::LISP_SIG_PORT, packetMapReqMsg);
 }
 
+void LispEtrItrApplication::SendRlocProbes (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rlocProbeRound++;
+
+  // Refresh the probe table from the map-cache. RLOCs already known keep
+  // their state, which is also applied to entries added since last round.
+  std::list<Ptr<MapEntry> > mapEntries;
+  m_mapTablesV4->GetMapEntryList (MapTables::IN_CACHE, mapEntries);
+  m_mapTablesV6->GetMapEntryList (MapTables::IN_CACHE, mapEntries);
+  for (std::list<Ptr<MapEntry> >::const_iterator it = mapEntries.begin ();
+       it != mapEntries.end (); ++it)
+    {
+      Ptr<Locators> locators = (*it)->GetLocators ();
+      if ((*it)->IsNegative () || locators == 0)
+        {
+          continue;
+        }
+      for (int i = 0; i < locators->GetNLocators (); i++)
+        {
+          Ptr<Locator> locator = locators->GetLocatorByIdx (i);
+          Ptr<RlocMetrics> metrics = locator->GetRlocMetrics ();
+          if (metrics->IsLocalInterface ())
+            {
+              // E.g. the RTR entry installed when behind a NAT: not an ETR.
+              continue;
+            }
+          RlocProbeTable_t::iterator state = m_rlocProbeTable.find (locator->GetRlocAddress ());
+          if (state == m_rlocProbeTable.end ())
+            {
+              RlocProbeState newState;
+              newState.m_eid = (*it)->GetEidPrefix ();
+              newState.m_nonce = 0;
+              newState.m_round = m_rlocProbeRound;
+              newState.m_missed = 0;
+              newState.m_up = metrics->IsUp ();
+              m_rlocProbeTable.insert (std::make_pair (locator->GetRlocAddress (), newState));
+            }
+          else
+            {
+              state->second.m_round = m_rlocProbeRound;
+              metrics->SetUp (state->second.m_up);
+            }
+        }
+    }
+
+  // Forget RLOCs no longer in the map-cache and age outstanding probes.
+  for (RlocProbeTable_t::iterator it = m_rlocProbeTable.begin (); it != m_rlocProbeTable.end (); )
+    {
+      RlocProbeState &state = it->second;
+      if (state.m_nonce != 0)
+        {
+          m_rlocProbeNonces.erase (state.m_nonce);
+          state.m_nonce = 0;
+          if (state.m_missed < UINT8_MAX)
+            {
+              state.m_missed++;
+            }
+          if (state.m_up && state.m_missed >= m_rlocProbeMaxMissed && state.m_round == m_rlocProbeRound)
+            {
+              SetRlocState (it->first, false);
+            }
+        }
+      if (state.m_round != m_rlocProbeRound)
+        {
+          m_rlocProbeTable.erase (it++);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+
+  // Send the batch, resuming after the last RLOC probed.
+  uint32_t nProbes = std::min<uint32_t> (m_rlocProbeBudget, m_rlocProbeTable.size ());
+  RlocProbeTable_t::iterator it = m_rlocProbeTable.upper_bound (m_rlocProbeCursor);
+  for (uint32_t i = 0; i < nProbes; i++, ++it)
+    {
+      if (it == m_rlocProbeTable.end ())
+        {
+          it = m_rlocProbeTable.begin ();
+        }
+      Ptr<MapRequestMsg> probe = GenerateMapRequest (it->second.m_eid);
+      probe->SetP (1);
+      uint32_t bufSize = probe->GetSizeInBytes ();
+      uint8_t bufMapReq[bufSize];
+      probe->Serialize (bufMapReq);
+      SendTo (it->first, LispOverIp::LISP_SIG_PORT, Create<Packet> (bufMapReq, bufSize));
+
+      it->second.m_nonce = probe->GetNonce ();
+      it->second.m_sent = Simulator::Now ();
+      m_rlocProbeNonces[probe->GetNonce ()] = it->first;
+      m_rlocProbeCursor = it->first;
+    }
+  NS_LOG_DEBUG ("RLOC-probing round " << m_rlocProbeRound << ": " << nProbes << " probes sent, "
+                                      << m_rlocProbeTable.size () << " RLOCs tracked");
+
+  m_rlocProbeEvent = Simulator::Schedule (m_rlocProbeInterval, &LispEtrItrApplication::SendRlocProbes, this);
+}
+
+void LispEtrItrApplication::HandleRlocProbeReply (Ptr<MapReplyMsg> replyMsg)
+{
+  NS_LOG_FUNCTION (this);
+  std::map<uint64_t, Address>::iterator nonce = m_rlocProbeNonces.find (replyMsg->GetNonce ());
+  if (nonce == m_rlocProbeNonces.end ())
+    {
+      NS_LOG_DEBUG ("RLOC-probe reply with unknown nonce " << replyMsg->GetNonce () << ". Ignore it.");
+      return;
+    }
+  RlocProbeTable_t::iterator it = m_rlocProbeTable.find (nonce->second);
+  m_rlocProbeNonces.erase (nonce);
+  if (it == m_rlocProbeTable.end ())
+    {
+      return;
+    }
+
+  RlocProbeState &state = it->second;
+  Time sample = Simulator::Now () - state.m_sent;
+  if (state.m_rtt.IsZero ())
+    {
+      state.m_rtt = sample;
+    }
+  else
+    {
+      state.m_rtt = TimeStep ((7 * state.m_rtt.GetTimeStep () + sample.GetTimeStep ()) / 8);
+    }
+  state.m_nonce = 0;
+  state.m_missed = 0;
+  NS_LOG_DEBUG ("RLOC-probe reply from " << it->first << ", RTT " << sample.GetSeconds () << "s");
+  if (!state.m_up)
+    {
+      SetRlocState (it->first, true);
+    }
+}
+
+void LispEtrItrApplication::SetRlocState (const Address &rloc, bool up)
+{
+  NS_LOG_FUNCTION (this << rloc << up);
+  RlocProbeTable_t::iterator it = m_rlocProbeTable.find (rloc);
+  if (it != m_rlocProbeTable.end ())
+    {
+      it->second.m_up = up;
+    }
+
+  std::list<Ptr<MapEntry> > mapEntries;
+  m_mapTablesV4->GetMapEntryList (MapTables::IN_CACHE, mapEntries);
+  m_mapTablesV6->GetMapEntryList (MapTables::IN_CACHE, mapEntries);
+  for (std::list<Ptr<MapEntry> >::const_iterator entry = mapEntries.begin ();
+       entry != mapEntries.end (); ++entry)
+    {
+      if ((*entry)->GetLocators () == 0)
+        {
+          continue;
+        }
+      Ptr<Locator> locator = (*entry)->GetLocators ()->FindLocator (rloc);
+      if (locator != 0)
+        {
+          locator->GetRlocMetrics ()->SetUp (up);
+        }
+    }
+  NS_LOG_INFO ("RLOC " << rloc << " is now " << (up ? "up" : "down"));
+  m_rlocStateTrace (rloc, up);
+}
+
+Time LispEtrItrApplication::GetRlocProbeRtt (const Address &rloc) const
+{
+  RlocProbeTable_t::const_iterator it = m_rlocProbeTable.find (rloc);
+  if (it == m_rlocProbeTable.end ())
+    {
+      return Time (0);
+    }
+  return it->second.m_rtt;
+}
+
 void LispEtrItrApplication::HandleMapSockRead (Ptr<Socket> lispMappingSocket)
 {
   NS_LOG_FUNCTION (this);
@@ -864,87 +1152,91 @@ void LispEtrItrApplication::HandleMapSockRead (Ptr<Socket> lispMappingSocket)
       uint8_t buf[packet->GetSize ()];
       packet->CopyData (buf, packet->GetSize ());
       Ptr<MappingSocketMsg> msg = MappingSocketMsg::Deserialize (buf);
-      //Show LISP control plan message header
-      NS_LOG_DEBUG ("MSG HEADER: " << sockMsgHdr);
-      if (sockMsgHdr.GetMapType ()
-          == static_cast<uint16_t> (LispMappingSocket::MAPM_MISS))
+      HandleMapSockMsg (DynamicCast<LispMappingSocket> (lispMappingSocket), sockMsgHdr, msg);
+    }
+}
+
+void LispEtrItrApplication::HandleMapSockMsg (Ptr<LispMappingSocket> lispMappingSocket,
+                                              const MappingSocketMsgHeader &sockMsgHdr,
+                                              Ptr<MappingSocketMsg> msg)
+{
+  NS_LOG_FUNCTION (this);
+  //Show LISP control plan message header
+  NS_LOG_DEBUG ("MSG HEADER: " << sockMsgHdr);
+  if (sockMsgHdr.GetMapType ()
+      == static_cast<uint16_t> (LispMappingSocket::MAPM_MISS))
+    {
+      // Means that: in kernel space, CacheLookup has been tried, but find nothing... => MAPM_MISS
+      // To support LISP-MN, we allows map request for each EID can be up to 3 times
+      Ptr<EndpointId> eid = msg->GetEndPointId ();
+      NS_LOG_DEBUG ("Received miss for " << eid->Print ());
+      uint8_t currRqstNb = 0;
+      if (IsInRequestList (eid))
+        {
+          currRqstNb = GetRequestCount (eid);
+        }
+      if (not IsInRequestList (eid)
+          or currRqstNb < LispEtrItrApplication::MAX_REQUEST_NB)
         {
-          // Means that: in kernel space, CacheLookup has been tried, but find nothing... => MAPM_MISS
-          // To support LISP-MN, we allows map request for each EID can be up to 3 times
-          Ptr<EndpointId> eid = msg->GetEndPointId ();
-          NS_LOG_DEBUG ("Received miss for " << eid->Print ());
-          uint8_t currRqstNb = 0;
-          if (IsInRequestList (eid))
+          NS_LOG_DEBUG (
+            "Remote EID" << eid->Print () << " has been requested " << unsigned(currRqstNb) << " times. Start to generate map request message.");
+          Ptr<MapRequestMsg> mapReqMsg =
+            LispEtrItrApplication::GenerateMapRequest (eid);
+
+          /* If LISP device is PITR -> Set p bit in MapRequest */
+          Ptr<LispOverIpv4> lisp = m_node->GetObject<LispOverIpv4>();
+          if (lisp->GetPitr ())
             {
-              currRqstNb = GetRequestCount (eid);
+              mapReqMsg->SetP2 (1);
             }
-          if (not IsInRequestList (eid)
-              or currRqstNb < LispEtrItrApplication::MAX_REQUEST_NB)
+          //I'm not sure what happens if one insert a key-value pair into map if the key is alreay existing.
+          if (currRqstNb == 0)
             {
-              NS_LOG_DEBUG (
-                "Remote EID" << eid->Print () << " has been requested " << unsigned(currRqstNb) << " times. Start to generate map request message.");
-              Ptr<MapRequestMsg> mapReqMsg =
-                LispEtrItrApplication::GenerateMapRequest (eid);
-
-              /* If LISP device is PITR -> Set p bit in MapRequest */
-              Ptr<LispOverIpv4> lisp = m_node->GetObject<LispOverIpv4>();
-              if (lisp->GetPitr ())
-                {
-                  mapReqMsg->SetP2 (1);
-                }
-              //I'm not sure what happens if one insert a key-value pair into map if the key is alreay existing.
-              if (currRqstNb == 0)
-                {
-                  // AddInMapReqList will populate m_requestCounter and m_requestList
-                  AddInMapReqList (eid, mapReqMsg);
-                }
-              else
-                {
-                  // Increment by 1
-                  m_requestCounter.find (eid)->second++;
-                }
-              SendMapRequest (mapReqMsg);
-              NS_LOG_DEBUG (
-                "Hence, A Mapping request has been sent in control plan to query for EID..." << msg->GetEndPointId ()->Print ());
+              // AddInMapReqList will populate m_requestCounter and m_requestList
+              AddInMapReqList (eid, mapReqMsg);
             }
           else
             {
-              // if and only isInRequestList and count = max.allowed.nb
-              NS_LOG_DEBUG (
-                "Remote EID has been requested up to " << unsigned(LispEtrItrApplication::MAX_REQUEST_NB) << " times! Give up to continue sending map request for this EID");
-              return;
+              // Increment by 1
+              m_requestCounter.find (eid)->second++;
             }
-
+          SendMapRequest (mapReqMsg);
+          NS_LOG_DEBUG (
+            "Hence, A Mapping request has been sent in control plan to query for EID..." << msg->GetEndPointId ()->Print ());
         }
-      else if (sockMsgHdr.GetMapType ()
-               == static_cast<uint16_t> (LispMappingSocket::MAPM_REGISTER))
+      else
         {
-
-          /* --- Notifies DataPlane that LISP device is NOT registered (NOT allowed to send data packets)--- */
-          Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg>();
-          mapSockMsg->SetEndPoint (
-            Create<EndpointId> (Ipv4Address ("0.0.0.0"), Ipv4Mask ("/32")));                  //Don't care about this endpoint (won't be used)
-          MappingSocketMsgHeader mapSockHeader;
-          mapSockHeader.SetMapType (LispMappingSocket::MAPM_ISREGISTERED);
-          mapSockHeader.SetMapRlocCount (0);
-          mapSockHeader.SetMapVersioning (0);
-
-          mapSockHeader.SetMapAddresses (static_cast<uint16_t> (LispMappingSocket::MAPA_EIDMASK));
-          //MAPA_EID used to say that LISP device is registered.
-          //MAPA_EIDMASK is used to say that LISP device is NOT registered.
-
-          uint8_t buf[256];
-          mapSockMsg->Serialize (buf);
-          Ptr<Packet> packet = Create<Packet> (buf, 256);
-          packet->AddHeader (mapSockHeader);
-          SendToLisp (packet);
-
-          /* --- Start InfoRequest Procedure --- */
-          LispEtrItrApplication::SendInfoRequest ();
-          //LispEtrItrApplication::SendMapRegisters();
+          // if and only isInRequestList and count = max.allowed.nb
           NS_LOG_DEBUG (
-            "Reception from Lisp data plan (LispOverIpv4): Lisp database base is updated. Send a new Map Register message.");
+            "Remote EID has been requested up to " << unsigned(LispEtrItrApplication::MAX_REQUEST_NB) << " times! Give up to continue sending map request for this EID");
+          return;
         }
+
+    }
+  else if (sockMsgHdr.GetMapType ()
+           == static_cast<uint16_t> (LispMappingSocket::MAPM_REGISTER))
+    {
+
+      /* --- Notifies DataPlane that LISP device is NOT registered (NOT allowed to send data packets)--- */
+      Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg>();
+      mapSockMsg->SetEndPoint (
+        Create<EndpointId> (Ipv4Address ("0.0.0.0"), Ipv4Mask ("/32")));                  //Don't care about this endpoint (won't be used)
+      MappingSocketMsgHeader mapSockHeader;
+      mapSockHeader.SetMapType (LispMappingSocket::MAPM_ISREGISTERED);
+      mapSockHeader.SetMapRlocCount (0);
+      mapSockHeader.SetMapVersioning (0);
+
+      mapSockHeader.SetMapAddresses (static_cast<uint16_t> (LispMappingSocket::MAPA_EIDMASK));
+      //MAPA_EID used to say that LISP device is registered.
+      //MAPA_EIDMASK is used to say that LISP device is NOT registered.
+
+      SendToLisp (mapSockHeader, mapSockMsg);
+
+      /* --- Start InfoRequest Procedure --- */
+      LispEtrItrApplication::SendInfoRequest ();
+      //LispEtrItrApplication::SendMapRegisters();
+      NS_LOG_DEBUG (
+        "Reception from Lisp data plan (LispOverIpv4): Lisp database base is updated. Send a new Map Register message.");
     }
 }
 
@@ -955,13 +1247,12 @@ std::list<Ptr<MapRequestMsg> > LispEtrItrApplication::GetMapRequestMsgList ()
 }
 
 MappingSocketMsgHeader LispEtrItrApplication::GenerateMapSocketAddMsgHeader (
-  Ptr<MapReplyMsg> replyMsg)
+  Ptr<MapReplyRecord> replyRecord)
 {
 
   MappingSocketMsgHeader mapSockHeader;
   mapSockHeader.SetMapType (LispMappingSocket::MAPM_ADD);
 
-  Ptr<MapReplyRecord> replyRecord = replyMsg->GetRecord ();
   if (replyRecord->GetLocatorCount () == 0)
     {
       // Negative Map Reply
@@ -989,11 +1280,10 @@ MappingSocketMsgHeader LispEtrItrApplication::GenerateMapSocketAddMsgHeader (
 }
 
 Ptr<MappingSocketMsg> LispEtrItrApplication::GenerateMapSocketAddMsgBody (
-  Ptr<MapReplyMsg> replyMsg)
+  Ptr<MapReplyRecord> replyRecord)
 {
 
   Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg>();
-  Ptr<MapReplyRecord> replyRecord = replyMsg->GetRecord ();
   if (replyRecord)
     {
       mapSockMsg->SetLocators (replyRecord->GetLocators ());
@@ -1054,8 +1344,6 @@ Ptr<MapRegisterMsg> LispEtrItrApplication::GenerateMapRegister (
   Ptr<MapEntry> mapEntry, bool rtr)
 {
   Ptr<MapRegisterMsg> msg = Create<MapRegisterMsg>();
-  Ptr<MapReplyRecord> record = Create<MapReplyRecord>();
-  record->SetRecordTtl (static_cast<uint32_t> (0xffffffff));
   /**
    * TODO: We consider M bit is set by default as 1
    * so that Map Server will sends a Map Notify Message once upon reception
@@ -1066,6 +1354,15 @@ Ptr<MapRegisterMsg> LispEtrItrApplication::GenerateMapRegister (
   msg->SetNonce (0);      // Nonce is 0 for map register
   msg->setKeyId (static_cast<uint16_t> (0xface));
   msg->SetAuthDataLen (04);      // Set
+  msg->SetRecord (GenerateMapRegisterRecord (mapEntry, rtr));
+  return msg;
+}
+
+Ptr<MapReplyRecord> LispEtrItrApplication::GenerateMapRegisterRecord (
+  Ptr<MapEntry> mapEntry, bool rtr)
+{
+  Ptr<MapReplyRecord> record = Create<MapReplyRecord>();
+  record->SetRecordTtl (m_registerTtl);
   record->SetEidPrefix (mapEntry->GetEidPrefix ()->GetEidAddress ());
   if (record->GetEidAfi () == LispControlMsg::IP)
     {
@@ -1090,9 +1387,7 @@ Ptr<MapRegisterMsg> LispEtrItrApplication::GenerateMapRegister (
     }
 
   record->SetMapVersionNumber (mapEntry->GetVersionNumber ());
-  msg->SetRecord (record);
-  msg->SetRecordCount (1);
-  return msg;
+  return record;
 }
 
 Ptr<MapReplyMsg>
@@ -1129,7 +1424,8 @@ LispEtrItrApplication::GenerateMapReply (
       Ptr<MapReplyRecord> replyRecord = Create<MapReplyRecord>();
 
       mapReply->SetNonce (requestMsg->GetNonce ());
-      mapReply->SetRecordCount (1);
+      // Echo the probe bit so that the ITR can tell an RLOC-probe reply
+      mapReply->SetP (requestMsg->GetP ());
       replyRecord->SetAct (MapReplyRecord::NoAction);
       replyRecord->SetA (1);
       replyRecord->SetMapVersionNumber (entry->GetVersionNumber ());
@@ -1148,10 +1444,10 @@ LispEtrItrApplication::GenerateMapReply (
         }
 
       replyRecord->SetLocators (entry->GetLocators ());
-      mapReply->SetRecord (replyRecord);
-      NS_LOG_DEBUG (
-        "MAP REPLY READY, Its content is as follows:\n" << *mapReply);
+      mapReply->AddRecord (replyRecord);
     }
+  NS_LOG_DEBUG (
+    "MAP REPLY READY, Its content is as follows:\n" << *mapReply);
   return mapReply;
 }
 
@@ -1166,31 +1462,23 @@ Ptr<MapReplyMsg> LispEtrItrApplication::GenerateMapReply4ChangedMapping (
    */
   NS_LOG_FUNCTION (this);
   Ptr<MapReplyMsg> mapReply = Create<MapReplyMsg>();       // Smart pointer, default value is 0
-  NS_ASSERT (m_event.IsExpired ());
   std::list<Ptr<MapEntry> > mapEntries;
-  NS_ASSERT_MSG (
-    m_mapTablesV4->GetNMapEntriesLispDataBase ()
-    + m_mapTablesV6->GetNMapEntriesLispDataBase () != 0,
-    "Number of Lisp Database's map entries (ipv4 or ipv6) should not be 0!");
   m_mapTablesV4->GetMapEntryList (MapTables::IN_DATABASE, mapEntries);
   m_mapTablesV6->GetMapEntryList (MapTables::IN_DATABASE, mapEntries);
+  if (mapEntries.empty ())
+    {
+      NS_LOG_DEBUG ("Empty LISP database, nothing to answer the invoked SMR with");
+      return 0;
+    }
   Ptr<MapEntry> entry;
-  /**
-   * For the case where database just has one map entry, the following code works well.
-   * However, we should implement a list of records. Question:
-   * It is possible that a map reply can convey more than one record?
-   * For example, a LISP-MN with ipv4 and ipv6 address at the same time.
-   * I think yes...
-   */
+  mapReply->SetNonce (requestMsg->GetNonce ());
+  // One record per database mapping, all carried by the same Map-Reply.
   for (std::list<Ptr<MapEntry> >::const_iterator it = mapEntries.begin ();
        it != mapEntries.end (); ++it)
     {
-      NS_LOG_DEBUG ("Prepare Map-Reply in response to invoked SMR");
       entry = *it;
       Ptr<MapReplyRecord> replyRecord = Create<MapReplyRecord>();
 
-      mapReply->SetNonce (requestMsg->GetNonce ());
-      mapReply->SetRecordCount (1);
       replyRecord->SetAct (MapReplyRecord::NoAction);
       replyRecord->SetA (1);
       replyRecord->SetMapVersionNumber (entry->GetVersionNumber ());
@@ -1209,10 +1497,10 @@ Ptr<MapReplyMsg> LispEtrItrApplication::GenerateMapReply4ChangedMapping (
         }
 
       replyRecord->SetLocators (entry->GetLocators ());
-      mapReply->SetRecord (replyRecord);
-      NS_LOG_DEBUG (
-        "MAP REPLY READY, Its content is as follows:\n" << *mapReply);
+      mapReply->AddRecord (replyRecord);
     }
+  NS_LOG_DEBUG (
+    "Map-Reply in response to invoked SMR ready, Its content is as follows:\n" << *mapReply);
   return mapReply;
 }
 
@@ -1502,12 +1790,8 @@ LispEtrItrApplication::HandleRead (Ptr<Socket> socket)
               MappingSocketMsgHeader mapSockHeader = GenerateMapSocketAddMsgHeaderForRtr ();
               NS_ASSERT_MSG (mapSockMsg != 0,
                              "Cannot create map socket message body for RTR !!! Please check why.");
-              uint8_t buf[256];
-              mapSockMsg->Serialize (buf);
-              Ptr<Packet> packet = Create<Packet> (buf, 256);
-              packet->AddHeader (mapSockHeader);
               // Send to lispOverIp object so that it can insert the mapping entry in Cache.
-              SendToLisp (packet);
+              SendToLisp (mapSockHeader, mapSockMsg);
 
               /*
                         Send Special MapRegister messages with RTR RLOC
@@ -1535,12 +1819,8 @@ LispEtrItrApplication::HandleRead (Ptr<Socket> socket)
                 (int) mapSockHeader.GetMapAddresses ()
                 | static_cast<int> (LispMappingSocket::MAPA_EIDMASK));
 
-              uint8_t buf[256];
-              mapSockMsg->Serialize (buf);
-              Ptr<Packet> packet = Create<Packet> (buf, 256);
-              packet->AddHeader (mapSockHeader);
               // Send to lispOverIp object so that it knows it is not NATed.
-              SendToLisp (packet);
+              SendToLisp (mapSockHeader, mapSockMsg);
               /* Send classic MapRegisters messages */
               SendMapRegisters ();
             }
@@ -36,6 +36,7 @@
 #include "ns3/mapping-socket-msg.h"
 #include "ns3/locators-impl.h"
 #include "ns3/string.h"
+#include "ns3/map-register-scheduler.h"
 
 
 namespace ns3 {
@@ -63,6 +64,7 @@ public:
   //TODO: implement this getter. useful for DHCP
   std::list<Ptr<Locator> > GetMapResolverRLocs (Ptr<Locator> locator);
   static const uint8_t MAX_REQUEST_NB; //!< maximum number of requests pending in list
+  static const uint8_t MAX_RECORDS_PER_MSG; //!< maximum number of records in a Map-Register (8-bit Record Count)
 
   std::list<Ptr<MapRequestMsg> > GetMapRequestMsgList ();
 
@@ -74,6 +76,19 @@ public:
   */
   void SendMapRegisters (bool rtr = false);
 
+  /**
+   * \brief Send the periodic refresh of the registration, with the same
+   * locators (own or RTR ones) as the initial registration, and schedule
+   * the next one. Called by the MapRegisterScheduler.
+   */
+  void RefreshMapRegisters (void);
+
+  /**
+   * \brief Set the scheduler driving the periodic registration refreshes.
+   * If none is set, the xTR creates its own one when needed.
+   */
+  void SetMapRegisterScheduler (Ptr<MapRegisterScheduler> scheduler);
+
   void SendInfoRequest (void);
 
   /**
@@ -98,6 +113,37 @@ public:
    */
   void SendMapRequest (Ptr<MapRequestMsg> mapRequestMsg);
 
+  /**
+   * \brief Run one RLOC-probing round.
+   *
+   * Probes (i.e. Map Requests with the P bit set) are sent to at most
+   * RlocProbeBudget RLOCs of the map-cache, taken in round-robin order,
+   * so that a large map-cache is covered over several rounds. Probes left
+   * unanswered since the previous round are counted as lost.
+   */
+  void SendRlocProbes (void);
+
+  /**
+   * \brief Process a Map Reply received in response to an RLOC-probe.
+   *
+   * Updates the RTT estimate and marks the probed RLOC as reachable.
+   */
+  void HandleRlocProbeReply (Ptr<MapReplyMsg> replyMsg);
+
+  /**
+   * \param rloc A remote RLOC address.
+   * \returns The smoothed RTT measured by RLOC-probing toward rloc, or zero if unknown.
+   */
+  Time GetRlocProbeRtt (const Address &rloc) const;
+
+  /**
+   * TracedCallback signature for RLOC reachability changes.
+   *
+   * \param [in] rloc The RLOC whose status changed.
+   * \param [in] up True if the RLOC became reachable.
+   */
+  typedef void (* RlocStateTracedCallback)(const Address &rloc, bool up);
+
 //protected:
   /**
    * \brief Schedule the next packet transmission
@@ -105,7 +151,7 @@ public:
    */
   void ScheduleTransmit (Time dt);
 
-  void SendToLisp (Ptr<Packet> packet);
+  void SendToLisp (const MappingSocketMsgHeader &mapSockHeader, Ptr<MappingSocketMsg> mapSockMsg);
 
   void SendTo (Address address, uint16_t port, Ptr<Packet> packet);
 
@@ -123,6 +169,7 @@ public:
   void HandleReadControlMsg (Ptr<Socket> socket);
 
   void HandleMapSockRead (Ptr<Socket> lispMappingSocket);
+  void HandleMapSockMsg (Ptr<LispMappingSocket> lispMappingSocket, const MappingSocketMsgHeader &sockMsgHdr, Ptr<MappingSocketMsg> msg);
 
   bool IsInRequestList (Ptr<EndpointId> eid) const;
   bool IsInRequestCounter (Ptr<EndpointId> eid) const;
@@ -140,10 +187,19 @@ public:
     locator of an RTR.
   */
   Ptr<MapRegisterMsg> GenerateMapRegister (Ptr<MapEntry> mapEntry, bool rtr = false);
+  /**
+   * \brief Build the record registering \p mapEntry, so that several of
+   * them can be packed in the same Map-Register.
+   */
+  Ptr<MapReplyRecord> GenerateMapRegisterRecord (Ptr<MapEntry> mapEntry, bool rtr = false);
+  /**
+   * \brief Serialize \p msg and send it to the first Map Server.
+   */
+  void SendMapRegister (Ptr<MapRegisterMsg> msg);
   Ptr<MapRequestMsg> GenerateMapRequest (Ptr<EndpointId> eid);
   Ptr<MapReplyMsg> GenerateMapReply (Ptr<MapRequestMsg> msg);
-  Ptr<MappingSocketMsg> GenerateMapSocketAddMsgBody (Ptr<MapReplyMsg> replyMsg);
-  MappingSocketMsgHeader GenerateMapSocketAddMsgHeader (Ptr<MapReplyMsg> replyMsg);
+  Ptr<MappingSocketMsg> GenerateMapSocketAddMsgBody (Ptr<MapReplyRecord> replyRecord);
+  MappingSocketMsgHeader GenerateMapSocketAddMsgHeader (Ptr<MapReplyRecord> replyRecord);
   Ptr<MapReplyMsg> GenerateMapReply4ChangedMapping (Ptr<MapRequestMsg> requestMsg);
   Ptr<MappingSocketMsg> GenerateMapSocketAddMsgBodyForRtr (Address rtrAddress);
   MappingSocketMsgHeader GenerateMapSocketAddMsgHeaderForRtr (void);
@@ -159,6 +215,25 @@ private:
 
   virtual void StopApplication (void);
 
+  /**
+   * \brief Set the reachability of a remote RLOC in every map-cache entry using it.
+   */
+  void SetRlocState (const Address &rloc, bool up);
+
+  /**
+   * Per-RLOC state of the RLOC-probing engine.
+   */
+  struct RlocProbeState
+  {
+    Ptr<EndpointId> m_eid; //!< EID-prefix put in the probes
+    uint64_t m_nonce;      //!< Nonce of the outstanding probe (0 if none)
+    Time m_sent;           //!< Transmission time of the outstanding probe
+    Time m_rtt;            //!< Smoothed RTT (zero until the first reply)
+    uint32_t m_round;      //!< Last round the RLOC was found in the map-cache
+    uint8_t m_missed;      //!< Consecutive unanswered probes
+    bool m_up;             //!< Current reachability
+  };
+
   bool m_requestSent;
   bool m_recvIvkSmr;
   EventId m_resendSmrEvent;                //!< Message refresh event
@@ -199,11 +274,29 @@ private:
   bool m_registerProxyMode;
   bool m_enableSubscribe;
 
+  Time m_registerRefresh;         //!< Registration refresh period (0: register once)
+  uint32_t m_registerTtl;         //!< Record TTL of the registrations, in minutes
+  bool m_registerWithRtr;         //!< Registration uses the RTR RLOC (NATed xTR)
+  Ptr<MapRegisterScheduler> m_registerScheduler;
+
+  bool m_rlocProbing;             //!< Enable RLOC-probing
+  Time m_rlocProbeInterval;       //!< Time between two probing rounds
+  uint32_t m_rlocProbeBudget;     //!< Maximum number of probes per round
+  uint8_t m_rlocProbeMaxMissed;   //!< Lost probes before declaring an RLOC down
+  EventId m_rlocProbeEvent;
+  uint32_t m_rlocProbeRound;
+  Address m_rlocProbeCursor;      //!< Last RLOC probed, for round-robin
+  typedef std::map<Address, RlocProbeState> RlocProbeTable_t;
+  RlocProbeTable_t m_rlocProbeTable;
+  std::map<uint64_t, Address> m_rlocProbeNonces; //!< Outstanding probes
+
   /// Callbacks for tracing the MapRegister Tx events
   TracedCallback<Ptr<const Packet> > m_mapRegisterTxTrace;
   /// Callbacks for tracing the MapNotify Rx events
   TracedCallback<Ptr<const Packet> > m_mapNotifyRxTrace;
   TracedCallback<Ptr<const Packet> > m_mappingUpdateTrace;
+  /// Callbacks for tracing RLOC reachability changes
+  TracedCallback<const Address &, bool> m_rlocStateTrace;
 
 };
 
@@ -30,12 +30,11 @@ MapNotifyMsg::MapNotifyMsg ()
 {
   m_nonce = 0;
   m_recordCount = 0;
-  m_record = 0;
 }
 
 MapNotifyMsg::~MapNotifyMsg ()
 {
-  m_record = 0;
+  m_records.clear ();
 }
 
 uint8_t
@@ -89,13 +88,44 @@ MapNotifyMsg::GetAuthDataLen (void)
 void
 MapNotifyMsg::SetRecord (Ptr<MapReplyRecord> record)
 {
-  m_record = record;
+  m_records.clear ();
+  if (record)
+    {
+      AddRecord (record);
+    }
 }
 
 Ptr<MapReplyRecord>
 MapNotifyMsg::GetRecord (void)
 {
-  return m_record;
+  return m_records.empty () ? 0 : m_records.front ();
+}
+
+void
+MapNotifyMsg::AddRecord (Ptr<MapReplyRecord> record)
+{
+  NS_ASSERT_MSG (m_records.size () < 0xff, "Record Count is an 8-bit field");
+  m_records.push_back (record);
+  m_recordCount = m_records.size ();
+}
+
+const std::vector<Ptr<MapReplyRecord> > &
+MapNotifyMsg::GetRecords (void) const
+{
+  return m_records;
+}
+
+uint32_t
+MapNotifyMsg::GetSizeInBytes (void) const
+{
+  // Serialize always writes 4 bytes of authentication data
+  uint32_t size = 16 + 4;
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      size += (*it)->GetSizeInBytes ();
+    }
+  return size;
 }
 
 void
@@ -107,7 +137,7 @@ MapNotifyMsg::Serialize (uint8_t *buf)
   buf[0] = type;
   buf[1] = 0x00;
   buf[2] = 0x00;
-  buf[3] = m_recordCount;
+  buf[3] = m_records.size ();
 
   for (int i = 0; i < MapNotifyMsg::NONCE_LEN; i++)
     {
@@ -124,7 +154,7 @@ MapNotifyMsg::Serialize (uint8_t *buf)
       buf[14 + i] = (m_authDataLen >> 8 * (MapNotifyMsg::AUTHEN_LEN_SIZE - 1 - i)) & 0xff;
     }
 
-  uint8_t size = 16;
+  uint32_t size = 16;
   // Authentication data field
   buf[16] = 0xaa;
   buf[17] = 0xbb;
@@ -133,15 +163,26 @@ MapNotifyMsg::Serialize (uint8_t *buf)
 
   size += m_authDataLen;
 
-  m_record->Serialize (buf + size);
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      (*it)->Serialize (buf + size);
+      size += (*it)->GetSizeInBytes ();
+    }
 }
 
 Ptr<MapNotifyMsg>
-MapNotifyMsg::Deserialize (uint8_t * buf)
+MapNotifyMsg::Deserialize (uint8_t * buf, uint32_t len)
 {
+  // Type/flags, Reserved, Record Count, Nonce, Key ID and Auth Data Length
+  if (len < 16 || len < 16u + ((buf[14] << 8) | buf[15]))
+    {
+      NS_LOG_WARN ("Map-Notify of " << len << " bytes is too short");
+      return 0;
+    }
   Ptr<MapNotifyMsg> msg = Create<MapNotifyMsg> ();
 
-  msg->SetRecordCount (buf[3]);
+  uint8_t recordCount = buf[3];
 
   uint64_t nonce = 0;
 
@@ -152,7 +193,7 @@ MapNotifyMsg::Deserialize (uint8_t * buf)
     }
   msg->SetNonce (nonce);
 
-  uint8_t size = 12;
+  uint32_t size = 12;
 
   // Retrieve key ID field
   uint16_t keyID = 0;
@@ -188,7 +229,20 @@ MapNotifyMsg::Deserialize (uint8_t * buf)
   NS_LOG_DEBUG (
     "Decoded Record Count: " << unsigned(buf[3]) << ";Decoded Key ID: " << keyID << ";Authentication data length: " << authDataLen << ";Authentication data: " << authData);
   //but is actually the address of the first element in buf array!
-  msg->SetRecord (MapReplyRecord::Deserialize (buf + size));
+  for (uint8_t i = 0; i < recordCount; i++)
+    {
+      uint32_t recordSize = MapReplyRecord::GetSerializedSize (buf + size,
+                                                               len - size);
+      if (recordSize == 0)
+        {
+          NS_LOG_WARN ("Record " << unsigned(i) << " of " << unsigned(recordCount)
+                                 << " exceeds the " << len << "-byte message");
+          return 0;
+        }
+      Ptr<MapReplyRecord> record = MapReplyRecord::Deserialize (buf + size);
+      size += recordSize;
+      msg->AddRecord (record);
+    }
   return msg;
 }
 
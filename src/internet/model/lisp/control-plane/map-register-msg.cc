@@ -28,7 +28,6 @@ MapRegisterMsg::MapRegisterMsg ()
   m_M = 0;
   m_nonce = 0;
   m_recordCount = 0;
-  m_record = 0;
 
   reserved = 0;
   m_keyID = 0;
@@ -38,7 +37,7 @@ MapRegisterMsg::MapRegisterMsg ()
 
 MapRegisterMsg::~MapRegisterMsg ()
 {
-  m_record = 0;
+  m_records.clear ();
 }
 
 uint8_t MapRegisterMsg::GetP (void)
@@ -107,12 +106,39 @@ uint64_t GetNonce (void);
 
 void MapRegisterMsg::SetRecord (Ptr<MapReplyRecord> record)
 {
-  m_record = record;
+  m_records.clear ();
+  if (record)
+    {
+      AddRecord (record);
+    }
 }
 
 Ptr<MapReplyRecord> MapRegisterMsg::GetRecord (void)
 {
-  return m_record;
+  return m_records.empty () ? 0 : m_records.front ();
+}
+
+void MapRegisterMsg::AddRecord (Ptr<MapReplyRecord> record)
+{
+  NS_ASSERT_MSG (m_records.size () < 0xff, "Record Count is an 8-bit field");
+  m_records.push_back (record);
+  m_recordCount = m_records.size ();
+}
+
+const std::vector<Ptr<MapReplyRecord> > & MapRegisterMsg::GetRecords (void) const
+{
+  return m_records;
+}
+
+uint32_t MapRegisterMsg::GetSizeInBytes (void) const
+{
+  uint32_t size = 16 + m_authDataLen;
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      size += (*it)->GetSizeInBytes ();
+    }
+  return size;
 }
 
 void MapRegisterMsg::Serialize (uint8_t *buf)
@@ -123,7 +149,7 @@ void MapRegisterMsg::Serialize (uint8_t *buf)
   buf[0] = (type) | (m_P << 3);
   buf[1] = 0x00;
   buf[2] = m_M;
-  buf[3] = m_recordCount;
+  buf[3] = m_records.size ();
 
   int nonce_size = 8;
   for (int i = 0; i < nonce_size; i++)
@@ -142,7 +168,7 @@ void MapRegisterMsg::Serialize (uint8_t *buf)
       buf[14 + i] = (m_authDataLen >> 8 * (authen_len_size - 1 - i)) & 0xff;
     }
 
-  uint8_t size = 16;
+  uint32_t size = 16;
   // Authentication data field
   buf[16] = 0xaa;
   buf[17] = 0xbb;
@@ -151,17 +177,28 @@ void MapRegisterMsg::Serialize (uint8_t *buf)
 
   size += m_authDataLen;
 
-  m_record->Serialize (buf + size);
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      (*it)->Serialize (buf + size);
+      size += (*it)->GetSizeInBytes ();
+    }
 }
 
-Ptr<MapRegisterMsg> MapRegisterMsg::Deserialize (uint8_t *buf)
+Ptr<MapRegisterMsg> MapRegisterMsg::Deserialize (uint8_t *buf, uint32_t len)
 {
+  // Type/flags, Reserved, Record Count, Nonce, Key ID and Auth Data Length
+  if (len < 16 || len < 16u + ((buf[14] << 8) | buf[15]))
+    {
+      NS_LOG_WARN ("Map-Register of " << len << " bytes is too short");
+      return 0;
+    }
   Ptr<MapRegisterMsg> msg = Create<MapRegisterMsg>();
 
   msg->SetP ((buf[0] >> 3) & 0x01);
   msg->SetM (buf[2]);
 
-  msg->SetRecordCount (buf[3]);
+  uint8_t recordCount = buf[3];
 
   uint64_t nonce = 0;
 
@@ -173,7 +210,7 @@ Ptr<MapRegisterMsg> MapRegisterMsg::Deserialize (uint8_t *buf)
       nonce |= buf[4 + i];
     }
   msg->SetNonce (nonce);
-  uint8_t size = 12;
+  uint32_t size = 12;
 
   // Retrieve key ID field
   int keyID_size = 2;
@@ -215,7 +252,20 @@ Ptr<MapRegisterMsg> MapRegisterMsg::Deserialize (uint8_t *buf)
       ";Authentication data: " << authData
     );
   //but is actually the address of the first element in buf array!
-  msg->SetRecord (MapReplyRecord::Deserialize (buf + size));
+  for (uint8_t i = 0; i < recordCount; i++)
+    {
+      uint32_t recordSize = MapReplyRecord::GetSerializedSize (buf + size,
+                                                               len - size);
+      if (recordSize == 0)
+        {
+          NS_LOG_WARN ("Record " << unsigned(i) << " of " << unsigned(recordCount)
+                                 << " exceeds the " << len << "-byte message");
+          return 0;
+        }
+      Ptr<MapReplyRecord> record = MapReplyRecord::Deserialize (buf + size);
+      size += recordSize;
+      msg->AddRecord (record);
+    }
   return msg;
 }
 
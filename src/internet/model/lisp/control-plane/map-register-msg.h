@@ -22,6 +22,7 @@
 
 #include "lisp-control-msg.h"
 #include "map-reply-msg.h"
+#include <vector>
 /**
  *
  *
@@ -53,11 +54,32 @@ public:
   void SetAuthDataLen (uint16_t authDataLen);
   uint16_t GetAuthDataLen (void);
 
+  /**
+   * \brief Replace the records carried by the message with \p record.
+   */
   void SetRecord (Ptr<MapReplyRecord> record);
+  /**
+   * \return The first record of the message (0 if there is none).
+   */
   Ptr<MapReplyRecord> GetRecord (void);
-
+  /**
+   * \brief Append a record to the message and update Record Count.
+   */
+  void AddRecord (Ptr<MapReplyRecord> record);
+  const std::vector<Ptr<MapReplyRecord> > & GetRecords (void) const;
+
+  /**
+   * \return The number of bytes needed to serialize the message.
+   */
+  uint32_t GetSizeInBytes (void) const;
   void Serialize (uint8_t *buf);
-  static Ptr<MapRegisterMsg> Deserialize (uint8_t *buf);
+  /**
+   * \param buf The serialized message.
+   * \param len Number of bytes in \p buf.
+   * \return The message, or 0 if \p buf is shorter than its Record Count
+   * and records claim.
+   */
+  static Ptr<MapRegisterMsg> Deserialize (uint8_t *buf, uint32_t len);
 
   static LispControlMsg::LispControlMsgType GetMsgType (void);
 
@@ -78,7 +100,7 @@ public:
   uint16_t m_keyID;
   uint16_t m_authDataLen;       //Authentication Data Length
   uint32_t m_authData;          //Authentication Data
-  Ptr<MapReplyRecord> m_record;
+  std::vector<Ptr<MapReplyRecord> > m_records;
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 University of Liege
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "map-register-scheduler.h"
+#include "lisp-etr-itr-application.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MapRegisterScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (MapRegisterScheduler);
+
+TypeId MapRegisterScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MapRegisterScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Lisp")
+    .AddConstructor<MapRegisterScheduler> ()
+    .AddAttribute ("SlotDuration",
+                   "The granularity of the refresh events: all the xTRs due in the same slot are refreshed by one event.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&MapRegisterScheduler::m_slotDuration),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("Jitter",
+                   "The random variable (in seconds) added to every refresh delay.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&MapRegisterScheduler::m_jitter),
+                   MakePointerChecker<RandomVariableStream> ());
+  return tid;
+}
+
+MapRegisterScheduler::MapRegisterScheduler ()
+  : m_eventSlot (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MapRegisterScheduler::~MapRegisterScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MapRegisterScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_event);
+  m_slots.clear ();
+  m_pending.clear ();
+  m_jitter = 0;
+  Object::DoDispose ();
+}
+
+void
+MapRegisterScheduler::Schedule (Ptr<LispEtrItrApplication> xtr, Time delay)
+{
+  NS_LOG_FUNCTION (this << xtr << delay);
+  Remove (xtr);
+
+  Time due = Simulator::Now () + delay + Seconds (m_jitter->GetValue ());
+  int64_t step = m_slotDuration.GetTimeStep ();
+  // First slot boundary at or after the due time
+  uint64_t slot = (std::max<int64_t> (due.GetTimeStep (), 0) + step - 1) / step;
+  m_slots[slot].push_back (xtr);
+  m_pending[xtr] = slot;
+  ArmEvent ();
+}
+
+void
+MapRegisterScheduler::Remove (Ptr<LispEtrItrApplication> xtr)
+{
+  NS_LOG_FUNCTION (this << xtr);
+  std::map<Ptr<LispEtrItrApplication>, uint64_t>::iterator it = m_pending.find (xtr);
+  if (it == m_pending.end ())
+    {
+      return;
+    }
+  std::map<uint64_t, Batch>::iterator slot = m_slots.find (it->second);
+  NS_ASSERT (slot != m_slots.end ());
+  Batch &batch = slot->second;
+  batch.erase (std::find (batch.begin (), batch.end (), xtr));
+  if (batch.empty ())
+    {
+      m_slots.erase (slot);
+    }
+  m_pending.erase (it);
+  ArmEvent ();
+}
+
+uint32_t
+MapRegisterScheduler::GetNPending (void) const
+{
+  return m_pending.size ();
+}
+
+int64_t
+MapRegisterScheduler::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_jitter->SetStream (stream);
+  return 1;
+}
+
+void
+MapRegisterScheduler::ArmEvent (void)
+{
+  if (m_slots.empty ())
+    {
+      Simulator::Cancel (m_event);
+      return;
+    }
+  uint64_t first = m_slots.begin ()->first;
+  if (m_event.IsRunning () && m_eventSlot == first)
+    {
+      return;
+    }
+  Simulator::Cancel (m_event);
+  m_eventSlot = first;
+  Time at = TimeStep (first * m_slotDuration.GetTimeStep ());
+  m_event = Simulator::Schedule (std::max (at - Simulator::Now (), Time (0)),
+                                 &MapRegisterScheduler::ProcessSlot, this);
+}
+
+void
+MapRegisterScheduler::ProcessSlot (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_slots.empty ());
+  Batch batch;
+  batch.swap (m_slots.begin ()->second);
+  m_slots.erase (m_slots.begin ());
+  for (Batch::const_iterator it = batch.begin (); it != batch.end (); ++it)
+    {
+      m_pending.erase (*it);
+    }
+  NS_LOG_DEBUG ("Refreshing the registration of " << batch.size () << " xTR(s)");
+  // Refreshing an xTR reschedules it, possibly arming the event again.
+  for (Batch::const_iterator it = batch.begin (); it != batch.end (); ++it)
+    {
+      (*it)->RefreshMapRegisters ();
+    }
+  ArmEvent ();
+}
+
+} /* namespace ns3 */
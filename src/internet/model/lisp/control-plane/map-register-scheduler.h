@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016 University of Liege
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SRC_INTERNET_MODEL_LISP_CONTROL_PLANE_MAP_REGISTER_SCHEDULER_H_
+#define SRC_INTERNET_MODEL_LISP_CONTROL_PLANE_MAP_REGISTER_SCHEDULER_H_
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+class LispEtrItrApplication;
+
+/**
+ * \brief Central scheduler of the periodic Map-Register refreshes.
+ *
+ * Instead of each xTR keeping its own refresh timer, the refreshes are
+ * gathered in time slots of SlotDuration. A single simulator event is
+ * pending at any time, for the earliest non-empty slot, and all the xTRs
+ * due in that slot refresh their registration in one batch. A random
+ * jitter is added to every refresh so that xTRs started at the same time
+ * drift apart instead of hitting the Map-Server in synchronized bursts.
+ *
+ * The LispEtrItrAppHelper shares one scheduler between all the xTRs it
+ * installs.
+ */
+class MapRegisterScheduler : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  MapRegisterScheduler ();
+  virtual
+  ~MapRegisterScheduler ();
+
+  /**
+   * \brief Schedule the next registration refresh of \p xtr, \p delay
+   * (plus jitter) from now. A pending refresh of \p xtr is replaced.
+   */
+  void Schedule (Ptr<LispEtrItrApplication> xtr, Time delay);
+  /**
+   * \brief Forget the pending refresh of \p xtr, if any.
+   */
+  void Remove (Ptr<LispEtrItrApplication> xtr);
+
+  /**
+   * \return The number of xTRs with a pending refresh.
+   */
+  uint32_t GetNPending (void) const;
+
+  /**
+   * \brief Assign a fixed random variable stream number to the jitter.
+   * \return The number of streams used.
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  typedef std::vector<Ptr<LispEtrItrApplication> > Batch;
+
+  /**
+   * \brief Refresh all the xTRs of the earliest slot and arm the event
+   * for the next one.
+   */
+  void ProcessSlot (void);
+  void ArmEvent (void);
+
+  Time m_slotDuration;
+  Ptr<RandomVariableStream> m_jitter;
+  std::map<uint64_t, Batch> m_slots;  //!< slot index -> xTRs due in that slot
+  std::map<Ptr<LispEtrItrApplication>, uint64_t> m_pending;  //!< xTR -> its slot
+  EventId m_event;
+  uint64_t m_eventSlot;  //!< slot m_event is armed for
+};
+
+} /* namespace ns3 */
+
+#endif /* SRC_INTERNET_MODEL_LISP_CONTROL_PLANE_MAP_REGISTER_SCHEDULER_H_ */
@@ -32,6 +32,7 @@ MapReplyMsg::MapReplyMsg ()
   m_P = 0;
   m_E = 0;
   m_S = 0;
+  m_recordCount = 0;
 }
 
 MapReplyMsg::~MapReplyMsg ()
@@ -87,12 +88,12 @@ void MapReplyMsg::Serialize (uint8_t *buf) const
 {
   uint8_t msg_type = static_cast<uint8_t> (GetMsgType ());
   uint8_t type_EPS = 0;
-  uint8_t position = 0;
+  uint32_t position = 0;
   type_EPS = (msg_type << 4) | (m_P << 3) | (m_E << 2) | (m_S << 1);
   buf[0] = type_EPS;
   buf[1] = m_reserved;       // should be 0
   buf[2] = 0x00;       // rest part of m_reserved, all bits are 0;
-  buf[3] = m_recordCount;
+  buf[3] = m_records.size ();
   position += 4;
   buf[position] = (m_nonce >> 56) & 0xffff;
   buf[position + 1] = (m_nonce >> 48) & 0xffff;
@@ -104,16 +105,24 @@ void MapReplyMsg::Serialize (uint8_t *buf) const
   buf[position + 7] = (m_nonce >> 0) & 0xffff;
   position += 8;
 
-  if (m_record != 0)      //Negative Map Reply case
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
     {
-      m_record->Serialize (buf + position);
+      (*it)->Serialize (buf + position);
+      position += (*it)->GetSizeInBytes ();
     }
 }
 
-Ptr<MapReplyMsg> MapReplyMsg::Deserialize (uint8_t *buf)
+Ptr<MapReplyMsg> MapReplyMsg::Deserialize (uint8_t *buf, uint32_t len)
 {
+  // Type/flags, Reserved, Record Count and Nonce
+  if (len < 12)
+    {
+      NS_LOG_WARN ("Map-Reply of " << len << " bytes is too short");
+      return 0;
+    }
   Ptr<MapReplyMsg> msg = Create<MapReplyMsg>();
-  uint8_t position = 0;
+  uint32_t position = 0;
   // The first bits are about Type, in this case 2
   // Do not forget to take and bitwise operation with 0x01 to extract each flag value
   uint8_t EPSres = buf[0];
@@ -121,7 +130,7 @@ Ptr<MapReplyMsg> MapReplyMsg::Deserialize (uint8_t *buf)
   msg->SetE ((EPSres >> 2) & 0x01);
   msg->SetS ((EPSres >> 1) & 0x01);
 
-  msg->SetRecordCount (buf[3]);
+  uint8_t recordCount = buf[3];
   position += 4;
   uint64_t nonce = 0;
   nonce |= buf[position];
@@ -143,9 +152,19 @@ Ptr<MapReplyMsg> MapReplyMsg::Deserialize (uint8_t *buf)
   msg->SetNonce (nonce);
   position += 8;
 
-  if (msg->GetRecordCount () != 0)
+  for (uint8_t i = 0; i < recordCount; i++)
     {
-      msg->SetRecord (MapReplyRecord::Deserialize (buf + position));
+      uint32_t recordSize = MapReplyRecord::GetSerializedSize (buf + position,
+                                                               len - position);
+      if (recordSize == 0)
+        {
+          NS_LOG_WARN ("Record " << unsigned(i) << " of " << unsigned(recordCount)
+                                 << " exceeds the " << len << "-byte message");
+          return 0;
+        }
+      Ptr<MapReplyRecord> record = MapReplyRecord::Deserialize (buf + position);
+      position += recordSize;
+      msg->AddRecord (record);
     }
 
   return msg;
@@ -153,11 +172,39 @@ Ptr<MapReplyMsg> MapReplyMsg::Deserialize (uint8_t *buf)
 
 void MapReplyMsg::SetRecord (Ptr<MapReplyRecord> record)
 {
-  m_record = record;
+  m_records.clear ();
+  if (record)
+    {
+      AddRecord (record);
+    }
 }
 Ptr<MapReplyRecord> MapReplyMsg::GetRecord (void)
 {
-  return m_record;
+  return m_records.empty () ? 0 : m_records.front ();
+}
+
+void MapReplyMsg::AddRecord (Ptr<MapReplyRecord> record)
+{
+  NS_ASSERT_MSG (m_records.size () < 0xff, "Record Count is an 8-bit field");
+  m_records.push_back (record);
+  m_recordCount = m_records.size ();
+}
+
+const std::vector<Ptr<MapReplyRecord> > & MapReplyMsg::GetRecords (void) const
+{
+  return m_records;
+}
+
+uint32_t MapReplyMsg::GetSizeInBytes (void) const
+{
+  // Type/flags, Reserved, Record Count and Nonce
+  uint32_t size = 4 + 8;
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      size += (*it)->GetSizeInBytes ();
+    }
+  return size;
 }
 
 void MapReplyMsg::Print (std::ostream& os) const
@@ -165,7 +212,11 @@ void MapReplyMsg::Print (std::ostream& os) const
   os << "E: " << unsigned(m_E) << " P: " << unsigned(m_P) << " S: "
      << unsigned(m_S) << " Nonce: " << unsigned(m_nonce)
      << " Record Count: " << unsigned(m_recordCount) << " Reply-Record: ";
-  m_record->Print (os);
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = m_records.begin ();
+       it != m_records.end (); ++it)
+    {
+      (*it)->Print (os);
+    }
   os << std::endl;
 }
 
@@ -24,6 +24,7 @@
 #include "ns3/map-reply-record.h"
 #include "ns3/map-tables.h"
 #include "ns3/map-request-msg.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -50,17 +51,38 @@ public:
   void SetNonce (uint64_t nonce);
   uint64_t GetNonce (void);
 
+  /**
+   * \brief Replace the records carried by the message with \p record.
+   */
   void SetRecord (Ptr<MapReplyRecord> record);
+  /**
+   * \return The first record of the message (0 if there is none).
+   */
   Ptr<MapReplyRecord> GetRecord (void);
-
+  /**
+   * \brief Append a record to the message and update Record Count.
+   */
+  void AddRecord (Ptr<MapReplyRecord> record);
+  const std::vector<Ptr<MapReplyRecord> > & GetRecords (void) const;
+
+  /**
+   * \return The number of bytes needed to serialize the message.
+   */
+  uint32_t GetSizeInBytes (void) const;
   void Serialize (uint8_t *buf) const;
-  static Ptr<MapReplyMsg> Deserialize (uint8_t *buf);
+  /**
+   * \param buf The serialized message.
+   * \param len Number of bytes in \p buf.
+   * \return The message, or 0 if \p buf is shorter than its Record Count
+   * and records claim.
+   */
+  static Ptr<MapReplyMsg> Deserialize (uint8_t *buf, uint32_t len);
 
   void Print (std::ostream& os) const;
   static LispControlMsg::LispControlMsgType GetMsgType (void);
 
 private:
-  Ptr<MapReplyRecord> m_record;
+  std::vector<Ptr<MapReplyRecord> > m_records;
   uint8_t m_recordCount;
   uint8_t m_P : 1; //!< Probe bit
   uint8_t m_E : 1; //!< Echo Nonce enable bit
@@ -118,7 +118,7 @@ Ptr<Locators> MapReplyRecord::GetLocators (void)
 
 void MapReplyRecord::Serialize (uint8_t *buf)
 {
-  uint8_t size = 0;
+  uint16_t size = 0;
   for (int i = 0; i < MapReplyRecord::RECORD_TTL_LEN; i++)
     {
       buf[size + i] = (m_recordTtl
@@ -181,7 +181,8 @@ void MapReplyRecord::Serialize (uint8_t *buf)
           // Serialize unused flags and L,p, R
           buf[size] = 0x00;
           size++;
-          buf[size] = 0x00;
+          // R: the sender considers the locator reachable
+          buf[size] = tmp_rlocmetrics->IsUp () ? RlocMetrics::RLOCF_R : 0x00;
           size++;
           // Loc-AFI field. Indicating AFI family of next Locator field
           Address tmp_loc_addr = tmp_locator->GetRlocAddress ();
@@ -199,8 +200,12 @@ void MapReplyRecord::Serialize (uint8_t *buf)
             }
           else
             {
-              //case of ipv6. Donot care now!
               buf[size] = 0x00;
+              size += 1;
+              buf[size] = static_cast<uint8_t> (LispControlMsg::IPV6);
+              size++;
+              Ipv6Address::ConvertFrom (tmp_loc_addr).Serialize (buf + size);
+              size += 16;
             }
 
 //			std::cout << "ID " << i << " of "
@@ -208,14 +213,71 @@ void MapReplyRecord::Serialize (uint8_t *buf)
 //			std::cout << m_locators->GetLocatorByIdx(i)->Print() << std::endl;
         }
     }
-  else
+  // NB: nothing is written past the last locator: records are packed back
+  // to back in multi-record messages and Deserialize relies on Locator Count.
+}
+
+uint16_t MapReplyRecord::GetSizeInBytes (void) const
+{
+  // Record TTL, Locator Count, EID mask-len, ACT/A/Reserved, Map-Version
+  uint16_t size = RECORD_TTL_LEN + 1 + 1 + 2 + 2 + EID_PREFIX_AFI_LEN;
+  size += (m_eidPrefixAfi == LispControlMsg::IP) ? 4 : 16;
+  if (m_locators)
     {
-      // Do not forget to set current buffer content as zero
-      // since in corresponding deserialize method, it depends current buf[size] value
-      // (0 or 1) to decide whether it is necessary to decode for Locators
-      buf[size] = 0;
+      for (int i = 0; i < m_locators->GetNLocators (); i++)
+        {
+          Address rloc = m_locators->GetLocatorByIdx (i)->GetRlocAddress ();
+          // priorities/weights, flags and Loc-AFI (8 bytes) plus the RLOC
+          size += Ipv4Address::IsMatchingType (rloc) ? 12 : 24;
+        }
     }
+  return size;
+}
 
+uint32_t MapReplyRecord::GetSerializedSize (const uint8_t *buf, uint32_t len)
+{
+  // Record TTL, Locator Count, EID mask-len, ACT/A/Reserved, Map-Version
+  uint32_t size = RECORD_TTL_LEN + 1 + 1 + 2 + 2 + EID_PREFIX_AFI_LEN;
+  if (len < size)
+    {
+      return 0;
+    }
+  uint8_t locatorCount = buf[RECORD_TTL_LEN];
+  uint16_t eidAfi = (buf[size - 2] << 8) | buf[size - 1];
+  if (eidAfi == static_cast<uint16_t> (LispControlMsg::IP))
+    {
+      size += 4;
+    }
+  else if (eidAfi == static_cast<uint16_t> (LispControlMsg::IPV6))
+    {
+      size += 16;
+    }
+  else
+    {
+      return 0;
+    }
+  for (uint8_t i = 0; i < locatorCount; i++)
+    {
+      // priorities/weights, flags and Loc-AFI (8 bytes) plus the RLOC
+      if (len < size + 8)
+        {
+          return 0;
+        }
+      uint16_t locAfi = (buf[size + 6] << 8) | buf[size + 7];
+      if (locAfi == RlocMetrics::IPv4)
+        {
+          size += 12;
+        }
+      else if (locAfi == RlocMetrics::IPv6)
+        {
+          size += 24;
+        }
+      else
+        {
+          return 0;
+        }
+    }
+  return (len < size) ? 0 : size;
 }
 
 Ptr<MapReplyRecord> MapReplyRecord::Deserialize (uint8_t *buf)
@@ -62,6 +62,21 @@ public:
 
   void Serialize (uint8_t *buf);
   static Ptr<MapReplyRecord> Deserialize (uint8_t *buf);
+  /**
+   * \brief Number of bytes the record occupies once serialized, i.e. the
+   * offset of the next record in a multi-record message.
+   */
+  uint16_t GetSizeInBytes (void) const;
+  /**
+   * \brief Size of the serialized record starting at \p buf, read from its
+   * own Locator Count and AFI fields.
+   *
+   * \param buf Start of the serialized record.
+   * \param len Number of bytes available from \p buf.
+   * \return The record size, or 0 if the record is truncated or carries an
+   * unknown address family.
+   */
+  static uint32_t GetSerializedSize (const uint8_t *buf, uint32_t len);
 
   void Print (std::ostream& os);
 
@@ -197,6 +197,29 @@ uint64_t MapRequestMsg::GetSiteId (void) const
   return m_siteId;
 }
 
+uint32_t MapRequestMsg::GetSizeInBytes (void) const
+{
+  // Type/flags, IRC, Record Count, Nonce and Source-EID-AFI
+  uint32_t size = 14;
+  if (m_sourceEidAfi == LispControlMsg::IP)
+    {
+      size += 4;
+    }
+  else if (m_sourceEidAfi == LispControlMsg::IPV6)
+    {
+      size += 16;
+    }
+  // ITR-RLOC-AFI and, if set, the IPv4 ITR-RLOC-Address
+  size += Ipv4Address ().IsEqual (Ipv4Address::ConvertFrom (m_itrRlocAddrIp)) ? 1 : 6;
+  size += m_mapReqRec->GetSizeInBytes ();
+  if (m_I)
+    {
+      // xTR-ID and Site-ID
+      size += 16 + 8;
+    }
+  return size;
+}
+
 void MapRequestMsg::Serialize (uint8_t *buf) const
 {
   uint8_t type = static_cast<uint8_t> (LispControlMsg::MAP_REQUEST);
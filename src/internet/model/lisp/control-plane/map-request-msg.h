@@ -125,6 +125,10 @@ public:
    */
   uint64_t GetSiteId (void) const;
 
+  /**
+   * \return The number of bytes needed to serialize the message.
+   */
+  uint32_t GetSizeInBytes (void) const;
   void Serialize (uint8_t *buf) const;
   static Ptr<MapRequestMsg> Deserialize (uint8_t *buf);
 
@@ -153,10 +153,11 @@ void MapResolverDdt::SendMapRequest (Ptr<MapRequestMsg> mapRequestMsg)
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_event.IsExpired ());
 
-  uint8_t buf[64];
+  uint32_t bufSize = mapRequestMsg->GetSizeInBytes ();
+  uint8_t buf[bufSize];
   mapRequestMsg->Serialize (buf);
   ConnectToPeerAddress (m_mapServerAddress, m_peerPort, m_socket);
-  Ptr<Packet> p = Create<Packet> (buf, 64);
+  Ptr<Packet> p = Create<Packet> (buf, bufSize);
   m_socket->Send (p);
 }
 
@@ -31,6 +31,7 @@
 #include "map-register-msg.h"
 #include "map-resolver.h"
 #include "subscribe-list.h"
+#include <algorithm>
 
 namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("MapServerDdt");
@@ -52,8 +53,8 @@ MapServerDdt::MapServerDdt ()
   /**
    * MapServerDdt and LispOverIp should point to the same MapTables!
    */
-  m_mapTablesv4 = Create<SimpleMapTables> ();
-  m_mapTablesv6 = Create<SimpleMapTables> ();
+  m_mapTablesv4 = CreateObject<SimpleMapTables> ();
+  m_mapTablesv6 = CreateObject<SimpleMapTables> ();
 
   m_subscribeList = Create<SubscribeList>();
 }
@@ -150,6 +151,12 @@ MapServerDdt::StopApplication (void)
       m_msClientSocket6 = 0;
     }
   Simulator::Cancel (m_event);
+  for (std::map<std::pair<Address, uint8_t>, EventId>::iterator it = m_registrationExpiry.begin ();
+       it != m_registrationExpiry.end (); ++it)
+    {
+      Simulator::Cancel (it->second);
+    }
+  m_registrationExpiry.clear ();
 }
 
 Ptr<MapNotifyMsg>
@@ -157,12 +164,16 @@ MapServerDdt::GenerateMapNotifyMsg (Ptr<MapRegisterMsg> msg)
 {
   //TODO implement map notification message here
   Ptr<MapNotifyMsg> mapNotify = Create<MapNotifyMsg> ();
-  mapNotify->SetRecordCount (msg->GetRecordCount ());
   mapNotify->SetNonce (msg->GetNonce ());
   mapNotify->SetAuthDataLen (msg->GetAuthDataLen ());
   mapNotify->setAuthData (msg->getAuthData ());
   mapNotify->setKeyId (msg->getKeyId ());
-  mapNotify->SetRecord (msg->GetRecord ());
+  const std::vector<Ptr<MapReplyRecord> > &records = msg->GetRecords ();
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = records.begin ();
+       it != records.end (); ++it)
+    {
+      mapNotify->AddRecord (*it);
+    }
   return mapNotify;
 }
 
@@ -202,9 +213,19 @@ MapServerDdt::PopulateDatabase (Ptr<MapRegisterMsg> msg)
   //replace by new one or combine them??
   //For multihoming case, combine RLOC for the same RLOC
   //For LISP-MN, replace them
-  NS_LOG_DEBUG ("Get a Map Register Message! Try to decode it...");
+  NS_LOG_DEBUG ("Get a Map Register Message with " << unsigned (msg->GetRecordCount ()) << " record(s)! Try to decode it...");
+  const std::vector<Ptr<MapReplyRecord> > &records = msg->GetRecords ();
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = records.begin ();
+       it != records.end (); ++it)
+    {
+      PopulateDatabase (*it);
+    }
+}
+
+void
+MapServerDdt::PopulateDatabase (Ptr<MapReplyRecord> record)
+{
   std::stringstream ss;
-  Ptr<MapReplyRecord> record = msg->GetRecord ();
   Ptr<EndpointId> eid;
   Ptr<Locators> locators = record->GetLocators ();
   if (record->GetEidAfi () == LispControlMsg::IP)
@@ -248,6 +269,49 @@ MapServerDdt::PopulateDatabase (Ptr<MapRegisterMsg> msg)
       m_mapTablesv6->SetEntry (record->GetEidPrefix (), prefix, mapEntry,
                                MapTables::IN_CACHE);
     }
+
+  // The registration is removed if it is not refreshed within its
+  // Record TTL, in minutes (RFC 6833).
+  std::pair<Address, uint8_t> key (record->GetEidPrefix (), record->GetEidMaskLength ());
+  if (record->GetRecordTtl () == MapReplyRecord::m_defaultRecordTtl)
+    {
+      std::map<std::pair<Address, uint8_t>, EventId>::iterator it = m_registrationExpiry.find (key);
+      if (it != m_registrationExpiry.end ())
+        {
+          Simulator::Cancel (it->second);
+          m_registrationExpiry.erase (it);
+        }
+      return;
+    }
+  EventId &expiry = m_registrationExpiry[key];
+  Simulator::Cancel (expiry);
+  expiry = Simulator::Schedule (Minutes (record->GetRecordTtl ()), &MapServerDdt::ExpireRegistration,
+                                this, record->GetEidPrefix (), record->GetEidMaskLength ());
+}
+
+void
+MapServerDdt::ExpireRegistration (Address eidPrefix, uint8_t maskLength)
+{
+  NS_LOG_FUNCTION (this << eidPrefix << unsigned (maskLength));
+  NS_LOG_DEBUG ("The registration of the EID-prefix of length " << unsigned (maskLength) << " expired");
+  m_registrationExpiry.erase (std::make_pair (eidPrefix, maskLength));
+  Ptr<MapTables> mapTables = Ipv4Address::IsMatchingType (eidPrefix) ? m_mapTablesv4 : m_mapTablesv6;
+  mapTables->DatabaseDelete (eidPrefix);
+  mapTables->CacheDelete (eidPrefix);
+}
+
+Ptr<MapEntry>
+MapServerDdt::DatabaseLookup (Ptr<MapReplyRecord> record)
+{
+  if (record->GetEidAfi () == LispControlMsg::IP)
+    {
+      return m_mapTablesv4->DatabaseLookup (record->GetEidPrefix ());
+    }
+  else if (record->GetEidAfi () == LispControlMsg::IPV6)
+    {
+      return m_mapTablesv6->DatabaseLookup (record->GetEidPrefix ());
+    }
+  return 0;
 }
 
 Ptr<MapReplyMsg>
@@ -258,7 +322,6 @@ GenerateMapReply (Ptr<MapRequestMsg> requestMsg, Ptr<MapEntry> entry)
   Ptr<MapReplyRecord> replyRecord = Create<MapReplyRecord>();
 
   mapReply->SetNonce (requestMsg->GetNonce ());
-  mapReply->SetRecordCount (1);
   replyRecord->SetAct (MapReplyRecord::NoAction);
   replyRecord->SetA (0);
   replyRecord->SetMapVersionNumber (entry->GetVersionNumber ());
@@ -279,7 +342,6 @@ GenerateMapNotify (uint16_t nounce, Ptr<MapEntry> entry)
   Ptr<MapReplyRecord> replyRecord = Create<MapReplyRecord>();
 
   mapNotify->SetNonce (nounce);
-  mapNotify->SetRecordCount (1);
   replyRecord->SetAct (MapReplyRecord::NoAction);
   replyRecord->SetA (0);
   replyRecord->SetMapVersionNumber (entry->GetVersionNumber ());
@@ -309,37 +371,35 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
       NS_LOG_DEBUG ("Decoded Message type: " << unsigned(msg_type));
       if (msg_type == static_cast<uint8_t> (MapRegisterMsg::GetMsgType ()))
         {
-          Ptr<MapRegisterMsg> msg = MapRegisterMsg::Deserialize (buf);
-          Ptr<MapReplyRecord> record = msg->GetRecord ();
-          Ptr<MapEntry> oldEntry;
-          if (record->GetEidAfi () == LispControlMsg::IP)
+          Ptr<MapRegisterMsg> msg = MapRegisterMsg::Deserialize (buf, packet->GetSize ());
+          if (msg == 0)
+            {
+              NS_LOG_WARN ("Truncated Map Register, drop it");
+              continue;
+            }
+          const std::vector<Ptr<MapReplyRecord> > &records = msg->GetRecords ();
+          if (records.empty ())
             {
-              oldEntry = m_mapTablesv4->DatabaseLookup (
-                record->GetEidPrefix ());
+              NS_LOG_WARN ("Map Register without any record, drop it");
+              continue;
             }
-          else if (record->GetEidAfi () == LispControlMsg::IPV6)
+          // Previous state of every registered prefix, needed by proxy mode
+          std::vector<Ptr<MapEntry> > oldEntries;
+          oldEntries.reserve (records.size ());
+          for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = records.begin ();
+               it != records.end (); ++it)
             {
-              oldEntry = m_mapTablesv6->DatabaseLookup (
-                record->GetEidPrefix ());
+              oldEntries.push_back (DatabaseLookup (*it));
             }
           MapServerDdt::PopulateDatabase (msg);
           // check if map register needs a map notification message...
           if (msg->GetM () == 1)
             {
-              // Actually, the following code is almost the same with that using to determine map-request's RLOC
-              // how to refactor these two blocs of code?
+              // A single Map Notify acknowledges all the records of the
+              // Map Register. They have been registered by the same ETR, so
+              // the RLOC of the first one is used to reach it.
               Ptr<MapNotifyMsg> mapNotifyMsg = GenerateMapNotifyMsg (msg);
-              Ptr<MapEntry> entry;
-              if (record->GetEidAfi () == LispControlMsg::IP)
-                {
-                  entry = m_mapTablesv4->DatabaseLookup (
-                    record->GetEidPrefix ());
-                }
-              else if (record->GetEidAfi () == LispControlMsg::IPV6)
-                {
-                  entry = m_mapTablesv6->DatabaseLookup (
-                    record->GetEidPrefix ());
-                }
+              Ptr<MapEntry> entry = DatabaseLookup (records.front ());
               NS_ASSERT_MSG (
                 entry != 0,
                 "Impossible!!!Map Server should be alaways find the RLOC to send Map Notify");
@@ -347,9 +407,10 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
               Ptr<Locator> locator = entry->GetLocators ()->SelectFirsValidRloc ();
               NS_LOG_DEBUG (
                 "Send Map Notify message to ETR " << Ipv4Address::ConvertFrom (locator->GetRlocAddress ()));
-              uint8_t buf[256];
-              mapNotifyMsg->Serialize (buf);
-              Ptr<Packet> packet = Create<Packet> (buf, 256);
+              uint32_t notifySize = std::max<uint32_t> (256, mapNotifyMsg->GetSizeInBytes ());
+              uint8_t notifyBuf[notifySize];
+              mapNotifyMsg->Serialize (notifyBuf);
+              Ptr<Packet> packet = Create<Packet> (notifyBuf, notifySize);
               Simulator::Schedule (Seconds (m_mapServerToXtrDelayVariable->GetValue ()), &MapServerDdt::SendTo, this,
                                    locator->GetRlocAddress (), m_peerPort, packet);
               NS_LOG_DEBUG (
@@ -357,39 +418,33 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
             }
           if (msg->GetP ())
             {
-              Ptr<MapReplyRecord> record = msg->GetRecord ();
-              Ptr<MapEntry> entry;
-              if (record->GetEidAfi () == LispControlMsg::IP)
-                {
-                  entry = m_mapTablesv4->DatabaseLookup (
-                    record->GetEidPrefix ());
-                }
-              else if (record->GetEidAfi () == LispControlMsg::IPV6)
+              for (uint32_t i = 0; i < records.size (); i++)
                 {
-                  entry = m_mapTablesv6->DatabaseLookup (
-                    record->GetEidPrefix ());
-                }
-              entry->SetProxyMode (true);
-              if (oldEntry == 0)
-                {
-                  NS_LOG_DEBUG ("Create entry in proxy mode.");
-                  m_subscribeList->CreateEntry (record->GetEidPrefix ());
-                }
-              else
-                {
-                  NS_LOG_DEBUG ("Updated entry in proxy mode.");
-                  Ptr<SubscribeEntry> subscribeEntry = m_subscribeList->GetEntry (record->GetEidPrefix ());
-                  auto subscribers = subscribeEntry->GetSubscribers ();
-                  for (auto iter = subscribers.begin (); iter != subscribers.end (); iter++)
+                  Ptr<MapReplyRecord> record = records[i];
+                  Ptr<MapEntry> entry = DatabaseLookup (record);
+                  entry->SetProxyMode (true);
+                  if (oldEntries[i] == 0)
+                    {
+                      NS_LOG_DEBUG ("Create entry in proxy mode.");
+                      m_subscribeList->CreateEntry (record->GetEidPrefix ());
+                    }
+                  else
                     {
-                      Locator subscriber = *iter;
-                      NS_LOG_DEBUG ("Sending to '" << Ipv4Address::ConvertFrom (subscriber.GetRlocAddress ()) << "'.");
-                      Ptr<MapNotifyMsg> mapNotify = GenerateMapNotify (0, entry);
-                      uint8_t newBuf[256];
-                      mapNotify->Serialize (newBuf);
-                      Ptr<Packet> reactedPacket = Create<Packet> (newBuf, 256);
-                      Simulator::Schedule (Seconds (m_mapServerToXtrDelayVariable->GetValue ()), &MapServerDdt::SendTo,
-                                           this, subscriber.GetRlocAddress (), m_peerPort, reactedPacket);
+                      NS_LOG_DEBUG ("Updated entry in proxy mode.");
+                      Ptr<SubscribeEntry> subscribeEntry = m_subscribeList->GetEntry (record->GetEidPrefix ());
+                      auto subscribers = subscribeEntry->GetSubscribers ();
+                      for (auto iter = subscribers.begin (); iter != subscribers.end (); iter++)
+                        {
+                          Locator subscriber = *iter;
+                          NS_LOG_DEBUG ("Sending to '" << Ipv4Address::ConvertFrom (subscriber.GetRlocAddress ()) << "'.");
+                          Ptr<MapNotifyMsg> mapNotify = GenerateMapNotify (0, entry);
+                          uint32_t bufSize = mapNotify->GetSizeInBytes ();
+                          uint8_t newBuf[bufSize];
+                          mapNotify->Serialize (newBuf);
+                          Ptr<Packet> reactedPacket = Create<Packet> (newBuf, bufSize);
+                          Simulator::Schedule (Seconds (m_mapServerToXtrDelayVariable->GetValue ()), &MapServerDdt::SendTo,
+                                               this, subscriber.GetRlocAddress (), m_peerPort, reactedPacket);
+                        }
                     }
                 }
             }
@@ -414,9 +469,10 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
               NS_LOG_DEBUG ("Send Negative Map-Reply");
 
               Ptr<MapReplyMsg> mapReply = GenerateNegMapReply (requestMsg);
-              uint8_t newBuf[256];
+              uint32_t bufSize = mapReply->GetSizeInBytes ();
+              uint8_t newBuf[bufSize];
               mapReply->Serialize (newBuf);
-              Ptr<Packet> reactedPacket = Create<Packet> (newBuf, 256);
+              Ptr<Packet> reactedPacket = Create<Packet> (newBuf, bufSize);
               Simulator::Schedule (Seconds (m_mappingSystemRttVariable->GetValue ()), &MapServerDdt::SendTo,
                                    this, requestMsg->GetItrRlocAddrIp (), m_peerPort, reactedPacket);
             }
@@ -424,7 +480,7 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
             {
               if (entry->IsProxyMode ())
                 {
-                  uint8_t newBuf[256];
+                  Ptr<Packet> reactedPacket;
                   Address destination;
 
                   if (requestMsg->GetI () && record->GetN ())
@@ -443,22 +499,30 @@ MapServerDdt::HandleReadFromClient (Ptr<Socket> socket)
                               destination = requestMsg->GetItrRlocAddrIp ();
                             }
                           Ptr<MapNotifyMsg> mapNotify = GenerateMapNotify (requestMsg->GetNonce (), entry);
+                          uint32_t bufSize = mapNotify->GetSizeInBytes ();
+                          uint8_t newBuf[bufSize];
                           mapNotify->Serialize (newBuf);
+                          reactedPacket = Create<Packet> (newBuf, bufSize);
                         }
                       else
                         {
                           destination = requestMsg->GetItrRlocAddrIp ();
                           Ptr<MapReplyMsg> mapReply = GenerateMapReply (requestMsg, entry);
+                          uint32_t bufSize = mapReply->GetSizeInBytes ();
+                          uint8_t newBuf[bufSize];
                           mapReply->Serialize (newBuf);
+                          reactedPacket = Create<Packet> (newBuf, bufSize);
                         }
                     }
                   else
                     {
                       destination = requestMsg->GetItrRlocAddrIp ();
                       Ptr<MapReplyMsg> mapReply = GenerateMapReply (requestMsg, entry);
+                      uint32_t bufSize = mapReply->GetSizeInBytes ();
+                      uint8_t newBuf[bufSize];
                       mapReply->Serialize (newBuf);
+                      reactedPacket = Create<Packet> (newBuf, bufSize);
                     }
-                  Ptr<Packet> reactedPacket = Create<Packet> (newBuf, 256);
                   Simulator::Schedule (Seconds (m_mappingSystemRttVariable->GetValue ()), &MapServerDdt::SendTo,
                                        this, destination, m_peerPort, reactedPacket);
                 }
@@ -525,7 +589,6 @@ MapServerDdt::GenerateNegMapReply (Ptr<MapRequestMsg> requestMsg)
 {
   Ptr<MapReplyMsg> mapReply = Create<MapReplyMsg>();
   mapReply->SetNonce (requestMsg->GetNonce ());
-  mapReply->SetRecordCount (1);
 
   // Record (with no locators)
   Ptr<MapReplyRecord> replyRecord = Create<MapReplyRecord>();
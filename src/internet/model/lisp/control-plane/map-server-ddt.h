@@ -31,6 +31,8 @@
 #include "ns3/map-notify-msg.h"
 #include "ns3/event-id.h"
 
+#include <map>
+
 namespace ns3 {
 
 class LispEtrItrApplication;
@@ -70,13 +72,29 @@ private:
   virtual void HandleReadFromClient (Ptr<Socket> socket);
 
   virtual void PopulateDatabase (Ptr<MapRegisterMsg> msg);
+  void PopulateDatabase (Ptr<MapReplyRecord> record);
+  /**
+   * \brief Look up the database entry registered for the EID-prefix of
+   * \p record, in the table matching its address family.
+   */
+  Ptr<MapEntry> DatabaseLookup (Ptr<MapReplyRecord> record);
 
   virtual Ptr<MapReplyMsg> GenerateNegMapReply (Ptr<MapRequestMsg> requestMsg);
   virtual Ptr<InfoRequestMsg> GenerateInfoReplyMsg (Ptr<InfoRequestMsg> msg, uint16_t port, Address address, Address msAddress);
 
+  /**
+   * \brief Remove a registration which was not refreshed within its
+   * Record TTL.
+   * \param eidPrefix The EID-prefix of the registration.
+   * \param maskLength The length of the EID-prefix.
+   */
+  void ExpireRegistration (Address eidPrefix, uint8_t maskLength);
+
   Ptr<MapTables> m_mapTablesv4;
   Ptr<MapTables> m_mapTablesv6;
   Ptr<SubscribeList> m_subscribeList;
+  /// (EID-prefix, mask length) -> expiry of the registrations with a finite Record TTL
+  std::map<std::pair<Address, uint8_t>, EventId> m_registrationExpiry;
 };
 
 
@@ -177,37 +177,67 @@ int LispMappingSocket::SendTo (Ptr<Packet> p, uint32_t flags,
 {
   NS_LOG_FUNCTION (this << p << flags << toAddress);
 
+  Ptr<LispMappingSocket> destSocket = GetDestSocket (toAddress);
+  if (destSocket == 0)
+    {
+      return -1;
+    }
+  Address fromAddress = static_cast<Address> (MappingSocketAddress ());
+  GetSockName (fromAddress);
+  destSocket->Forward (p, fromAddress);
+  return 0;
+}
+
+int LispMappingSocket::SendMsg (const MappingSocketMsgHeader &header,
+                                Ptr<MappingSocketMsg> msg)
+{
+  return SendMsgTo (header, msg, m_destAddres);
+}
+
+int LispMappingSocket::SendMsgTo (const MappingSocketMsgHeader &header,
+                                  Ptr<MappingSocketMsg> msg,
+                                  const Address &toAddress)
+{
+  NS_LOG_FUNCTION (this << toAddress);
+
+  Ptr<LispMappingSocket> destSocket = GetDestSocket (toAddress);
+  if (destSocket == 0)
+    {
+      return -1;
+    }
+  Address fromAddress = static_cast<Address> (MappingSocketAddress ());
+  GetSockName (fromAddress);
+  destSocket->ForwardMsg (header, msg, fromAddress);
+  return 0;
+}
+
+Ptr<LispMappingSocket> LispMappingSocket::GetDestSocket (const Address &toAddress)
+{
   if (!m_connected)
     {
       NS_LOG_LOGIC ("ERROR_BADF");
       m_errno = ERROR_BADF;
-      return -1;
+      return 0;
     }
   if (m_shutdownSend)
     {
       NS_LOG_LOGIC ("ERROR_SHUTDOWN");
       m_errno = ERROR_SHUTDOWN;
-      return -1;
+      return 0;
     }
   if (!MappingSocketAddress::IsMatchingType (toAddress))
     {
       NS_LOG_LOGIC ("ERROR_AFNOSUPPORT");
       m_errno = ERROR_AFNOSUPPORT;
-      return -1;
+      return 0;
     }
   MappingSocketAddress address = MappingSocketAddress::ConvertFrom (toAddress);
   uint8_t sockIndex = address.GetSockIndex ();
-  NS_LOG_DEBUG ("Send a packet to: " << address << ", address Socket Index is: " << unsigned(sockIndex));
-
-
-  Address fromAddress = static_cast<Address> (MappingSocketAddress ());
-  GetSockName (fromAddress);
-  Ptr<LispMappingSocket> destSocket = m_lisp->GetMappingSocket (sockIndex);
-  destSocket->Forward (p, fromAddress);
-  return 0;
+  NS_LOG_DEBUG ("Send to: " << address << ", address Socket Index is: " << unsigned(sockIndex));
+  return m_lisp->GetMappingSocket (sockIndex);
 }
 
-std::queue<Ptr<Packet> > LispMappingSocket::GetDeliveryQueue (void)
+const std::queue<Ptr<Packet> > &LispMappingSocket::GetDeliveryQueue (void) const
 {
   return m_deliveryQueue;
 }
@@ -295,6 +325,12 @@ void LispMappingSocket::SetSockIndex (uint8_t sockIndex)
   m_lispSockIndex = sockIndex;
 }
 
+void LispMappingSocket::SetRecvMsgCallback (MsgCallback msgCallback)
+{
+  NS_LOG_FUNCTION (this);
+  m_recvMsgCallback = msgCallback;
+}
+
 void LispMappingSocket::Forward (Ptr<const Packet> packet, const Address &from)
 {
   NS_LOG_FUNCTION (this << packet << from);
@@ -313,6 +349,28 @@ void LispMappingSocket::Forward (Ptr<const Packet> packet, const Address &from)
     }
 }
 
+void LispMappingSocket::ForwardMsg (const MappingSocketMsgHeader &header,
+                                    Ptr<MappingSocketMsg> msg, const Address &from)
+{
+  NS_LOG_FUNCTION (this << from);
+
+  if (m_shutdownRecv)
+    {
+      return;
+    }
+  if (!m_recvMsgCallback.IsNull ())
+    {
+      m_recvMsgCallback (this, header, msg);
+      return;
+    }
+  // No fast channel on this end (e.g. DHCP client): fall back on packets.
+  uint8_t buf[256];
+  msg->Serialize (buf);
+  Ptr<Packet> packet = Create<Packet> (buf, 256);
+  packet->AddHeader (header);
+  Forward (packet, from);
+}
+
 uint32_t LispMappingSocket::GetRcvBufSize (void) const
 {
   return m_rcvBufSize;
@@ -126,6 +126,16 @@ public:
     MAPA_RLOC = 0x4    //!< MAPA_RLOC
   };
 
+  /**
+   * \brief Callback used by the in-process fast channel.
+   *
+   * The callback receives the socket, the mapping socket message header
+   * and the message body. Since both ends of a mapping socket always live
+   * on the same node, the message does not need to be serialized into a
+   * packet.
+   */
+  typedef Callback<void, Ptr<LispMappingSocket>, const MappingSocketMsgHeader &, Ptr<MappingSocketMsg> > MsgCallback;
+
   /**
    * \brief Set the node associated with this socket.
    * \param node node to set
@@ -166,12 +176,44 @@ public:
 
   void SetSockIndex (uint8_t sockIndex);
 
+  /**
+   * \brief Register the fast channel receive callback.
+   *
+   * If set, messages sent with SendMsg/SendMsgTo are delivered directly
+   * to this callback. Otherwise, they are serialized into a packet and
+   * queued for Recv, as done by Send/SendTo.
+   *
+   * \param msgCallback The callback (a null callback disables the fast channel)
+   */
+  void SetRecvMsgCallback (MsgCallback msgCallback);
+
+  /**
+   * \brief Send a message to the connected peer without serializing it.
+   * \param header The mapping socket message header
+   * \param msg The mapping socket message body
+   * \return 0 on success, -1 on error (errno is set)
+   */
+  int SendMsg (const MappingSocketMsgHeader &header, Ptr<MappingSocketMsg> msg);
+
+  /**
+   * \brief Send a message to the given mapping socket without serializing it.
+   * \param header The mapping socket message header
+   * \param msg The mapping socket message body
+   * \param toAddress The MappingSocketAddress of the destination socket
+   * \return 0 on success, -1 on error (errno is set)
+   */
+  int SendMsgTo (const MappingSocketMsgHeader &header, Ptr<MappingSocketMsg> msg,
+                 const Address &toAddress);
+
   uint32_t GetRcvBufSize (void) const;
   void SetRcvBufSize (uint32_t rcvBufSize);
 
 private:
-  std::queue<Ptr<Packet> >GetDeliveryQueue (void);
+  const std::queue<Ptr<Packet> > &GetDeliveryQueue (void) const;
+  Ptr<LispMappingSocket> GetDestSocket (const Address &toAddress);
   void Forward (Ptr<const Packet> packet, const Address &from);
+  void ForwardMsg (const MappingSocketMsgHeader &header, Ptr<MappingSocketMsg> msg,
+                   const Address &from);
   Ptr<LispOverIp> m_lisp;       //!< The associated LISP protocol
   Address m_destAddres;         //!< The destination address
   uint8_t m_lispSockIndex;      //!< The index assigned to this socket
@@ -183,6 +225,7 @@ private:
   std::queue<Ptr<Packet> > m_deliveryQueue;     //!< Packet waiting to be processed.
   uint32_t m_rxAvailable;       //!< Number of available bytes to be received
   uint32_t m_rcvBufSize;        //!< receive buffer size
+  MsgCallback m_recvMsgCallback; //!< fast channel receive callback
 
 
 };
@@ -27,6 +27,7 @@
 #include "lisp-mapping-socket-factory.h"
 #include "lisp-mapping-socket.h"
 #include "simple-map-tables.h"
+#include "locators-impl.h"
 #include "ns3/string.h"
 
 namespace ns3 {
@@ -355,7 +356,7 @@ LispOverIp::SelectSourceRloc (Address const &srcEid,
   else
     {
       NS_LOG_ERROR ("No valid source RLOC is found!");
-      NS_LOG_DEBUG ("Currently, the mapping database's content: " << *m_mapTablesIpv4);
+      NS_LOG_SAMPLED (LOG_DEBUG, 100, "Currently, the mapping database's content: " << *m_mapTablesIpv4);
     }
   return srcRloc;
 }
@@ -385,6 +386,8 @@ LispOverIp::OpenLispMappingSocket (void)
   m_lispSocket->Bind (m_lispAddress);
   m_lispSocket->SetRecvCallback (
     MakeCallback (&LispOverIp::HandleMapSockRead, this));
+  DynamicCast<LispMappingSocket> (m_lispSocket)->SetRecvMsgCallback (
+    MakeCallback (&LispOverIp::HandleMapSockMsg, this));
   NS_LOG_DEBUG ("Bind to " << m_lispAddress);
 }
 
@@ -402,249 +405,263 @@ LispOverIp::HandleMapSockRead (Ptr<Socket> socket)
       uint8_t buf[packet->GetSize ()];
       packet->CopyData (buf, packet->GetSize ());
       Ptr<MappingSocketMsg> msg = MappingSocketMsg::Deserialize (buf);
-      NS_LOG_DEBUG ("MSG HEADER " << sockMsgHdr);
-      if (sockMsgHdr.GetMapType ()
-          == static_cast<uint16_t> (LispMappingSocket::MAPM_ADD))
-        {
-          //TODO: extract the following code and write it as an function
-          // Both MAPM_ADD and MAPM_UPDATE will use the same code.
-          NS_LOG_DEBUG (
-            "ADD Message received on lisp (" << msg->GetEndPointId ()->Print () << ") \n" << msg->GetLocators ()->Print ());
-          Ptr<EndpointId> eid = msg->GetEndPointId ();
+      HandleMapSockMsg (DynamicCast<LispMappingSocket> (socket), sockMsgHdr, msg);
+    }
+}
 
-          /* Check if wild card entry. If so, this means the LISP device is NATed */
-          if (eid->GetIpv4Mask ().IsEqual (Ipv4Mask ("/0")))
-            {
-              NS_LOG_DEBUG ("Wild card entry detected -> LISP device is NATed");
-              SetNated (true);
+void
+LispOverIp::HandleMapSockMsg (Ptr<LispMappingSocket> socket,
+                              const MappingSocketMsgHeader &sockMsgHdr,
+                              Ptr<MappingSocketMsg> msg)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("MSG HEADER " << sockMsgHdr);
+  if (sockMsgHdr.GetMapType ()
+      == static_cast<uint16_t> (LispMappingSocket::MAPM_ADD))
+    {
+      //TODO: extract the following code and write it as an function
+      // Both MAPM_ADD and MAPM_UPDATE will use the same code.
+      NS_LOG_DEBUG (
+        "ADD Message received on lisp (" << msg->GetEndPointId ()->Print () << ") \n" << msg->GetLocators ()->Print ());
+      Ptr<EndpointId> eid = msg->GetEndPointId ();
 
-              // Delete any previous entry in the cache
-              m_mapTablesIpv4->WipeCache ();
-            }
+      /* Check if wild card entry. If so, this means the LISP device is NATed */
+      if (eid->GetIpv4Mask ().IsEqual (Ipv4Mask ("/0")))
+        {
+          NS_LOG_DEBUG ("Wild card entry detected -> LISP device is NATed");
+          SetNated (true);
 
-          Ptr<MapEntry> mapEntry = Create<MapEntryImpl> ();
-          Ptr<Locators> locators;
-          mapEntry->SetEidPrefix (eid);
-          if ((int) sockMsgHdr.GetMapFlags () & (int) LispMappingSocket::MAPF_NEGATIVE)
-            {
-              NS_LOG_DEBUG ("MAP ENTRY is negative!");
-              mapEntry->setIsNegative (1);
-            }
-          else
-            {
-              NS_LOG_DEBUG ("Setting Is Local If to 0!");
-              locators = msg->GetLocators ();
-              for (int i = 0; i < locators->GetNLocators (); ++i)
-                {
-                  Ptr<Locator> locator = locators->GetLocatorByIdx (i);
-                  locator->GetRlocMetrics ()->SetIsLocalIf (0);
-                }
-              mapEntry->setIsNegative (0);
-              mapEntry->SetLocators (locators);
-            }
-          if (eid->IsIpv4 ())
-            {
-              // In the case of cache update, we should first delete the previous one containing EID-prefix
-              // This work is done by SetEntry method!
-              m_mapTablesIpv4->SetEntry (eid->GetEidAddress (),
-                                         eid->GetIpv4Mask (), mapEntry,
-                                         MapTables::IN_CACHE);
-              NS_LOG_DEBUG (
-                "Ipv4 Map Entry IPv4 (Extracted from Map Reply Message) has been saved in cache database by LispOverIp");
-            }
-          else
+          // Delete any previous entry in the cache
+          m_mapTablesIpv4->WipeCache ();
+        }
+
+      Ptr<MapEntry> mapEntry = Create<MapEntryImpl> ();
+      Ptr<Locators> locators;
+      mapEntry->SetEidPrefix (eid);
+      if ((int) sockMsgHdr.GetMapFlags () & (int) LispMappingSocket::MAPF_NEGATIVE)
+        {
+          NS_LOG_DEBUG ("MAP ENTRY is negative!");
+          mapEntry->setIsNegative (1);
+        }
+      else
+        {
+          NS_LOG_DEBUG ("Setting Is Local If to 0!");
+          // The message is shared with the sender and the other receivers:
+          // the cache gets its own copy of the locators.
+          Ptr<Locators> msgLocators = msg->GetLocators ();
+          locators = Create<LocatorsImpl> ();
+          for (int i = 0; i < msgLocators->GetNLocators (); ++i)
             {
-              m_mapTablesIpv6->SetEntry (eid->GetEidAddress (),
-                                         eid->GetIpv6Prefix (), mapEntry,
-                                         MapTables::IN_CACHE);
-              NS_LOG_DEBUG (
-                "Ipv4 Map Entry IPv6 (Extracted from Map Reply Message) has been saved in cache database by LispOverIp");
+              Ptr<Locator> msgLocator = msgLocators->GetLocatorByIdx (i);
+              Ptr<Locator> locator = Create<Locator> (msgLocator->GetRlocAddress ());
+              Ptr<RlocMetrics> metrics = Create<RlocMetrics> (*msgLocator->GetRlocMetrics ());
+              metrics->SetIsLocalIf (0);
+              locator->SetRlocMetrics (metrics);
+              locators->InsertLocator (locator);
             }
+          mapEntry->setIsNegative (0);
+          mapEntry->SetLocators (locators);
         }
-      else if (sockMsgHdr.GetMapType ()
-               == static_cast<uint16_t> (LispMappingSocket::MAPM_DELETE))
+      mapEntry->SetVersionNumber (sockMsgHdr.GetMapVersioning ());
+      if (eid->IsIpv4 ())
         {
+          // In the case of cache update, the entry already in cache is updated
+          // in place. This work is done by SetEntry method!
+          m_mapTablesIpv4->SetEntry (eid->GetEidAddress (),
+                                     eid->GetIpv4Mask (), mapEntry,
+                                     MapTables::IN_CACHE);
+          NS_LOG_DEBUG (
+            "Ipv4 Map Entry IPv4 (Extracted from Map Reply Message) has been saved in cache database by LispOverIp");
+        }
+      else
+        {
+          m_mapTablesIpv6->SetEntry (eid->GetEidAddress (),
+                                     eid->GetIpv6Prefix (), mapEntry,
+                                     MapTables::IN_CACHE);
+          NS_LOG_DEBUG (
+            "Ipv4 Map Entry IPv6 (Extracted from Map Reply Message) has been saved in cache database by LispOverIp");
+        }
+    }
+  else if (sockMsgHdr.GetMapType ()
+           == static_cast<uint16_t> (LispMappingSocket::MAPM_DELETE))
+    {
+
+    }
+  else if (sockMsgHdr.GetMapType ()
+           == static_cast<uint16_t> (LispMappingSocket::MAPM_GET))
+    {
 
+    }
+  else if (sockMsgHdr.GetMapType ()
+           == static_cast<uint16_t> (LispMappingSocket::MAPM_NAT))
+    {
+      NS_LOG_DEBUG ("MAPM_NAT received in LispOverIp: SetNated(false)");
+      SetNated (false);
+      /* Remove wild card entry if any */
+      m_mapTablesIpv4->CacheDelete (Ipv4Address ("0.0.0.0"));
+    }
+  else if (sockMsgHdr.GetMapType ()
+           == static_cast<uint16_t> (LispMappingSocket::MAPM_ISREGISTERED))
+    {
+      NS_LOG_DEBUG ("MAPM_ISREGISTERED received in LispOverIp");
+      //MAPA_EID used to say that LISP device is registered.
+      //MAPA_EIDMASK is used to say that LISP device is NOT registered.
+      if ( (int) sockMsgHdr.GetMapAddresses () == (int) LispMappingSocket::MAPA_EID)
+        {
+          NS_LOG_DEBUG ("LISP device is registered to the MDS");
+          m_registered = true;
         }
-      else if (sockMsgHdr.GetMapType ()
-               == static_cast<uint16_t> (LispMappingSocket::MAPM_GET))
+      else
         {
+          NS_LOG_DEBUG ("LISP device is NOT registered to the MDS");
+          m_registered = false;
+        }
 
+    }
+  else if (sockMsgHdr.GetMapType () == static_cast<uint16_t> (LispMappingSocket::MAPM_DATABASE_UPDATE))
+    {
+      /**
+       * TODO: Notify to xTR to send a new Map-Register message.
+       * In this case, first check whether the received EID is in the database.
+       * If yes => update the map entry
+       * If no => add the map entry.
+       * Maybe we can use another solution:
+       * 1) if DHCP client detect link state change
+       * (e.g. during mobility, the wifi link is temporarily lost), DHCP has no
+       * IP address (RLOC). Trigger a MAPM_DELETE message to flush LISP-MN database
+       * 10-07-2017: The answer is no. Since flush LISP-MN database cannot update map version number!
+       * (how to treat Cache?=> Never touch Cache! Since it is the only place we
+       * know to which it communicate!! if cache is not flushed. It is OK if we have
+       * cache but no database? or database is empty?)
+       */
+      NS_LOG_DEBUG (
+        "Update or Add one mapping (" << msg->GetEndPointId ()->Print () << ") \n" << msg->GetLocators ()->Print ());
+      Ptr<EndpointId> eid = msg->GetEndPointId ();
+      Ptr<MapEntry> mapEntry = Create<MapEntryImpl> ();
+      Ptr<Locators> locators = msg->GetLocators ();
+      mapEntry->SetEidPrefix (eid);
+      /* MAPM_DATABASE_UPDATE is only sent dy DHCP client when receiving a new LRLOC.
+       *
+       * We need an additional MapEntry in database for encapsulation (in case of NAT).
+       * This additional MapEntry is equivalent to the config file where we add:
+       * <if-address-v4>  192.168.1.1 </if-address-v4>
+       * <entry>
+       * <eid-v4>  192.168.1.0 255.255.255.0 0 </eid-v4>
+       * <rloc-v4> 192.168.1.1 200 30  1 </rloc-v4>
+       * </entry>
+       */
+      Ptr<MapEntry> mapEntryEncap = Create<MapEntryImpl> ();
+
+      if ((int) sockMsgHdr.GetMapFlags ()
+          & (int) LispMappingSocket::MAPF_NEGATIVE)
+        {
+          NS_LOG_DEBUG ("MAP ENTRY is negative!");
+          mapEntry->setIsNegative (1);
         }
-      else if (sockMsgHdr.GetMapType ()
-               == static_cast<uint16_t> (LispMappingSocket::MAPM_NAT))
+      else
         {
-          NS_LOG_DEBUG ("MAPM_NAT received in LispOverIp: SetNated(false)");
-          SetNated (false);
-          /* Remove wild card entry if any */
-          m_mapTablesIpv4->CacheDelete (Ipv4Address ("0.0.0.0"));
+          mapEntry->setIsNegative (0);
+          mapEntry->SetLocators (locators);
+
+          mapEntryEncap->SetEidPrefix (
+            Create<EndpointId> (locators->GetLocatorByIdx (0)->GetRlocAddress (), Ipv4Mask ("/32")));
+          mapEntryEncap->setIsNegative (0);
+          mapEntryEncap->SetLocators (locators);
         }
-      else if (sockMsgHdr.GetMapType ()
-               == static_cast<uint16_t> (LispMappingSocket::MAPM_ISREGISTERED))
+      /* Get current (MN EID -> LRLOC) mapping */
+      Ptr<MapEntry> curEidMapEntry = LispOverIp::DatabaseLookup (eid->GetEidAddress ());
+      if (curEidMapEntry != 0)
         {
-          NS_LOG_DEBUG ("MAPM_ISREGISTERED received in LispOverIp");
-          //MAPA_EID used to say that LISP device is registered.
-          //MAPA_EIDMASK is used to say that LISP device is NOT registered.
-          if ( (int) sockMsgHdr.GetMapAddresses () == (int) LispMappingSocket::MAPA_EID)
-            {
-              NS_LOG_DEBUG ("LISP device is registered to the MDS");
-              m_registered = true;
-            }
-          else
-            {
-              NS_LOG_DEBUG ("LISP device is NOT registered to the MDS");
-              m_registered = false;
-            }
+          Address curRlocAddr = curEidMapEntry->GetLocators ()->GetLocatorByIdx (0)->GetRlocAddress ();
+          /* Erase previous (LRLOC -> LRLOC) mapping */
+          LispOverIp::DatabaseDelete (curRlocAddr);
+        }
 
+      if (eid->IsIpv4 ())
+        {
+          //TODO: to verify if map data structure supports add (or update) manipulation.
+          // This is important cause DHCP will periodically received offered @IP.
+          // If two different RLOCs, how to treat it?
+          // 07-10-2017: DHCP client should guarantee that the newly assigned @IP is different from previous one
+          // In the case of cache update, we should first delete the previous one containing EID-prefix
+          // This work is done by SetEntry method!
+
+          /* Add new (MN EID -> LRLOC) mapping */
+          m_mapTablesIpv4->SetEntry (
+            eid->GetEidAddress (),
+            eid->GetIpv4Mask (),
+            mapEntry,
+            MapTables::IN_DATABASE);
+          /* Add new (LRLOC -> LRLOC) mapping */
+          m_mapTablesIpv4->SetEntry (
+            mapEntryEncap->GetEidPrefix ()->GetEidAddress (),
+            mapEntryEncap->GetEidPrefix ()->GetIpv4Mask (),
+            mapEntryEncap,
+            MapTables::IN_DATABASE);
+          NS_LOG_DEBUG (
+            "Ipv4 Map Entry IPv4 (Received from DHCP client) has been saved in database by LispOverIp");
+          NS_LOG_DEBUG ("After message from DHCP to LISP, LISP Database now: \n" << *(LispOverIp::GetMapTablesV4 ()));
         }
-      else if (sockMsgHdr.GetMapType () == static_cast<uint16_t> (LispMappingSocket::MAPM_DATABASE_UPDATE))
+      else
         {
-          /**
-           * TODO: Notify to xTR to send a new Map-Register message.
-           * In this case, first check whether the received EID is in the database.
-           * If yes => update the map entry
-           * If no => add the map entry.
-           * Maybe we can use another solution:
-           * 1) if DHCP client detect link state change
-           * (e.g. during mobility, the wifi link is temporarily lost), DHCP has no
-           * IP address (RLOC). Trigger a MAPM_DELETE message to flush LISP-MN database
-           * 10-07-2017: The answer is no. Since flush LISP-MN database cannot update map version number!
-           * (how to treat Cache?=> Never touch Cache! Since it is the only place we
-           * know to which it communicate!! if cache is not flushed. It is OK if we have
-           * cache but no database? or database is empty?)
-           */
+          m_mapTablesIpv6->SetEntry (eid->GetEidAddress (),
+                                     eid->GetIpv6Prefix (), mapEntry,
+                                     MapTables::IN_DATABASE);
           NS_LOG_DEBUG (
-            "Update or Add one mapping (" << msg->GetEndPointId ()->Print () << ") \n" << msg->GetLocators ()->Print ());
-          Ptr<EndpointId> eid = msg->GetEndPointId ();
-          Ptr<MapEntry> mapEntry = Create<MapEntryImpl> ();
-          Ptr<Locators> locators = msg->GetLocators ();
-          mapEntry->SetEidPrefix (eid);
-          /* MAPM_DATABASE_UPDATE is only sent dy DHCP client when receiving a new LRLOC.
-           *
-           * We need an additional MapEntry in database for encapsulation (in case of NAT).
-           * This additional MapEntry is equivalent to the config file where we add:
-           * <if-address-v4>  192.168.1.1 </if-address-v4>
-           * <entry>
-           * <eid-v4>  192.168.1.0 255.255.255.0 0 </eid-v4>
-           * <rloc-v4> 192.168.1.1 200 30  1 </rloc-v4>
-           * </entry>
-           */
-          Ptr<MapEntry> mapEntryEncap = Create<MapEntryImpl> ();
-
-          if ((int) sockMsgHdr.GetMapFlags ()
-              & (int) LispMappingSocket::MAPF_NEGATIVE)
-            {
-              NS_LOG_DEBUG ("MAP ENTRY is negative!");
-              mapEntry->setIsNegative (1);
-            }
-          else
-            {
-              mapEntry->setIsNegative (0);
-              mapEntry->SetLocators (locators);
-
-              mapEntryEncap->SetEidPrefix (
-                Create<EndpointId> (locators->GetLocatorByIdx (0)->GetRlocAddress (), Ipv4Mask ("/32")));
-              mapEntryEncap->setIsNegative (0);
-              mapEntryEncap->SetLocators (locators);
-            }
-          /* Get current (MN EID -> LRLOC) mapping */
-          Ptr<MapEntry> curEidMapEntry = LispOverIp::DatabaseLookup (eid->GetEidAddress ());
-          if (curEidMapEntry != 0)
+            "Ipv4 Map Entry IPv6 (Received from DHCP client) has been saved in database by LispOverIp");
+        }
+      /**
+       * IMPORTANT: To support LISP-MN.
+       * 1) Send a signal (MAPM_REGISTER) to xTR application so that xTR send map register again
+       * 2) Delete the previously assigned RLOC IP address (by DHCP server) in m_rlocsList attribute
+       * of lispOverIpv4 object. This attribute is previously set by lispHelper class.
+       * 3) Add the newly obtained RLOC IP address into m_rlocsList
+       *
+       * TODO: Current implementation does not support empty message content.
+       * Otherwise error occurs. Should consider this!
+       */
+      Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg> ();
+      MappingSocketMsgHeader mapSockHeader;
+      mapSockMsg->SetEndPoint (eid);
+      mapSockMsg->SetLocators (msg->GetLocators ());
+      mapSockHeader.SetMapType (LispMappingSocket::MAPM_REGISTER);
+      uint8_t messageType = static_cast<uint8_t> (LispMappingSocket::MAPM_REGISTER);
+
+
+      // Normally the received EID-RLOC mapping contains just one RLOC.
+      // If more than one RLOCs, it is anormal!! First delete the RLOC in
+      // m_rlocsList then add the newly assigned RLOC into it.
+      NS_ASSERT (msg->GetLocators ()->GetNLocators () == 1);
+
+      // Is necessary to delete the previously RLOC? What's the hurt?
+      // What if EID has two RLOCs assigned? which one to delete?
+//	    Ptr<MapEntry> curEidMapEntry = LispOverIp::DatabaseLookup(eid->GetEidAddress());
+//	    Address curRlocAddr = curEidMapEntry->GetLocators()->GetLocatorByIdx(0)->GetRlocAddress();
+//	    m_rlocsList.erase(curRlocAddr);
+      Address rlocAddr = msg->GetLocators ()->GetLocatorByIdx (0)->GetRlocAddress ();
+      m_rlocsList.insert (rlocAddr);
+      for (std::set<Address>::const_iterator it = m_rlocsList.begin (); it != m_rlocsList.end (); ++it)
+        {
+          if (Ipv4Address::IsMatchingType (*it))
             {
-              Address curRlocAddr = curEidMapEntry->GetLocators ()->GetLocatorByIdx (0)->GetRlocAddress ();
-              /* Erase previous (LRLOC -> LRLOC) mapping */
-              LispOverIp::DatabaseDelete (curRlocAddr);
+              NS_LOG_DEBUG ("RLOC list item: " << Ipv4Address::ConvertFrom (*it));
             }
-
-          if (eid->IsIpv4 ())
+          else if (Ipv6Address::IsMatchingType (*it))
             {
-              //TODO: to verify if map data structure supports add (or update) manipulation.
-              // This is important cause DHCP will periodically received offered @IP.
-              // If two different RLOCs, how to treat it?
-              // 07-10-2017: DHCP client should guarantee that the newly assigned @IP is different from previous one
-              // In the case of cache update, we should first delete the previous one containing EID-prefix
-              // This work is done by SetEntry method!
-
-              /* Add new (MN EID -> LRLOC) mapping */
-              m_mapTablesIpv4->SetEntry (
-                eid->GetEidAddress (),
-                eid->GetIpv4Mask (),
-                mapEntry,
-                MapTables::IN_DATABASE);
-              /* Add new (LRLOC -> LRLOC) mapping */
-              m_mapTablesIpv4->SetEntry (
-                mapEntryEncap->GetEidPrefix ()->GetEidAddress (),
-                mapEntryEncap->GetEidPrefix ()->GetIpv4Mask (),
-                mapEntryEncap,
-                MapTables::IN_DATABASE);
-              NS_LOG_DEBUG (
-                "Ipv4 Map Entry IPv4 (Received from DHCP client) has been saved in database by LispOverIp");
-              NS_LOG_DEBUG ("After message from DHCP to LISP, LISP Database now: \n" << *(LispOverIp::GetMapTablesV4 ()));
+              NS_LOG_DEBUG ("RLOC list item: " << Ipv6Address::ConvertFrom (*it));
             }
           else
             {
-              m_mapTablesIpv6->SetEntry (eid->GetEidAddress (),
-                                         eid->GetIpv6Prefix (), mapEntry,
-                                         MapTables::IN_DATABASE);
-              NS_LOG_DEBUG (
-                "Ipv4 Map Entry IPv6 (Received from DHCP client) has been saved in database by LispOverIp");
-            }
-          /**
-           * IMPORTANT: To support LISP-MN.
-           * 1) Send a signal (MAPM_REGISTER) to xTR application so that xTR send map register again
-           * 2) Delete the previously assigned RLOC IP address (by DHCP server) in m_rlocsList attribute
-           * of lispOverIpv4 object. This attribute is previously set by lispHelper class.
-           * 3) Add the newly obtained RLOC IP address into m_rlocsList
-           *
-           * TODO: Current implementation does not support empty message content.
-           * Otherwise error occurs. Should consider this!
-           */
-          uint8_t buf[256];
-          Ptr<MappingSocketMsg> mapSockMsg = Create<MappingSocketMsg> ();
-          MappingSocketMsgHeader mapSockHeader;
-          mapSockMsg->SetEndPoint (eid);
-          mapSockMsg->SetLocators (msg->GetLocators ());
-          mapSockMsg->Serialize (buf);
-          mapSockHeader.SetMapType (LispMappingSocket::MAPM_REGISTER);
-          Ptr<Packet> packet = Create<Packet> (buf, 100);
-          uint8_t messageType = static_cast<uint8_t> (LispMappingSocket::MAPM_REGISTER);
-
-
-          // Normally the received EID-RLOC mapping contains just one RLOC.
-          // If more than one RLOCs, it is anormal!! First delete the RLOC in
-          // m_rlocsList then add the newly assigned RLOC into it.
-          NS_ASSERT (msg->GetLocators ()->GetNLocators () == 1);
-
-          // Is necessary to delete the previously RLOC? What's the hurt?
-          // What if EID has two RLOCs assigned? which one to delete?
-//	    Ptr<MapEntry> curEidMapEntry = LispOverIp::DatabaseLookup(eid->GetEidAddress());
-//	    Address curRlocAddr = curEidMapEntry->GetLocators()->GetLocatorByIdx(0)->GetRlocAddress();
-//	    m_rlocsList.erase(curRlocAddr);
-          Address rlocAddr = msg->GetLocators ()->GetLocatorByIdx (0)->GetRlocAddress ();
-          m_rlocsList.insert (rlocAddr);
-          for (std::set<Address>::const_iterator it = m_rlocsList.begin (); it != m_rlocsList.end (); ++it)
-            {
-              if (Ipv4Address::IsMatchingType (*it))
-                {
-                  NS_LOG_DEBUG ("RLOC list item: " << Ipv4Address::ConvertFrom (*it));
-                }
-              else if (Ipv6Address::IsMatchingType (*it))
-                {
-                  NS_LOG_DEBUG ("RLOC list item: " << Ipv6Address::ConvertFrom (*it));
-                }
-              else
-                {
-                  NS_LOG_ERROR ("Unknown Address Type...");
-                }
+              NS_LOG_ERROR ("Unknown Address Type...");
             }
-
-          // First populate m_rlocList then send map register message. Otherwise
-          // Lisp data plan will try to find a RLOC for the real RLOC...
-          NS_LOG_DEBUG ("Notify xTR to send map register message.");
-          LispOverIp::SendNotifyMessage (messageType, packet, mapSockHeader,0);
         }
 
+      // First populate m_rlocList then send map register message. Otherwise
+      // Lisp data plan will try to find a RLOC for the real RLOC...
+      NS_LOG_DEBUG ("Notify xTR to send map register message.");
+      LispOverIp::SendNotifyMessage (messageType, mapSockMsg, mapSockHeader, 0);
     }
+
 }
 
 Address
@@ -695,6 +712,27 @@ LispOverIp::SendNotifyMessage (uint8_t messageType, Ptr<Packet> packet,
     }
 }
 
+void
+LispOverIp::SendNotifyMessage (uint8_t messageType, Ptr<MappingSocketMsg> msg,
+                               MappingSocketMsgHeader mapSockMsgHeader,
+                               int flags)
+{
+  NS_LOG_FUNCTION (this << "Message Type: " << unsigned(messageType));
+
+  mapSockMsgHeader.SetMapFlags (flags | LispMappingSocket::MAPF_DONE);
+  Ptr<LispMappingSocket> lispSocket = DynamicCast<LispMappingSocket> (m_lispSocket);
+  NS_LOG_DEBUG ("Send Messages from data plan to control plan: " << m_sockets.size () - 1 << " sockets.");
+  for (uint32_t i = 1; i < m_sockets.size (); ++i)
+    {
+      Address ad = static_cast<Address> (MappingSocketAddress ());
+      m_sockets.at (i)->GetSockName (ad);
+      lispSocket->Connect (ad);
+      lispSocket->SendMsgTo (mapSockMsgHeader, msg, ad);
+      NS_LOG_DEBUG (
+        "Send Notification: " << MappingSocketAddress::ConvertFrom (m_lispAddress) << "-->" << MappingSocketAddress::ConvertFrom (ad));
+    }
+}
+
 void
 LispOverIp::SetRlocsList (const std::set<Address> rlocsList)
 {
@@ -948,6 +986,15 @@ bool LispOverIp::IsMapVersionNumberNewer (uint16_t vnum2, uint16_t vnum1)
     }
 }
 
+uint16_t LispOverIp::GetNextMapVersionNumber (uint16_t vnum)
+{
+  if (vnum >= LispOverIp::MAX_VERSION_NUM)
+    {
+      return LispOverIp::NULL_VERSION_NUM + 1;
+    }
+  return vnum + 1;
+}
+
 void
 LispOverIp::SetPetrAddress (Address address)
 {
@@ -201,6 +201,17 @@ public:
    */
   static bool IsMapVersionNumberNewer (uint16_t vnum2, uint16_t vnum1);
 
+  /**
+   * This method returns the Map-Version number following the one given
+   * as an argument. It wraps around after MAX_VERSION_NUM and never
+   * returns NULL_VERSION_NUM.
+   *
+   * \param vnum The current Map-Version number
+   *
+   * \return The next Map-Version number.
+   */
+  static uint16_t GetNextMapVersionNumber (uint16_t vnum);
+
   /**
    * \brief Constructor
    */
@@ -360,8 +371,36 @@ public:
    * \param socket The socket on which the packet is received.
    */
   void HandleMapSockRead (Ptr<Socket> socket);
+
+  /**
+   * \brief Handle a mapping socket message received from the control plane.
+   *
+   * This is the fast channel counterpart of HandleMapSockRead: the message
+   * is delivered as is, without going through a packet.
+   *
+   * \param socket The socket on which the message is received.
+   * \param sockMsgHdr The mapping socket message header.
+   * \param msg The mapping socket message body.
+   */
+  void HandleMapSockMsg (Ptr<LispMappingSocket> socket, const MappingSocketMsgHeader &sockMsgHdr, Ptr<MappingSocketMsg> msg);
+
   void SendNotifyMessage (uint8_t messageType, Ptr<Packet> packet, MappingSocketMsgHeader mapSockMsgHeader, int flags);
 
+  /**
+   * \brief Notify every control plane application connected to the
+   * data plane.
+   *
+   * Applications that registered a fast channel callback on their
+   * LispMappingSocket receive the message directly; the others receive
+   * it as a serialized packet.
+   *
+   * \param messageType The mapping socket message type
+   * \param msg The mapping socket message body
+   * \param mapSockMsgHeader The mapping socket message header
+   * \param flags The mapping flags to add to the header
+   */
+  void SendNotifyMessage (uint8_t messageType, Ptr<MappingSocketMsg> msg, MappingSocketMsgHeader mapSockMsgHeader, int flags);
+
   /**
    * \brief Set the List of the RLOC addresses of the system.
    * \param rlocsList A set containing all the RLOC addresses of the system.
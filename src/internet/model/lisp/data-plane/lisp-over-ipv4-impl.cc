@@ -128,7 +128,10 @@ void LispOverIpv4Impl::LispOutput (Ptr<Packet> packet, Ipv4Header const &innerHe
   else
     {
       destLocator = SelectDestinationRloc (remoteMapping);
-      NS_LOG_DEBUG ("Destination RLOC address: " << Ipv4Address::ConvertFrom (destLocator->GetRlocAddress ()));
+      if (destLocator != 0)
+        {
+          NS_LOG_DEBUG ("Destination RLOC address: " << Ipv4Address::ConvertFrom (destLocator->GetRlocAddress ()));
+        }
     }
 
   if (destLocator == 0)
@@ -540,7 +543,8 @@ LispOverIpv4::MapStatus LispOverIpv4Impl::IsMapForEncapsulation (Ipv4Header cons
   if (destMapEntry == 0)
     {
       NS_LOG_DEBUG ("[MapForEncap] SOURCE map entry exists but DEST map entry does not !");
-      NS_LOG_DEBUG ("MapTables content:" << *m_mapTablesIpv4);
+      // Every packet to an unresolved EID misses: dump the tables sparingly.
+      NS_LOG_SAMPLED (LOG_DEBUG, 100, "MapTables content:" << *m_mapTablesIpv4);
       Ptr<LispOverIp> lisp = GetNode ()->GetObject<LispOverIp>();
       //NS_LOG_INFO("XXX:"<<*lisp->GetMapTablesV4());
       MappingSocketMsgHeader sockMsgHdr;
@@ -553,12 +557,9 @@ LispOverIpv4::MapStatus LispOverIpv4Impl::IsMapForEncapsulation (Ipv4Header cons
       mapSockMsg->GetEndPointId ()->SetIpv4Mask (Ipv4Mask ("255.255.255.255"));
       mapSockMsg->SetLocators (0);
       NS_LOG_DEBUG ("[MapForEncap] EID not found " << innerHeader.GetDestination ());
-      uint8_t buf[64];
-      mapSockMsg->Serialize (buf);
-      Ptr<Packet> packet = Create<Packet> (buf, 100);
       NS_LOG_DEBUG ("Send Notification to all LISP apps");
 
-      SendNotifyMessage (static_cast<uint8_t> (LispMappingSocket::MAPM_MISS), packet, sockMsgHdr, 0);
+      SendNotifyMessage (static_cast<uint8_t> (LispMappingSocket::MAPM_MISS), mapSockMsg, sockMsgHdr, 0);
       return LispOverIpv4::No_Mapping;
     }
   else if (destMapEntry->IsNegative ())
@@ -650,9 +651,10 @@ bool LispOverIpv4Impl::NeedDecapsulation (Ptr<const Packet> packet, Ipv4Header c
          Control packets that are not ECM encapsulated musn't be decapsulated, obviously */
       else
         {
-          uint8_t buf[p->GetSize ()];
-          p->CopyData (buf, p->GetSize ());
-          uint8_t msg_type = (buf[0] >> 4);
+          // Only the message type is needed: do not copy the payload.
+          uint8_t firstByte = 0;
+          p->CopyData (&firstByte, 1);
+          uint8_t msg_type = (firstByte >> 4);
           if (msg_type == static_cast<uint8_t> (LispEncapsulatedControlMsgHeader::GetMsgType ()))
             {
               NS_LOG_DEBUG ("ECM encapsulated Control packet => Needs decapsulation");
@@ -684,8 +686,13 @@ LispOverIpv4Impl::IsMapNotifyForNatedXtr (Ptr<Packet> packet, Ipv4Header const &
 
   if (msg_type == static_cast<uint8_t> (LispControlMsg::MAP_NOTIFY))
     {
-      Ptr<MapNotifyMsg> mapNotify = MapNotifyMsg::Deserialize (buf);
+      Ptr<MapNotifyMsg> mapNotify = MapNotifyMsg::Deserialize (buf, sizeof (buf));
 
+      if (mapNotify == 0 || mapNotify->GetRecord () == 0)
+        {
+          return false;
+        }
+      /* All the records of a Map-Notify belong to the same xTR */
       Address eid = mapNotify->GetRecord ()->GetEidPrefix ();
       NS_LOG_DEBUG ("MapNotify for EID: " << eid);
 
@@ -781,11 +788,10 @@ LispOverIpv4Impl::ChangeItrRloc (Ptr<Packet> &packet, Address address)
 
   msg->SetItrRlocAddrIp (address);
 
-  /*uint8_t BUF_SIZE = 16 + msg->GetAuthDataLen() + 16
-        + 12 * msg->GetRecord()->GetLocatorCount();*/
-  uint8_t *newbuf = new uint8_t[64];
+  uint32_t bufSize = msg->GetSizeInBytes ();
+  uint8_t newbuf[bufSize];
   msg->Serialize (newbuf);
-  Ptr<Packet> p = Create<Packet> (newbuf, 64);
+  Ptr<Packet> p = Create<Packet> (newbuf, bufSize);
   packet = p;
 
   /* Add back UDP header */
@@ -820,24 +826,14 @@ void
 LispOverIpv4Impl::SetNatedEntry (Ptr<Packet> packet, Ipv4Header const &outerHeader)
 {
 
-  Ptr<MapEntry> mapEntryCache = Create<MapEntryImpl> ();
-  Ptr<MapEntry> mapEntryDB = Create<MapEntryImpl> ();
-
   /* For cache entry: Locator is the translated global address */
   Ptr<Locators> locators = Create<LocatorsImpl> ();
   Ptr<Locator> locator = Create<Locator> (outerHeader.GetSource ());
   locators->InsertLocator (locator);
-  mapEntryCache->SetLocators (locators);
-
-  /* RTR address */
-  mapEntryCache->SetRtrRloc (Create<Locator> (outerHeader.GetDestination ()));
 
   UdpHeader udpHeader;
   packet->RemoveHeader (udpHeader);
 
-  /* Translated global port */
-  mapEntryCache->SetTranslatedPort (udpHeader.GetSourcePort ());
-
   /* Remove ECM header */
   LispEncapsulatedControlMsgHeader ecmHeader;
   packet->RemoveHeader (ecmHeader);
@@ -845,9 +841,6 @@ LispOverIpv4Impl::SetNatedEntry (Ptr<Packet> packet, Ipv4Header const &outerHead
   Ipv4Header innerHeader;
   packet->RemoveHeader (innerHeader);
 
-  /* Local (NATed) RLOC address of xTR */
-  mapEntryCache->SetXtrLloc (Create<Locator> (innerHeader.GetSource ()));
-
   /* Remove inner UDP header */
   UdpHeader innerUdpHeader;
   packet->RemoveHeader (innerUdpHeader);
@@ -855,23 +848,42 @@ LispOverIpv4Impl::SetNatedEntry (Ptr<Packet> packet, Ipv4Header const &outerHead
   /* We arrive at MapRegister msg */
   uint8_t buf[packet->GetSize ()];
   packet->CopyData (buf, packet->GetSize ());
-  Ptr<MapRegisterMsg> msg = MapRegisterMsg::Deserialize (buf);
-  std::stringstream ss;
-  Ptr<MapReplyRecord> record = msg->GetRecord ();
-  Ptr<EndpointId> eid;
-  ss << "/" << unsigned (record->GetEidMaskLength ());
-  Ipv4Mask mask = Ipv4Mask (ss.str ().c_str ());
-  eid = Create<EndpointId> (record->GetEidPrefix (), mask);
-  mapEntryCache->SetEidPrefix (eid);
-  mapEntryDB->SetEidPrefix (eid);
-  /* For DB entry: Locator is the RTR locator */
-  mapEntryDB->SetLocators (record->GetLocators ());
-
-  /* Set Entry in cache */
-  m_mapTablesIpv4->SetEntry (record->GetEidPrefix (), mask, mapEntryCache, MapTables::IN_CACHE);
-
-  /* Set Entry in database */
-  m_mapTablesIpv4->SetEntry (record->GetEidPrefix (), mask, mapEntryDB, MapTables::IN_DATABASE);
+  Ptr<MapRegisterMsg> msg = MapRegisterMsg::Deserialize (buf, packet->GetSize ());
+  if (msg == 0)
+    {
+      return;
+    }
+  /* One pair of entries per EID-prefix registered by the NATed device */
+  const std::vector<Ptr<MapReplyRecord> > &records = msg->GetRecords ();
+  for (std::vector<Ptr<MapReplyRecord> >::const_iterator it = records.begin ();
+       it != records.end (); ++it)
+    {
+      Ptr<MapReplyRecord> record = *it;
+      Ptr<MapEntry> mapEntryCache = Create<MapEntryImpl> ();
+      Ptr<MapEntry> mapEntryDB = Create<MapEntryImpl> ();
+      mapEntryCache->SetLocators (locators);
+      /* RTR address */
+      mapEntryCache->SetRtrRloc (Create<Locator> (outerHeader.GetDestination ()));
+      /* Translated global port */
+      mapEntryCache->SetTranslatedPort (udpHeader.GetSourcePort ());
+      /* Local (NATed) RLOC address of xTR */
+      mapEntryCache->SetXtrLloc (Create<Locator> (innerHeader.GetSource ()));
+
+      std::stringstream ss;
+      ss << "/" << unsigned (record->GetEidMaskLength ());
+      Ipv4Mask mask = Ipv4Mask (ss.str ().c_str ());
+      Ptr<EndpointId> eid = Create<EndpointId> (record->GetEidPrefix (), mask);
+      mapEntryCache->SetEidPrefix (eid);
+      mapEntryDB->SetEidPrefix (eid);
+      /* For DB entry: Locator is the RTR locator */
+      mapEntryDB->SetLocators (record->GetLocators ());
+
+      /* Set Entry in cache */
+      m_mapTablesIpv4->SetEntry (record->GetEidPrefix (), mask, mapEntryCache, MapTables::IN_CACHE);
+
+      /* Set Entry in database */
+      m_mapTablesIpv4->SetEntry (record->GetEidPrefix (), mask, mapEntryDB, MapTables::IN_DATABASE);
+    }
 
   /* When RTR receives an ECM encapsulated MapRegister for the EID MN, it adds:
    * - in cache: the entry (EID -> NAT translated address) => Forward data packets to NATed device
@@ -131,7 +131,7 @@ Ptr<Locator> Locator::DeserializedInMapReplyRecord (const uint8_t *buf)
     }
   else if (rlocMetrics->GetLocAfi () == RlocMetrics::IPv6 )
     {
-      locator->SetRlocAddress (static_cast<Address> (Ipv4Address::Deserialize (buf + position)));
+      locator->SetRlocAddress (static_cast<Address> (Ipv6Address::Deserialize (buf + position)));
     }
   return locator;
 }
@@ -86,6 +86,46 @@ LocatorsImpl::InsertLocator (Ptr<Locator> locator)
   m_locatorsChain.sort (compare_rloc);
 }
 
+bool
+LocatorsImpl::Update (Ptr<Locators> locators)
+{
+  bool changed = false;
+  for (std::list<Ptr<Locator> >::iterator it = m_locatorsChain.begin ();
+       it != m_locatorsChain.end (); /* empty */)
+    {
+      if (locators->FindLocator ((*it)->GetRlocAddress ()) == 0)
+        {
+          it = m_locatorsChain.erase (it);
+          changed = true;
+        }
+      else
+        {
+          ++it;
+        }
+    }
+
+  for (uint8_t i = 0; i < locators->GetNLocators (); i++)
+    {
+      Ptr<Locator> locator = locators->GetLocatorByIdx (i);
+      Ptr<Locator> current = FindLocator (locator->GetRlocAddress ());
+      if (current == 0)
+        {
+          m_locatorsChain.push_back (locator);
+          changed = true;
+        }
+      else if (current->GetRlocMetrics ()->Update (locator->GetRlocMetrics ()))
+        {
+          changed = true;
+        }
+    }
+
+  // Keep the chain ordered for RLOC selection
+  if (changed)
+    {
+      m_locatorsChain.sort (compare_rloc);
+    }
+  return changed;
+}
 
 std::string LocatorsImpl::Print (void) const
 {
@@ -26,6 +26,7 @@ public:
   void InsertLocator (Ptr<Locator> locator);
   uint8_t GetNLocators (void) const;
   Ptr<Locator> SelectFirsValidRloc (void) const;
+  bool Update (Ptr<Locators> locators);
   std::string Print (void) const;
 
   int Serialize (uint8_t *buf);
@@ -30,6 +30,16 @@ public:
   virtual Ptr<Locator> GetLocatorByIdx (uint8_t locIndex) = 0;
   virtual uint8_t GetNLocators (void) const = 0;
   virtual Ptr<Locator> SelectFirsValidRloc (void) const = 0;
+  /**
+   * \brief Bring this locator set in line with the one given as an argument.
+   *
+   * Locators absent from \p locators are removed, new ones are inserted
+   * and the metrics of the remaining ones are updated in place.
+   *
+   * \param locators The new locator set.
+   * \return True if the locator set changed.
+   */
+  virtual bool Update (Ptr<Locators> locators) = 0;
   virtual std::string Print (void) const = 0;
 
   virtual int Serialize (uint8_t *buf) = 0;
@@ -155,6 +155,30 @@ void MapEntry::SetProxyMode (bool value)
   m_proxyMode = value;
 }
 
+bool MapEntry::Update (Ptr<MapEntry> mapEntry)
+{
+  bool changed = m_isNegative != mapEntry->IsNegative ();
+  m_isNegative = mapEntry->IsNegative ();
+  m_useVersioning = mapEntry->IsUsingVersioning ();
+  m_useLocatorStatusBits = mapEntry->IsUsingLocStatusBits ();
+  m_proxyMode = mapEntry->IsProxyMode ();
+  m_port = mapEntry->GetTranslatedPort ();
+  m_rtrRloc = mapEntry->GetRtrRloc ();
+  m_xTRLocalRloc = mapEntry->GetXtrLloc ();
+
+  Ptr<Locators> locators = mapEntry->GetLocators ();
+  if (m_locators == 0 || locators == 0)
+    {
+      changed = changed || m_locators != locators;
+      m_locators = locators;
+    }
+  else if (m_locators != locators && m_locators->Update (locators))
+    {
+      changed = true;
+    }
+  return changed;
+}
+
 uint32_t MapEntry::GetTTL ()
 {
   return m_ttl;
@@ -69,6 +69,17 @@ public:
    */
   void SetProxyMode (bool value);
 
+  /**
+   * \brief Update this entry in place with the content of another entry.
+   *
+   * The locator set is updated incrementally (see Locators::Update). The
+   * EID prefix, the TTL and the Map-Version number are left untouched.
+   *
+   * \param mapEntry The entry holding the new mapping.
+   * \return True if the mapping (negative flag or locators) changed.
+   */
+  bool Update (Ptr<MapEntry> mapEntry);
+
   uint32_t GetTTL ();
   uint32_t ReduceTTL ();
   void SetTTL (uint32_t ttl);
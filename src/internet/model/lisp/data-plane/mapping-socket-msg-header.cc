@@ -86,7 +86,7 @@ void MappingSocketMsgHeader::SetMapVersion (uint8_t mapVersion)
 {
   m_mapVersion = mapVersion;
 }
-uint8_t MappingSocketMsgHeader::GetMapVersion (void)
+uint8_t MappingSocketMsgHeader::GetMapVersion (void) const
 {
   return m_mapVersion;
 }
@@ -95,7 +95,7 @@ void MappingSocketMsgHeader::SetMapType (uint16_t mapType)
 {
   m_mapType = mapType;
 }
-uint16_t MappingSocketMsgHeader::GetMapType (void)
+uint16_t MappingSocketMsgHeader::GetMapType (void) const
 {
   return m_mapType;
 }
@@ -105,7 +105,7 @@ void MappingSocketMsgHeader::SetMapFlags (uint32_t mapFlags)
   m_mapFlags = mapFlags;
 }
 
-uint32_t MappingSocketMsgHeader::GetMapFlags (void)
+uint32_t MappingSocketMsgHeader::GetMapFlags (void) const
 {
   return m_mapFlags;
 }
@@ -115,7 +115,7 @@ void MappingSocketMsgHeader::SetMapAddresses (uint16_t mapAddresses)
   m_mapAddresses = mapAddresses;
 }
 
-uint16_t MappingSocketMsgHeader::GetMapAddresses (void)
+uint16_t MappingSocketMsgHeader::GetMapAddresses (void) const
 {
   return m_mapAddresses;
 }
@@ -125,7 +125,7 @@ void MappingSocketMsgHeader::SetMapVersioning (uint16_t mapVersioning)
   m_mapVersioning = mapVersioning;
 }
 
-uint16_t MappingSocketMsgHeader::GetMapVersioning (void)
+uint16_t MappingSocketMsgHeader::GetMapVersioning (void) const
 {
   return m_mapVersioning;
 }
@@ -135,7 +135,7 @@ void MappingSocketMsgHeader::SetMapRlocCount (uint32_t mapRlocCount)
   m_mapRlocCount = mapRlocCount;
 }
 
-uint32_t MappingSocketMsgHeader::GetMapRlocCount (void)
+uint32_t MappingSocketMsgHeader::GetMapRlocCount (void) const
 {
   return m_mapRlocCount;
 }
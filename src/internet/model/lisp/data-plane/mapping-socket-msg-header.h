@@ -59,22 +59,22 @@ public:
   virtual TypeId GetInstanceTypeId (void) const;
 
   void SetMapVersion (uint8_t mapVersion);
-  uint8_t GetMapVersion (void);
+  uint8_t GetMapVersion (void) const;
 
   void SetMapType (uint16_t mapType);
-  uint16_t GetMapType (void);
+  uint16_t GetMapType (void) const;
 
   void SetMapFlags (uint32_t mapFlags);
-  uint32_t GetMapFlags (void);
+  uint32_t GetMapFlags (void) const;
 
   void SetMapAddresses (uint16_t mapAddresses);
-  uint16_t GetMapAddresses (void);
+  uint16_t GetMapAddresses (void) const;
 
   void SetMapVersioning (uint16_t mapVersioning);
-  uint16_t GetMapVersioning (void);
+  uint16_t GetMapVersioning (void) const;
 
   void SetMapRlocCount (uint32_t mapRlocCount);
-  uint32_t GetMapRlocCount (void);
+  uint32_t GetMapRlocCount (void) const;
 private:
   uint8_t m_mapVersion;   /* ? future binary compatibility */
   uint16_t m_mapType;   /* message type */
@@ -31,6 +31,10 @@ RlocMetrics::RlocMetrics () :
     true), m_rlocIsLocalInterface (false), m_txNoncePresent (false), m_rxNoncePresent (
     false), m_txNonce (0), m_rxNonce (0), m_mtu (0)
 {
+  m_flagp = false;
+  m_flagL = false;
+  m_flagR = false;
+  m_locAfi = IPv4;
 
 }
 
@@ -47,14 +51,9 @@ RlocMetrics::RlocMetrics (uint8_t priority, uint8_t mpriority, uint8_t weight,
   m_mweight = mweight;
 }
 
-RlocMetrics::RlocMetrics (uint8_t priority, uint8_t weight, bool reachable)
+RlocMetrics::RlocMetrics (uint8_t priority, uint8_t weight, bool reachable) : RlocMetrics (priority, weight)
 {
-  m_priority = priority;
-  m_weight = weight;
-  // by default locator is up
   m_rlocIsUp = reachable;
-  // default 0 : mtu not set yet
-  m_mtu = 0;
 }
 
 RlocMetrics::~RlocMetrics ()
@@ -99,7 +98,7 @@ bool RlocMetrics::IsUp (void)
 
 void RlocMetrics::SetUp (bool status)
 {
-  m_rlocIsUp = true;
+  m_rlocIsUp = status;
 }
 
 bool RlocMetrics::IsLocalInterface (void)
@@ -192,6 +191,28 @@ void RlocMetrics::SetLocAfi (RlocAfi afi)
   m_locAfi = afi;
 }
 
+bool RlocMetrics::Update (Ptr<RlocMetrics> metrics)
+{
+  bool changed = m_priority != metrics->m_priority
+    || m_weight != metrics->m_weight
+    || m_mpriority != metrics->m_mpriority
+    || m_mweight != metrics->m_mweight
+    || m_mtu != metrics->m_mtu
+    || m_rlocIsLocalInterface != metrics->m_rlocIsLocalInterface;
+
+  m_priority = metrics->m_priority;
+  m_weight = metrics->m_weight;
+  m_mpriority = metrics->m_mpriority;
+  m_mweight = metrics->m_mweight;
+  m_mtu = metrics->m_mtu;
+  m_rlocIsLocalInterface = metrics->m_rlocIsLocalInterface;
+  m_flagL = metrics->m_flagL;
+  m_flagp = metrics->m_flagp;
+  m_flagR = metrics->m_flagR;
+  m_locAfi = metrics->m_locAfi;
+  return changed;
+}
+
 std::string RlocMetrics::Print ()
 {
   std::stringstream str;
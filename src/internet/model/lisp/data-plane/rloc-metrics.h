@@ -197,6 +197,16 @@ public:
    */
   void SetRxNonce (uint32_t rxNonce);
 
+  /**
+   * Update the metrics advertised by the mapping system (priorities,
+   * weights, MTU, flags) with those of the RlocMetrics given as an argument.
+   * Runtime state (reachability and nonces) is left untouched.
+   *
+   * \param metrics The RlocMetrics carrying the new values.
+   * \return True if a value used for RLOC selection changed.
+   */
+  bool Update (Ptr<RlocMetrics> metrics);
+
   /**
    * Print the RlocMetrics object.
    * \return The string representation of the RlocMetrics object.
@@ -39,6 +39,7 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/lisp-header.h"
+#include "ns3/lisp-over-ip.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -195,6 +196,22 @@ SimpleMapTables::WipeCache (void)
   m_mappingCache.clear ();
 }
 
+bool
+SimpleMapTables::IsSamePrefix (Ptr<const EndpointId> a, Ptr<const EndpointId> b)
+{
+  if (a->IsIpv4 () != b->IsIpv4 ())
+    {
+      return false;
+    }
+  if (a->IsIpv4 ())
+    {
+      return a->GetEidAddress () == b->GetEidAddress ()
+             && a->GetIpv4Mask ().IsEqual (b->GetIpv4Mask ());
+    }
+  return a->GetEidAddress () == b->GetEidAddress ()
+         && a->GetIpv6Prefix ().IsEqual (b->GetIpv6Prefix ());
+}
+
 void SimpleMapTables::SetxTRApp (Ptr<LispEtrItrApplication> xTRApp)
 {
   m_xTRApp = PeekPointer (xTRApp);
@@ -220,22 +237,51 @@ void SimpleMapTables::SetEntry (const Address &eidAddress, const Ipv4Mask &mask,
       m_mutexDatabase.Lock ();
       std::map<Ptr<EndpointId>, Ptr<MapEntry>, CompareEndpointId>::iterator it =
         m_mappingDatabase.find (eid);
-      if (it != m_mappingDatabase.end ())
+      if (it != m_mappingDatabase.end () && IsSamePrefix (it->first, eid))
         {
-          //Before erase the found mapEntry, take out the map version number
-          //update it (e.g. increment by one) and assign it to the new map entry
-          uint16_t newerMapVersionNb = it->second->GetVersionNumber () + 1;
-          if (newerMapVersionNb > 1)
+          // Update the existing entry in place, following the same newer-only
+          // Map-Version rule as the cache. If the new mapping does not carry
+          // its own Map-Version number, bump the current one when the mapping
+          // changed.
+          Ptr<MapEntry> current = it->second;
+          uint16_t currentVersion = current->GetVersionNumber ();
+          uint16_t newVersion = mapEntry->GetVersionNumber ();
+          if (current == mapEntry)
+            {
+              NS_LOG_DEBUG ("Database entry for EID " << eid->Print () << " already present");
+            }
+          else if (currentVersion != LispOverIp::NULL_VERSION_NUM
+                   && newVersion != LispOverIp::NULL_VERSION_NUM
+                   && !LispOverIp::IsMapVersionNumberNewer (newVersion, currentVersion))
             {
-              //TODO: add method to set map version number
-              //10-07-2017: Setter method has been added.
-              //mapEntry->SetVersionNumber(newerMapVersionNb);
+              NS_LOG_DEBUG ("Database entry for EID " << eid->Print () << " kept (version "
+                                                     << currentVersion << ", received " << newVersion << ")");
+            }
+          else
+            {
+              bool changed = current->Update (mapEntry);
+              if (newVersion != LispOverIp::NULL_VERSION_NUM)
+                {
+                  current->SetVersionNumber (newVersion);
+                }
+              else if (changed)
+                {
+                  current->SetVersionNumber (
+                    LispOverIp::GetNextMapVersionNumber (current->GetVersionNumber ()));
+                }
+              NS_LOG_DEBUG ("Database entry for EID " << eid->Print () << " updated in place (changed: "
+                                                     << changed << ", version: " << current->GetVersionNumber () << ")");
             }
-          m_mappingDatabase.erase (it);
         }
-
-      m_mappingDatabase.insert (
-        std::pair<Ptr<EndpointId>, Ptr<MapEntry> > (eid, mapEntry));
+      else
+        {
+          if (it != m_mappingDatabase.end ())
+            {
+              m_mappingDatabase.erase (it);
+            }
+          m_mappingDatabase.insert (
+            std::pair<Ptr<EndpointId>, Ptr<MapEntry> > (eid, mapEntry));
+        }
 
       m_mutexDatabase.Unlock ();
     }
@@ -251,12 +297,40 @@ void SimpleMapTables::SetEntry (const Address &eidAddress, const Ipv4Mask &mask,
       m_mutexCache.Lock ();
       std::map<Ptr<EndpointId>, Ptr<MapEntry>, CompareEndpointId>::iterator it =
         m_mappingCache.find (eid);
-      if (it != m_mappingCache.end ())
+      if (it != m_mappingCache.end () && IsSamePrefix (it->first, eid))
         {
-          m_mappingCache.erase (it);
+          Ptr<MapEntry> current = it->second;
+          current->SetTTL (m_defaultTTL);
+          uint16_t currentVersion = current->GetVersionNumber ();
+          uint16_t newVersion = mapEntry->GetVersionNumber ();
+          if (current == mapEntry)
+            {
+              NS_LOG_DEBUG ("Cache entry for EID " << eid->Print () << " already present");
+            }
+          else if (currentVersion != LispOverIp::NULL_VERSION_NUM
+                   && newVersion != LispOverIp::NULL_VERSION_NUM
+                   && !LispOverIp::IsMapVersionNumberNewer (newVersion, currentVersion))
+            {
+              // Same or older Map-Version: the cached mapping is up to date.
+              NS_LOG_DEBUG ("Cache entry for EID " << eid->Print () << " refreshed (version "
+                                                  << currentVersion << ", received " << newVersion << ")");
+            }
+          else
+            {
+              bool changed = current->Update (mapEntry);
+              current->SetVersionNumber (newVersion);
+              NS_LOG_DEBUG ("Cache entry for EID " << eid->Print () << " updated in place (changed: " << changed << ")");
+            }
+        }
+      else
+        {
+          if (it != m_mappingCache.end ())
+            {
+              m_mappingCache.erase (it);
+            }
+          m_mappingCache.insert (
+            std::pair<Ptr<EndpointId>, Ptr<MapEntry> > (eid, mapEntry));
         }
-      m_mappingCache.insert (
-        std::pair<Ptr<EndpointId>, Ptr<MapEntry> > (eid, mapEntry));
       m_mutexCache.Unlock ();
       NS_LOG_DEBUG ("Set an Mapping Entry for EID:" << eid->GetEidAddress ());
       /**
@@ -146,6 +146,15 @@ private:
   void
   ReduceCacheTTL ();
 
+  /**
+   * \brief Check if two EIDs designate exactly the same prefix.
+   *
+   * The map comparator matches an EID against the prefixes that contain
+   * it, so a successful find does not mean the prefixes are identical.
+   */
+  static bool
+  IsSamePrefix (Ptr<const EndpointId> a, Ptr<const EndpointId> b);
+
   SystemMutex m_mutexCache;
   SystemMutex m_mutexDatabase;
   std::map<Ptr<EndpointId>, Ptr<MapEntry>, CompareEndpointId> m_mappingCache;
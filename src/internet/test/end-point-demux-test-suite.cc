@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/simulator.h"
+#include "../model/ipv4-end-point.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux lookup Test
+ *
+ * Check that the most specific endpoint is found, also after the peer
+ * of an endpoint changes, and that deallocated endpoints are not found.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the endpoint of a packet.
+   * \param demux The demux.
+   * \param daddr The destination address.
+   * \param dport The destination port.
+   * \param saddr The source address.
+   * \param sport The source port.
+   * \returns The single matching endpoint, or 0.
+   */
+  Ipv4EndPoint *Lookup (Ipv4EndPointDemux &demux, const char *daddr, uint16_t dport,
+                        const char *saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< The incoming interface.
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookup")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux &demux, const char *daddr, uint16_t dport,
+                                   const char *saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (Ipv4Address (daddr), dport,
+                                                         Ipv4Address (saddr), sport, m_interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  Ipv4EndPointDemux demux;
+
+  Ipv4EndPoint *any = demux.Allocate (0, 80);
+  Ipv4EndPoint *local = demux.Allocate (0, Ipv4Address ("10.0.0.1"), 80);
+  Ipv4EndPoint *full = demux.Allocate (0, Ipv4Address ("10.0.0.1"), 80, Ipv4Address ("10.0.0.2"), 1000);
+  Ipv4EndPoint *other = demux.Allocate (0, 81);
+  NS_TEST_ASSERT_MSG_NE (full, 0, "Allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, Ipv4Address ("10.0.0.1"), 80, Ipv4Address ("10.0.0.2"), 1000), 0,
+                         "Duplicated endpoint allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), true, "Port 80 not found");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (82), false, "Port 82 found");
+
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "10.0.0.2", 1000), full, "Full match not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "10.0.0.3", 1000), local, "Local match not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.9", 80, "10.0.0.2", 1000), any, "Wildcard match not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.9", 81, "10.0.0.2", 1000), other, "Port 81 not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.9", 82, "10.0.0.2", 1000), 0, "Port 82 found");
+
+  // A connection set up after the allocation, as TCP does.
+  Ipv4EndPoint *client = demux.Allocate (Ipv4Address ("10.0.0.1"));
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "10.0.0.4", 80), client, "Client not found");
+  client->SetPeer (Ipv4Address ("10.0.0.4"), 80);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "10.0.0.4", 80), client, "Connected client not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "10.0.0.5", 80), 0, "Connected client found for another peer");
+  client->SetPeer (Ipv4Address::GetAny (), 0);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", port, "10.0.0.5", 80), client, "Disconnected client not found");
+
+  demux.DeAllocate (full);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "10.0.0.2", 1000), local, "Deallocated endpoint found");
+  demux.DeAllocate (local);
+  demux.DeAllocate (any);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "10.0.0.1", 80, "10.0.0.2", 1000), 0, "Deallocated endpoint found");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "Port 80 still found");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (Ipv4Address ("10.0.0.9"), 81, Ipv4Address ("10.0.0.2"), 1000), other,
+                         "Simple lookup failed");
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6EndPointDemux lookup Test
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the endpoint of a packet.
+   * \param demux The demux.
+   * \param daddr The destination address.
+   * \param dport The destination port.
+   * \param saddr The source address.
+   * \param sport The source port.
+   * \returns The single matching endpoint, or 0.
+   */
+  Ipv6EndPoint *Lookup (Ipv6EndPointDemux &demux, const char *daddr, uint16_t dport,
+                        const char *saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookup")
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::Lookup (Ipv6EndPointDemux &demux, const char *daddr, uint16_t dport,
+                                   const char *saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (Ipv6Address (daddr), dport,
+                                                         Ipv6Address (saddr), sport, 0);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+
+  Ipv6EndPoint *any = demux.Allocate (0, 80);
+  Ipv6EndPoint *local = demux.Allocate (0, Ipv6Address ("2001::1"), 80);
+  Ipv6EndPoint *full = demux.Allocate (0, Ipv6Address ("2001::1"), 80, Ipv6Address ("2001::2"), 1000);
+  NS_TEST_ASSERT_MSG_NE (full, 0, "Allocation failed");
+
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001::2", 1000), full, "Full match not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001::3", 1000), local, "Local match not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::9", 80, "2001::2", 1000), any, "Wildcard match not found");
+
+  Ipv6EndPoint *client = demux.Allocate (Ipv6Address ("2001::1"));
+  uint16_t port = client->GetLocalPort ();
+  client->SetPeer (Ipv6Address ("2001::4"), 80);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", port, "2001::4", 80), client, "Connected client not found");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", port, "2001::5", 80), 0, "Connected client found for another peer");
+
+  demux.DeAllocate (full);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, "2001::1", 80, "2001::2", 1000), local, "Deallocated endpoint found");
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "Deallocated port still found");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief EndPointDemux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
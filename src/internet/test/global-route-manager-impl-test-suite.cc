@@ -65,13 +65,44 @@ GlobalRouteManagerImplTestCase::DoRun (void)
       candidate.Push (v);
     }
 
+  uint32_t lastDistance = 0;
   for (int i = 0; i < 100; ++i)
     {
       SPFVertex *v = candidate.Pop ();
+      NS_TEST_ASSERT_MSG_EQ ((v->GetDistanceFromRoot () >= lastDistance), true, 
+                             "Candidates not popped in order of distance");
+      lastDistance = v->GetDistanceFromRoot ();
       delete v;
       v = 0;
     }
 
+  // Lower the distance of a candidate, and check that it is found and
+  // popped first.
+  for (int i = 0; i < 10; ++i)
+    {
+      GlobalRoutingLSA *lsa = new GlobalRoutingLSA ();
+      lsa->SetLSType (GlobalRoutingLSA::RouterLSA);
+      lsa->SetLinkStateId (Ipv4Address (i + 1));
+      SPFVertex *v = new SPFVertex (lsa);
+      v->SetDistanceFromRoot (10 + i);
+      candidate.Push (v);
+    }
+  SPFVertex *w = candidate.Find (Ipv4Address (7));
+  NS_TEST_ASSERT_MSG_NE (w, 0, "Candidate not found");
+  NS_TEST_ASSERT_MSG_EQ (w->GetVertexId (), Ipv4Address (7), "Wrong candidate found");
+  w->SetDistanceFromRoot (1);
+  candidate.DecreaseKey (w);
+  NS_TEST_ASSERT_MSG_EQ (candidate.Pop (), w, "Candidate with decreased distance not popped first");
+  NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (7)), 0, "Popped candidate still found");
+  delete w->GetLSA ();
+  delete w;
+  while (!candidate.Empty ())
+    {
+      SPFVertex *v = candidate.Pop ();
+      delete v->GetLSA ();
+      delete v;
+    }
+
   // Build fake link state database; four routers (0-3), 3 point-to-point
   // links
   //
@@ -22,6 +22,10 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/packet.h"
@@ -36,6 +40,8 @@
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
 
+#include <sstream>
+
 using namespace ns3;
 
 /**
@@ -201,6 +207,112 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 StaticRouting route selection Test
+ *
+ * Check the route chosen among overlapping routes: longest prefix first,
+ * then lowest metric (the last added among equal metrics), except for
+ * host routes where the first added wins; and that removed routes are
+ * not used anymore.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the route to a destination.
+   * \param routing The routing protocol.
+   * \param dest The destination address.
+   * \returns The gateway of the route, or 255.255.255.255 if none.
+   */
+  Ipv4Address Lookup (Ptr<Ipv4StaticRouting> routing, std::string dest);
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase ()
+  : TestCase ("Static routing route selection")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLookupTestCase::Lookup (Ptr<Ipv4StaticRouting> routing, std::string dest)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  Socket::SocketErrno err;
+  Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, 0, err);
+  return route ? route->GetGateway () : Ipv4Address::GetBroadcast ();
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      int32_t ifIndex = ipv4->AddInterface (device);
+      std::ostringstream address;
+      address << "10.0." << i << ".1";
+      ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address (address.str ().c_str ()), Ipv4Mask ("/24")));
+      ipv4->SetUp (ifIndex);
+    }
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting (ipv4);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "8.8.8.8"), Ipv4Address::GetBroadcast (), "Unexpected route");
+
+  routing->SetDefaultRoute (Ipv4Address ("10.0.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.0.0"), Ipv4Mask ("/12"), Ipv4Address ("10.0.2.2"), 2);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.5.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.1.3"), 1, 5);
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.5.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.2.3"), 2, 3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "8.8.8.8"), Ipv4Address ("10.0.1.2"), "Default route not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "10.0.3.7"), Ipv4Address ("0.0.0.0"), "Interface route not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.17.1.1"), Ipv4Address ("10.0.2.2"), "Longest prefix not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.9"), Ipv4Address ("10.0.2.3"), "Lowest metric not used");
+
+  routing->AddNetworkRouteTo (Ipv4Address ("172.16.5.0"), Ipv4Mask ("/24"), Ipv4Address ("10.0.3.3"), 3, 3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.9"), Ipv4Address ("10.0.3.3"), "Last equal metric route not used");
+
+  routing->AddHostRouteTo (Ipv4Address ("172.16.5.9"), Ipv4Address ("10.0.1.4"), 1, 10);
+  routing->AddHostRouteTo (Ipv4Address ("172.16.5.9"), Ipv4Address ("10.0.2.4"), 2, 1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.9"), Ipv4Address ("10.0.1.4"), "First host route not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.10"), Ipv4Address ("10.0.3.3"), "Host route used for another host");
+
+  // A non-contiguous mask counts as its leading ones.
+  routing->AddNetworkRouteTo (Ipv4Address ("9.0.7.0"), Ipv4Mask ("255.0.255.0"), Ipv4Address ("10.0.3.5"), 3);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "9.99.7.1"), Ipv4Address ("10.0.3.5"), "Non-contiguous mask not used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "9.99.8.1"), Ipv4Address ("10.0.1.2"), "Non-contiguous mask wrongly used");
+
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      if (routing->GetRoute (i).GetGateway () == Ipv4Address ("10.0.1.4")
+          || routing->GetRoute (i).GetGateway () == Ipv4Address ("10.0.3.5"))
+        {
+          routing->RemoveRoute (i--);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.9"), Ipv4Address ("10.0.2.4"), "Removed host route used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "9.99.7.1"), Ipv4Address ("10.0.1.2"), "Removed route used");
+
+  // Routes through an interface going down are removed.
+  ipv4->SetDown (2);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.16.5.9"), Ipv4Address ("10.0.3.3"), "Route through a down interface used");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (routing, "172.17.1.1"), Ipv4Address ("10.0.1.2"), "Route through a down interface used");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -217,6 +329,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite ipv4StaticRoutingTestSuite; //!< Static variable for test initialization
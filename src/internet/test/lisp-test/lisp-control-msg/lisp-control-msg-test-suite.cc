@@ -0,0 +1,362 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/locator.h"
+#include "ns3/locators-impl.h"
+#include "ns3/rloc-metrics.h"
+#include "ns3/map-reply-record.h"
+#include "ns3/map-reply-msg.h"
+#include "ns3/map-register-msg.h"
+#include "ns3/map-notify-msg.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/lisp-helper.h"
+#include "ns3/lisp-over-ip.h"
+#include "ns3/lisp-mapping-socket.h"
+#include "ns3/mapping-socket-msg.h"
+#include "ns3/mapping-socket-msg-header.h"
+#include "ns3/simple-map-tables.h"
+#include "ns3/endpoint-id.h"
+#include "ns3/simulator.h"
+
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * Build the records used by the tests: an IPv4 EID-prefix with two IPv4
+ * locators, an IPv6 EID-prefix with an IPv6 and an IPv4 locator, and an
+ * IPv4 EID-prefix without locator.
+ *
+ * \returns the records
+ */
+static std::vector<Ptr<MapReplyRecord> >
+MakeRecords (void)
+{
+  std::vector<Ptr<MapReplyRecord> > records;
+
+  Ptr<MapReplyRecord> record = Create<MapReplyRecord> ();
+  record->SetRecordTtl (60);
+  record->SetEidPrefix (Ipv4Address ("10.1.0.0"));
+  record->SetEidMaskLength (16);
+  record->SetAct (MapReplyRecord::NoAction);
+  record->SetMapVersionNumber (7);
+  Ptr<Locators> locators = Create<LocatorsImpl> ();
+  Ptr<Locator> locator = Create<Locator> (Ipv4Address ("192.168.0.1"));
+  locator->SetRlocMetrics (Create<RlocMetrics> (1, 50, true));
+  locators->InsertLocator (locator);
+  locator = Create<Locator> (Ipv4Address ("192.168.0.2"));
+  locator->SetRlocMetrics (Create<RlocMetrics> (2, 50, false));
+  locators->InsertLocator (locator);
+  record->SetLocators (locators);
+  records.push_back (record);
+
+  record = Create<MapReplyRecord> ();
+  record->SetRecordTtl (1440);
+  record->SetEidPrefix (Ipv6Address ("2001:db8::"));
+  record->SetEidMaskLength (32);
+  record->SetAct (MapReplyRecord::NoAction);
+  record->SetMapVersionNumber (0x1234);
+  locators = Create<LocatorsImpl> ();
+  locator = Create<Locator> (Ipv6Address ("2001:db8:ffff::1"));
+  locator->SetRlocMetrics (Create<RlocMetrics> (3, 100, true));
+  locators->InsertLocator (locator);
+  locator = Create<Locator> (Ipv4Address ("192.168.1.1"));
+  locator->SetRlocMetrics (Create<RlocMetrics> (4, 10, true));
+  locators->InsertLocator (locator);
+  record->SetLocators (locators);
+  records.push_back (record);
+
+  record = Create<MapReplyRecord> ();
+  record->SetRecordTtl (15);
+  record->SetEidPrefix (Ipv4Address ("10.2.0.0"));
+  record->SetEidMaskLength (24);
+  record->SetAct (MapReplyRecord::NativelyForward);
+  record->SetMapVersionNumber (0);
+  records.push_back (record);
+
+  return records;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Serialize and deserialize LISP control messages with several
+ * records, including IPv6 EID-prefixes and locators.
+ */
+class LispMultiRecordTestCase : public TestCase
+{
+public:
+  LispMultiRecordTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check that a deserialized record is the same as the original one
+   * \param record the deserialized record
+   * \param expected the original record
+   * \param index index of the record in the message
+   */
+  void CheckRecord (Ptr<MapReplyRecord> record, Ptr<MapReplyRecord> expected, uint32_t index);
+};
+
+LispMultiRecordTestCase::LispMultiRecordTestCase ()
+  : TestCase ("Serialize and deserialize multi-record Map-Reply and Map-Register messages")
+{
+}
+
+void
+LispMultiRecordTestCase::CheckRecord (Ptr<MapReplyRecord> record, Ptr<MapReplyRecord> expected, uint32_t index)
+{
+  NS_TEST_EXPECT_MSG_EQ (record->GetRecordTtl (), expected->GetRecordTtl (), "Wrong TTL in record " << index);
+  NS_TEST_EXPECT_MSG_EQ (record->GetEidPrefix (), expected->GetEidPrefix (), "Wrong EID-prefix in record " << index);
+  NS_TEST_EXPECT_MSG_EQ (record->GetEidAfi (), expected->GetEidAfi (), "Wrong EID-prefix AFI in record " << index);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) record->GetEidMaskLength (), (uint32_t) expected->GetEidMaskLength (),
+                         "Wrong mask length in record " << index);
+  NS_TEST_EXPECT_MSG_EQ (record->GetAct (), expected->GetAct (), "Wrong action in record " << index);
+  NS_TEST_EXPECT_MSG_EQ (record->GetMapVersionNumber (), expected->GetMapVersionNumber (),
+                         "Wrong Map-Version in record " << index);
+  NS_TEST_EXPECT_MSG_EQ (record->GetSizeInBytes (), expected->GetSizeInBytes (), "Wrong size of record " << index);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) record->GetLocatorCount (), (uint32_t) expected->GetLocatorCount (),
+                         "Wrong locator count in record " << index);
+  uint32_t nLocators = std::min (record->GetLocatorCount (), expected->GetLocatorCount ());
+  for (uint32_t i = 0; i < nLocators; i++)
+    {
+      Ptr<Locator> locator = record->GetLocators ()->GetLocatorByIdx (i);
+      Ptr<Locator> expectedLocator = expected->GetLocators ()->GetLocatorByIdx (i);
+      NS_TEST_EXPECT_MSG_EQ (locator->GetRlocAddress (), expectedLocator->GetRlocAddress (),
+                             "Wrong RLOC " << i << " in record " << index);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) locator->GetRlocMetrics ()->GetPriority (),
+                             (uint32_t) expectedLocator->GetRlocMetrics ()->GetPriority (),
+                             "Wrong priority of RLOC " << i << " in record " << index);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) locator->GetRlocMetrics ()->GetWeight (),
+                             (uint32_t) expectedLocator->GetRlocMetrics ()->GetWeight (),
+                             "Wrong weight of RLOC " << i << " in record " << index);
+      NS_TEST_EXPECT_MSG_EQ (locator->GetRlocMetrics ()->IsUp (), expectedLocator->GetRlocMetrics ()->IsUp (),
+                             "Wrong reachability of RLOC " << i << " in record " << index);
+    }
+}
+
+void
+LispMultiRecordTestCase::DoRun (void)
+{
+  std::vector<Ptr<MapReplyRecord> > records = MakeRecords ();
+  // Record TTL to EID-prefix AFI, EID-prefix, and 8 bytes plus the
+  // address per locator
+  NS_TEST_EXPECT_MSG_EQ (records[0]->GetSizeInBytes (), 12 + 4 + 2 * 12, "Wrong size of the IPv4 record");
+  NS_TEST_EXPECT_MSG_EQ (records[1]->GetSizeInBytes (), 12 + 16 + 24 + 12, "Wrong size of the IPv6 record");
+  NS_TEST_EXPECT_MSG_EQ (records[2]->GetSizeInBytes (), 12 + 4, "Wrong size of the record without locator");
+
+  Ptr<MapReplyMsg> reply = Create<MapReplyMsg> ();
+  reply->SetNonce (0x0123456789abcdefULL);
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      reply->AddRecord (records[i]);
+    }
+  // One more byte, which must not be written
+  std::vector<uint8_t> buffer (reply->GetSizeInBytes () + 1, 0xa5);
+  reply->Serialize (&buffer[0]);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) buffer.back (), 0xa5, "Map-Reply written past its size");
+  Ptr<MapReplyMsg> replyCopy = MapReplyMsg::Deserialize (&buffer[0], reply->GetSizeInBytes ());
+  NS_TEST_ASSERT_MSG_EQ ((replyCopy != 0), true, "Map-Reply not deserialized");
+  NS_TEST_EXPECT_MSG_EQ (replyCopy->GetNonce (), reply->GetNonce (), "Wrong Map-Reply nonce");
+  NS_TEST_EXPECT_MSG_EQ (replyCopy->GetSizeInBytes (), reply->GetSizeInBytes (), "Wrong Map-Reply size");
+  NS_TEST_EXPECT_MSG_EQ (replyCopy->GetRecords ().size (), records.size (), "Wrong Map-Reply record count");
+  for (uint32_t i = 0; i < std::min (replyCopy->GetRecords ().size (), records.size ()); i++)
+    {
+      CheckRecord (replyCopy->GetRecords ()[i], records[i], i);
+    }
+
+  Ptr<MapRegisterMsg> reg = Create<MapRegisterMsg> ();
+  reg->SetNonce (42);
+  reg->SetM (1);
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      reg->AddRecord (records[i]);
+    }
+  buffer.assign (reg->GetSizeInBytes () + 1, 0xa5);
+  reg->Serialize (&buffer[0]);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) buffer.back (), 0xa5, "Map-Register written past its size");
+  Ptr<MapRegisterMsg> regCopy = MapRegisterMsg::Deserialize (&buffer[0], reg->GetSizeInBytes ());
+  NS_TEST_ASSERT_MSG_EQ ((regCopy != 0), true, "Map-Register not deserialized");
+  NS_TEST_EXPECT_MSG_EQ (regCopy->GetNonce (), reg->GetNonce (), "Wrong Map-Register nonce");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) regCopy->GetM (), 1, "Wrong Map-Register M flag");
+  NS_TEST_EXPECT_MSG_EQ (regCopy->GetSizeInBytes (), reg->GetSizeInBytes (), "Wrong Map-Register size");
+  NS_TEST_EXPECT_MSG_EQ (regCopy->GetRecords ().size (), records.size (), "Wrong Map-Register record count");
+  for (uint32_t i = 0; i < std::min (regCopy->GetRecords ().size (), records.size ()); i++)
+    {
+      CheckRecord (regCopy->GetRecords ()[i], records[i], i);
+    }
+
+  Ptr<MapNotifyMsg> notify = Create<MapNotifyMsg> ();
+  notify->SetNonce (7);
+  for (uint32_t i = 0; i < records.size (); i++)
+    {
+      notify->AddRecord (records[i]);
+    }
+  buffer.assign (notify->GetSizeInBytes (), 0);
+  notify->Serialize (&buffer[0]);
+  Ptr<MapNotifyMsg> notifyCopy = MapNotifyMsg::Deserialize (&buffer[0], buffer.size ());
+  NS_TEST_ASSERT_MSG_EQ ((notifyCopy != 0), true, "Map-Notify not deserialized");
+  NS_TEST_EXPECT_MSG_EQ (notifyCopy->GetRecords ().size (), records.size (), "Wrong Map-Notify record count");
+
+  // A message shorter than its records, or whose Record Count claims more
+  // records than it carries, is rejected.
+  NS_TEST_EXPECT_MSG_EQ ((MapNotifyMsg::Deserialize (&buffer[0], buffer.size () - 1) == 0), true,
+                         "Truncated Map-Notify accepted");
+  buffer[3]++;
+  NS_TEST_EXPECT_MSG_EQ ((MapNotifyMsg::Deserialize (&buffer[0], buffer.size ()) == 0), true,
+                         "Map-Notify with an excessive Record Count accepted");
+
+  buffer.assign (reg->GetSizeInBytes (), 0);
+  reg->Serialize (&buffer[0]);
+  NS_TEST_EXPECT_MSG_EQ ((MapRegisterMsg::Deserialize (&buffer[0], buffer.size () - 1) == 0), true,
+                         "Truncated Map-Register accepted");
+  buffer[3]++;
+  NS_TEST_EXPECT_MSG_EQ ((MapRegisterMsg::Deserialize (&buffer[0], buffer.size ()) == 0), true,
+                         "Map-Register with an excessive Record Count accepted");
+
+  buffer.assign (reply->GetSizeInBytes (), 0);
+  reply->Serialize (&buffer[0]);
+  NS_TEST_EXPECT_MSG_EQ ((MapReplyMsg::Deserialize (&buffer[0], 11) == 0), true,
+                         "Map-Reply without a complete header accepted");
+  NS_TEST_EXPECT_MSG_EQ ((MapReplyMsg::Deserialize (&buffer[0], buffer.size () - 1) == 0), true,
+                         "Truncated Map-Reply accepted");
+  buffer[3] = 0xff;
+  NS_TEST_EXPECT_MSG_EQ ((MapReplyMsg::Deserialize (&buffer[0], buffer.size ()) == 0), true,
+                         "Map-Reply with an excessive Record Count accepted");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Send the same MAPM_ADD mapping socket message to the data plane of
+ * two nodes, and check that neither the message nor the other receiver
+ * sees the changes of a receiver.
+ */
+class LispSharedMappingSocketMsgTestCase : public TestCase
+{
+public:
+  LispSharedMappingSocketMsgTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LispSharedMappingSocketMsgTestCase::LispSharedMappingSocketMsgTestCase ()
+  : TestCase ("Mapping socket message shared by two receivers is not modified")
+{
+}
+
+void
+LispSharedMappingSocketMsgTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      nodes.Get (i)->AddDevice (device);
+    }
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (nodes);
+  LispHelper lispHelper;
+  lispHelper.Install (nodes);
+
+  Ptr<Locators> locators = Create<LocatorsImpl> ();
+  Ptr<Locator> locator = Create<Locator> (Ipv4Address ("192.168.0.1"));
+  Ptr<RlocMetrics> metrics = Create<RlocMetrics> (1, 100, true);
+  metrics->SetIsLocalIf (1);
+  locator->SetRlocMetrics (metrics);
+  locators->InsertLocator (locator);
+  Ptr<MappingSocketMsg> msg = Create<MappingSocketMsg> ();
+  msg->SetEndPoint (Create<EndpointId> (Ipv4Address ("10.1.0.0"), Ipv4Mask ("/16")));
+  msg->SetLocators (locators);
+
+  MappingSocketMsgHeader header;
+  header.SetMapType (LispMappingSocket::MAPM_ADD);
+  header.SetMapRlocCount (1);
+  header.SetMapAddresses (static_cast<int> (LispMappingSocket::MAPA_RLOC));
+
+  std::vector<Ptr<MapTables> > mapTables;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<LispOverIp> lisp = nodes.Get (i)->GetObject<LispOverIp> ();
+      mapTables.push_back (CreateObject<SimpleMapTables> ());
+      lisp->SetMapTablesIpv4 (mapTables[i]);
+      Ptr<Socket> socket = Socket::CreateSocket (nodes.Get (i), TypeId::LookupByName ("ns3::LispMappingSocketFactory"));
+      socket->Bind ();
+      socket->Connect (lisp->GetLispMapSockAddress ());
+      NS_TEST_EXPECT_MSG_EQ (DynamicCast<LispMappingSocket> (socket)->SendMsg (header, msg), 0,
+                             "Could not send the message to receiver " << i);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (msg->GetLocators (), locators, "The locators of the message were replaced");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) locators->GetNLocators (), 1, "The locators of the message were modified");
+  NS_TEST_EXPECT_MSG_EQ (metrics->IsLocalInterface (), true, "The metrics of the sender were modified");
+  std::vector<Ptr<Locator> > cached (mapTables.size ());
+  for (uint32_t i = 0; i < mapTables.size (); i++)
+    {
+      Ptr<MapEntry> entry = mapTables[i]->CacheLookup (Ipv4Address ("10.1.2.3"));
+      if (entry != 0 && entry->GetLocators () != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((uint32_t) entry->GetLocators ()->GetNLocators (), 1,
+                                 "Wrong locator count for receiver " << i);
+          cached[i] = entry->GetLocators ()->FindLocator (locator->GetRlocAddress ());
+        }
+      NS_TEST_EXPECT_MSG_NE (cached[i], 0, "The RLOC is not cached by receiver " << i);
+      if (cached[i] == 0)
+        {
+          continue;
+        }
+      NS_TEST_EXPECT_MSG_EQ (cached[i]->GetRlocMetrics ()->IsLocalInterface (), false,
+                             "Cached RLOC of receiver " << i << " is a local interface");
+      NS_TEST_EXPECT_MSG_NE (cached[i], locator, "Receiver " << i << " caches the locator of the sender");
+      NS_TEST_EXPECT_MSG_NE (cached[i]->GetRlocMetrics (), metrics,
+                             "Receiver " << i << " caches the metrics of the sender");
+    }
+  NS_TEST_EXPECT_MSG_NE (cached[0], cached[1], "Both receivers cache the same locator");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief LISP control messages TestSuite
+ */
+class LispControlMsgTestSuite : public TestSuite
+{
+public:
+  LispControlMsgTestSuite ()
+    : TestSuite ("lisp-control-msg", UNIT)
+  {
+    AddTestCase (new LispMultiRecordTestCase, TestCase::QUICK);
+    AddTestCase (new LispSharedMappingSocketMsgTestCase, TestCase::QUICK);
+  }
+};
+
+static LispControlMsgTestSuite g_lispControlMsgTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/endpoint-id.h"
+#include "ns3/locator.h"
+#include "ns3/locators-impl.h"
+#include "ns3/rloc-metrics.h"
+#include "ns3/simple-map-tables.h"
+#include "ns3/lisp-over-ip.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that map-cache and database entries are only replaced by a
+ * mapping with a newer Map-Version, and that the replacement is done in place.
+ */
+class LispMapVersionTestCase : public TestCase
+{
+public:
+  LispMapVersionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Put a mapping of 10.1.0.0/16 in the map-cache
+   * \param version the Map-Version of the mapping
+   * \param rloc the single RLOC of the mapping
+   */
+  void SetCacheEntry (uint16_t version, Ipv4Address rloc);
+  /**
+   * \brief Put a mapping of 10.1.0.0/16 in the map tables
+   * \param version the Map-Version of the mapping
+   * \param rloc the single RLOC of the mapping
+   * \param location the map-cache or the database
+   */
+  void SetEntry (uint16_t version, Ipv4Address rloc, MapTables::MapEntryLocation location);
+  /**
+   * \brief Check the cache entry of 10.1.0.0/16
+   * \param version the expected Map-Version
+   * \param rloc the expected single RLOC
+   * \param step description of the last change of the map-cache
+   */
+  void CheckCacheEntry (uint16_t version, Ipv4Address rloc, std::string step);
+  /**
+   * \brief Check the database entry of 10.1.0.0/16
+   * \param version the expected Map-Version
+   * \param rloc the expected single RLOC
+   * \param step description of the last change of the database
+   */
+  void CheckDatabaseEntry (uint16_t version, Ipv4Address rloc, std::string step);
+  /**
+   * \brief Check an entry of 10.1.0.0/16
+   * \param entry the entry found for 10.1.2.3
+   * \param version the expected Map-Version
+   * \param rloc the expected single RLOC
+   * \param step description of the last change of the map tables
+   */
+  void CheckEntry (Ptr<MapEntry> entry, uint16_t version, Ipv4Address rloc, std::string step);
+
+  Ptr<MapTables> m_mapTables; //!< Map tables under test
+  Ptr<MapEntry> m_entry;      //!< Entry created by the first mapping
+};
+
+LispMapVersionTestCase::LispMapVersionTestCase ()
+  : TestCase ("Map-cache and database entries are only updated by newer Map-Versions, in place")
+{
+}
+
+void
+LispMapVersionTestCase::SetCacheEntry (uint16_t version, Ipv4Address rloc)
+{
+  SetEntry (version, rloc, MapTables::IN_CACHE);
+}
+
+void
+LispMapVersionTestCase::SetEntry (uint16_t version, Ipv4Address rloc, MapTables::MapEntryLocation location)
+{
+  Ptr<EndpointId> eid = Create<EndpointId> (Ipv4Address ("10.1.0.0"), Ipv4Mask ("/16"));
+  Ptr<Locators> locators = Create<LocatorsImpl> ();
+  Ptr<Locator> locator = Create<Locator> (rloc);
+  locator->SetRlocMetrics (Create<RlocMetrics> (1, 100, true));
+  locators->InsertLocator (locator);
+  Ptr<MapEntry> mapEntry = Create<MapEntryImpl> ();
+  mapEntry->SetEidPrefix (eid);
+  mapEntry->setIsNegative (0);
+  mapEntry->SetLocators (locators);
+  mapEntry->SetVersionNumber (version);
+  m_mapTables->SetEntry (eid->GetEidAddress (), eid->GetIpv4Mask (), mapEntry, location);
+}
+
+void
+LispMapVersionTestCase::CheckCacheEntry (uint16_t version, Ipv4Address rloc, std::string step)
+{
+  CheckEntry (m_mapTables->CacheLookup (Ipv4Address ("10.1.2.3")), version, rloc, step);
+}
+
+void
+LispMapVersionTestCase::CheckDatabaseEntry (uint16_t version, Ipv4Address rloc, std::string step)
+{
+  CheckEntry (m_mapTables->DatabaseLookup (Ipv4Address ("10.1.2.3")), version, rloc, step);
+}
+
+void
+LispMapVersionTestCase::CheckEntry (Ptr<MapEntry> entry, uint16_t version, Ipv4Address rloc, std::string step)
+{
+  NS_TEST_EXPECT_MSG_EQ (entry, m_entry, "Entry replaced instead of updated in place after " << step);
+  if (entry == 0)
+    {
+      return;
+    }
+  NS_TEST_EXPECT_MSG_EQ (entry->GetVersionNumber (), version, "Wrong Map-Version after " << step);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) entry->GetLocators ()->GetNLocators (), 1, "Wrong locator count after " << step);
+  NS_TEST_EXPECT_MSG_NE (entry->GetLocators ()->FindLocator (rloc), 0, "Wrong RLOC after " << step);
+}
+
+void
+LispMapVersionTestCase::DoRun (void)
+{
+  m_mapTables = CreateObject<SimpleMapTables> ();
+  Ipv4Address rloc1 ("192.168.0.1");
+  Ipv4Address rloc2 ("192.168.0.2");
+
+  SetCacheEntry (10, rloc1);
+  m_entry = m_mapTables->CacheLookup (Ipv4Address ("10.1.2.3"));
+  NS_TEST_EXPECT_MSG_NE (m_entry, 0, "No cache entry for the first mapping");
+  CheckCacheEntry (10, rloc1, "the first mapping");
+
+  SetCacheEntry (9, rloc2);
+  CheckCacheEntry (10, rloc1, "an older Map-Version");
+  SetCacheEntry (10, rloc2);
+  CheckCacheEntry (10, rloc1, "the same Map-Version");
+  SetCacheEntry (11, rloc2);
+  CheckCacheEntry (11, rloc2, "a newer Map-Version");
+
+  // Map-Versions are compared modulo 4096 (RFC 6834): 1 follows 4095.
+  SetCacheEntry (2000, rloc1);
+  SetCacheEntry (4000, rloc2);
+  SetCacheEntry (LispOverIp::MAX_VERSION_NUM, rloc1);
+  CheckCacheEntry (LispOverIp::MAX_VERSION_NUM, rloc1, "the maximum Map-Version");
+  SetCacheEntry (1, rloc2);
+  CheckCacheEntry (1, rloc2, "a Map-Version which wrapped around");
+  SetCacheEntry (LispOverIp::MAX_VERSION_NUM, rloc1);
+  CheckCacheEntry (1, rloc2, "an older Map-Version before the wrap-around");
+
+  // The database follows the same rule. A mapping without a Map-Version
+  // bumps the current one when it changes the entry.
+  SetEntry (10, rloc1, MapTables::IN_DATABASE);
+  m_entry = m_mapTables->DatabaseLookup (Ipv4Address ("10.1.2.3"));
+  NS_TEST_EXPECT_MSG_NE (m_entry, 0, "No database entry for the first mapping");
+  CheckDatabaseEntry (10, rloc1, "the first database mapping");
+  SetEntry (9, rloc2, MapTables::IN_DATABASE);
+  CheckDatabaseEntry (10, rloc1, "an older Map-Version in the database");
+  SetEntry (10, rloc2, MapTables::IN_DATABASE);
+  CheckDatabaseEntry (10, rloc1, "the same Map-Version in the database");
+  SetEntry (11, rloc2, MapTables::IN_DATABASE);
+  CheckDatabaseEntry (11, rloc2, "a newer Map-Version in the database");
+  SetEntry (LispOverIp::NULL_VERSION_NUM, rloc1, MapTables::IN_DATABASE);
+  CheckDatabaseEntry (12, rloc1, "a database mapping without Map-Version");
+
+  m_entry = 0;
+  m_mapTables = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief LISP map tables TestSuite
+ */
+class LispMapTablesTestSuite : public TestSuite
+{
+public:
+  LispMapTablesTestSuite ()
+    : TestSuite ("lisp-map-tables", UNIT)
+  {
+    AddTestCase (new LispMapVersionTestCase, TestCase::QUICK);
+  }
+};
+
+static LispMapTablesTestSuite g_lispMapTablesTestSuite; //!< Static variable for test initialization
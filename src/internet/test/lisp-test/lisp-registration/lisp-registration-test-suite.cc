@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the map server removes the registrations which are
+ * not refreshed within their Record TTL, and keeps the refreshed ones.
+ */
+class LispRegistrationExpiryTestCase : public TestCase
+{
+public:
+  LispRegistrationExpiryTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Count the Map-Registers sent by the second xTR
+   * \param p the Map-Register
+   */
+  void MapRegisterTx (Ptr<const Packet> p);
+  /**
+   * \brief Check which sites are registered on the map server
+   * \param ms the map server
+   * \param site1 whether the site of the first xTR must be registered
+   * \param site2 whether the site of the second xTR must be registered
+   */
+  void CheckRegistered (Ptr<MapServerDdt> ms, bool site1, bool site2);
+
+  uint32_t m_mapRegisterTx; //!< Map-Registers sent by the second xTR
+};
+
+LispRegistrationExpiryTestCase::LispRegistrationExpiryTestCase ()
+  : TestCase ("Map server expires the registrations which are not refreshed"),
+    m_mapRegisterTx (0)
+{
+}
+
+void
+LispRegistrationExpiryTestCase::MapRegisterTx (Ptr<const Packet> p)
+{
+  m_mapRegisterTx++;
+}
+
+void
+LispRegistrationExpiryTestCase::CheckRegistered (Ptr<MapServerDdt> ms, bool site1, bool site2)
+{
+  Ptr<MapTables> mapTables = ms->GetMapTablesV4 ();
+  NS_TEST_EXPECT_MSG_EQ ((mapTables->DatabaseLookup (Ipv4Address ("10.1.1.1")) != 0), site1,
+                         "Wrong registration of the first site at " << Simulator::Now ().GetSeconds () << "s");
+  NS_TEST_EXPECT_MSG_EQ ((mapTables->DatabaseLookup (Ipv4Address ("10.1.2.1")) != 0), site2,
+                         "Wrong registration of the second site at " << Simulator::Now ().GetSeconds () << "s");
+}
+
+void
+LispRegistrationExpiryTestCase::DoRun (void)
+{
+  /* Topology:                    MR/MS (n5/n6)
+                                    |
+                xTR1 (n1) <----> R (n2) <-----> xTR2 (n3)
+                /               (non-LISP)        \
+               /                                   \
+            n0 (non-LISP)                         n4 (non-LISP)
+  */
+  NodeContainer nodes;
+  nodes.Create (7);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (0), nodes.Get (1)));
+  ipv4.SetBase ("192.168.1.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (1), nodes.Get (2)));
+  ipv4.SetBase ("192.168.2.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (3)));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (3), nodes.Get (4)));
+  ipv4.SetBase ("192.168.3.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMR = ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (5)));
+  ipv4.SetBase ("192.168.4.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMS = ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (6)));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  NodeContainer lispRouters = NodeContainer (nodes.Get (1), nodes.Get (3), nodes.Get (5), nodes.Get (6));
+  NodeContainer xTRs = NodeContainer (nodes.Get (1), nodes.Get (3));
+
+  LispHelper lispHelper;
+  lispHelper.BuildRlocsSet ("src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs.txt");
+  lispHelper.Install (lispRouters);
+  lispHelper.BuildMapTables2 ("src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs_config_xml.txt");
+  lispHelper.InstallMapTables (lispRouters);
+
+  // Both xTRs refresh their registrations every 20 s, with a Record TTL
+  // of 1 minute. The first xTR stops refreshing at 30 s.
+  LispEtrItrAppHelper lispAppHelper;
+  lispAppHelper.AddMapResolverRlocs (Create<Locator> (iR_iMR.GetAddress (1)));
+  lispAppHelper.AddMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  lispAppHelper.SetAttribute ("MapRegisterRefresh", TimeValue (Seconds (20)));
+  lispAppHelper.SetAttribute ("MapRegisterTtl", UintegerValue (1));
+  ApplicationContainer xTRApps = lispAppHelper.Install (xTRs);
+  xTRApps.Start (Seconds (1.0));
+  xTRApps.Get (0)->SetStopTime (Seconds (30.0));
+  xTRApps.Get (1)->SetStopTime (Seconds (150.0));
+  xTRApps.Get (1)->TraceConnectWithoutContext ("MapRegisterTx",
+                                               MakeCallback (&LispRegistrationExpiryTestCase::MapRegisterTx, this));
+
+  MapResolverDdtHelper mrHelper;
+  mrHelper.SetMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  ApplicationContainer mrApps = mrHelper.Install (nodes.Get (5));
+  mrApps.Start (Seconds (0.0));
+  mrApps.Stop (Seconds (150.0));
+
+  MapServerDdtHelper msHelper;
+  ApplicationContainer msApps = msHelper.Install (nodes.Get (6));
+  msApps.Start (Seconds (0.0));
+  msApps.Stop (Seconds (150.0));
+  Ptr<MapServerDdt> ms = DynamicCast<MapServerDdt> (msApps.Get (0));
+
+  // The last registration of the first xTR is sent at 21 s and expires at
+  // 81 s; the second xTR refreshes its registration until the end.
+  Simulator::Schedule (Seconds (0.5), &LispRegistrationExpiryTestCase::CheckRegistered, this, ms, false, false);
+  Simulator::Schedule (Seconds (25.0), &LispRegistrationExpiryTestCase::CheckRegistered, this, ms, true, true);
+  Simulator::Schedule (Seconds (75.0), &LispRegistrationExpiryTestCase::CheckRegistered, this, ms, true, true);
+  Simulator::Schedule (Seconds (90.0), &LispRegistrationExpiryTestCase::CheckRegistered, this, ms, false, true);
+  Simulator::Schedule (Seconds (145.0), &LispRegistrationExpiryTestCase::CheckRegistered, this, ms, false, true);
+
+  Simulator::Stop (Seconds (160.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // Map-Registers at 1 s, then every 20 s until 141 s
+  NS_TEST_EXPECT_MSG_EQ (m_mapRegisterTx, 8, "Wrong number of Map-Registers sent by the second xTR");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief LISP registration TestSuite
+ */
+class LispRegistrationTestSuite : public TestSuite
+{
+public:
+  LispRegistrationTestSuite ()
+    : TestSuite ("lisp-registration", UNIT)
+  {
+    AddTestCase (new LispRegistrationExpiryTestCase, TestCase::QUICK);
+  }
+};
+
+static LispRegistrationTestSuite g_lispRegistrationTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that an ITR probes the RLOC of its map-cache, handles the
+ * replies, and marks the RLOC down once its ETR stops answering.
+ */
+class LispRlocProbingTestCase : public TestCase
+{
+public:
+  LispRlocProbingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Record the reachability changes reported by the first xTR
+   * \param rloc the RLOC whose status changed
+   * \param up true if the RLOC became reachable
+   */
+  void RlocStateChange (const Address &rloc, bool up);
+  /**
+   * \brief Check the probing state of the RLOC of the second xTR, as seen
+   * by the first xTR
+   * \param itr the first xTR
+   * \param up whether the RLOC must be up in the map-cache
+   */
+  void CheckRloc (Ptr<LispEtrItrApplication> itr, bool up);
+
+  Ipv4Address m_rloc; //!< RLOC of the second xTR
+  uint32_t m_nDown;   //!< Times m_rloc was marked down
+  uint32_t m_nUp;     //!< Times m_rloc was marked up
+  Time m_downTime;    //!< Last time m_rloc was marked down
+};
+
+LispRlocProbingTestCase::LispRlocProbingTestCase ()
+  : TestCase ("ITR probes the RLOCs of its map-cache and detects an unreachable RLOC"),
+    m_rloc ("192.168.2.2"),
+    m_nDown (0),
+    m_nUp (0)
+{
+}
+
+void
+LispRlocProbingTestCase::RlocStateChange (const Address &rloc, bool up)
+{
+  if (Ipv4Address::ConvertFrom (rloc) != m_rloc)
+    {
+      return;
+    }
+  if (up)
+    {
+      m_nUp++;
+    }
+  else
+    {
+      m_nDown++;
+      m_downTime = Simulator::Now ();
+    }
+}
+
+void
+LispRlocProbingTestCase::CheckRloc (Ptr<LispEtrItrApplication> itr, bool up)
+{
+  Ptr<MapEntry> entry = itr->GetNode ()->GetObject<LispOverIp> ()->GetMapTablesV4 ()->CacheLookup (Ipv4Address ("10.1.2.1"));
+  Ptr<Locator> locator;
+  if (entry != 0 && entry->GetLocators () != 0)
+    {
+      locator = entry->GetLocators ()->FindLocator (m_rloc);
+    }
+  NS_TEST_EXPECT_MSG_NE (locator, 0, "No map-cache entry for the RLOC at " << Simulator::Now ().GetSeconds () << "s");
+  if (locator == 0)
+    {
+      return;
+    }
+  NS_TEST_EXPECT_MSG_EQ (locator->GetRlocMetrics ()->IsUp (), up,
+                         "Wrong reachability of the RLOC at " << Simulator::Now ().GetSeconds () << "s");
+  NS_TEST_EXPECT_MSG_GT (itr->GetRlocProbeRtt (m_rloc), Seconds (0),
+                         "No RLOC-probe reply handled at " << Simulator::Now ().GetSeconds () << "s");
+}
+
+void
+LispRlocProbingTestCase::DoRun (void)
+{
+  /* Topology:                    MR/MS (n5/n6)
+                                    |
+                xTR1 (n1) <----> R (n2) <-----> xTR2 (n3)
+                /               (non-LISP)        \
+               /                                   \
+            n0 (non-LISP)                         n4 (non-LISP)
+  */
+  // The LISP data plane walks the headers of the decapsulated packets
+  PacketMetadata::Enable ();
+
+  NodeContainer nodes;
+  nodes.Create (7);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (0), nodes.Get (1)));
+  ipv4.SetBase ("192.168.1.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (1), nodes.Get (2)));
+  ipv4.SetBase ("192.168.2.0", "255.255.255.0");
+  ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (3)));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer ixTR2_in4 = ipv4.Assign (p2p.Install (nodes.Get (3), nodes.Get (4)));
+  ipv4.SetBase ("192.168.3.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMR = ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (5)));
+  ipv4.SetBase ("192.168.4.0", "255.255.255.0");
+  Ipv4InterfaceContainer iR_iMS = ipv4.Assign (p2p.Install (nodes.Get (2), nodes.Get (6)));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  NodeContainer lispRouters = NodeContainer (nodes.Get (1), nodes.Get (3), nodes.Get (5), nodes.Get (6));
+  NodeContainer xTRs = NodeContainer (nodes.Get (1), nodes.Get (3));
+
+  LispHelper lispHelper;
+  lispHelper.BuildRlocsSet ("src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs.txt");
+  lispHelper.Install (lispRouters);
+  lispHelper.BuildMapTables2 ("src/internet/test/lisp-test/simple-lisp/simple_lisp_rlocs_config_xml.txt");
+  lispHelper.InstallMapTables (lispRouters);
+
+  // Probe every 2 s; an RLOC is down after 2 lost probes. The ETR of the
+  // second site stops answering at 20 s.
+  LispEtrItrAppHelper lispAppHelper;
+  lispAppHelper.AddMapResolverRlocs (Create<Locator> (iR_iMR.GetAddress (1)));
+  lispAppHelper.AddMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  lispAppHelper.SetAttribute ("EnableRlocProbing", BooleanValue (true));
+  lispAppHelper.SetAttribute ("RlocProbeInterval", TimeValue (Seconds (2)));
+  lispAppHelper.SetAttribute ("RlocProbeMaxMissed", UintegerValue (2));
+  ApplicationContainer xTRApps = lispAppHelper.Install (xTRs);
+  xTRApps.Start (Seconds (1.0));
+  xTRApps.Get (0)->SetStopTime (Seconds (40.0));
+  xTRApps.Get (1)->SetStopTime (Seconds (20.0));
+  Ptr<LispEtrItrApplication> itr = DynamicCast<LispEtrItrApplication> (xTRApps.Get (0));
+  itr->TraceConnectWithoutContext ("RlocStateChange",
+                                   MakeCallback (&LispRlocProbingTestCase::RlocStateChange, this));
+
+  MapResolverDdtHelper mrHelper;
+  mrHelper.SetMapServerAddress (static_cast<Address> (iR_iMS.GetAddress (1)));
+  ApplicationContainer mrApps = mrHelper.Install (nodes.Get (5));
+  mrApps.Start (Seconds (0.0));
+  mrApps.Stop (Seconds (40.0));
+
+  MapServerDdtHelper msHelper;
+  ApplicationContainer msApps = msHelper.Install (nodes.Get (6));
+  msApps.Start (Seconds (0.0));
+  msApps.Stop (Seconds (40.0));
+
+  // Traffic from the first site fills the map-cache of the first xTR
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (nodes.Get (4));
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (40.0));
+
+  UdpEchoClientHelper echoClient (ixTR2_in4.GetAddress (1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (5));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = echoClient.Install (nodes.Get (0));
+  clientApps.Start (Seconds (4.0));
+  clientApps.Stop (Seconds (40.0));
+
+  Simulator::Schedule (Seconds (19.0), &LispRlocProbingTestCase::CheckRloc, this, itr, true);
+  Simulator::Schedule (Seconds (35.0), &LispRlocProbingTestCase::CheckRloc, this, itr, false);
+
+  Simulator::Stop (Seconds (45.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // The probes of 21 s and 23 s are lost: the RLOC is down at 25 s
+  NS_TEST_EXPECT_MSG_EQ (m_nDown, 1, "The RLOC was not marked down once");
+  NS_TEST_EXPECT_MSG_EQ (m_nUp, 0, "The RLOC was marked up while never down before");
+  NS_TEST_EXPECT_MSG_GT (m_downTime, Seconds (20), "The RLOC was marked down while reachable");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_downTime, Seconds (25), "The RLOC was marked down too late");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief LISP RLOC-probing TestSuite
+ */
+class LispRlocProbingTestSuite : public TestSuite
+{
+public:
+  LispRlocProbingTestSuite ()
+    : TestSuite ("lisp-rloc-probing", UNIT)
+  {
+    AddTestCase (new LispRlocProbingTestCase, TestCase::QUICK);
+  }
+};
+
+static LispRlocProbingTestSuite g_lispRlocProbingTestSuite; //!< Static variable for test initialization
@@ -208,6 +208,22 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, uint32_t headerBytes, bool compress)
+{
+  NS_LOG_FUNCTION (filename << headerBytes << compress);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  file->Open (filename, headerBytes, 1 << 20, false, compress);
+  NS_ABORT_MSG_IF (file->Fail (), "AsciiTraceHelper::CreateBinaryFileStream():  Unable to Open " << filename);
+
+  //
+  // As with CreateFileStream, the file is closed when the last reference
+  // to the stream, usually held by the trace callbacks, goes away.
+  //
+  return Create<OutputStreamWrapper> (file);
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -310,6 +326,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::ENQUEUE, "", p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +339,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::ENQUEUE, context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +364,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::DROP, "", p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +377,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::DROP, context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +403,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::DEQUEUE, "", p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +416,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::DEQUEUE, context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +439,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::RECEIVE, "", p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +452,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> file = stream->GetBinaryFile ();
+  if (file)
+    {
+      file->Write (BinaryTraceFile::RECEIVE, context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -222,6 +222,26 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create an output stream which records the traced events in a
+   * binary columnar file (see BinaryTraceFile) instead of printing them.
+   *
+   * The default trace sinks below record one fixed-size entry per event,
+   * with the first headerBytes bytes of the packet, rather than printing
+   * the whole packet.  The other sinks write to the stream as usual, and
+   * their lines are kept in the file as text.  The file can be converted
+   * to text with BinaryTraceFile::ConvertToText or with the
+   * binary-trace-to-ascii utility.
+   *
+   * @param filename file name
+   * @param headerBytes number of bytes saved from the start of each packet
+   * @param compress whether the file is compressed with gzip
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename,
+                                                   uint32_t headerBytes = 0,
+                                                   bool compress = false);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -50,7 +50,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+thread_local uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -68,6 +68,8 @@ uint32_t Buffer::g_recommendedStart = 0;
  * which the compiler assigns to zero-memory which is initialized to _zero_
  * before the constructors run so this ensures perfect handling of crazy 
  * constructor orderings.
+ * The free list and the size heuristics are per thread: with the
+ * MultithreadedSimulatorImpl, the buffers are created concurrently.
  */
 #define MAGIC_DESTROYED (~(long) 0)
 #define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
@@ -75,9 +77,9 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList *Buffer::g_freeList = 0;
+thread_local struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
@@ -123,6 +125,8 @@ Buffer::Create (uint32_t dataSize)
   if (IS_UNINITIALIZED (g_freeList))
     {
       g_freeList = new Buffer::FreeList ();
+      // Register the destructor of the free list of this thread.
+      (void) &g_localStaticDestructor;
     }
   else if (IS_INITIALIZED (g_freeList))
     {
@@ -400,17 +404,24 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
-      m_end == m_zeroAreaEnd &&
-      m_end == m_data->m_dirtyEnd &&
+  if (m_end == m_zeroAreaEnd &&
       o.m_start == o.m_zeroAreaStart &&
       o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
-       * adjacent zero areas.
+       * adjacent zero areas: the zero areas are merged, and
+       * never turned into real bytes.
        */
+      if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+          /* The data is shared with other buffers: take a
+           * private copy of the real bytes before growing
+           * the zero area.
+           */
+          Unshare ();
+        }
       uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
       m_zeroAreaEnd += zeroSize;
       m_end = m_zeroAreaEnd;
@@ -419,9 +430,11 @@ Buffer::AddAtEnd (const Buffer &o)
       AddAtEnd (endData);
       Buffer::Iterator dst = End ();
       dst.Prev (endData);
-      Buffer::Iterator src = o.End ();
-      src.Prev (endData);
-      dst.Write (src, o.End ());
+      /* The real bytes of o all follow its zero area, and
+       * dst follows ours: write them through the zero-aware
+       * Iterator::Write (uint8_t const *, uint32_t).
+       */
+      dst.Write (o.m_data->m_data + o.m_zeroAreaStart, endData);
       NS_ASSERT (CheckInternalState ());
       return;
     }
@@ -437,6 +450,32 @@ Buffer::AddAtEnd (const Buffer &o)
   NS_ASSERT (CheckInternalState ());
 }
 
+void
+Buffer::Unshare (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (CheckInternalState ());
+  struct Buffer::Data *newData = Buffer::Create (GetInternalSize ());
+  memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
+  m_data->m_count--;
+  if (m_data->m_count == 0)
+    {
+      Buffer::Recycle (m_data);
+    }
+  m_data = newData;
+
+  int32_t delta = -m_start;
+  m_zeroAreaStart += delta;
+  m_zeroAreaEnd += delta;
+  m_end += delta;
+  m_start += delta;
+
+  m_data->m_dirtyStart = m_start;
+  m_data->m_dirtyEnd = m_end;
+  m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
+  NS_ASSERT (CheckInternalState ());
+}
+
 void 
 Buffer::RemoveAtStart (uint32_t start)
 {
@@ -65,10 +65,13 @@ namespace ns3 {
  * contains real data bytes in its BufferData instance but it also
  * contains "virtual zero data" which typically is used to represent
  * application-level payload. No memory is allocated to store the
- * zero bytes of application-level payload unless the user fragments
- * a Buffer: this application-level payload is kept track of with
+ * zero bytes of application-level payload unless the user calls
+ * PeekData, or concatenates two Buffers whose zero areas are not
+ * adjacent: this application-level payload is kept track of with
  * a pair of integers which describe where in the buffer content
- * the "virtual zero area" starts and ends.
+ * the "virtual zero area" starts and ends.  Fragmenting a Buffer,
+ * and concatenating fragments of zero areas back together, keep
+ * the payload virtual.
  *
  * \verbatim
  * ***: unused bytes
@@ -697,6 +700,15 @@ private:
    * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
    */
   void TransformIntoRealBuffer (void) const;
+
+  /**
+   * \brief Give this buffer its own copy of its real bytes, if they are
+   * shared with other buffers.
+   *
+   * Unlike TransformIntoRealBuffer, the zero area is kept virtual: only
+   * the bytes before and after it are copied.
+   */
+  void Unshare (void);
   /**
    * \brief Checks the internal buffer structures consistency
    *
@@ -765,9 +777,10 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value. Per thread, as all the Buffer heuristics, so that the
+   * threads of the MultithreadedSimulatorImpl do not share them.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -798,9 +811,9 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
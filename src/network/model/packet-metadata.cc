@@ -33,10 +33,12 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
-bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+bool PacketMetadata::m_light = false;
+std::atomic<bool> PacketMetadata::m_metadataSkipped (false);
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -45,7 +47,19 @@ PacketMetadata::DataFreeList::~DataFreeList ()
     {
       PacketMetadata::Deallocate (*i);
     }
-  PacketMetadata::m_enable = false;
+  clear ();
+  PacketMetadata::m_freeListDestroyed = true;
+}
+
+void
+PacketMetadata::SetMetadataSkipped (void)
+{
+  // Only written once, not to make the threads of a multithreaded
+  // simulation fight over the cache line for each packet.
+  if (!m_metadataSkipped.load (std::memory_order_relaxed))
+    {
+      m_metadataSkipped.store (true, std::memory_order_relaxed);
+    }
 }
 
 void 
@@ -70,6 +84,17 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableLight (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT_MSG (!m_enable || m_light,
+                 "Error: the light packet metadata must be enabled before "
+                 "the full packet metadata.");
+  Enable ();
+  m_light = true;
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -575,7 +600,7 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
-  while (!m_freeList.empty ()) 
+  while (!m_freeListDestroyed && !m_freeList.empty ()) 
     {
       struct PacketMetadata::Data *data = m_freeList.back ();
       m_freeList.pop_back ();
@@ -596,7 +621,7 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
+  if (!m_enable || m_freeListDestroyed)
     {
       PacketMetadata::Deallocate (data);
       return;
@@ -654,6 +679,11 @@ void
 PacketMetadata::AddHeader (const Header &header, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &header << size);
+  if (m_light)
+    {
+      LightAddHeader (header.GetInstanceTypeId ().GetUid (), size);
+      return;
+    }
   NS_ASSERT (IsStateOk ());
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   DoAddHeader (uid, size);
@@ -665,7 +695,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   NS_LOG_FUNCTION (this << uid << size);
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
 
@@ -682,12 +712,17 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
 void 
 PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 {
-  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &header << size);
+  if (m_light)
+    {
+      LightRemoveHeader (header.GetInstanceTypeId ().GetUid (), size);
+      return;
+    }
+  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -730,12 +765,17 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 void 
 PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
+  if (m_light)
+    {
+      GetLightForWrite ()->size += size;
+      return;
+    }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_ASSERT (IsStateOk ());
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -752,12 +792,20 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 void 
 PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
+  if (m_light)
+    {
+      LightData *light = GetLightForWrite ();
+      NS_ASSERT (light->size >= size);
+      light->size -= size;
+      LightTrimHeaders ();
+      return;
+    }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -801,10 +849,25 @@ void
 PacketMetadata::AddAtEnd (PacketMetadata const&o)
 {
   NS_LOG_FUNCTION (this << &o);
+  if (m_light)
+    {
+      // The headers of o are not at the start of the packet.
+      if (GetLight ()->size == 0)
+        {
+          uint64_t uid = m_packetUid;
+          *this = o;
+          m_packetUid = uid;
+        }
+      else
+        {
+          GetLightForWrite ()->size += o.GetLight ()->size;
+        }
+      return;
+    }
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   if (m_tail == 0xffff)
@@ -879,9 +942,14 @@ void
 PacketMetadata::AddPaddingAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
+  if (m_light)
+    {
+      GetLightForWrite ()->size += end;
+      return;
+    }
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
 }
@@ -889,10 +957,15 @@ void
 PacketMetadata::RemoveAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
+  if (m_light)
+    {
+      LightRemoveAtStart (start);
+      return;
+    }
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -952,10 +1025,18 @@ void
 PacketMetadata::RemoveAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
+  if (m_light)
+    {
+      LightData *light = GetLightForWrite ();
+      NS_ASSERT (light->size >= end);
+      light->size -= end;
+      LightTrimHeaders ();
+      return;
+    }
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -1013,6 +1094,121 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
   NS_ASSERT (leftToRemove == 0);
   NS_ASSERT (IsStateOk ());
 }
+const PacketMetadata::LightData *
+PacketMetadata::GetLight (void) const
+{
+  return reinterpret_cast<const LightData *> (m_data->m_data);
+}
+PacketMetadata::LightData *
+PacketMetadata::GetLightForWrite (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data->m_count > 1)
+    {
+      struct PacketMetadata::Data *newData = PacketMetadata::Create (sizeof (LightData));
+      memcpy (newData->m_data, m_data->m_data, sizeof (LightData));
+      m_data->m_count--;
+      m_data = newData;
+    }
+  return reinterpret_cast<LightData *> (m_data->m_data);
+}
+void
+PacketMetadata::LightAddHeader (uint16_t tid, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << tid << size);
+  LightData *light = GetLightForWrite ();
+  light->size += size;
+  if (size > 0xffff)
+    {
+      // Too large to be recorded: the offsets of the headers below
+      // are not known any more.
+      light->count = 0;
+      return;
+    }
+  if (light->count == LIGHT_MAX_HEADERS)
+    {
+      // forget the last header of the packet.
+      memmove (light->headers, light->headers + 1, (LIGHT_MAX_HEADERS - 1) * sizeof (LightHeader));
+      light->count--;
+    }
+  light->headers[light->count].tid = tid;
+  light->headers[light->count].size = size;
+  light->count++;
+}
+void
+PacketMetadata::LightRemoveHeader (uint16_t tid, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << tid << size);
+  LightData *light = GetLightForWrite ();
+  NS_ASSERT (light->size >= size);
+  light->size -= size;
+  if (light->count == 0)
+    {
+      return;
+    }
+  const LightHeader &first = light->headers[light->count - 1];
+  if (first.tid == tid && first.size == size)
+    {
+      light->count--;
+      return;
+    }
+  if (m_enableChecking)
+    {
+      NS_FATAL_ERROR ("Removing unexpected header.");
+    }
+  // The start of the packet is not known any more.
+  light->count = 0;
+}
+void
+PacketMetadata::LightRemoveAtStart (uint32_t start)
+{
+  NS_LOG_FUNCTION (this << start);
+  LightData *light = GetLightForWrite ();
+  NS_ASSERT (light->size >= start);
+  light->size -= start;
+  while (start > 0 && light->count > 0)
+    {
+      uint32_t size = light->headers[light->count - 1].size;
+      if (size > start)
+        {
+          // a part of a header is left: forget all the headers.
+          light->count = 0;
+          return;
+        }
+      start -= size;
+      light->count--;
+    }
+}
+void
+PacketMetadata::LightTrimHeaders (void)
+{
+  NS_LOG_FUNCTION (this);
+  LightData *light = GetLightForWrite ();
+  uint32_t headersSize = LightGetHeadersSize ();
+  uint8_t removed = 0;
+  while (headersSize > light->size)
+    {
+      headersSize -= light->headers[removed].size;
+      removed++;
+    }
+  if (removed > 0)
+    {
+      light->count -= removed;
+      memmove (light->headers, light->headers + removed, light->count * sizeof (LightHeader));
+    }
+}
+uint32_t
+PacketMetadata::LightGetHeadersSize (void) const
+{
+  const LightData *light = GetLight ();
+  uint32_t headersSize = 0;
+  for (uint8_t i = 0; i < light->count; i++)
+    {
+      headersSize += light->headers[i].size;
+    }
+  return headersSize;
+}
+
 uint32_t
 PacketMetadata::GetTotalSize (void) const
 {
@@ -1051,7 +1247,7 @@ PacketMetadata::BeginItem (Buffer buffer) const
 PacketMetadata::ItemIterator::ItemIterator (const PacketMetadata *metadata, Buffer buffer)
   : m_metadata (metadata),
     m_buffer (buffer),
-    m_current (metadata->m_head),
+    m_current (m_light ? metadata->GetLight ()->count : metadata->m_head),
     m_offset (0),
     m_hasReadTail (false)
 {
@@ -1061,6 +1257,11 @@ bool
 PacketMetadata::ItemIterator::HasNext (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_light)
+    {
+      // m_current is the number of headers left
+      return m_current > 0 || (!m_hasReadTail && m_offset < m_metadata->GetLight ()->size);
+    }
   if (m_current == 0xffff)
     {
       return false;
@@ -1076,6 +1277,32 @@ PacketMetadata::ItemIterator::Next (void)
 {
   NS_LOG_FUNCTION (this);
   struct PacketMetadata::Item item;
+  if (m_light)
+    {
+      item.isFragment = false;
+      item.currentTrimedFromStart = 0;
+      item.currentTrimedFromEnd = 0;
+      if (m_current > 0)
+        {
+          m_current--;
+          const PacketMetadata::LightHeader &header = m_metadata->GetLight ()->headers[m_current];
+          item.type = PacketMetadata::Item::HEADER;
+          item.tid.SetUid (header.tid);
+          item.currentSize = header.size;
+          item.current = m_buffer.Begin ();
+          item.current.Next (m_offset);
+          m_offset += header.size;
+        }
+      else
+        {
+          item.type = PacketMetadata::Item::PAYLOAD;
+          item.tid.SetUid (0);
+          item.currentSize = m_metadata->GetLight ()->size - m_offset;
+          m_offset = m_metadata->GetLight ()->size;
+          m_hasReadTail = true;
+        }
+      return item;
+    }
   struct PacketMetadata::SmallItem smallItem;
   struct PacketMetadata::ExtraItem extraItem;
   m_metadata->ReadItems (m_current, &smallItem, &extraItem);
@@ -1146,6 +1373,22 @@ PacketMetadata::GetSerializedSize (void) const
       return totalSize;
     }
 
+  if (m_light)
+    {
+      const LightData *light = GetLight ();
+      for (uint8_t i = 0; i < light->count; i++)
+        {
+          TypeId tid;
+          tid.SetUid (light->headers[i].tid);
+          totalSize += 4 + tid.GetName ().size () + 1 + 4 + 2 + 4 + 4 + 8;
+        }
+      if (light->size > LightGetHeadersSize ())
+        {
+          totalSize += 4 + 1 + 4 + 2 + 4 + 4 + 8;
+        }
+      return totalSize;
+    }
+
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t current = m_head;
@@ -1186,6 +1429,33 @@ PacketMetadata::Serialize (uint8_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
+  if (m_light)
+    {
+      // The headers, first header of the packet first, then the rest
+      // of the packet as payload.
+      const LightData *light = GetLight ();
+      for (uint8_t i = light->count; i > 0; i--)
+        {
+          buffer = LightSerializeItem (light->headers[i - 1].tid, light->headers[i - 1].size,
+                                       start, buffer, maxSize);
+          if (buffer == 0)
+            {
+              return 0;
+            }
+        }
+      uint32_t headersSize = LightGetHeadersSize ();
+      if (light->size > headersSize)
+        {
+          buffer = LightSerializeItem (0, light->size - headersSize, start, buffer, maxSize);
+          if (buffer == 0)
+            {
+              return 0;
+            }
+        }
+      NS_ASSERT (static_cast<uint32_t> (buffer - start) == maxSize);
+      return 1;
+    }
+
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t current = m_head;
@@ -1285,6 +1555,17 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
   buffer = ReadFromRawU64 (m_packetUid, start, buffer, size);
   desSize -= 8;
 
+  // In light mode, only the whole headers at the start of the packet
+  // are kept.
+  bool lightHeaders = true;
+  LightData *light = 0;
+  if (m_light)
+    {
+      light = GetLightForWrite ();
+      light->count = 0;
+      light->size = 0;
+    }
+
   struct PacketMetadata::SmallItem item = {0};
   struct PacketMetadata::ExtraItem extraItem = {0};
   while (desSize > 0)
@@ -1329,6 +1610,23 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
                     ", size="<<item.size<<", chunkUid="<<item.chunkUid<<
                     ", fragmentStart="<<extraItem.fragmentStart<<", fragmentEnd="<<
                     extraItem.fragmentEnd<< ", packetUid="<<extraItem.packetUid);
+      if (m_light)
+        {
+          light->size += extraItem.fragmentEnd - extraItem.fragmentStart;
+          TypeId tid;
+          tid.SetUid (uid);
+          lightHeaders = lightHeaders && uid != 0 && tid.IsChildOf (Header::GetTypeId ())
+            && extraItem.fragmentStart == 0 && extraItem.fragmentEnd == item.size
+            && item.size <= 0xffff;
+          if (lightHeaders && light->count < LIGHT_MAX_HEADERS)
+            {
+              memmove (light->headers + 1, light->headers, light->count * sizeof (LightHeader));
+              light->headers[0].tid = uid;
+              light->headers[0].size = item.size;
+              light->count++;
+            }
+          continue;
+        }
       uint32_t tmp = AddBig (0xffff, m_tail, &item, &extraItem);
       UpdateTail (tmp);
     }
@@ -1336,6 +1634,63 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
   return (desSize !=0) ? 0 : 1;
 }
 
+uint8_t*
+PacketMetadata::LightSerializeItem (uint16_t uid, uint32_t size,
+                                    uint8_t* start, uint8_t* current,
+                                    uint32_t maxSize) const
+{
+  NS_LOG_FUNCTION (this << uid << size << &start << &current << maxSize);
+  if (uid != 0)
+    {
+      TypeId tid;
+      tid.SetUid (uid);
+      std::string uidString = tid.GetName ();
+      uint32_t uidStringSize = uidString.size ();
+      current = AddToRawU32 (uidStringSize, start, current, maxSize);
+      if (current == 0)
+        {
+          return 0;
+        }
+      current = AddToRaw (reinterpret_cast<const uint8_t *> (uidString.c_str ()),
+                          uidStringSize, start, current, maxSize);
+    }
+  else
+    {
+      current = AddToRawU32 (0, start, current, maxSize);
+    }
+  if (current == 0)
+    {
+      return 0;
+    }
+  // isBig, size, chunkUid, fragmentStart and fragmentEnd of a whole item
+  current = AddToRawU8 (0, start, current, maxSize);
+  if (current == 0)
+    {
+      return 0;
+    }
+  current = AddToRawU32 (size, start, current, maxSize);
+  if (current == 0)
+    {
+      return 0;
+    }
+  current = AddToRawU16 (0, start, current, maxSize);
+  if (current == 0)
+    {
+      return 0;
+    }
+  current = AddToRawU32 (0, start, current, maxSize);
+  if (current == 0)
+    {
+      return 0;
+    }
+  current = AddToRawU32 (size, start, current, maxSize);
+  if (current == 0)
+    {
+      return 0;
+    }
+  return AddToRawU64 (m_packetUid, start, current, maxSize);
+}
+
 uint8_t* 
 PacketMetadata::AddToRawU8 (const uint8_t& data,
                             uint8_t* start,
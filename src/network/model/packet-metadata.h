@@ -21,6 +21,7 @@
 #define PACKET_METADATA_H
 
 #include <stdint.h>
+#include <atomic>
 #include <vector>
 #include <limits>
 #include "ns3/callback.h"
@@ -28,6 +29,8 @@
 #include "ns3/type-id.h"
 #include "buffer.h"
 
+class PacketMetadataLightTest;
+
 namespace ns3 {
 
 class Chunk;
@@ -74,6 +77,17 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * In light mode (see EnableLight), none of this is maintained: the
+ * Data of each PacketMetadata only holds a fixed-size LightData, with
+ * the TypeId and the size of the headers at the start of the packet, up
+ * to LIGHT_MAX_HEADERS of them, and the size of the packet.  The Data is
+ * shared by the copies of a packet, and copied when one of them changes.  The items
+ * are then these headers, followed by the rest of the packet as a
+ * single payload item.  This is enough to dissect and print the
+ * headers of a packet, at a fraction of the cost of the full metadata,
+ * but the trailers, the fragments of headers and the headers of
+ * concatenated packets are not described.
  */
 class PacketMetadata 
 {
@@ -160,6 +174,16 @@ private:
    * \brief Enable the packet metadata checking
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable the light packet metadata
+   *
+   * Like Enable, this must be called before any packet is created.
+   * Enable and EnableChecking keep the light mode when called after.
+   */
+  static void EnableLight (void);
+
+  /// The maximum number of headers recorded in light mode
+  static const uint32_t LIGHT_MAX_HEADERS = 8;
 
   /**
    * \brief Constructor
@@ -494,6 +518,25 @@ private:
     uint64_t packetUid;
   };
 
+  /**
+   * \brief A header recorded in light mode
+   */
+  struct LightHeader {
+    uint16_t tid;  //!< uid of the TypeId of the header
+    uint16_t size; //!< size of the header
+  };
+
+  /**
+   * \brief The metadata of a packet in light mode, stored in the buffer
+   * of its Data
+   */
+  struct LightData {
+    uint32_t size;  //!< size of the packet
+    uint8_t count;  //!< number of headers recorded
+    /// headers recorded, the first header of the packet last
+    LightHeader headers[LIGHT_MAX_HEADERS];
+  };
+
   /**
    * \brief Class to hold all the metadata
    */
@@ -506,6 +549,8 @@ public:
   friend DataFreeList::~DataFreeList ();
   /// Friend class
   friend class ItemIterator;
+  /// Friend class, to switch to the light mode in the tests
+  friend class ::PacketMetadataLightTest;
 
   PacketMetadata ();
 
@@ -620,6 +665,58 @@ public:
    * \param size header serialized size
    */
   void DoAddHeader (uint32_t uid, uint32_t size);
+  /**
+   * \brief Add a header in light mode
+   * \param tid uid of the TypeId of the header
+   * \param size header serialized size
+   */
+  void LightAddHeader (uint16_t tid, uint32_t size);
+  /**
+   * \brief Get the metadata in light mode
+   * \return the metadata
+   */
+  const LightData *GetLight (void) const;
+  /**
+   * \brief Get the metadata in light mode, to modify it
+   *
+   * The Data is copied first if it is shared with other packets.
+   *
+   * \return the metadata
+   */
+  LightData *GetLightForWrite (void);
+  /**
+   * \brief Remove a header in light mode
+   * \param tid uid of the TypeId of the header
+   * \param size header serialized size
+   */
+  void LightRemoveHeader (uint16_t tid, uint32_t size);
+  /**
+   * \brief Remove bytes at the start of the packet in light mode
+   * \param start the number of bytes
+   */
+  void LightRemoveAtStart (uint32_t start);
+  /**
+   * \brief Forget the headers which do not fit in the packet any more,
+   * in light mode
+   */
+  void LightTrimHeaders (void);
+  /**
+   * \brief Get the size of the headers recorded in light mode
+   * \return the size of the headers
+   */
+  uint32_t LightGetHeadersSize (void) const;
+  /**
+   * \brief Serialize an item of the light mode
+   * \param uid uid of the TypeId of the item, zero for payload
+   * \param size size of the item
+   * \param start start of the buffer
+   * \param current current position in the buffer
+   * \param maxSize maximum size
+   * \return updated current position, or 0 if the buffer is too small
+   */
+  uint8_t* LightSerializeItem (uint16_t uid, uint32_t size,
+                               uint8_t* start, uint8_t* current,
+                               uint32_t maxSize) const;
   /**
    * \brief Check if the metadata state is ok
    * \returns true if the internal state is ok
@@ -661,19 +758,25 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  static thread_local DataFreeList m_freeList; //!< the metadata data storage, per thread
+  static thread_local bool m_freeListDestroyed; //!< m_freeList of this thread was destroyed
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
+  static bool m_light; //!< Enable the light packet metadata
 
   /**
    * Set to true when adding metadata to a packet is skipped because
    * m_enable is false; used to detect enabling of metadata in the
    * middle of a simulation, which isn't allowed.
    */
-  static bool m_metadataSkipped;
+  static std::atomic<bool> m_metadataSkipped;
+  /**
+   * \brief Set m_metadataSkipped
+   */
+  static void SetMetadataSkipped (void);
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+  static thread_local uint16_t m_chunkUid; //!< Chunk Uid, per thread
 
   struct Data *m_data; //!< Metadata storage
   /*
@@ -692,12 +795,19 @@ public:
 namespace ns3 {
 
 PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
-  : m_data (PacketMetadata::Create (10)),
+  : m_data (PacketMetadata::Create (m_light ? sizeof (LightData) : 10)),
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
     m_packetUid (uid)
 {
+  if (m_light)
+    {
+      LightData *light = reinterpret_cast<LightData *> (m_data->m_data);
+      light->size = size;
+      light->count = 0;
+      return;
+    }
   memset (m_data->m_data, 0xff, 4);
   if (size > 0)
     {
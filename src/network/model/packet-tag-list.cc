@@ -29,11 +29,99 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include <cstring>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+namespace {
+
+/**
+ * \ingroup packet
+ *
+ * \brief The tag types with a fixed slot in the PacketTagList objects.
+ */
+struct SlotRegistry
+{
+  SlotRegistry ()
+    : slots (0),
+      bytes (0)
+  {
+  }
+  std::vector<int8_t> index;                     //!< Slot of each TypeId uid, or -1
+  TypeId tid[PacketTagList::SLOTS];              //!< Tag type of each slot
+  uint8_t offset[PacketTagList::SLOTS];          //!< Offset of each slot
+  uint8_t size[PacketTagList::SLOTS];            //!< Size of each slot
+  uint32_t slots;                                //!< Number of slots used
+  uint32_t bytes;                                //!< Number of bytes used
+};
+
+/**
+ * \brief Get the tag types with a fixed slot.
+ * \returns the registry of the slots
+ */
+SlotRegistry &
+GetSlotRegistry (void)
+{
+  static SlotRegistry registry;
+  return registry;
+}
+
+} // anonymous namespace
+
+bool
+PacketTagList::RegisterFastTag (Tag const &tag)
+{
+  TypeId tid = tag.GetInstanceTypeId ();
+  uint32_t size = tag.GetSerializedSize ();
+  NS_LOG_FUNCTION (tid << size);
+  if (FindSlot (tid) >= 0)
+    {
+      return true;
+    }
+  SlotRegistry &registry = GetSlotRegistry ();
+  if (registry.slots == SLOTS || registry.bytes + size > SLOT_BYTES)
+    {
+      NS_LOG_WARN ("No slot left for " << tid);
+      return false;
+    }
+  uint32_t slot = registry.slots++;
+  registry.tid[slot] = tid;
+  registry.offset[slot] = registry.bytes;
+  registry.size[slot] = size;
+  registry.bytes += size;
+  if (registry.index.size () <= tid.GetUid ())
+    {
+      registry.index.resize (tid.GetUid () + 1, -1);
+    }
+  registry.index[tid.GetUid ()] = slot;
+  return true;
+}
+
+int32_t
+PacketTagList::FindSlot (TypeId tid)
+{
+  const SlotRegistry &registry = GetSlotRegistry ();
+  uint16_t uid = tid.GetUid ();
+  return uid < registry.index.size () ? registry.index[uid] : -1;
+}
+
+bool
+PacketTagList::GetSlot (uint32_t slot, TypeId &tid, uint8_t const *&data, uint32_t &size) const
+{
+  NS_ASSERT (slot < SLOTS);
+  if ((m_slots & (1 << slot)) == 0)
+    {
+      return false;
+    }
+  const SlotRegistry &registry = GetSlotRegistry ();
+  tid = registry.tid[slot];
+  data = m_slotData + registry.offset[slot];
+  size = registry.size[slot];
+  return true;
+}
+
 PacketTagList::TagData *
 PacketTagList::CreateTagData (size_t dataSize)
 {
@@ -175,6 +263,15 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  int32_t slot = FindSlot (tag.GetInstanceTypeId ());
+  if (slot >= 0 && (m_slots & (1 << slot)))
+    {
+      const SlotRegistry &registry = GetSlotRegistry ();
+      uint8_t *data = m_slotData + registry.offset[slot];
+      tag.Deserialize (TagBuffer (data, data + registry.size[slot]));
+      m_slots &= ~(1 << slot);
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -214,6 +311,24 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  int32_t slot = FindSlot (tag.GetInstanceTypeId ());
+  if (slot >= 0 && (m_slots & (1 << slot)))
+    {
+      const SlotRegistry &registry = GetSlotRegistry ();
+      m_slots &= ~(1 << slot);
+      if (tag.GetSerializedSize () <= registry.size[slot])
+        {
+          uint8_t *data = m_slotData + registry.offset[slot];
+          tag.Serialize (TagBuffer (data, data + registry.size[slot]));
+          m_slots |= 1 << slot;
+        }
+      else
+        {
+          // the new value does not fit in the slot
+          Add (tag);
+        }
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -260,12 +375,24 @@ void
 PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  int32_t slot = FindSlot (tag.GetInstanceTypeId ());
+  NS_ASSERT_MSG (slot < 0 || (m_slots & (1 << slot)) == 0,
+                 "Error: cannot add the same kind of tag twice.");
   // ensure this id was not yet added
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
                      "Error: cannot add the same kind of tag twice.");
     }
+  const SlotRegistry &registry = GetSlotRegistry ();
+  if (slot >= 0 && tag.GetSerializedSize () <= registry.size[slot])
+    {
+      PacketTagList *self = const_cast<PacketTagList *> (this);
+      uint8_t *data = self->m_slotData + registry.offset[slot];
+      tag.Serialize (TagBuffer (data, data + registry.size[slot]));
+      self->m_slots |= 1 << slot;
+      return;
+    }
   struct TagData * head = CreateTagData (tag.GetSerializedSize ());
   head->count = 1;
   head->next = 0;
@@ -281,6 +408,15 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  int32_t slot = FindSlot (tid);
+  if (slot >= 0 && (m_slots & (1 << slot)))
+    {
+      const SlotRegistry &registry = GetSlotRegistry ();
+      const uint8_t *data = m_slotData + registry.offset[slot];
+      tag.Deserialize (TagBuffer (const_cast<uint8_t *> (data),
+                                  const_cast<uint8_t *> (data) + registry.size[slot]));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       if (cur->tid == tid) 
@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -119,6 +120,18 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Fixed slots </b>
+ *
+ *   - A few tag types, set on most packets (the socket tags for instance),
+ *     can be given a fixed slot with #RegisterFastTag.  The tags of these
+ *     types are serialized in a small array held by the PacketTagList
+ *     itself, rather than in the tree: they are found, added and removed
+ *     in constant time, without any allocation, and are copied along with
+ *     the PacketTagList.
+ *
+ *   - A tag whose serialized size exceeds the size of its slot, and the
+ *     tags of the other types, are stored in the tree.
  */
 class PacketTagList 
 {
@@ -215,9 +228,40 @@ public:
   inline void RemoveAll (void);
   /**
    * \returns pointer to head of tag list
+   *
+   * The tags held in the fixed slots are not on the list: see #GetSlot.
    */
   const struct PacketTagList::TagData *Head (void) const;
 
+  /**
+   * Get the tag held in a fixed slot.
+   *
+   * \param [in] slot The slot, less than #SLOTS.
+   * \param [out] tid The type of the tag.
+   * \param [out] data The serialized tag.
+   * \param [out] size The size of the \pname{data} buffer.
+   * \returns True if the slot holds a tag, false otherwise.
+   */
+  bool GetSlot (uint32_t slot, TypeId &tid, uint8_t const *&data, uint32_t &size) const;
+
+  /**
+   * Give a tag type a fixed slot in all the PacketTagList objects.
+   *
+   * This should be called at startup, before any packet carries a tag
+   * of this type.  The size of the slot is the serialized size of
+   * \pname{tag}, so only tag types with a fixed serialized size should
+   * be registered.
+   *
+   * \param [in] tag A tag of the type to register.
+   * \returns True if the type has a slot, false if the slots are full.
+   */
+  static bool RegisterFastTag (Tag const &tag);
+
+  /** The maximum number of tag types with a fixed slot. */
+  static const uint32_t SLOTS = 8;
+  /** The number of bytes shared by the fixed slots. */
+  static const uint32_t SLOT_BYTES = 40;
+
 private:
   /**
    * Allocate and construct a TagData struct, sizing the data area
@@ -278,10 +322,26 @@ private:
   bool ReplaceWriter (Tag & tag, bool preMerge,
                       struct TagData * cur, struct TagData ** prevNext);
 
+  /**
+   * Find the fixed slot of a tag type.
+   *
+   * \param [in] tid The type of the tag.
+   * \returns The slot, or -1 if the type has none.
+   */
+  static int32_t FindSlot (TypeId tid);
+
   /**
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  /**
+   * Bit mask of the fixed slots which hold a tag
+   */
+  uint8_t m_slots;
+  /**
+   * Serialized tags of the fixed slots
+   */
+  uint8_t m_slotData[SLOT_BYTES];
 };
 
 } // namespace ns3
@@ -293,32 +353,46 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_slots (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_slots (o.m_slots)
 {
   if (m_next != 0)
     {
       m_next->count++;
     }
+  if (m_slots != 0)
+    {
+      std::memcpy (m_slotData, o.m_slotData, SLOT_BYTES);
+    }
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o) 
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (m_next != o.m_next)
     {
-      m_next->count++;
+      RemoveAll ();
+      m_next = o.m_next;
+      if (m_next != 0) 
+        {
+          m_next->count++;
+        }
+    }
+  m_slots = o.m_slots;
+  if (m_slots != 0)
+    {
+      std::memcpy (m_slotData, o.m_slotData, SLOT_BYTES);
     }
   return *this;
 }
@@ -352,6 +426,7 @@ PacketTagList::RemoveAll (void)
       std::free (prev);
     }
   m_next = 0;
+  m_slots = 0;
 }
 
 } // namespace ns3
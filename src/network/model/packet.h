@@ -21,6 +21,7 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <atomic>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -155,10 +156,14 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param tid the type of the tag.
+     * \param data the serialized tag.
+     * \param size the size of the serialized tag.
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (TypeId tid, uint8_t const *data, uint32_t size);
+    TypeId m_tid;          //!< the type of the tag
+    uint8_t const *m_data; //!< the serialized tag
+    uint32_t m_size;       //!< the size of the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -173,10 +178,16 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the list of the items
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
+  PacketTagIterator (const PacketTagList *list);
+  /**
+   * Move to the next fixed slot which holds a tag, if any.
+   */
+  void SkipEmptySlots (void);
+  const PacketTagList *m_list;  //!< the set of tags in a packet
+  uint32_t m_slot;  //!< actual position over the fixed slots of the set
+  const struct PacketTagList::TagData *m_current;  //!< actual position over the list of the set
 };
 
 /**
@@ -731,7 +742,8 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  /// Global counter of packets Uid, shared by the threads of a multithreaded simulation
+  static std::atomic<uint32_t> m_globalUid;
 };
 
 /**
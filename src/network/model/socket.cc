@@ -22,6 +22,7 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/packet-tag-list.h"
 #include "node.h"
 #include "socket.h"
 #include "socket-factory.h"
@@ -954,4 +955,23 @@ SocketIpv6TclassTag::Print (std::ostream &os) const
   os << "IPV6_TCLASS = " << m_ipv6Tclass;
 }
 
+/**
+ * \ingroup socket
+ * \brief Give the socket tags, set on most packets by the sockets and
+ * removed by the IP layers, a fixed slot in the PacketTagList.
+ */
+static class SocketTagSlots
+{
+public:
+  SocketTagSlots ()
+  {
+    PacketTagList::RegisterFastTag (SocketIpTtlTag ());
+    PacketTagList::RegisterFastTag (SocketIpTosTag ());
+    PacketTagList::RegisterFastTag (SocketPriorityTag ());
+    PacketTagList::RegisterFastTag (SocketIpv6HopLimitTag ());
+    PacketTagList::RegisterFastTag (SocketIpv6TclassTag ());
+    PacketTagList::RegisterFastTag (SocketSetDontFragmentTag ());
+  }
+} g_socketTagSlots; //!< Registers the socket tags with a fixed slot
+
 } // namespace ns3
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the events recorded in a binary
+ * trace file through the default ascii trace sinks are converted back
+ * to text.
+ */
+class BinaryTraceFileTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param compress whether the file is compressed
+   */
+  BinaryTraceFileTestCase (bool compress);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Record the events of the test.
+   * \param stream the stream of the binary file
+   */
+  void RecordEvents (Ptr<OutputStreamWrapper> stream);
+
+  bool m_compress; //!< The file is compressed
+};
+
+BinaryTraceFileTestCase::BinaryTraceFileTestCase (bool compress)
+  : TestCase (compress ? "Check the compressed binary trace files" : "Check the binary trace files"),
+    m_compress (compress)
+{
+}
+
+void
+BinaryTraceFileTestCase::RecordEvents (Ptr<OutputStreamWrapper> stream)
+{
+  Ptr<Packet> p = Create<Packet> (reinterpret_cast<const uint8_t*> ("hello"), 5);
+  std::string context = "/NodeList/3/DeviceList/1/$ns3::PointToPointNetDevice/TxQueue/Enqueue";
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, context, p);
+  *stream->GetStream () << "a line of text" << std::endl;
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, p);
+  AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, "/NodeList/2/DeviceList/0/MacRx", p);
+  AsciiTraceHelper::DefaultDropSinkWithContext (stream, "/NodeList/2", p);
+  // Enough records for several blocks
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, context, p);
+    }
+}
+
+void
+BinaryTraceFileTestCase::DoRun (void)
+{
+#ifndef HAVE_ZLIB
+  if (m_compress)
+    {
+      return;
+    }
+#endif
+  std::string filename = CreateTempDirFilename (m_compress ? "trace.btr.gz" : "trace.btr");
+  AsciiTraceHelper ascii;
+  Ptr<OutputStreamWrapper> stream = ascii.CreateBinaryFileStream (filename, 4, m_compress);
+  NS_TEST_ASSERT_MSG_NE (stream->GetBinaryFile (), 0, "Not a binary stream");
+  Simulator::Schedule (Seconds (1.5), &BinaryTraceFileTestCase::RecordEvents, this, stream);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // Closes the file
+  stream = 0;
+
+  std::ostringstream text;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ConvertToText (filename, text), true, "Cannot convert " << filename);
+  std::istringstream lines (text.str ());
+  std::string line;
+  std::vector<std::string> expected;
+  expected.push_back ("+ 1.5 /NodeList/3/DeviceList/1/$ns3::PointToPointNetDevice/TxQueue/Enqueue uid=");
+  expected.push_back ("a line of text");
+  expected.push_back ("- 1.5 uid=");
+  expected.push_back ("r 1.5 /NodeList/2/DeviceList/0/MacRx uid=");
+  expected.push_back ("d 1.5 /NodeList/2 uid=");
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (std::getline (lines, line).fail (), false, "Missing line " << i);
+      NS_TEST_EXPECT_MSG_EQ (line.substr (0, expected[i].size ()), expected[i], "Wrong line " << i);
+      if (i != 1)
+        {
+          std::string packet = " size=5 bytes=68656c6c";
+          bool end = line.size () >= packet.size () && line.substr (line.size () - packet.size ()) == packet;
+          NS_TEST_EXPECT_MSG_EQ (end, true, "Wrong packet in line " << line);
+        }
+    }
+  uint32_t count = 0;
+  while (std::getline (lines, line))
+    {
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 10000, "Wrong number of lines");
+
+  if (!m_compress)
+    {
+      // The first block starts with its time column, then the event, node
+      // and device columns.
+      std::ifstream f (filename.c_str (), std::ios::in | std::ios::binary);
+      uint32_t header[6];
+      f.read (reinterpret_cast<char *> (header), sizeof (header));
+      NS_TEST_ASSERT_MSG_EQ (header[0], BinaryTraceFile::MAGIC, "Wrong magic number");
+      NS_TEST_ASSERT_MSG_EQ (header[2], 4, "Wrong number of bytes per packet");
+      uint32_t records = header[4];
+      NS_TEST_ASSERT_MSG_EQ (records, BinaryTraceFile::RECORDS_PER_BLOCK, "Wrong number of records in the first block");
+      std::vector<int64_t> time (records);
+      std::vector<uint8_t> event (records);
+      std::vector<uint32_t> node (records);
+      std::vector<uint32_t> device (records);
+      f.read (reinterpret_cast<char *> (time.data ()), records * sizeof (int64_t));
+      f.read (reinterpret_cast<char *> (event.data ()), records);
+      f.read (reinterpret_cast<char *> (node.data ()), records * sizeof (uint32_t));
+      f.read (reinterpret_cast<char *> (device.data ()), records * sizeof (uint32_t));
+      NS_TEST_ASSERT_MSG_EQ (f.fail (), false, "Truncated block");
+      // A context definition, then the first enqueue
+      NS_TEST_EXPECT_MSG_EQ (event[0], BinaryTraceFile::CONTEXT, "Wrong event type");
+      NS_TEST_EXPECT_MSG_EQ (event[1], '+', "Wrong event type");
+      NS_TEST_EXPECT_MSG_EQ (time[1], 1500000000, "Wrong time");
+      NS_TEST_EXPECT_MSG_EQ (node[1], 3, "Wrong node");
+      NS_TEST_EXPECT_MSG_EQ (device[1], 1, "Wrong device");
+      // The dequeue without context
+      NS_TEST_EXPECT_MSG_EQ (event[3], '-', "Wrong event type");
+      NS_TEST_EXPECT_MSG_EQ (node[3], BinaryTraceFile::NO_INDEX, "Wrong node");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace file TestSuite
+ */
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceFileTestCase (false), TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileTestCase (true), TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite g_binaryTraceFileTestSuite; //!< Static variable for test initialization
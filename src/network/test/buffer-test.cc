@@ -22,6 +22,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -378,6 +379,98 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Zero area (virtual payload) unit tests.
+ */
+class BufferZeroAreaTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  BufferZeroAreaTest ();
+private:
+  /**
+   * Checks the buffer content: header bytes, then zero bytes, then
+   * trailer bytes.
+   * \param b The buffer to check
+   * \param header The number of header bytes
+   * \param headerValue The value of the header bytes
+   * \param zeroes The number of zero bytes
+   * \param trailer The number of trailer bytes
+   * \param trailerValue The value of the trailer bytes
+   * \returns true if the content is the expected one
+   */
+  bool CheckContent (Buffer b, uint32_t header, uint8_t headerValue,
+                     uint32_t zeroes, uint32_t trailer, uint8_t trailerValue);
+};
+
+BufferZeroAreaTest::BufferZeroAreaTest ()
+  : TestCase ("Buffer zero area") {
+}
+
+bool
+BufferZeroAreaTest::CheckContent (Buffer b, uint32_t header, uint8_t headerValue,
+                                  uint32_t zeroes, uint32_t trailer, uint8_t trailerValue)
+{
+  if (b.GetSize () != header + zeroes + trailer)
+    {
+      return false;
+    }
+  std::vector<uint8_t> data (b.GetSize ());
+  b.CopyData (data.data (), data.size ());
+  for (uint32_t j = 0; j < data.size (); j++)
+    {
+      uint8_t expected = j < header ? headerValue : j < header + zeroes ? 0 : trailerValue;
+      if (data[j] != expected)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+BufferZeroAreaTest::DoRun (void)
+{
+  // A payload with a header, cut into fragments which are put back
+  // together, as done by the IP reassembly and the TCP buffers.
+  Buffer payload (3000);
+  payload.AddAtStart (20);
+  payload.Begin ().WriteU8 (0xaa, 20);
+  Buffer first = payload.CreateFragment (0, 1000);
+  Buffer second = payload.CreateFragment (1000, 1000);
+  Buffer third = payload.CreateFragment (2000, 1020);
+
+  Buffer whole = first;
+  whole.AddAtEnd (second);
+  whole.AddAtEnd (third);
+  NS_TEST_EXPECT_MSG_EQ (CheckContent (whole, 20, 0xaa, 3000, 0, 0), true, "bad reassembled content");
+  // only the header is made of real bytes: 3 lengths and the 20 header bytes
+  NS_TEST_EXPECT_MSG_EQ (whole.GetSerializedSize (), 12 + 20, "the zero area must stay virtual");
+
+  // the buffers which shared their data with the reassembled one are untouched
+  whole.AddAtEnd (4);
+  Buffer::Iterator i = whole.End ();
+  i.Prev (4);
+  i.WriteU8 (0xbb, 4);
+  first.AddAtEnd (4);
+  i = first.End ();
+  i.Prev (4);
+  i.WriteU8 (0xcc, 4);
+  NS_TEST_EXPECT_MSG_EQ (CheckContent (whole, 20, 0xaa, 3000, 4, 0xbb), true, "shared trailer overwritten");
+  NS_TEST_EXPECT_MSG_EQ (CheckContent (first, 20, 0xaa, 980, 4, 0xcc), true, "bad fragment content");
+  NS_TEST_EXPECT_MSG_EQ (CheckContent (payload, 20, 0xaa, 3000, 0, 0), true, "original payload modified");
+
+  // zero areas which are not adjacent are still concatenated
+  whole.AddAtEnd (third);
+  NS_TEST_EXPECT_MSG_EQ (whole.GetSize (), 3024 + 1020, "bad size");
+  std::vector<uint8_t> data (whole.GetSize ());
+  whole.CopyData (data.data (), data.size ());
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)data[3020], 0xbb, "bad trailer");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)data[3024], 0, "bad concatenated zero area");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -394,6 +487,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferZeroAreaTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
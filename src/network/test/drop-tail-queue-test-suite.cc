@@ -19,6 +19,9 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+
+#include <deque>
 
 using namespace ns3;
 
@@ -83,6 +86,93 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the DropTailQueue keeps the FIFO order with both storages,
+ * while the ring buffer wraps around and grows, and when the storage is
+ * changed with items in the queue.
+ */
+class DropTailQueueStorageTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param storage the storage of the queue
+   */
+  DropTailQueueStorageTestCase (QueueBase::QueueStorage storage);
+  virtual void DoRun (void);
+
+private:
+  QueueBase::QueueStorage m_storage; //!< the storage of the queue
+};
+
+DropTailQueueStorageTestCase::DropTailQueueStorageTestCase (QueueBase::QueueStorage storage)
+  : TestCase (std::string ("Check the order of the drop tail queue with the ")
+              + (storage == QueueBase::QUEUE_STORAGE_RING ? "ring" : "list") + " storage"),
+    m_storage (storage)
+{
+}
+
+void
+DropTailQueueStorageTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (1000));
+  queue->SetAttribute ("Storage", EnumValue (m_storage));
+
+  std::deque<Ptr<Packet> > expected;
+  uint32_t dropped = 0;
+  // Grow and shrink the queue, so that the ring wraps around at various
+  // capacities, up to the limit of the queue.
+  for (uint32_t round = 0; round < 40; round++)
+    {
+      uint32_t enqueue = (round * 37) % 101 + 25 * (round % 3);
+      for (uint32_t i = 0; i < enqueue; i++)
+        {
+          Ptr<Packet> p = Create<Packet> (i % 50);
+          if (queue->Enqueue (p))
+            {
+              expected.push_back (p);
+            }
+          else
+            {
+              dropped++;
+            }
+        }
+      uint32_t dequeue = (round * 53) % 89;
+      for (uint32_t i = 0; i < dequeue && !expected.empty (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue->Peek (), expected.front (), "Bad head in round " << round);
+          NS_TEST_ASSERT_MSG_EQ (queue->Dequeue (), expected.front (), "Bad order in round " << round);
+          expected.pop_front ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue->GetNPackets (), expected.size (), "Bad number of packets");
+      if (round == 20)
+        {
+          // Switch the storage with items in the queue.
+          queue->SetAttribute ("Storage", EnumValue (m_storage == QueueBase::QUEUE_STORAGE_RING ?
+                                                     QueueBase::QUEUE_STORAGE_LIST :
+                                                     QueueBase::QUEUE_STORAGE_RING));
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), dropped, "Bad number of dropped packets");
+
+  // Remove drops from the head.
+  Ptr<Packet> removed = queue->Remove ();
+  NS_TEST_EXPECT_MSG_EQ (removed, expected.front (), "Bad removed packet");
+  expected.pop_front ();
+  while (!expected.empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (queue->Dequeue (), expected.front (), "Bad order at the end");
+      expected.pop_front ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "There are really no packets in there");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -96,6 +186,8 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueStorageTestCase (QueueBase::QUEUE_STORAGE_RING), TestCase::QUICK);
+    AddTestCase (new DropTailQueueStorageTestCase (QueueBase::QUEUE_STORAGE_LIST), TestCase::QUICK);
   }
 };
 
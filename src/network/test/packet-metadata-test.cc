@@ -319,6 +319,11 @@ HistoryTrailer<N>::Deserialize (Buffer::Iterator start)
 class PacketMetadataTest : public TestCase {
 public:
   PacketMetadataTest ();
+  /**
+   * Constructor
+   * \param name The name of the test
+   */
+  PacketMetadataTest (std::string name);
   virtual ~PacketMetadataTest ();
   /**
    * Checks the packet header and trailer history
@@ -344,6 +349,11 @@ PacketMetadataTest::PacketMetadataTest ()
 {
 }
 
+PacketMetadataTest::PacketMetadataTest (std::string name)
+  : TestCase (name)
+{
+}
+
 PacketMetadataTest::~PacketMetadataTest ()
 {
 }
@@ -903,6 +913,96 @@ PacketMetadataTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet Metadata unit tests in light mode.
+ */
+class PacketMetadataLightTest : public PacketMetadataTest {
+public:
+  PacketMetadataLightTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Checks the history of packets in light mode
+   */
+  void CheckLightHistory (void);
+};
+
+PacketMetadataLightTest::PacketMetadataLightTest ()
+  : PacketMetadataTest ("Packet metadata in light mode")
+{
+}
+
+void
+PacketMetadataLightTest::DoRun (void)
+{
+  // The mode cannot change while packets exist: all the packets of the
+  // test are destroyed before it is restored.
+  bool light = PacketMetadata::m_light;
+  PacketMetadata::Enable ();
+  PacketMetadata::m_light = true;
+  CheckLightHistory ();
+  PacketMetadata::m_light = light;
+}
+
+void
+PacketMetadataLightTest::CheckLightHistory (void)
+{
+  Ptr<Packet> p = Create<Packet> (10);
+  ADD_HEADER (p, 1);
+  ADD_HEADER (p, 2);
+  CHECK_HISTORY (p, 3, 2, 1, 10);
+  REM_HEADER (p, 2);
+  CHECK_HISTORY (p, 2, 1, 10);
+  // the trailers are part of the payload
+  ADD_TRAILER (p, 5);
+  CHECK_HISTORY (p, 2, 1, 15);
+  p->RemoveAtStart (1);
+  CHECK_HISTORY (p, 1, 15);
+  REM_TRAILER (p, 5);
+  CHECK_HISTORY (p, 1, 10);
+
+  p = Create<Packet> (10);
+  ADD_HEADER (p, 3);
+  ADD_HEADER (p, 4);
+  // a part of a header is not a header
+  Ptr<Packet> fragment = p->CreateFragment (0, 5);
+  CHECK_HISTORY (fragment, 2, 4, 1);
+  fragment = p->CreateFragment (4, 13);
+  CHECK_HISTORY (fragment, 2, 3, 10);
+  fragment = p->CreateFragment (2, 10);
+  CHECK_HISTORY (fragment, 1, 10);
+
+  // the headers of a concatenated packet are payload
+  Ptr<Packet> empty = Create<Packet> ();
+  empty->AddAtEnd (p);
+  CHECK_HISTORY (empty, 3, 4, 3, 10);
+  Ptr<Packet> other = Create<Packet> (5);
+  ADD_HEADER (other, 1);
+  other->AddAtEnd (p);
+  CHECK_HISTORY (other, 2, 1, 22);
+  other->RemoveAtEnd (21);
+  CHECK_HISTORY (other, 2, 1, 1);
+
+  // only the first headers of the packet are recorded
+  p = Create<Packet> (1);
+  ADD_HEADER (p, 1);
+  ADD_HEADER (p, 2);
+  ADD_HEADER (p, 3);
+  ADD_HEADER (p, 4);
+  ADD_HEADER (p, 5);
+  ADD_HEADER (p, 6);
+  ADD_HEADER (p, 7);
+  ADD_HEADER (p, 8);
+  ADD_HEADER (p, 9);
+  CHECK_HISTORY (p, 9, 9, 8, 7, 6, 5, 4, 3, 2, 2);
+  REM_HEADER (p, 9);
+  REM_HEADER (p, 8);
+  CHECK_HISTORY (p, 7, 7, 6, 5, 4, 3, 2, 2);
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -919,6 +1019,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
+  AddTestCase (new PacketMetadataLightTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
@@ -1035,6 +1035,91 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet tags with a fixed slot in the PacketTagList.
+ */
+class PacketTagSlotTest : public TestCase
+{
+public:
+  PacketTagSlotTest ();
+
+private:
+  void DoRun (void);
+};
+
+PacketTagSlotTest::PacketTagSlotTest ()
+  : TestCase ("PacketTagSlotTest: tags with a fixed slot")
+{
+}
+
+void
+PacketTagSlotTest::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (PacketTagList::RegisterFastTag (ATestTag<0> ()), true,
+                         "no slot left for the test tag");
+  // registering twice is harmless
+  NS_TEST_ASSERT_MSG_EQ (PacketTagList::RegisterFastTag (ATestTag<0> ()), true,
+                         "a registered tag must keep its slot");
+
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddPacketTag (ATestTag<1> (1));
+  p->AddPacketTag (ATestTag<0> (7));
+  p->AddPacketTag (ATestTag<2> (2));
+
+  ATestTag<0> slot;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (slot), true, "slot tag not found");
+  NS_TEST_EXPECT_MSG_EQ (slot.GetData (), 7, "wrong slot tag value");
+  NS_TEST_EXPECT_MSG_EQ (slot.m_error, false, "slot tag corrupted");
+  ATestTag<1> a1;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (a1), true, "list tag not found");
+  NS_TEST_EXPECT_MSG_EQ (a1.GetData (), 1, "wrong list tag value");
+
+  // the iterator visits the slots and the list
+  uint32_t count = 0;
+  bool foundSlot = false;
+  PacketTagIterator i = p->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      PacketTagIterator::Item item = i.Next ();
+      if (item.GetTypeId () == ATestTag<0>::GetTypeId ())
+        {
+          ATestTag<0> tag;
+          item.GetTag (tag);
+          foundSlot = tag.GetData () == 7;
+        }
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 3, "the iterator must visit every tag");
+  NS_TEST_EXPECT_MSG_EQ (foundSlot, true, "the iterator must visit the slot tag");
+
+  // copies are independent
+  Ptr<Packet> copy = p->Copy ();
+  ATestTag<0> replacement (8);
+  NS_TEST_EXPECT_MSG_EQ (copy->ReplacePacketTag (replacement), true, "slot tag not replaced");
+  p->PeekPacketTag (slot);
+  NS_TEST_EXPECT_MSG_EQ (slot.GetData (), 7, "replacing in a copy changed the original");
+  copy->PeekPacketTag (slot);
+  NS_TEST_EXPECT_MSG_EQ (slot.GetData (), 8, "wrong replaced value");
+
+  NS_TEST_EXPECT_MSG_EQ (p->RemovePacketTag (slot), true, "slot tag not removed");
+  NS_TEST_EXPECT_MSG_EQ (slot.GetData (), 7, "wrong removed value");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (slot), false, "removed slot tag still found");
+  NS_TEST_EXPECT_MSG_EQ (p->RemovePacketTag (slot), false, "removed slot tag removed twice");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (slot), true, "removing from the original changed the copy");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (a1), true, "list tag lost");
+
+  // a tag can be added again once removed
+  NS_TEST_EXPECT_MSG_EQ (p->ReplacePacketTag (replacement), false, "replace must add a missing tag");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (slot), true, "added slot tag not found");
+
+  copy->RemoveAllPacketTags ();
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (slot), false, "slot tag not removed by RemoveAll");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetPacketTagIterator ().HasNext (), false, "tags left after RemoveAll");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1052,6 +1137,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketTagSlotTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
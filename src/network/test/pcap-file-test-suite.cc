@@ -20,11 +20,22 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
+#include <vector>
 #include <cstring>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -46,6 +57,15 @@ Swap (uint32_t val)
   return ((val >> 24) & 0x000000ff) | ((val >> 8) & 0x0000ff00) | ((val << 8) & 0x00ff0000) | ((val << 24) & 0xff000000);
 }
 
+static std::string
+ReadFileContents (std::string filename)
+{
+  std::ifstream f (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream contents;
+  contents << f.rdbuf ();
+  return contents.str ();
+}
+
 static bool
 CheckFileExists (std::string filename)
 {
@@ -1144,6 +1164,187 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the files written through memory
+ * buffers, by a background thread or compressed, are the same as the
+ * files written directly.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Write the known packets to a file.
+   * \param filename the name of the file
+   * \param bufferSize the size of the memory buffers, or 0 to write
+   *        the file directly
+   * \param asynchronous whether the buffers are written by a thread
+   * \param compress whether the file is compressed
+   */
+  void WriteKnownPackets (std::string filename, uint32_t bufferSize, bool asynchronous, bool compress);
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that buffered, asynchronous and compressed pcap files are correct")
+{
+}
+
+void
+BufferedWriteTestCase::WriteKnownPackets (std::string filename, uint32_t bufferSize, bool asynchronous, bool compress)
+{
+  PcapFile f;
+  if (bufferSize == 0)
+    {
+      f.Open (filename, std::ios::out);
+    }
+  else
+    {
+      f.OpenBuffered (filename, bufferSize, asynchronous, compress);
+    }
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+  f.Init (1, N_PACKET_BYTES);
+
+  for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+      PacketEntry const & p = knownPackets[i];
+      f.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+      NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+    }
+  // Packets larger than the buffers go through a buffer of their own.
+  Ptr<Packet> large = Create<Packet> (3000);
+  f.Write (5, 0, large);
+  f.Close ();
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Close must not fail");
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string direct = CreateTempDirFilename ("direct.pcap");
+  WriteKnownPackets (direct, 0, false, false);
+  std::string expected = ReadFileContents (direct);
+  NS_TEST_ASSERT_MSG_EQ (expected.empty (), false, "The direct file must not be empty");
+
+  std::string buffered = CreateTempDirFilename ("buffered.pcap");
+  WriteKnownPackets (buffered, 50, false, false);
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileContents (buffered) == expected), true, "Buffered file differs");
+
+  std::string asynchronous = CreateTempDirFilename ("asynchronous.pcap");
+  WriteKnownPackets (asynchronous, 50, true, false);
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileContents (asynchronous) == expected), true, "Asynchronous file differs");
+
+#ifdef HAVE_ZLIB
+  std::string compressed = CreateTempDirFilename ("compressed.pcap.gz");
+  WriteKnownPackets (compressed, 50, true, true);
+  gzFile gz = gzopen (compressed.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (gz, 0, "Cannot open " << compressed);
+  std::string contents;
+  char data[256];
+  int read;
+  while ((read = gzread (gz, data, sizeof (data))) > 0)
+    {
+      contents.append (data, read);
+    }
+  gzclose (gz);
+  NS_TEST_EXPECT_MSG_EQ ((contents == expected), true, "Uncompressed file differs");
+#endif
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the PcapFileWrapper objects with the
+ * same PcapNgFile attribute write to a single PCAPNG file.
+ */
+class PcapNgTestCase : public TestCase
+{
+public:
+  PcapNgTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgTestCase::PcapNgTestCase ()
+  : TestCase ("Check that PcapFileWrapper objects share a PCAPNG file")
+{
+}
+
+void
+PcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("shared.pcapng");
+
+  Ptr<PcapFileWrapper> first = CreateObject<PcapFileWrapper> ();
+  first->SetAttribute ("PcapNgFile", StringValue (filename));
+  first->Open ("first.pcap", std::ios::out);
+  first->Init (1, 100);
+  Ptr<PcapFileWrapper> second = CreateObject<PcapFileWrapper> ();
+  second->SetAttribute ("PcapNgFile", StringValue (filename));
+  second->SetAttribute ("NanosecMode", BooleanValue (true));
+  second->Open ("second.pcap", std::ios::out);
+  second->Init (101, 100);
+
+  first->Write (Seconds (1.5), Create<Packet> (10));
+  second->Write (NanoSeconds (2000000123), Create<Packet> (200));
+  NS_TEST_ASSERT_MSG_EQ (second->Fail (), false, "Writing " << filename << " failed");
+  first->Close ();
+  second->Close ();
+
+  std::string contents = ReadFileContents (filename);
+  const uint8_t *block = reinterpret_cast<const uint8_t *> (contents.data ());
+  const uint8_t *end = block + contents.size ();
+  std::vector<uint32_t> types;
+  std::vector<uint32_t> fields;
+  while (block + 8 <= end)
+    {
+      uint32_t type;
+      uint32_t length;
+      std::memcpy (&type, block, 4);
+      std::memcpy (&length, block + 4, 4);
+      NS_TEST_ASSERT_MSG_EQ ((length % 4 == 0 && block + length <= end), true, "Bad block length " << length);
+      uint32_t trailer;
+      std::memcpy (&trailer, block + length - 4, 4);
+      NS_TEST_ASSERT_MSG_EQ (trailer, length, "Block lengths must match");
+      types.push_back (type);
+      if (type == 6)
+        {
+          // Interface ID, timestamp and lengths of the packet.
+          for (uint32_t i = 0; i < 5; ++i)
+            {
+              uint32_t field;
+              std::memcpy (&field, block + 8 + 4 * i, 4);
+              fields.push_back (field);
+            }
+        }
+      block += length;
+    }
+  NS_TEST_EXPECT_MSG_EQ ((block == end), true, "Trailing bytes in the file");
+  NS_TEST_ASSERT_MSG_EQ (types.size (), 5, "Expected a section, two interfaces and two packets");
+  NS_TEST_EXPECT_MSG_EQ (types[0], 0x0a0d0d0a, "Expected a Section Header Block");
+  NS_TEST_EXPECT_MSG_EQ (types[1], 1, "Expected an Interface Description Block");
+  NS_TEST_EXPECT_MSG_EQ (types[2], 1, "Expected an Interface Description Block");
+  NS_TEST_EXPECT_MSG_EQ (types[3], 6, "Expected an Enhanced Packet Block");
+  NS_TEST_EXPECT_MSG_EQ (types[4], 6, "Expected an Enhanced Packet Block");
+
+  NS_TEST_EXPECT_MSG_EQ (fields[0], 0, "The first packet is on the first interface");
+  NS_TEST_EXPECT_MSG_EQ (((uint64_t (fields[1]) << 32) | fields[2]), 1500000, "Timestamp in microseconds");
+  NS_TEST_EXPECT_MSG_EQ (fields[3], 10, "Captured length");
+  NS_TEST_EXPECT_MSG_EQ (fields[4], 10, "Original length");
+  NS_TEST_EXPECT_MSG_EQ (fields[5], 1, "The second packet is on the second interface");
+  NS_TEST_EXPECT_MSG_EQ (((uint64_t (fields[6]) << 32) | fields[7]), 2000000123, "Timestamp in nanoseconds");
+  NS_TEST_EXPECT_MSG_EQ (fields[8], 100, "Captured length limited by the snapshot length");
+  NS_TEST_EXPECT_MSG_EQ (fields[9], 200, "Original length");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1368,8 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,444 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/core-config.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "binary-trace-file.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace {
+
+/**
+ * \brief Parse "/Name/index" at the start of a context.
+ *
+ * \param context the context
+ * \param pos the position in the context, moved past the index
+ * \param name the expected name, with its slashes
+ * \param index the index
+ * \return true if the context matches
+ */
+bool
+ParseIndex (std::string const &context, std::string::size_type &pos, const char *name, uint32_t &index)
+{
+  std::string::size_type length = std::strlen (name);
+  if (context.compare (pos, length, name) != 0)
+    {
+      return false;
+    }
+  const char *start = context.c_str () + pos + length;
+  char *end;
+  unsigned long value = std::strtoul (start, &end, 10);
+  if (end == start || (*end != '/' && *end != '\0'))
+    {
+      return false;
+    }
+  index = static_cast<uint32_t> (value);
+  pos = end - context.c_str ();
+  return true;
+}
+
+/**
+ * \brief A reader of a file, possibly compressed with gzip.
+ */
+class Reader
+{
+public:
+  /**
+   * Constructor
+   * \param filename the name of the file
+   */
+  Reader (std::string const &filename)
+#ifdef HAVE_ZLIB
+    : m_gzFile (gzopen (filename.c_str (), "rb"))
+#else
+    : m_file (filename.c_str (), std::ios::in | std::ios::binary)
+#endif
+  {
+  }
+  ~Reader ()
+  {
+#ifdef HAVE_ZLIB
+    if (m_gzFile != 0)
+      {
+        gzclose (m_gzFile);
+      }
+#endif
+  }
+  /**
+   * \param data the space for the bytes
+   * \param size the number of bytes to read
+   * \return false if the bytes cannot be read
+   */
+  bool Read (void *data, uint32_t size)
+  {
+    if (size == 0)
+      {
+        return true;
+      }
+#ifdef HAVE_ZLIB
+    return m_gzFile != 0 && gzread (m_gzFile, data, size) == static_cast<int> (size);
+#else
+    m_file.read (static_cast<char *> (data), size);
+    return !m_file.fail ();
+#endif
+  }
+  /**
+   * \brief Read a column.
+   * \param column the column
+   * \param count the number of values
+   * \return false if the values cannot be read
+   */
+  template <typename T>
+  bool ReadColumn (std::vector<T> &column, uint32_t count)
+  {
+    column.resize (count);
+    return Read (column.data (), count * sizeof (T));
+  }
+
+private:
+#ifdef HAVE_ZLIB
+  gzFile m_gzFile; //!< The file
+#else
+  std::ifstream m_file; //!< The file
+#endif
+};
+
+/**
+ * \brief Append a column to a buffer.
+ * \param buffer the buffer, moved past the column
+ * \param column the column
+ */
+template <typename T>
+void
+AppendColumn (uint8_t *&buffer, std::vector<T> const &column)
+{
+  uint32_t size = column.size () * sizeof (T);
+  if (size > 0)
+    {
+      std::memcpy (buffer, column.data (), size);
+      buffer += size;
+    }
+}
+
+} // anonymous namespace
+
+BinaryTraceFile::TextBuffer::TextBuffer (BinaryTraceFile *file)
+  : m_file (file)
+{
+}
+
+BinaryTraceFile::TextBuffer::int_type
+BinaryTraceFile::TextBuffer::overflow (int_type c)
+{
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  char ch = traits_type::to_char_type (c);
+  xsputn (&ch, 1);
+  return c;
+}
+
+std::streamsize
+BinaryTraceFile::TextBuffer::xsputn (const char *s, std::streamsize n)
+{
+  const char *end = s + n;
+  while (s != end)
+    {
+      const char *newline = std::find (s, end, '\n');
+      m_line.append (s, newline);
+      if (newline == end)
+        {
+          break;
+        }
+      m_file->AddText (m_line);
+      m_line.clear ();
+      s = newline + 1;
+    }
+  return n;
+}
+
+BinaryTraceFile::BinaryTraceFile ()
+  : m_open (false),
+    m_headerBytes (0),
+    m_textBuffer (this),
+    m_textStream (&m_textBuffer)
+{
+  NS_LOG_FUNCTION (this);
+  m_noContext.id = 0;
+  m_noContext.node = NO_INDEX;
+  m_noContext.device = NO_INDEX;
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+BinaryTraceFile::Open (std::string const &filename, uint32_t headerBytes, uint32_t bufferSize, bool asynchronous, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << headerBytes << bufferSize << asynchronous << compress);
+  NS_ASSERT (!m_open);
+  m_writer.Open (filename, bufferSize, asynchronous, compress);
+  m_open = true;
+  m_headerBytes = headerBytes;
+  m_contexts.clear ();
+  // The empty context is the first one, and needs no definition.
+  m_contexts[""] = m_noContext;
+
+  uint32_t header[4] = { MAGIC, VERSION, headerBytes, 0 };
+  m_writer.Write (header, sizeof (header));
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_open)
+    {
+      WriteBlock ();
+      m_writer.Flush ();
+    }
+}
+
+void
+BinaryTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_open)
+    {
+      WriteBlock ();
+      m_writer.Close ();
+      m_open = false;
+    }
+}
+
+std::ostream *
+BinaryTraceFile::GetTextStream (void)
+{
+  return &m_textStream;
+}
+
+const BinaryTraceFile::Context &
+BinaryTraceFile::GetContext (std::string const &context)
+{
+  std::unordered_map<std::string, Context>::iterator it = m_contexts.find (context);
+  if (it != m_contexts.end ())
+    {
+      return it->second;
+    }
+  Context c;
+  c.id = m_contexts.size ();
+  c.node = NO_INDEX;
+  c.device = NO_INDEX;
+  std::string::size_type pos = 0;
+  if (ParseIndex (context, pos, "/NodeList/", c.node))
+    {
+      ParseIndex (context, pos, "/DeviceList/", c.device);
+    }
+  const Context &result = m_contexts.insert (std::make_pair (context, c)).first->second;
+  uint8_t *data = AddRecord (CONTEXT, result, 0, 0, context.size ());
+  std::memcpy (data, context.data (), context.size ());
+  return result;
+}
+
+uint8_t *
+BinaryTraceFile::AddRecord (uint8_t event, const Context &context, uint64_t uid, uint32_t size, uint32_t length)
+{
+  NS_ASSERT_MSG (m_open, "BinaryTraceFile: the file is not open");
+  if (m_time.size () == RECORDS_PER_BLOCK)
+    {
+      WriteBlock ();
+    }
+  m_time.push_back (Simulator::Now ().GetNanoSeconds ());
+  m_event.push_back (event);
+  m_node.push_back (context.node);
+  m_device.push_back (context.device);
+  m_context.push_back (context.id);
+  m_uid.push_back (uid);
+  m_size.push_back (size);
+  m_length.push_back (length);
+  std::vector<uint8_t>::size_type start = m_data.size ();
+  m_data.resize (start + length);
+  return m_data.data () + start;
+}
+
+void
+BinaryTraceFile::Write (EventType event, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  const Context &c = GetContext (context);
+  uint32_t size = p->GetSize ();
+  uint32_t length = std::min (size, m_headerBytes);
+  uint8_t *data = AddRecord (event, c, p->GetUid (), size, length);
+  if (length > 0)
+    {
+      p->CopyData (data, length);
+    }
+}
+
+void
+BinaryTraceFile::AddText (std::string const &line)
+{
+  uint8_t *data = AddRecord (TEXT, m_noContext, 0, 0, line.size ());
+  if (line.size () > 0)
+    {
+      std::memcpy (data, line.data (), line.size ());
+    }
+}
+
+void
+BinaryTraceFile::WriteBlock (void)
+{
+  uint32_t count = m_time.size ();
+  if (count == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << count);
+  uint32_t header[2] = { count, static_cast<uint32_t> (m_data.size ()) };
+  uint32_t size = sizeof (header) + count * (sizeof (int64_t) + sizeof (uint8_t) + 5 * sizeof (uint32_t) + sizeof (uint64_t))
+    + m_data.size ();
+  uint8_t *buffer = m_writer.Reserve (size);
+  std::memcpy (buffer, header, sizeof (header));
+  buffer += sizeof (header);
+  AppendColumn (buffer, m_time);
+  AppendColumn (buffer, m_event);
+  AppendColumn (buffer, m_node);
+  AppendColumn (buffer, m_device);
+  AppendColumn (buffer, m_context);
+  AppendColumn (buffer, m_uid);
+  AppendColumn (buffer, m_size);
+  AppendColumn (buffer, m_length);
+  AppendColumn (buffer, m_data);
+
+  m_time.clear ();
+  m_event.clear ();
+  m_node.clear ();
+  m_device.clear ();
+  m_context.clear ();
+  m_uid.clear ();
+  m_size.clear ();
+  m_length.clear ();
+  m_data.clear ();
+}
+
+bool
+BinaryTraceFile::ConvertToText (std::string const &filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename << &os);
+  Reader reader (filename);
+  uint32_t header[4];
+  if (!reader.Read (header, sizeof (header)) || header[0] != MAGIC || header[1] != VERSION)
+    {
+      NS_LOG_WARN ("Not a binary trace file: " << filename);
+      return false;
+    }
+
+  std::vector<std::string> contexts (1);
+  std::vector<int64_t> time;
+  std::vector<uint8_t> event;
+  std::vector<uint32_t> node;
+  std::vector<uint32_t> device;
+  std::vector<uint32_t> context;
+  std::vector<uint64_t> uid;
+  std::vector<uint32_t> size;
+  std::vector<uint32_t> length;
+  std::vector<uint8_t> data;
+  uint32_t blockHeader[2];
+  while (reader.Read (blockHeader, sizeof (blockHeader)))
+    {
+      uint32_t count = blockHeader[0];
+      if (!reader.ReadColumn (time, count) || !reader.ReadColumn (event, count)
+          || !reader.ReadColumn (node, count) || !reader.ReadColumn (device, count)
+          || !reader.ReadColumn (context, count) || !reader.ReadColumn (uid, count)
+          || !reader.ReadColumn (size, count) || !reader.ReadColumn (length, count)
+          || !reader.ReadColumn (data, blockHeader[1]))
+        {
+          NS_LOG_WARN ("Truncated binary trace file: " << filename);
+          return false;
+        }
+
+      const uint8_t *record = data.data ();
+      for (uint32_t i = 0; i < count; i++)
+        {
+          if (record + length[i] > data.data () + data.size ())
+            {
+              NS_LOG_WARN ("Corrupted binary trace file: " << filename);
+              return false;
+            }
+          std::string bytes (reinterpret_cast<const char *> (record), length[i]);
+          record += length[i];
+          switch (event[i])
+            {
+            case CONTEXT:
+              if (context[i] >= contexts.size ())
+                {
+                  contexts.resize (context[i] + 1);
+                }
+              contexts[context[i]] = bytes;
+              break;
+            case TEXT:
+              os << bytes << "\n";
+              break;
+            default:
+              os << static_cast<char> (event[i]) << " " << time[i] / 1e9 << " ";
+              if (context[i] < contexts.size () && !contexts[context[i]].empty ())
+                {
+                  os << contexts[context[i]] << " ";
+                }
+              os << "uid=" << uid[i] << " size=" << size[i];
+              if (length[i] > 0)
+                {
+                  os << " bytes=" << std::hex << std::setfill ('0');
+                  for (uint32_t j = 0; j < length[i]; j++)
+                    {
+                      os << std::setw (2) << static_cast<uint32_t> (static_cast<uint8_t> (bytes[j]));
+                    }
+                  os << std::dec << std::setfill (' ');
+                }
+              os << "\n";
+              break;
+            }
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <streambuf>
+#include <unordered_map>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "pcap-writer.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief A binary, columnar file of trace events, written with a
+ * PcapWriter.
+ *
+ * This is a compact alternative to the ascii trace files: instead of
+ * printing each packet, the events are recorded with a fixed schema
+ * (time in nanoseconds, event type, node, device, trace context, packet
+ * uid, packet size) and, optionally, the first bytes of the packet.
+ * The records are grouped in blocks of up to RECORDS_PER_BLOCK records,
+ * each block storing its columns one after the other.
+ *
+ * The node and device are taken from the trace context
+ * ("/NodeList/n/DeviceList/d/..."), and are NO_INDEX when the context
+ * does not name them.  Each context is written once, in a CONTEXT
+ * record whose data is the context string; the packet records refer to
+ * it by ID.  Lines written to GetTextStream() are kept as TEXT records,
+ * so that the trace sinks which print their own lines still work.
+ *
+ * The file starts with a header of four 32-bit words (MAGIC, version,
+ * number of packet bytes saved per record, reserved), in the byte order
+ * of the host.  ConvertToText() prints the file in the ascii trace
+ * format, see the binary-trace-to-ascii utility.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /** The type of a record. */
+  enum EventType
+  {
+    CONTEXT = 0,   //!< Definition of a trace context
+    TEXT = 1,      //!< A line of text
+    ENQUEUE = '+', //!< A packet was enqueued
+    DEQUEUE = '-', //!< A packet was dequeued
+    DROP = 'd',    //!< A packet was dropped
+    RECEIVE = 'r'  //!< A packet was received
+  };
+
+  static const uint32_t MAGIC = 0x6e334254;           //!< Magic number of the files
+  static const uint32_t VERSION = 1;                  //!< Version of the format
+  static const uint32_t NO_INDEX = 0xffffffff;        //!< Unknown node or device
+  static const uint32_t RECORDS_PER_BLOCK = 4096;     //!< The maximum number of records per block
+
+  BinaryTraceFile ();
+  ~BinaryTraceFile ();
+
+  /**
+   * \brief Create a file, and write its header.
+   *
+   * \param filename the name of the file
+   * \param headerBytes the number of bytes saved from the start of each packet
+   * \param bufferSize the size of the memory buffers, in bytes
+   * \param asynchronous whether the buffers are written by a background thread
+   * \param compress whether the file is compressed with gzip
+   */
+  void Open (std::string const &filename, uint32_t headerBytes, uint32_t bufferSize, bool asynchronous, bool compress);
+
+  /**
+   * \return true if the file could not be opened or written
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Write the pending records, and flush the file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Write the pending records, and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \brief Record a packet event at the current simulation time.
+   *
+   * \param event the type of the event
+   * \param context the trace context, possibly empty
+   * \param p the packet
+   */
+  void Write (EventType event, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \return a stream whose lines are recorded as TEXT records
+   */
+  std::ostream *GetTextStream (void);
+
+  /**
+   * \brief Print a binary trace file in the ascii trace format.
+   *
+   * The packet records are printed as
+   * "event seconds [context] uid=uid size=size [bytes=hex]", and the
+   * TEXT records as they were written.
+   *
+   * \param filename the name of the file, possibly compressed with gzip
+   * \param os the output
+   * \return false if the file cannot be read
+   */
+  static bool ConvertToText (std::string const &filename, std::ostream &os);
+
+private:
+  /** A stream buffer which records each line as a TEXT record. */
+  class TextBuffer : public std::streambuf
+  {
+public:
+    /**
+     * Constructor
+     * \param file the file of the records
+     */
+    TextBuffer (BinaryTraceFile *file);
+
+protected:
+    virtual int_type overflow (int_type c);
+    virtual std::streamsize xsputn (const char *s, std::streamsize n);
+
+private:
+    BinaryTraceFile *m_file; //!< The file of the records
+    std::string m_line;      //!< The line being written
+  };
+
+  /** A trace context. */
+  struct Context
+  {
+    uint32_t id;     //!< The ID of the context
+    uint32_t node;   //!< The node of the context
+    uint32_t device; //!< The device of the context
+  };
+
+  /**
+   * \brief Copy constructor (disabled).
+   * \param o object to copy
+   */
+  BinaryTraceFile (const BinaryTraceFile &o);
+  /**
+   * \brief Assignment operator (disabled).
+   * \param o object to copy
+   * \returns the copied object
+   */
+  BinaryTraceFile &operator= (const BinaryTraceFile &o);
+
+  /**
+   * \brief Find a context, and define it if it is new.
+   * \param context the trace context
+   * \return the context
+   */
+  const Context &GetContext (std::string const &context);
+  /**
+   * \brief Add a record to the current block.
+   *
+   * \param event the type of the event
+   * \param context the context
+   * \param uid the uid of the packet
+   * \param size the size of the packet
+   * \param length the number of bytes of data
+   * \return the space for the data of the record
+   */
+  uint8_t *AddRecord (uint8_t event, const Context &context, uint64_t uid, uint32_t size, uint32_t length);
+  /**
+   * \brief Add a line of text.
+   * \param line the line
+   */
+  void AddText (std::string const &line);
+  /**
+   * \brief Write the current block to the file.
+   */
+  void WriteBlock (void);
+
+  PcapWriter m_writer;             //!< The file
+  bool m_open;                     //!< The file is open
+  uint32_t m_headerBytes;          //!< The number of bytes saved per packet
+  std::unordered_map<std::string, Context> m_contexts; //!< The contexts, by string
+  Context m_noContext;             //!< The empty context
+  TextBuffer m_textBuffer;         //!< The buffer of the TEXT records
+  std::ostream m_textStream;       //!< The stream of the TEXT records
+
+  std::vector<int64_t> m_time;     //!< Time column, in nanoseconds
+  std::vector<uint8_t> m_event;    //!< Event type column
+  std::vector<uint32_t> m_node;    //!< Node column
+  std::vector<uint32_t> m_device;  //!< Device column
+  std::vector<uint32_t> m_context; //!< Context ID column
+  std::vector<uint64_t> m_uid;     //!< Packet uid column
+  std::vector<uint32_t> m_size;    //!< Packet size column
+  std::vector<uint32_t> m_length;  //!< Data length column
+  std::vector<uint8_t> m_data;     //!< Data of all the records
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -20,6 +20,7 @@
 #define DROPTAIL_H
 
 #include "ns3/queue.h"
+#include "ns3/enum.h"
 
 namespace ns3 {
 
@@ -27,6 +28,9 @@ namespace ns3 {
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * The items are stored in a ring buffer by default, so that they are
+ * enqueued and dequeued without allocation (see the Storage attribute).
  */
 template <typename Item>
 class DropTailQueue : public Queue<Item>
@@ -75,6 +79,13 @@ DropTailQueue<Item>::GetTypeId (void)
     .SetParent<Queue<Item> > ()
     .SetGroupName ("Network")
     .template AddConstructor<DropTailQueue<Item> > ()
+    .AddAttribute ("Storage",
+                   "The container which stores the items.",
+                   EnumValue (QueueBase::QUEUE_STORAGE_RING),
+                   MakeEnumAccessor (&DropTailQueue<Item>::SetStorage,
+                                     &DropTailQueue<Item>::GetStorage),
+                   MakeEnumChecker (QueueBase::QUEUE_STORAGE_RING, "QUEUE_STORAGE_RING",
+                                    QueueBase::QUEUE_STORAGE_LIST, "QUEUE_STORAGE_LIST"))
   ;
   return tid;
 }
@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-file.h"
 
 namespace ns3 {
 
@@ -64,6 +65,10 @@ namespace ns3 {
  * \endverbatim
  *
  *
+ * A wrapper can also hold a BinaryTraceFile instead of a text stream: the
+ * default ascii trace sinks then record their events in the binary file,
+ * and the lines written to GetStream () are kept in it as text.
+ *
  * This class uses a basic ns-3 reference counting base class but is not 
  * an ns3::Object with attributes, TypeId, or aggregation.
  */
@@ -81,6 +86,11 @@ public:
    * \param os output stream
    */
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Constructor
+   * \param file binary trace file
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceFile> file);
   ~OutputStreamWrapper ();
 
   /**
@@ -92,9 +102,15 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \returns the binary trace file, or 0 if the wrapper holds a text stream
+   */
+  Ptr<BinaryTraceFile> GetBinaryFile (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceFile> m_binaryFile; //!< The binary trace file
 };
 
 } // namespace ns3
@@ -19,9 +19,11 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
+#include <map>
 
 namespace ns3 {
 
@@ -29,6 +31,21 @@ NS_LOG_COMPONENT_DEFINE ("PcapFileWrapper");
 
 NS_OBJECT_ENSURE_REGISTERED (PcapFileWrapper);
 
+namespace {
+
+/**
+ * \brief Get the PCAPNG files shared by the wrappers.
+ * \return the open PCAPNG files, by name
+ */
+std::map<std::string, PcapNgFile *> &
+GetPcapNgFiles (void)
+{
+  static std::map<std::string, PcapNgFile *> files;
+  return files;
+}
+
+} // anonymous namespace
+
 TypeId 
 PcapFileWrapper::GetTypeId (void)
 {
@@ -46,12 +63,36 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size of the memory buffers in which the records are formatted before "
+                   "being written to the file; 0 writes the records one by one to the file stream.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsynchronousWrite",
+                   "Whether the full write buffers are written by a background thread.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asynchronousWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Compress",
+                   "Whether the file is compressed with gzip (requires zlib).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_compress),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PcapNgFile",
+                   "If not empty, the PCAPNG file shared by all the wrappers with the same "
+                   "value, in which each wrapper is an interface named after the file name "
+                   "it is opened with, instead of creating that file.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapFileWrapper::m_pcapNgFilename),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +107,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapNgFile != 0)
+    {
+      return m_pcapNgFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +131,17 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapNgFile != 0)
+    {
+      // The last wrapper of the shared file closes it.
+      if (m_pcapNgFile->GetReferenceCount () == 1)
+        {
+          GetPcapNgFiles ().erase (m_pcapNgFilename);
+          m_pcapNgFile->Close ();
+        }
+      m_pcapNgFile = 0;
+      return;
+    }
   m_file.Close ();
 }
 
@@ -93,7 +149,35 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
-  m_file.Open (filename, mode);
+  uint32_t bufferSize = m_writeBufferSize;
+  if (bufferSize == 0 && (m_asynchronousWrite || m_compress || !m_pcapNgFilename.empty ()))
+    {
+      bufferSize = 1 << 20;
+    }
+  bool write = (mode & std::ios::out) && !(mode & (std::ios::in | std::ios::app));
+  if (write && !m_pcapNgFilename.empty ())
+    {
+      std::map<std::string, PcapNgFile *>::iterator it = GetPcapNgFiles ().find (m_pcapNgFilename);
+      if (it != GetPcapNgFiles ().end ())
+        {
+          m_pcapNgFile = it->second;
+        }
+      else
+        {
+          m_pcapNgFile = Create<PcapNgFile> ();
+          m_pcapNgFile->Open (m_pcapNgFilename, bufferSize, m_asynchronousWrite, m_compress);
+          GetPcapNgFiles ()[m_pcapNgFilename] = PeekPointer (m_pcapNgFile);
+        }
+      m_interfaceName = filename;
+    }
+  else if (write && bufferSize > 0)
+    {
+      m_file.OpenBuffered (filename, bufferSize, m_asynchronousWrite, m_compress);
+    }
+  else
+    {
+      m_file.Open (filename, mode);
+    }
 }
 
 void
@@ -105,6 +189,12 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
+  if (m_pcapNgFile != 0)
+    {
+      snapLen = snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen;
+      m_interface = m_pcapNgFile->AddInterface (m_interfaceName, dataLinkType, snapLen, m_nanosecMode);
+      return;
+    }
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -119,62 +209,70 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
-  if (m_file.IsNanoSecMode())
-    {
-      uint64_t current = t.GetNanoSeconds ();
-      uint64_t s       = current / 1000000000;
-      uint64_t ns      = current % 1000000000;
-      m_file.Write (s, ns, p);
-    }
-  else
+  if (m_pcapNgFile != 0)
     {
-      uint64_t current = t.GetMicroSeconds ();
-      uint64_t s       = current / 1000000;
-      uint64_t us      = current % 1000000;
-      m_file.Write (s, us, p);
+      m_pcapNgFile->Write (m_interface, GetPcapNgTimestamp (t), p);
+      return;
     }
+  uint64_t s;
+  uint64_t subsec;
+  GetTimestamp (t, s, subsec);
+  m_file.Write (s, subsec, p);
 }
 
 void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
-  if (m_file.IsNanoSecMode())
-    {
-      uint64_t current = t.GetNanoSeconds ();
-      uint64_t s       = current / 1000000000;
-      uint64_t ns      = current % 1000000000;
-      m_file.Write (s, ns, header, p);
-    }
-  else
+  if (m_pcapNgFile != 0)
     {
-      uint64_t current = t.GetMicroSeconds ();
-      uint64_t s       = current / 1000000;
-      uint64_t us      = current % 1000000;
-      m_file.Write (s, us, header, p);
+      m_pcapNgFile->Write (m_interface, GetPcapNgTimestamp (t), header, p);
+      return;
     }
+  uint64_t s;
+  uint64_t subsec;
+  GetTimestamp (t, s, subsec);
+  m_file.Write (s, subsec, header, p);
 }
 
 void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
-  if (m_file.IsNanoSecMode())
+  if (m_pcapNgFile != 0)
+    {
+      m_pcapNgFile->Write (m_interface, GetPcapNgTimestamp (t), buffer, length);
+      return;
+    }
+  uint64_t s;
+  uint64_t subsec;
+  GetTimestamp (t, s, subsec);
+  m_file.Write (s, subsec, buffer, length);
+}
+
+void
+PcapFileWrapper::GetTimestamp (Time t, uint64_t &sec, uint64_t &subsec)
+{
+  if (m_file.IsNanoSecMode ())
     {
       uint64_t current = t.GetNanoSeconds ();
-      uint64_t s       = current / 1000000000;
-      uint64_t ns      = current % 1000000000;
-      m_file.Write (s, ns, buffer, length);
+      sec = current / 1000000000;
+      subsec = current % 1000000000;
     }
   else
     {
       uint64_t current = t.GetMicroSeconds ();
-      uint64_t s       = current / 1000000;
-      uint64_t us      = current % 1000000;
-      m_file.Write (s, us, buffer, length);
+      sec = current / 1000000;
+      subsec = current % 1000000;
     }
 }
 
+uint64_t
+PcapFileWrapper::GetPcapNgTimestamp (Time t) const
+{
+  return m_pcapNgFile->IsNanoSecMode (m_interface) ? t.GetNanoSeconds () : t.GetMicroSeconds ();
+}
+
 Ptr<Packet> 
 PcapFileWrapper::Read (Time &t)
 {
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -35,6 +36,23 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * The attributes select how the files opened for writing are written:
+ *  - WriteBufferSize, AsynchronousWrite and Compress write the records
+ *    through a PcapWriter, in large memory buffers, optionally written
+ *    by a background thread and compressed with gzip;
+ *  - PcapNgFile multiplexes all the wrappers with the same value into a
+ *    single PCAPNG file, in which each wrapper is an interface named
+ *    after the file name it was opened with.
+ *
+ * For instance, to capture all the devices of a topology in one
+ * compressed file:
+ *
+ * \code
+ *   Config::SetDefault ("ns3::PcapFileWrapper::PcapNgFile", StringValue ("all.pcapng.gz"));
+ *   Config::SetDefault ("ns3::PcapFileWrapper::Compress", BooleanValue (true));
+ *   pointToPoint.EnablePcapAll ("lisp");
+ * \endcode
  */
 class PcapFileWrapper : public Object
 {
@@ -221,9 +239,31 @@ public:
   uint32_t GetDataLinkType (void);
 
 private:
+  /**
+   * \brief Get the timestamp of a packet in the resolution of the file.
+   * \param t the time of the packet
+   * \param [out] sec the seconds
+   * \param [out] subsec the microseconds or nanoseconds
+   */
+  void GetTimestamp (Time t, uint64_t &sec, uint64_t &subsec);
+  /**
+   * \brief Get the timestamp of a packet in the resolution of the PCAPNG
+   * interface.
+   * \param t the time of the packet
+   * \return the timestamp
+   */
+  uint64_t GetPcapNgTimestamp (Time t) const;
+
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_writeBufferSize; //!< size of the write buffers, or 0
+  bool     m_asynchronousWrite; //!< write the buffers from a thread
+  bool     m_compress; //!< compress the file with gzip
+  std::string m_pcapNgFilename; //!< shared PCAPNG file, or empty
+  Ptr<PcapNgFile> m_pcapNgFile; //!< shared PCAPNG file, when opened
+  std::string m_interfaceName; //!< name of the PCAPNG interface
+  uint32_t m_interface; //!< ID of the PCAPNG interface
 };
 
 } // namespace ns3
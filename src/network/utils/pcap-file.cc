@@ -50,7 +50,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_writer (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,6 +69,10 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -88,6 +93,18 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+      // Keep the state of the writer for Fail ().
+      if (m_writer->Fail ())
+        {
+          m_file.setstate (std::ios::failbit);
+        }
+      delete m_writer;
+      m_writer = 0;
+      return;
+    }
   m_file.close ();
 }
 
@@ -206,7 +223,10 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (m_writer == 0)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +254,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteBytes (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteBytes (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteBytes (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteBytes (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteBytes (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteBytes (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteBytes (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -341,6 +361,29 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::OpenBuffered (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << asynchronous << compress);
+  NS_ASSERT (!Fail () && m_writer == 0);
+  m_filename = filename;
+  m_writer = new PcapWriter ();
+  m_writer->Open (filename, bufferSize, asynchronous, compress);
+}
+
+void
+PcapFile::WriteBytes (void const *data, uint32_t size)
+{
+  if (m_writer != 0)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write (static_cast<const char *> (data), size);
+    }
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -403,7 +446,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_writer != 0 || m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -422,11 +465,11 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteBytes (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteBytes (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteBytes (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteBytes (&header.m_origLen, sizeof(header.m_origLen));
+  NS_BUILD_DEBUG(if (m_writer == 0) m_file.flush ());
   return inclLen;
 }
 
@@ -435,8 +478,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteBytes (data, inclLen);
+  NS_BUILD_DEBUG(if (m_writer == 0) m_file.flush ());
 }
 
 void 
@@ -444,8 +487,15 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  if (m_writer != 0)
+    {
+      p->CopyData (m_writer->Reserve (inclLen), inclLen);
+    }
+  else
+    {
+      p->CopyData (&m_file, inclLen);
+    }
+  NS_BUILD_DEBUG(if (m_writer == 0) m_file.flush ());
 }
 
 void 
@@ -460,9 +510,17 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  if (m_writer != 0)
+    {
+      headerBuffer.CopyData (m_writer->Reserve (toCopy), toCopy);
+      p->CopyData (m_writer->Reserve (inclLen), inclLen);
+    }
+  else
+    {
+      headerBuffer.CopyData (&m_file, toCopy);
+      p->CopyData (&m_file, inclLen);
+    }
 }
 
 void
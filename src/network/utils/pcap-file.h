@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "pcap-writer.h"
 
 namespace ns3 {
 
@@ -80,6 +81,19 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file, written through a PcapWriter: the records
+   * are formatted in memory buffers rather than written to a stream one
+   * by one, and only reach the file once a buffer is full, or when the
+   * file is closed.
+   *
+   * \param filename String containing the name of the file.
+   * \param bufferSize the size of the memory buffers, in bytes
+   * \param asynchronous whether the buffers are written by a background thread
+   * \param compress whether the file is compressed with gzip
+   */
+  void OpenBuffered (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress);
+
   /**
    * Close the underlying file.
    */
@@ -366,11 +380,19 @@ private:
    */
   void ReadAndVerifyFileHeader (void);
 
+  /**
+   * \brief Write bytes to the file.
+   * \param data the bytes
+   * \param size the number of bytes
+   */
+  void WriteBytes (void const *data, uint32_t size);
+
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  PcapWriter *m_writer;         //!< buffered writer, instead of m_file
 };
 
 } // namespace ns3
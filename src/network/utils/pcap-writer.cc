@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/core-config.h"
+#include "pcap-writer.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapWriter");
+
+PcapWriter::PcapWriter ()
+  : m_open (false),
+    m_fail (false),
+    m_asynchronous (false),
+    m_gzFile (0),
+    m_writing (false),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_current.size = 0;
+}
+
+PcapWriter::~PcapWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapWriter::Open (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << asynchronous << compress);
+  NS_ASSERT (!m_open);
+  m_open = true;
+  m_fail = false;
+  m_current.data.resize (std::max<uint32_t> (bufferSize, 1));
+  m_current.size = 0;
+
+  if (compress)
+    {
+#ifdef HAVE_ZLIB
+      m_gzFile = gzopen (filename.c_str (), "wb");
+      m_fail = m_gzFile == 0;
+#else
+      NS_FATAL_ERROR ("Cannot compress " << filename << ": ns-3 was built without zlib");
+#endif
+    }
+  else
+    {
+      m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      m_fail = m_file.fail ();
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (asynchronous && !m_fail)
+    {
+      m_asynchronous = true;
+      m_stop = false;
+      m_thread = std::thread (&PcapWriter::Run, this);
+    }
+#else
+  if (asynchronous)
+    {
+      NS_LOG_WARN ("No threads: " << filename << " is written synchronously");
+    }
+#endif
+}
+
+bool
+PcapWriter::Fail (void) const
+{
+  return m_fail;
+}
+
+uint8_t *
+PcapWriter::Reserve (uint32_t size)
+{
+  NS_ASSERT (m_open);
+  if (m_current.size + size > m_current.data.size ())
+    {
+      Submit ();
+      if (size > m_current.data.size ())
+        {
+          m_current.data.resize (size);
+        }
+    }
+  uint8_t *space = m_current.data.data () + m_current.size;
+  m_current.size += size;
+  return space;
+}
+
+void
+PcapWriter::Write (void const *data, uint32_t size)
+{
+  if (size > 0)
+    {
+      std::memcpy (Reserve (size), data, size);
+    }
+}
+
+void
+PcapWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this << m_current.size);
+  if (m_current.size == 0)
+    {
+      return;
+    }
+  if (!m_asynchronous)
+    {
+      Output (m_current);
+      m_current.size = 0;
+      return;
+    }
+  uint32_t capacity = m_current.data.size ();
+  std::unique_lock<std::mutex> lock (m_mutex);
+  // Bound the memory used when the file system cannot keep up.
+  while (m_pending.size () >= MAX_PENDING)
+    {
+      m_idle.wait (lock);
+    }
+  m_pending.push_back (Chunk ());
+  m_pending.back ().data.swap (m_current.data);
+  m_pending.back ().size = m_current.size;
+  if (!m_free.empty ())
+    {
+      m_current.data.swap (m_free.back ().data);
+      m_free.pop_back ();
+    }
+  lock.unlock ();
+  m_wake.notify_one ();
+  m_current.data.resize (capacity);
+  m_current.size = 0;
+}
+
+void
+PcapWriter::Output (const Chunk &chunk)
+{
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      if (gzwrite (static_cast<gzFile> (m_gzFile), &chunk.data[0], chunk.size) != static_cast<int> (chunk.size))
+        {
+          m_fail = true;
+        }
+      return;
+    }
+#endif
+  m_file.write (reinterpret_cast<const char *> (&chunk.data[0]), chunk.size);
+  if (m_file.fail ())
+    {
+      m_fail = true;
+    }
+}
+
+void
+PcapWriter::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (m_pending.empty () && !m_stop)
+        {
+          m_wake.wait (lock);
+        }
+      if (m_pending.empty ())
+        {
+          break;
+        }
+      Chunk chunk;
+      chunk.data.swap (m_pending.front ().data);
+      chunk.size = m_pending.front ().size;
+      m_pending.pop_front ();
+      m_writing = true;
+      lock.unlock ();
+      Output (chunk);
+      lock.lock ();
+      m_writing = false;
+      m_free.push_back (Chunk ());
+      m_free.back ().data.swap (chunk.data);
+      m_idle.notify_all ();
+    }
+}
+
+void
+PcapWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  Submit ();
+  if (m_asynchronous)
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      while (!m_pending.empty () || m_writing)
+        {
+          m_idle.wait (lock);
+        }
+    }
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzflush (static_cast<gzFile> (m_gzFile), Z_SYNC_FLUSH);
+      return;
+    }
+#endif
+  m_file.flush ();
+}
+
+void
+PcapWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  Submit ();
+  if (m_asynchronous)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_stop = true;
+      }
+      m_wake.notify_one ();
+      m_thread.join ();
+      m_asynchronous = false;
+      m_free.clear ();
+    }
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      if (gzclose (static_cast<gzFile> (m_gzFile)) != Z_OK)
+        {
+          m_fail = true;
+        }
+      m_gzFile = 0;
+    }
+#endif
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  std::vector<uint8_t> ().swap (m_current.data);
+  m_open = false;
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_WRITER_H
+#define PCAP_WRITER_H
+
+#include <string>
+#include <fstream>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Buffered writer of a trace file.
+ *
+ * The records are formatted in a large memory buffer, which is written
+ * out to the file once full, instead of going through a stream for
+ * every record.  The full buffers can be written by a background
+ * thread, so that the simulation does not wait for the file system,
+ * and they can be compressed with gzip.
+ *
+ * The data only reaches the file on Flush() and Close(), or when a
+ * buffer fills up: a file being written cannot be read back as is.
+ */
+class PcapWriter
+{
+public:
+  PcapWriter ();
+  ~PcapWriter ();
+
+  /**
+   * \brief Create a file, truncating any existing file.
+   *
+   * \param filename the name of the file
+   * \param bufferSize the size of the memory buffers, in bytes
+   * \param asynchronous whether the buffers are written by a background thread
+   * \param compress whether the file is compressed with gzip
+   */
+  void Open (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress);
+
+  /**
+   * \return true if the file could not be opened or written
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Reserve space for the next bytes of the file.
+   *
+   * The caller must fill the space right away, before any other call.
+   *
+   * \param size the number of bytes
+   * \return the space for the bytes
+   */
+  uint8_t *Reserve (uint32_t size);
+
+  /**
+   * \brief Append bytes to the file.
+   *
+   * \param data the bytes
+   * \param size the number of bytes
+   */
+  void Write (void const *data, uint32_t size);
+
+  /**
+   * \brief Write out all the buffered bytes, and wait until they are
+   * in the file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Flush and close the file, and stop the background thread.
+   */
+  void Close (void);
+
+private:
+  /** A memory buffer. */
+  struct Chunk
+  {
+    std::vector<uint8_t> data; //!< The bytes, and the free space.
+    uint32_t size;             //!< The number of bytes used.
+  };
+
+  /**
+   * \brief Copy constructor (disabled).
+   * \param o object to copy
+   */
+  PcapWriter (const PcapWriter &o);
+  /**
+   * \brief Assignment operator (disabled).
+   * \param o object to copy
+   * \returns the copied object
+   */
+  PcapWriter &operator= (const PcapWriter &o);
+
+  /**
+   * \brief Hand the current buffer over to be written, and get a new one.
+   */
+  void Submit (void);
+  /**
+   * \brief Write a buffer to the file.
+   * \param chunk the buffer
+   */
+  void Output (const Chunk &chunk);
+  /**
+   * \brief Loop of the background thread.
+   */
+  void Run (void);
+
+  /** The maximum number of full buffers waiting for the thread. */
+  static const uint32_t MAX_PENDING = 4;
+
+  bool m_open;                    //!< The file is open.
+  std::atomic<bool> m_fail;       //!< An operation on the file failed.
+  bool m_asynchronous;            //!< The background thread is running.
+  std::ofstream m_file;           //!< The file, without compression.
+  void *m_gzFile;                 //!< The file, with compression.
+  Chunk m_current;                //!< The buffer being filled.
+
+  std::thread m_thread;           //!< The background thread.
+  std::mutex m_mutex;             //!< Protects the fields below.
+  std::condition_variable m_wake; //!< Signals the pending buffers and the stop.
+  std::condition_variable m_idle; //!< Signals a buffer written.
+  std::deque<Chunk> m_pending;    //!< The buffers to write.
+  std::vector<Chunk> m_free;      //!< The written buffers, for reuse.
+  bool m_writing;                 //!< The thread is writing a buffer.
+  bool m_stop;                    //!< The thread must stop.
+};
+
+} // namespace ns3
+
+#endif /* PCAP_WRITER_H */
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+namespace {
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;        //!< Section Header Block type
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x00000001; //!< Interface Description Block type
+const uint32_t ENHANCED_PACKET_BLOCK = 0x00000006;       //!< Enhanced Packet Block type
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;            //!< Byte-order magic of the section
+const uint16_t OPT_ENDOFOPT = 0;                         //!< End of the options
+const uint16_t IF_NAME = 2;                              //!< Interface name option
+const uint16_t IF_TSRESOL = 9;                           //!< Timestamp resolution option
+
+/**
+ * \brief Pad a length to a multiple of 32 bits.
+ * \param length the length
+ * \return the padded length
+ */
+uint32_t
+Pad (uint32_t length)
+{
+  return (length + 3) & ~3U;
+}
+
+/**
+ * \brief Append a value to a block.
+ * \param block the block
+ * \param value the value
+ */
+template <typename T>
+void
+Append (std::vector<uint8_t> &block, T value)
+{
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *> (&value);
+  block.insert (block.end (), bytes, bytes + sizeof (T));
+}
+
+/**
+ * \brief Append an option to a block.
+ * \param block the block
+ * \param code the option code
+ * \param data the value of the option
+ * \param length the length of the value
+ */
+void
+AppendOption (std::vector<uint8_t> &block, uint16_t code, const void *data, uint16_t length)
+{
+  Append (block, code);
+  Append (block, length);
+  const uint8_t *bytes = static_cast<const uint8_t *> (data);
+  block.insert (block.end (), bytes, bytes + length);
+  block.resize (block.size () + Pad (length) - length, 0);
+}
+
+} // anonymous namespace
+
+PcapNgFile::PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << asynchronous << compress);
+  m_writer.Open (filename, bufferSize, asynchronous, compress);
+  m_interfaces.clear ();
+
+  uint32_t length = 28;
+  m_writer.Write (&SECTION_HEADER_BLOCK, 4);
+  m_writer.Write (&length, 4);
+  m_writer.Write (&BYTE_ORDER_MAGIC, 4);
+  uint16_t versionMajor = 1;
+  uint16_t versionMinor = 0;
+  m_writer.Write (&versionMajor, 2);
+  m_writer.Write (&versionMinor, 2);
+  // The length of the section is not known in advance.
+  int64_t sectionLength = -1;
+  m_writer.Write (&sectionLength, 8);
+  m_writer.Write (&length, 4);
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Close ();
+}
+
+uint32_t
+PcapNgFile::AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen, bool nanosecMode)
+{
+  NS_LOG_FUNCTION (this << name << dataLinkType << snapLen << nanosecMode);
+  std::vector<uint8_t> block;
+  Append (block, INTERFACE_DESCRIPTION_BLOCK);
+  Append (block, uint32_t (0));
+  Append (block, static_cast<uint16_t> (dataLinkType));
+  Append (block, uint16_t (0));
+  Append (block, snapLen);
+  AppendOption (block, IF_NAME, name.c_str (), std::min<size_t> (name.size (), 0xffff));
+  uint8_t resolution = nanosecMode ? 9 : 6;
+  AppendOption (block, IF_TSRESOL, &resolution, 1);
+  AppendOption (block, OPT_ENDOFOPT, 0, 0);
+  uint32_t length = block.size () + 4;
+  std::memcpy (&block[4], &length, 4);
+  Append (block, length);
+  m_writer.Write (&block[0], block.size ());
+
+  Interface interface;
+  interface.snapLen = snapLen;
+  interface.nanosecMode = nanosecMode;
+  m_interfaces.push_back (interface);
+  return m_interfaces.size () - 1;
+}
+
+bool
+PcapNgFile::IsNanoSecMode (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].nanosecMode;
+}
+
+uint32_t
+PcapNgFile::WritePacketHeader (uint32_t interface, uint64_t timestamp, uint32_t totalLen)
+{
+  NS_ASSERT_MSG (interface < m_interfaces.size (), "Unknown interface " << interface);
+  uint32_t inclLen = std::min (totalLen, m_interfaces[interface].snapLen);
+  uint32_t fields[7];
+  fields[0] = ENHANCED_PACKET_BLOCK;
+  fields[1] = 32 + Pad (inclLen);
+  fields[2] = interface;
+  fields[3] = static_cast<uint32_t> (timestamp >> 32);
+  fields[4] = static_cast<uint32_t> (timestamp);
+  fields[5] = inclLen;
+  fields[6] = totalLen;
+  m_writer.Write (fields, sizeof (fields));
+  return inclLen;
+}
+
+void
+PcapNgFile::WritePacketTrailer (uint32_t inclLen)
+{
+  uint8_t trailer[8] = { 0 };
+  uint32_t padding = Pad (inclLen) - inclLen;
+  uint32_t length = 32 + Pad (inclLen);
+  std::memcpy (trailer + padding, &length, 4);
+  m_writer.Write (trailer, padding + 4);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &data << totalLen);
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, totalLen);
+  m_writer.Write (data, inclLen);
+  WritePacketTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << p);
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, p->GetSize ());
+  p->CopyData (m_writer.Reserve (inclLen), inclLen);
+  WritePacketTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t timestamp, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, headerSize + p->GetSize ());
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (m_writer.Reserve (toCopy), toCopy);
+  p->CopyData (m_writer.Reserve (inclLen - toCopy), inclLen - toCopy);
+  WritePacketTrailer (inclLen);
+}
+
+} // namespace ns3
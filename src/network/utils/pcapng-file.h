@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "pcap-writer.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \ingroup network
+ *
+ * \brief A PCAPNG file, written with a PcapWriter.
+ *
+ * Unlike a pcap file, a PCAPNG file holds the packets of several
+ * interfaces, each with its own data link type, snapshot length and
+ * timestamp resolution.  The file is a single section, made of a
+ * Section Header Block, one Interface Description Block per interface
+ * and one Enhanced Packet Block per packet, in the byte order of the
+ * host.
+ *
+ * See https://github.com/pcapng/pcapng
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \brief Create a file, and write its Section Header Block.
+   *
+   * \param filename the name of the file
+   * \param bufferSize the size of the memory buffers, in bytes
+   * \param asynchronous whether the buffers are written by a background thread
+   * \param compress whether the file is compressed with gzip
+   */
+  void Open (std::string const &filename, uint32_t bufferSize, bool asynchronous, bool compress);
+
+  /**
+   * \return true if the file could not be opened or written
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Close the file.
+   */
+  void Close (void);
+
+  /**
+   * \brief Add an interface to the file.
+   *
+   * \param name the name of the interface
+   * \param dataLinkType the data link type of the packets of the interface
+   * \param snapLen the maximum number of bytes saved per packet
+   * \param nanosecMode whether the timestamps are in nanoseconds rather
+   *        than microseconds
+   * \return the ID of the interface
+   */
+  uint32_t AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen, bool nanosecMode);
+
+  /**
+   * \param interface the ID of an interface
+   * \return true if the timestamps of the interface are in nanoseconds
+   */
+  bool IsNanoSecMode (uint32_t interface) const;
+
+  /**
+   * \brief Write a packet.
+   *
+   * \param interface the ID of the interface of the packet
+   * \param timestamp the timestamp, in the resolution of the interface
+   * \param data the bytes of the packet
+   * \param totalLen the size of the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, uint8_t const *data, uint32_t totalLen);
+
+  /**
+   * \brief Write a packet.
+   *
+   * \param interface the ID of the interface of the packet
+   * \param timestamp the timestamp, in the resolution of the interface
+   * \param p the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a header along with a packet.
+   *
+   * \param interface the ID of the interface of the packet
+   * \param timestamp the timestamp, in the resolution of the interface
+   * \param header the header to prepend to the packet
+   * \param p the packet
+   */
+  void Write (uint32_t interface, uint64_t timestamp, const Header &header, Ptr<const Packet> p);
+
+private:
+  /** An interface of the file. */
+  struct Interface
+  {
+    uint32_t snapLen;  //!< The maximum number of bytes saved per packet.
+    bool nanosecMode;  //!< The timestamps are in nanoseconds.
+  };
+
+  /**
+   * \brief Write the start of an Enhanced Packet Block.
+   *
+   * \param interface the ID of the interface of the packet
+   * \param timestamp the timestamp, in the resolution of the interface
+   * \param totalLen the size of the packet
+   * \return the number of bytes of the packet to save
+   */
+  uint32_t WritePacketHeader (uint32_t interface, uint64_t timestamp, uint32_t totalLen);
+  /**
+   * \brief Write the end of an Enhanced Packet Block.
+   *
+   * \param inclLen the number of bytes of the packet saved
+   */
+  void WritePacketTrailer (uint32_t inclLen);
+
+  PcapWriter m_writer;                 //!< The file.
+  std::vector<Interface> m_interfaces; //!< The interfaces, by ID.
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
@@ -77,7 +77,10 @@ QueueDiscItem::QueueDiscItem (Ptr<Packet> p, const Address& addr, uint16_t proto
   : QueueItem (p),
     m_address (addr),
     m_protocol (protocol),
-    m_txq (0)
+    m_txq (0),
+    m_hash (0),
+    m_hashPerturbation (0),
+    m_hashComputed (false)
 {
   NS_LOG_FUNCTION (this << p << addr << protocol);
 }
@@ -129,6 +132,27 @@ QueueDiscItem::SetTimeStamp (Time t)
   m_tstamp = t;
 }
 
+uint32_t
+QueueDiscItem::Hash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+  if (!m_hashComputed || m_hashPerturbation != perturbation)
+    {
+      m_hash = DoHash (perturbation);
+      m_hashPerturbation = perturbation;
+      m_hashComputed = true;
+    }
+  return m_hash;
+}
+
+uint32_t
+QueueDiscItem::DoHash (uint32_t perturbation) const
+{
+  NS_LOG_FUNCTION (this << perturbation);
+  NS_LOG_WARN ("The flow of this item is unknown, hash value 0");
+  return 0;
+}
+
 void
 QueueDiscItem::Print (std::ostream& os) const
 {
@@ -215,7 +215,31 @@ public:
    */
   virtual bool Mark (void) = 0;
 
+  /**
+   * \brief Computes the hash of the flow of the packet, i.e., of its 5-tuple
+   *
+   * The hash is computed by DoHash the first time it is requested, and then
+   * kept in the item, so that the packet filters and the queue discs which
+   * classify the same item do not parse its headers again.
+   *
+   * \param perturbation the salt used as an additional input to the hash
+   * \return the hash of the flow of the packet
+   */
+  uint32_t Hash (uint32_t perturbation = 0) const;
+
 private:
+  /**
+   * \brief Computes the hash of the flow of the packet
+   *
+   * Subclasses which know the headers of the packet override this method.
+   * The default implementation returns 0, i.e., puts all the packets in
+   * the same flow.
+   *
+   * \param perturbation the salt used as an additional input to the hash
+   * \return the hash of the flow of the packet
+   */
+  virtual uint32_t DoHash (uint32_t perturbation) const;
+
   /**
    * \brief Default constructor
    *
@@ -240,6 +264,9 @@ private:
   uint16_t m_protocol;    //!< L3 Protocol number
   uint8_t m_txq;          //!< Transmission queue index
   Time m_tstamp;          //!< timestamp when the packet was enqueued
+  mutable uint32_t m_hash;              //!< hash of the flow, if computed
+  mutable uint32_t m_hashPerturbation;  //!< salt used to compute m_hash
+  mutable bool m_hashComputed;          //!< whether m_hash has been computed
 };
 
 } // namespace ns3
@@ -32,6 +32,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -167,6 +168,15 @@ public:
     QUEUE_MODE_BYTES,       /**< Use number of bytes for maximum queue size */
   };
 
+  /**
+   * \brief Enumeration of the containers which can store the items.
+   */
+  enum QueueStorage
+  {
+    QUEUE_STORAGE_LIST,     /**< Store the items in a linked list */
+    QUEUE_STORAGE_RING,     /**< Store the items in a growable ring buffer */
+  };
+
   /**
    * Set the operating mode of this device.
    *
@@ -322,8 +332,52 @@ public:
 
 protected:
 
-  /// Const iterator.
-  typedef typename std::list<Ptr<Item> >::const_iterator ConstIterator;
+  /**
+   * \brief Const iterator over the items in the queue.
+   *
+   * With the list storage, the iterators stay valid until their item is
+   * removed.  With the ring storage, an iterator is the position of an
+   * item, so that inserting or removing an item invalidates the iterators
+   * to the items after it.
+   */
+  class ConstIterator
+  {
+public:
+    ConstIterator ();
+    /**
+     * \return the item the iterator refers to
+     */
+    const Ptr<Item> & operator* (void) const;
+    /**
+     * \brief Prefix increment.
+     * \return the iterator to the next item
+     */
+    ConstIterator & operator++ (void);
+    /**
+     * \brief Postfix increment.
+     * \return the iterator before the increment
+     */
+    ConstIterator operator++ (int);
+    /**
+     * \param o the other iterator
+     * \return true if both iterators refer to the same position
+     */
+    bool operator== (const ConstIterator &o) const;
+    /**
+     * \param o the other iterator
+     * \return true if the iterators refer to different positions
+     */
+    bool operator!= (const ConstIterator &o) const;
+
+private:
+    friend class Queue<Item>;
+    /// The list iterator, with the list storage.
+    typename std::list<Ptr<Item> >::const_iterator m_it;
+    /// The queue, with the ring storage; 0 otherwise.
+    const Queue<Item> *m_queue;
+    /// The position in the ring, with the ring storage.
+    uint32_t m_index;
+  };
 
   /**
    * \brief Get a const iterator which refers to the first item in the queue.
@@ -406,9 +460,70 @@ protected:
    */
   void DropAfterDequeue (Ptr<Item> item);
 
+  /**
+   * \brief Set the container which stores the items
+   *
+   * The items already in the queue are moved to the new container.
+   *
+   * \param storage the container type
+   */
+  void SetStorage (QueueBase::QueueStorage storage);
+
+  /**
+   * \return the container which stores the items
+   */
+  QueueBase::QueueStorage GetStorage (void) const;
+
 private:
-  std::list<Ptr<Item> > m_packets;          //!< the items in the queue
+  /**
+   * \brief Get an item of the ring storage.
+   * \param index the position of the item, from the head of the queue
+   * \return the slot of the item
+   */
+  Ptr<Item> & RingAt (uint32_t index);
+  /**
+   * \brief Get an item of the ring storage.
+   * \param index the position of the item, from the head of the queue
+   * \return the slot of the item
+   */
+  const Ptr<Item> & RingAt (uint32_t index) const;
+  /**
+   * \brief Insert an item in the ring storage, growing it if full.
+   *
+   * This is O(1) at both ends of the queue.
+   *
+   * \param index the position of the item, from the head of the queue
+   * \param item the item
+   */
+  void RingInsert (uint32_t index, Ptr<Item> item);
+  /**
+   * \brief Remove an item from the ring storage.
+   *
+   * This is O(1) at both ends of the queue.
+   *
+   * \param index the position of the item, from the head of the queue
+   * \return the item
+   */
+  Ptr<Item> RingErase (uint32_t index);
+  /**
+   * \brief Insert an item in the container.
+   * \param pos the position where the item is inserted
+   * \param item the item
+   */
+  void Insert (ConstIterator pos, Ptr<Item> item);
+  /**
+   * \brief Remove an item from the container.
+   * \param pos the position of the item
+   * \return the item
+   */
+  Ptr<Item> Erase (ConstIterator pos);
+
   NS_LOG_TEMPLATE_DECLARE;                  //!< the log component
+  QueueStorage m_storage;                   //!< the container type
+  std::list<Ptr<Item> > m_packets;          //!< the items, with the list storage
+  std::vector<Ptr<Item> > m_ring;           //!< the items, with the ring storage
+  uint32_t m_ringHead;                      //!< slot of the head item in m_ring
+  uint32_t m_ringSize;                      //!< number of items in m_ring
 
   /// Traced callback: fired when a packet is enqueued
   TracedCallback<Ptr<const Item> > m_traceEnqueue;
@@ -454,9 +569,64 @@ Queue<Item>::GetTypeId (void)
   return tid;
 }
 
+template <typename Item>
+Queue<Item>::ConstIterator::ConstIterator ()
+  : m_queue (0),
+    m_index (0)
+{
+}
+
+template <typename Item>
+const Ptr<Item> &
+Queue<Item>::ConstIterator::operator* (void) const
+{
+  return m_queue != 0 ? m_queue->RingAt (m_index) : *m_it;
+}
+
+template <typename Item>
+typename Queue<Item>::ConstIterator &
+Queue<Item>::ConstIterator::operator++ (void)
+{
+  if (m_queue != 0)
+    {
+      m_index++;
+    }
+  else
+    {
+      ++m_it;
+    }
+  return *this;
+}
+
+template <typename Item>
+typename Queue<Item>::ConstIterator
+Queue<Item>::ConstIterator::operator++ (int)
+{
+  ConstIterator old = *this;
+  ++(*this);
+  return old;
+}
+
+template <typename Item>
+bool
+Queue<Item>::ConstIterator::operator== (const ConstIterator &o) const
+{
+  return m_queue != 0 ? m_index == o.m_index : m_it == o.m_it;
+}
+
+template <typename Item>
+bool
+Queue<Item>::ConstIterator::operator!= (const ConstIterator &o) const
+{
+  return !(*this == o);
+}
+
 template <typename Item>
 Queue<Item>::Queue ()
-  : NS_LOG_TEMPLATE_DEFINE ("Queue")
+  : NS_LOG_TEMPLATE_DEFINE ("Queue"),
+    m_storage (QUEUE_STORAGE_LIST),
+    m_ringHead (0),
+    m_ringSize (0)
 {
 }
 
@@ -485,7 +655,7 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
       return false;
     }
 
-  m_packets.insert (pos, item);
+  Insert (pos, item);
 
   uint32_t size = item->GetSize ();
   m_nBytes += size;
@@ -512,8 +682,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
       return 0;
     }
 
-  Ptr<Item> item = *pos;
-  m_packets.erase (pos);
+  Ptr<Item> item = Erase (pos);
 
   if (item != 0)
     {
@@ -541,8 +710,7 @@ Queue<Item>::DoRemove (ConstIterator pos)
       return 0;
     }
 
-  Ptr<Item> item = *pos;
-  m_packets.erase (pos);
+  Ptr<Item> item = Erase (pos);
 
   if (item != 0)
     {
@@ -590,13 +758,164 @@ Queue<Item>::DoPeek (ConstIterator pos) const
 template <typename Item>
 typename Queue<Item>::ConstIterator Queue<Item>::Head (void) const
 {
-  return m_packets.cbegin ();
+  ConstIterator it;
+  if (m_storage == QUEUE_STORAGE_RING)
+    {
+      it.m_queue = this;
+      it.m_index = 0;
+    }
+  else
+    {
+      it.m_it = m_packets.cbegin ();
+    }
+  return it;
 }
 
 template <typename Item>
 typename Queue<Item>::ConstIterator Queue<Item>::Tail (void) const
 {
-  return m_packets.cend ();
+  ConstIterator it;
+  if (m_storage == QUEUE_STORAGE_RING)
+    {
+      it.m_queue = this;
+      it.m_index = m_ringSize;
+    }
+  else
+    {
+      it.m_it = m_packets.cend ();
+    }
+  return it;
+}
+
+template <typename Item>
+void
+Queue<Item>::SetStorage (QueueBase::QueueStorage storage)
+{
+  NS_LOG_FUNCTION (this << storage);
+  if (storage == m_storage)
+    {
+      return;
+    }
+  if (storage == QUEUE_STORAGE_RING)
+    {
+      for (typename std::list<Ptr<Item> >::const_iterator i = m_packets.begin (); i != m_packets.end (); i++)
+        {
+          RingInsert (m_ringSize, *i);
+        }
+      m_packets.clear ();
+    }
+  else
+    {
+      while (m_ringSize > 0)
+        {
+          m_packets.push_back (RingErase (0));
+        }
+      std::vector<Ptr<Item> > ().swap (m_ring);
+    }
+  m_storage = storage;
+}
+
+template <typename Item>
+QueueBase::QueueStorage
+Queue<Item>::GetStorage (void) const
+{
+  return m_storage;
+}
+
+template <typename Item>
+Ptr<Item> &
+Queue<Item>::RingAt (uint32_t index)
+{
+  // The capacity of the ring is a power of two.
+  return m_ring[(m_ringHead + index) & (m_ring.size () - 1)];
+}
+
+template <typename Item>
+const Ptr<Item> &
+Queue<Item>::RingAt (uint32_t index) const
+{
+  return m_ring[(m_ringHead + index) & (m_ring.size () - 1)];
+}
+
+template <typename Item>
+void
+Queue<Item>::RingInsert (uint32_t index, Ptr<Item> item)
+{
+  NS_ASSERT (index <= m_ringSize);
+  if (m_ringSize == m_ring.size ())
+    {
+      // Double the capacity, the items starting again from the first slot.
+      std::vector<Ptr<Item> > ring (m_ring.empty () ? 16 : 2 * m_ring.size ());
+      for (uint32_t i = 0; i < m_ringSize; i++)
+        {
+          ring[i] = RingAt (i);
+        }
+      m_ring.swap (ring);
+      m_ringHead = 0;
+    }
+  if (index == 0)
+    {
+      m_ringHead = (m_ringHead - 1) & (m_ring.size () - 1);
+    }
+  else
+    {
+      for (uint32_t i = m_ringSize; i > index; i--)
+        {
+          RingAt (i) = RingAt (i - 1);
+        }
+    }
+  RingAt (index) = item;
+  m_ringSize++;
+}
+
+template <typename Item>
+Ptr<Item>
+Queue<Item>::RingErase (uint32_t index)
+{
+  NS_ASSERT (index < m_ringSize);
+  Ptr<Item> item = RingAt (index);
+  if (index == 0)
+    {
+      RingAt (0) = 0;
+      m_ringHead = (m_ringHead + 1) & (m_ring.size () - 1);
+    }
+  else
+    {
+      for (uint32_t i = index; i + 1 < m_ringSize; i++)
+        {
+          RingAt (i) = RingAt (i + 1);
+        }
+      RingAt (m_ringSize - 1) = 0;
+    }
+  m_ringSize--;
+  return item;
+}
+
+template <typename Item>
+void
+Queue<Item>::Insert (ConstIterator pos, Ptr<Item> item)
+{
+  if (m_storage == QUEUE_STORAGE_RING)
+    {
+      RingInsert (pos.m_index, item);
+    }
+  else
+    {
+      m_packets.insert (pos.m_it, item);
+    }
+}
+
+template <typename Item>
+Ptr<Item>
+Queue<Item>::Erase (ConstIterator pos)
+{
+  if (m_storage == QUEUE_STORAGE_RING)
+    {
+      return RingErase (pos.m_index);
+    }
+  Ptr<Item> item = *pos.m_it;
+  m_packets.erase (pos.m_it);
+  return item;
 }
 
 template <typename Item>
@@ -16,12 +16,17 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <vector>
 #include "point-to-point-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 
 namespace ns3 {
 
@@ -80,9 +85,21 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
       m_link[1].m_dst = m_link[0].m_src;
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
+      GetDstNodeId (0);
+      GetDstNodeId (1);
     }
 }
 
+uint32_t
+PointToPointChannel::GetDstNodeId (uint32_t wire)
+{
+  if (m_link[wire].m_dstNodeId == 0xffffffff && m_link[wire].m_dst->GetNode () != 0)
+    {
+      m_link[wire].m_dstNodeId = m_link[wire].m_dst->GetNode ()->GetId ();
+    }
+  return m_link[wire].m_dstNodeId;
+}
+
 bool
 PointToPointChannel::TransmitStart (
   Ptr<const Packet> p,
@@ -97,7 +114,25 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+  uint32_t dstNodeId = GetDstNodeId (wire);
+
+#ifdef HAVE_PTHREAD_H
+  if (MultithreadedSimulatorImpl::IsRemote (dstNodeId))
+    {
+      // The receiver runs in another thread: hand it over a packet which
+      // shares no buffer with this one, and do not reference its device
+      // (nor fire the animation trace, which would).
+      std::vector<uint8_t> buffer (p->GetSerializedSize ());
+      p->Serialize (&buffer[0], buffer.size ());
+      Simulator::ScheduleWithContext (dstNodeId, txTime + m_delay,
+                                      &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst),
+                                      Create<Packet> (&buffer[0], buffer.size (), true));
+      return true;
+    }
+#endif
+
+  Simulator::ScheduleWithContext (dstNodeId,
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p->Copy ());
 
@@ -106,6 +141,56 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointChannel::TransmitBurst (
+  std::vector<Ptr<Packet> > const &burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &txTime,
+  Time interframeGap)
+{
+  NS_LOG_FUNCTION (this << burst.size () << src);
+  NS_ASSERT (!burst.empty () && burst.size () == txTime.size ());
+
+  NS_ASSERT (m_link[0].m_state != INITIALIZING);
+  NS_ASSERT (m_link[1].m_state != INITIALIZING);
+
+  uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+  uint32_t dstNodeId = GetDstNodeId (wire);
+
+#ifdef HAVE_PTHREAD_H
+  bool remote = MultithreadedSimulatorImpl::IsRemote (dstNodeId);
+#else
+  bool remote = false;
+#endif
+  // Each packet is received when its own last bit arrives: the burst only
+  // saves the events of the transmitter.
+  Time end = Seconds (0);
+  for (uint32_t i = 0; i < burst.size (); i++)
+    {
+      end += txTime[i];
+      if (remote)
+        {
+          // See TransmitStart
+          std::vector<uint8_t> buffer (burst[i]->GetSerializedSize ());
+          burst[i]->Serialize (&buffer[0], buffer.size ());
+          Simulator::ScheduleWithContext (dstNodeId, end + m_delay,
+                                          &PointToPointNetDevice::Receive,
+                                          PeekPointer (m_link[wire].m_dst),
+                                          Create<Packet> (&buffer[0], buffer.size (), true));
+        }
+      else
+        {
+          Simulator::ScheduleWithContext (dstNodeId,
+                                          end + m_delay, &PointToPointNetDevice::Receive,
+                                          m_link[wire].m_dst, burst[i]->Copy ());
+          m_txrxPointToPoint (burst[i], src, m_link[wire].m_dst, txTime[i], end + m_delay);
+        }
+      end += interframeGap;
+    }
+  return true;
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
@@ -80,6 +81,22 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Transmit a burst of back-to-back packets over this channel
+   *
+   * The packet i of the burst starts when packet i - 1 and the interframe
+   * gap are transmitted, and it is received by the other device when its
+   * last bit arrives.
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time of each packet
+   * \param interframeGap Time between the packets
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBurst (std::vector<Ptr<Packet> > const &burst, Ptr<PointToPointNetDevice> src,
+                              std::vector<Time> const &txTime, Time interframeGap);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
@@ -194,13 +211,26 @@ public:
     /** \brief Create the link, it will be in INITIALIZING state
      *
      */
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstNodeId (0xffffffff) {}
 
     WireState                  m_state; //!< State of the link
     Ptr<PointToPointNetDevice> m_src;   //!< First NetDevice
     Ptr<PointToPointNetDevice> m_dst;   //!< Second NetDevice
+    uint32_t                   m_dstNodeId; //!< Node id of m_dst, once known
   };
 
+  /**
+   * \brief Get the node id of the receiving end of a wire.
+   *
+   * The id is cached, so that transmitting does not touch the reference
+   * count of the remote node, which may be running in another thread
+   * with the MultithreadedSimulatorImpl.
+   *
+   * \param wire The wire index.
+   * \returns The node id of the receiving device.
+   */
+  uint32_t GetDstNodeId (uint32_t wire);
+
   Link    m_link[N_DEVICES]; //!< Link model
 };
 
@@ -68,6 +68,16 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("MaxBurstSize",
+                   "The maximum number of queued packets sent back to back "
+                   "as one burst, with a single transmit complete event (1 "
+                   "disables the bursts).  The packets are received at their "
+                   "own times.  No burst is sent while the sniffer, PhyTxBegin "
+                   "or PhyTxEnd traces are connected; the queue Dequeue trace "
+                   "of a burst fires at its start",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_maxBurstSize),
+                   MakeUintegerChecker<uint32_t> (1))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -178,7 +188,8 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_maxBurstSize (1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -249,6 +260,7 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_currentBurst.clear ();
   m_queue = 0;
   m_queueInterface = 0;
   NetDevice::DoDispose ();
@@ -298,6 +310,71 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+bool
+PointToPointNetDevice::IsBurstEnabled (void) const
+{
+  return m_maxBurstSize > 1
+         && m_snifferTrace.IsEmpty () && m_promiscSnifferTrace.IsEmpty ()
+         && m_phyTxBeginTrace.IsEmpty () && m_phyTxEndTrace.IsEmpty ();
+}
+
+bool
+PointToPointNetDevice::TransmitBurst (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+  NS_LOG_LOGIC ("UID is " << p->GetUid () << ")");
+
+  if (m_queue->IsEmpty ())
+    {
+      return TransmitStart (p);
+    }
+
+  //
+  // Send the packets waiting in the queue back to back after this one.  The
+  // traces of each packet fire in the same order as when the packets are
+  // sent one by one.  Only the Dequeue trace of the queue fires earlier: the
+  // other traces are not connected when the bursts are enabled.
+  //
+  NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
+  NS_ASSERT (m_currentBurst.empty ());
+  m_txMachineState = BUSY;
+  m_currentPkt = p;
+
+  std::vector<Time> txTime;
+  Time txCompleteTime = Seconds (0);
+  while (p != 0)
+    {
+      m_phyTxBeginTrace (p);
+      m_currentBurst.push_back (p);
+      txTime.push_back (m_bps.CalculateBytesTxTime (p->GetSize ()));
+      txCompleteTime += txTime.back () + m_tInterframeGap;
+      if (m_currentBurst.size () == m_maxBurstSize)
+        {
+          break;
+        }
+      p = m_queue->Dequeue ();
+      if (p != 0)
+        {
+          m_snifferTrace (p);
+          m_promiscSnifferTrace (p);
+        }
+    }
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent of " << m_currentBurst.size () <<
+                " packets in " << txCompleteTime.GetSeconds () << "sec");
+  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+
+  bool result = m_channel->TransmitBurst (m_currentBurst, this, txTime, m_tInterframeGap);
+  if (result == false)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = m_currentBurst.begin (); i != m_currentBurst.end (); i++)
+        {
+          m_phyTxDropTrace (*i);
+        }
+    }
+  return result;
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -314,7 +391,18 @@ PointToPointNetDevice::TransmitComplete (void)
 
   NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
+  if (m_currentBurst.empty ())
+    {
+      m_phyTxEndTrace (m_currentPkt);
+    }
+  else
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = m_currentBurst.begin (); i != m_currentBurst.end (); i++)
+        {
+          m_phyTxEndTrace (*i);
+        }
+      m_currentBurst.clear ();
+    }
   m_currentPkt = 0;
 
   Ptr<Packet> p = m_queue->Dequeue ();
@@ -329,7 +417,14 @@ PointToPointNetDevice::TransmitComplete (void)
   //
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
-  TransmitStart (p);
+  if (IsBurstEnabled ())
+    {
+      TransmitBurst (p);
+    }
+  else
+    {
+      TransmitStart (p);
+    }
 }
 
 bool
@@ -580,7 +675,7 @@ PointToPointNetDevice::Send (
           packet = m_queue->Dequeue ();
           m_snifferTrace (packet);
           m_promiscSnifferTrace (packet);
-          bool ret = TransmitStart (packet);
+          bool ret = IsBurstEnabled () ? TransmitBurst (packet) : TransmitStart (packet);
           return ret;
         }
       return true;
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -59,6 +60,14 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the PointToPointChannel).
+ *
+ * When the MaxBurstSize attribute is greater than one, the packets which
+ * are waiting in the queue when the transmitter becomes ready are sent
+ * back to back as one burst, and the device schedules a single event for
+ * the end of the burst.  Each packet is still received at the arrival time
+ * of its own last bit.  No burst is sent while the sniffer, PhyTxBegin or
+ * PhyTxEnd traces are connected, so that they keep the times of each
+ * packet; the Dequeue trace of the queue fires when the burst starts.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -271,6 +280,27 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Start Sending a Burst of Packets Down the Wire.
+   *
+   * The packets after the first one are taken from the queue, and the
+   * transmission of the burst is started on the channel with a single call.
+   * One event is scheduled for the time at which the last packet and its
+   * interframe gap have been transmitted.
+   *
+   * \see PointToPointChannel::TransmitBurst ()
+   * \param p the first packet of the burst
+   * \returns true if success, false on failure
+   */
+  bool TransmitBurst (Ptr<Packet> p);
+
+  /**
+   * \returns true if the queued packets are sent in bursts: MaxBurstSize
+   * is greater than one, and neither the sniffers nor the PhyTxBegin and
+   * PhyTxEnd traces, whose timestamps a burst would shift, are connected.
+   */
+  bool IsBurstEnabled (void) const;
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -461,6 +491,8 @@ private:
   uint32_t m_mtu;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  std::vector<Ptr<Packet> > m_currentBurst; //!< Packets of the current burst, m_currentPkt first
+  uint32_t m_maxBurstSize;  //!< The maximum number of packets of a burst
 
   /**
    * \brief PPP to Ethernet protocol number mapping
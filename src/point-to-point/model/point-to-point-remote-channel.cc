@@ -77,4 +77,34 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitBurst (
+  std::vector<Ptr<Packet> > const &burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &txTime,
+  Time interframeGap)
+{
+  NS_LOG_FUNCTION (this << burst.size () << src);
+
+  IsInitialized ();
+
+  uint32_t wire = src == GetSource (0) ? 0 : 1;
+  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+
+#ifdef NS3_MPI
+  // The packets go through MPI one by one anyway: send each one with the
+  // reception time of its last bit.
+  Time rxTime = Simulator::Now () + GetDelay ();
+  for (uint32_t i = 0; i < burst.size (); i++)
+    {
+      rxTime += txTime[i];
+      MpiInterface::SendPacket (burst[i]->Copy (), rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
+      rxTime += interframeGap;
+    }
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+  return true;
+}
+
 } // namespace ns3
@@ -68,6 +68,18 @@ public:
    */
   virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Transmit a burst of packets, each one at its own reception time
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time of each packet
+   * \param interframeGap Time between the packets
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBurst (std::vector<Ptr<Packet> > const &burst, Ptr<PointToPointNetDevice> src,
+                              std::vector<Time> const &txTime, Time interframeGap);
 };
 
 } // namespace ns3
@@ -24,6 +24,13 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
 
 using namespace ns3;
 
@@ -101,6 +108,329 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the bursts of the PointToPoint model
+ *
+ * It sends several packets at once from a device whose bursts are enabled,
+ * and checks that each packet is received at the arrival time of its own
+ * last bit, as without bursts.  With the PhyTxBegin and PhyTxEnd traces
+ * connected, the bursts are not used, and the traces fire at the times of
+ * each packet.
+ */
+class PointToPointBurstTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBurstTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param n number of packets
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+
+  /**
+   * \brief Receive a packet
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  /**
+   * \brief Record the start of the transmission of a packet
+   *
+   * \param p the packet
+   */
+  void TxBegin (Ptr<const Packet> p);
+
+  /**
+   * \brief Record the end of the transmission of a packet
+   *
+   * \param p the packet
+   */
+  void TxEnd (Ptr<const Packet> p);
+
+  /**
+   * \brief Send 6 packets at once on a link and check their times
+   *
+   * \param traceTx whether to connect the PhyTxBegin and PhyTxEnd traces
+   */
+  void RunLink (bool traceTx);
+
+  std::vector<Time> m_rxTime;  //!< Reception time of the packets
+  std::vector<uint64_t> m_rxUid; //!< Uid of the received packets
+  std::vector<Time> m_txBeginTime; //!< Transmission start time of the packets
+  std::vector<Time> m_txEndTime; //!< Transmission end time of the packets
+};
+
+PointToPointBurstTest::PointToPointBurstTest ()
+  : TestCase ("PointToPoint bursts")
+{
+}
+
+void
+PointToPointBurstTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      device->Send (p, device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointBurstTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_rxTime.push_back (Simulator::Now ());
+  m_rxUid.push_back (p->GetUid ());
+  return true;
+}
+
+void
+PointToPointBurstTest::TxBegin (Ptr<const Packet> p)
+{
+  m_txBeginTime.push_back (Simulator::Now ());
+}
+
+void
+PointToPointBurstTest::TxEnd (Ptr<const Packet> p)
+{
+  m_txEndTime.push_back (Simulator::Now ());
+}
+
+void
+PointToPointBurstTest::RunLink (bool traceTx)
+{
+  m_rxTime.clear ();
+  m_rxUid.clear ();
+  m_txBeginTime.clear ();
+  m_txEndTime.clear ();
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->SetAttribute ("MaxBurstSize", UintegerValue (3));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBurstTest::Receive, this));
+  if (traceTx)
+    {
+      devA->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&PointToPointBurstTest::TxBegin, this));
+      devA->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&PointToPointBurstTest::TxEnd, this));
+    }
+
+  // The first packet is sent alone, then the queued ones in bursts of 3
+  // and 2 packets
+  Simulator::Schedule (Seconds (1.0), &PointToPointBurstTest::SendPackets, this, devA, 6);
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTime.size (), 6, "Wrong number of received packets");
+  for (uint32_t i = 1; i < m_rxUid.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_GT (m_rxUid[i], m_rxUid[i - 1], "Packets received out of order");
+    }
+  // 1000 bytes and the PPP header
+  Time txTime = DataRate ("8Mbps").CalculateBytesTxTime (1002);
+  Time rxTime = Seconds (1.0) + MilliSeconds (1);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      rxTime += txTime;
+      NS_TEST_EXPECT_MSG_EQ (m_rxTime[i], rxTime, "Wrong reception time of packet " << i);
+    }
+
+  if (traceTx)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_txBeginTime.size (), 6, "Wrong number of started packets");
+      NS_TEST_ASSERT_MSG_EQ (m_txEndTime.size (), 6, "Wrong number of transmitted packets");
+      for (uint32_t i = 0; i < 6; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_txBeginTime[i], Seconds (1.0) + i * txTime,
+                                 "Wrong PhyTxBegin time of packet " << i);
+          NS_TEST_EXPECT_MSG_EQ (m_txEndTime[i], Seconds (1.0) + (i + 1) * txTime,
+                                 "Wrong PhyTxEnd time of packet " << i);
+        }
+    }
+}
+
+void
+PointToPointBurstTest::DoRun (void)
+{
+  RunLink (false);
+  RunLink (true);
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \brief Test class for the PointToPoint model in a multithreaded simulation
+ *
+ * The two nodes of a link run in two partitions of the
+ * MultithreadedSimulatorImpl and send packets to each other at the same
+ * times, so that both threads create packets concurrently. It checks that
+ * all the packets get a distinct uid, and that each packet keeps its uid
+ * when it is handed over to the other partition.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param side index of the sending node
+   * \param n number of packets
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t side, uint32_t n);
+
+  /**
+   * \brief Receive a packet
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  /** Number of times each node sends packets. */
+  static const uint32_t N_ROUNDS = 40;
+  /** Number of packets sent by each node at once. */
+  static const uint32_t N_PACKETS = 50;
+
+  Ptr<NetDevice> m_device[2];      //!< The devices of the nodes
+  std::vector<uint64_t> m_txUid[2]; //!< Uid of the packets sent by each node
+  std::vector<uint64_t> m_rxUid[2]; //!< Uid of the packets received by each node
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPoint in a multithreaded simulation")
+{
+}
+
+void
+PointToPointMultithreadedTest::DoSetup (void)
+{
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (2));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (MilliSeconds (1)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+}
+
+void
+PointToPointMultithreadedTest::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (0));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (NanoSeconds (1)));
+}
+
+void
+PointToPointMultithreadedTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t side, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100);
+      m_txUid[side].push_back (p->GetUid ());
+      device->Send (p, device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  // Each node only writes to its own vectors, from its own partition.
+  m_rxUid[device == m_device[0] ? 0 : 1].push_back (p->GetUid ());
+  return true;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  Ptr<PointToPointNetDevice> dev[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      // Consecutive node ids, hence different partitions
+      Ptr<Node> node = CreateObject<Node> ();
+      dev[i] = CreateObject<PointToPointNetDevice> ();
+      dev[i]->Attach (channel);
+      dev[i]->SetAddress (Mac48Address::Allocate ());
+      dev[i]->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+      dev[i]->SetDataRate (DataRate ("1Gbps"));
+      node->AddDevice (dev[i]);
+      dev[i]->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+      m_device[i] = dev[i];
+    }
+  for (uint32_t round = 0; round < N_ROUNDS; round++)
+    {
+      for (uint32_t i = 0; i < 2; i++)
+        {
+          Simulator::ScheduleWithContext (dev[i]->GetNode ()->GetId (), MicroSeconds (100 * round),
+                                          &PointToPointMultithreadedTest::SendPackets, this,
+                                          dev[i], i, N_PACKETS);
+        }
+    }
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+
+  std::vector<uint64_t> uids;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_txUid[i].size (), N_ROUNDS * N_PACKETS, "Wrong number of sent packets");
+      NS_TEST_EXPECT_MSG_EQ ((m_rxUid[1 - i] == m_txUid[i]), true, "Wrong uids received from node " << i);
+      uids.insert (uids.end (), m_txUid[i].begin (), m_txUid[i].end ());
+    }
+  std::sort (uids.begin (), uids.end ());
+  NS_TEST_EXPECT_MSG_EQ ((std::adjacent_find (uids.begin (), uids.end ()) == uids.end ()), true,
+                         "Two packets have the same uid");
+  m_device[0] = 0;
+  m_device[1] = 0;
+}
+#endif /* HAVE_PTHREAD_H */
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -117,6 +447,10 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBurstTest, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
+#endif
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
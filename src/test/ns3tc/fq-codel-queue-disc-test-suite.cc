@@ -485,6 +485,88 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * This class tests the flows separation without packet filters
+ */
+class FqCoDelQueueDiscNoFilter : public TestCase
+{
+public:
+  FqCoDelQueueDiscNoFilter ();
+  virtual ~FqCoDelQueueDiscNoFilter ();
+
+private:
+  virtual void DoRun (void);
+  void AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, UdpHeader udpHdr);
+};
+
+FqCoDelQueueDiscNoFilter::FqCoDelQueueDiscNoFilter ()
+  : TestCase ("Test flows separation without packet filters")
+{
+}
+
+FqCoDelQueueDiscNoFilter::~FqCoDelQueueDiscNoFilter ()
+{
+}
+
+void
+FqCoDelQueueDiscNoFilter::AddPacket (Ptr<FqCoDelQueueDisc> queue, Ipv4Header ipHdr, UdpHeader udpHdr)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (udpHdr);
+  Address dest;
+  Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, ipHdr);
+  queue->Enqueue (item);
+}
+
+void
+FqCoDelQueueDiscNoFilter::DoRun (void)
+{
+  // Without filters, the queue disc classifies the packets by the hash of their items
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("PacketLimit", UintegerValue (10),
+                                                                                  "Perturbation", UintegerValue (1234));
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  Ipv4Header hdr;
+  hdr.SetPayloadSize (100);
+  hdr.SetSource (Ipv4Address ("10.10.1.1"));
+  hdr.SetDestination (Ipv4Address ("10.10.1.2"));
+  hdr.SetProtocol (17);
+
+  UdpHeader udpHdr;
+  udpHdr.SetSourcePort (7);
+  udpHdr.SetDestinationPort (27);
+
+  // Add two packets from the first flow
+  AddPacket (queueDisc, hdr, udpHdr);
+  AddPacket (queueDisc, hdr, udpHdr);
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 1, "one flow queue should have been created");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (0)->GetQueueDisc ()->GetNPackets (), 2, "unexpected number of packets in the first flow queue");
+
+  // Add a packet from the second flow
+  udpHdr.SetSourcePort (8);
+  AddPacket (queueDisc, hdr, udpHdr);
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetNQueueDiscClasses (), 2, "two flow queues should have been created");
+  NS_TEST_ASSERT_MSG_EQ (queueDisc->GetQueueDiscClass (1)->GetQueueDisc ()->GetNPackets (), 1, "unexpected number of packets in the second flow queue");
+
+  // The filters classify with the same hash as the items
+  Ptr<FqCoDelIpv4PacketFilter> filter = CreateObjectWithAttributes<FqCoDelIpv4PacketFilter> ("Perturbation", UintegerValue (1234));
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (udpHdr);
+  Address dest;
+  Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, dest, 0, hdr);
+  uint32_t hash = item->Hash (1234);
+  NS_TEST_ASSERT_MSG_EQ (filter->Classify (item), static_cast<int32_t> (hash), "the filter and the item should agree on the hash");
+  NS_TEST_ASSERT_MSG_EQ (item->Hash (1234), hash, "the hash should not change");
+  udpHdr.SetSourcePort (7);
+  Ptr<Packet> q = Create<Packet> (100);
+  q->AddHeader (udpHdr);
+  Ptr<Ipv4QueueDiscItem> other = Create<Ipv4QueueDiscItem> (q, dest, 0, hdr);
+  NS_TEST_ASSERT_MSG_NE (other->Hash (1234), hash, "different flows should have different hashes");
+
+  Simulator::Destroy ();
+}
+
 class FqCoDelQueueDiscTestSuite : public TestSuite
 {
 public:
@@ -499,6 +581,7 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite ()
   AddTestCase (new FqCoDelQueueDiscDeficit, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscTCPFlowsSeparation, TestCase::QUICK);
   AddTestCase (new FqCoDelQueueDiscUDPFlowsSeparation, TestCase::QUICK);
+  AddTestCase (new FqCoDelQueueDiscNoFilter, TestCase::QUICK);
 }
 
 static FqCoDelQueueDiscTestSuite fqCoDelQueueDiscTestSuite;
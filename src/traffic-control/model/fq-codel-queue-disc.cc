@@ -123,6 +123,12 @@ TypeId FqCoDelQueueDisc::GetTypeId (void)
                    UintegerValue (64),
                    MakeUintegerAccessor (&FqCoDelQueueDisc::m_dropBatchSize),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Perturbation",
+                   "The salt used as an additional input to the hash function used to classify packets, "
+                   "when no packet filter is installed",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqCoDelQueueDisc::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -156,19 +162,28 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  int32_t ret = Classify (item);
-
-  if (ret == PacketFilter::PF_NO_MATCH)
+  uint32_t h;
+  if (GetNPacketFilters () == 0)
     {
-      NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
-      DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
-      return false;
+      // the hash is computed once per item, and cached in the item
+      h = item->Hash (m_perturbation) % m_flows;
     }
+  else
+    {
+      int32_t ret = Classify (item);
 
-  uint32_t h = ret % m_flows;
+      if (ret == PacketFilter::PF_NO_MATCH)
+        {
+          NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
+          DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+          return false;
+        }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+      h = ret % m_flows;
+    }
+
+  Ptr<FqCoDelFlow> flow = m_flowsIndices[h];
+  if (flow == 0)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
       flow = m_flowFactory.Create<FqCoDelFlow> ();
@@ -177,11 +192,7 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       flow->SetQueueDisc (qd);
       AddQueueDiscClass (flow);
 
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      m_flowsIndices[h] = flow;
     }
 
   if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
@@ -193,7 +204,7 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 
   flow->GetQueueDisc ()->Enqueue (item);
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
 
   if (GetNPackets () > m_limit)
     {
@@ -320,12 +331,6 @@ FqCoDelQueueDisc::CheckConfig (void)
       return false;
     }
 
-  if (GetNPacketFilters () == 0)
-    {
-      NS_LOG_ERROR ("FqCoDelQueueDisc needs at least a packet filter");
-      return false;
-    }
-
   if (GetNInternalQueues () > 0)
     {
       NS_LOG_ERROR ("FqCoDelQueueDisc cannot have internal queues");
@@ -350,6 +355,8 @@ FqCoDelQueueDisc::InitializeParams (void)
       NS_LOG_DEBUG ("Setting the quantum to the MTU of the device: " << m_quantum);
     }
 
+  m_flowsIndices.assign (m_flows, 0);
+
   m_flowFactory.SetTypeId ("ns3::FqCoDelFlow");
 
   m_queueDiscFactory.SetTypeId ("ns3::CoDelQueueDisc");
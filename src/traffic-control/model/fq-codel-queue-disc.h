@@ -25,7 +25,7 @@
 #include "ns3/queue-disc.h"
 #include "ns3/object-factory.h"
 #include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -149,11 +149,12 @@ private:
   uint32_t m_quantum;        //!< Deficit assigned to flows at each round
   uint32_t m_flows;          //!< Number of flow queues
   uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
+  uint32_t m_perturbation;   //!< Hash perturbation value, without packet filters
 
   std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
   std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
 
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
+  std::vector<Ptr<FqCoDelFlow> > m_flowsIndices;    //!< The class of each flow, indexed by flow hash (null if not created yet)
 
   ObjectFactory m_flowFactory;         //!< Factory to create a new flow
   ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
@@ -362,12 +362,14 @@ int main (int argc, char *argv[])
   uint32_t n = 0;
   uint32_t minIterations = 1;
   bool enablePrinting = false;
+  bool enableLightPrinting = false;
 
   CommandLine cmd;
   cmd.Usage ("Benchmark Packet class");
   cmd.AddValue ("n", "number of iterations", n);
   cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
   cmd.AddValue ("enable-printing", "enable packet printing", enablePrinting);
+  cmd.AddValue ("enable-light-printing", "enable packet printing, recording only the headers", enableLightPrinting);
   cmd.Parse (argc, argv);
 
   if (n == 0)
@@ -376,6 +378,15 @@ int main (int argc, char *argv[])
         "by command-line argument --n=(number of packets)" << std::endl;
       exit (1);
     }
+  if (enableLightPrinting)
+    {
+      PacketMetadata::EnableLight ();
+    }
+  else if (enablePrinting)
+    {
+      Packet::EnablePrinting ();
+    }
+
   std::cout << "Running bench-packets with n=" << n << std::endl;
   std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program prints a binary trace file, written by
+// AsciiTraceHelper::CreateBinaryFileStream, in the ascii trace format.
+// Sample usage:  ./waf --run 'binary-trace-to-ascii --input=trace.btr --output=trace.tr'
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace-file.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file to text");
+  cmd.AddValue ("input", "binary trace file, possibly compressed with gzip", input);
+  cmd.AddValue ("output", "text file (default: standard output)", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "Error-- the binary trace file must be specified " <<
+        "by command-line argument --input=(file name)" << std::endl;
+      exit (1);
+    }
+
+  bool converted;
+  if (output.empty ())
+    {
+      converted = BinaryTraceFile::ConvertToText (input, std::cout);
+    }
+  else
+    {
+      std::ofstream os (output.c_str ());
+      converted = BinaryTraceFile::ConvertToText (input, os);
+    }
+  if (!converted)
+    {
+      std::cerr << "Error-- cannot read " << input << std::endl;
+      exit (1);
+    }
+  return 0;
+}